@@ -0,0 +1,469 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <apps/Benchmark/benchmark.h>
+
+#include <apps/Benchmark/headlesswindowwrapper.h>
+
+#include <openspace/engine/openspaceengine.h>
+#include <openspace/performance/performancelayout.h>
+#include <openspace/performance/performancemanager.h>
+#include <openspace/properties/propertyregistry.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/scene/scene.h>
+#include <openspace/scene/scenegraphnode.h>
+#include <openspace/scripting/scriptengine.h>
+#include <openspace/util/camera.h>
+#include <openspace/util/time.h>
+
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/sharedmemory.h>
+
+#include <ext/json/json.hpp>
+
+#include <sgct.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+namespace {
+    const std::string _loggerCat = "Benchmark";
+
+    const std::string KeyFrameTime = "FrameTime";
+    const std::string KeyFrames = "Frames";
+    const std::string KeyWarmupFrames = "WarmupFrames";
+    const std::string KeyCamera = "Camera";
+    const std::string KeyTime = "Time";
+    const std::string KeyScripts = "Scripts";
+
+    const std::string KeyFrame = "Frame";
+    const std::string KeyAnchor = "Anchor";
+    const std::string KeyPosition = "Position";
+    const std::string KeyRotation = "Rotation";
+    const std::string KeyDeltaTime = "DeltaTime";
+    const std::string KeyPause = "Pause";
+    const std::string KeyScript = "Script";
+
+    const int DefaultNumberOfFrames = 600;
+    const int DefaultNumberOfWarmupFrames = 60;
+
+    // The version of the JSON output, which has to be increased if the layout changes
+    const int ResultVersion = 1;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    double microseconds(Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<double, std::micro>(end - start).count();
+    }
+
+    // Returns the entries of a Lua list, which are stored with the keys 1, 2, ...
+    std::vector<ghoul::Dictionary> listEntries(const ghoul::Dictionary& dictionary,
+                                               const std::string& key)
+    {
+        std::vector<ghoul::Dictionary> result;
+        if (!dictionary.hasKeyAndValue<ghoul::Dictionary>(key))
+            return result;
+
+        ghoul::Dictionary list = dictionary.value<ghoul::Dictionary>(key);
+        for (size_t i = 1; i <= list.size(); ++i) {
+            ghoul::Dictionary entry;
+            if (!list.getValue(std::to_string(i), entry)) {
+                throw ghoul::RuntimeError(
+                    "Entry " + std::to_string(i) + " of '" + key + "' is not a table",
+                    "Benchmark"
+                );
+            }
+            if (!entry.hasKeyAndValue<double>(KeyFrame)) {
+                throw ghoul::RuntimeError(
+                    "Entry " + std::to_string(i) + " of '" + key + "' has no Frame",
+                    "Benchmark"
+                );
+            }
+            result.push_back(std::move(entry));
+        }
+        return result;
+    }
+
+    int frameOf(const ghoul::Dictionary& entry) {
+        return static_cast<int>(entry.value<double>(KeyFrame));
+    }
+
+    template <typename T>
+    void sortByFrame(std::vector<T>& keyframes) {
+        std::stable_sort(keyframes.begin(), keyframes.end(),
+            [](const T& lhs, const T& rhs) { return lhs.frame < rhs.frame; }
+        );
+    }
+
+    nlohmann::json statistics(std::vector<double> values) {
+        nlohmann::json result = nlohmann::json::object();
+        result["count"] = values.size();
+        if (values.empty())
+            return result;
+
+        std::sort(values.begin(), values.end());
+        double sum = 0.0;
+        for (double v : values)
+            sum += v;
+
+        auto percentile = [&values](double p) {
+            size_t i = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+            return values[i];
+        };
+
+        result["mean"] = sum / values.size();
+        result["median"] = percentile(0.5);
+        result["p95"] = percentile(0.95);
+        result["max"] = values.back();
+        return result;
+    }
+}
+
+namespace openspace {
+namespace benchmark {
+
+const double Benchmark::DefaultFrameTime = 1.0 / 60.0;
+
+Benchmark::Benchmark(const ghoul::Dictionary& path)
+    : _frameTime(DefaultFrameTime)
+    , _nFrames(DefaultNumberOfFrames)
+    , _nWarmupFrames(DefaultNumberOfWarmupFrames)
+    , _loadTime(0.0)
+{
+    path.getValue(KeyFrameTime, _frameTime);
+
+    double nFrames = _nFrames;
+    path.getValue(KeyFrames, nFrames);
+    _nFrames = static_cast<int>(nFrames);
+
+    double nWarmupFrames = _nWarmupFrames;
+    path.getValue(KeyWarmupFrames, nWarmupFrames);
+    _nWarmupFrames = static_cast<int>(nWarmupFrames);
+
+    if (_frameTime <= 0.0)
+        throw ghoul::RuntimeError("FrameTime must be positive", "Benchmark");
+    if (_nFrames <= _nWarmupFrames)
+        throw ghoul::RuntimeError("Frames must exceed WarmupFrames", "Benchmark");
+
+    for (const ghoul::Dictionary& entry : listEntries(path, KeyCamera)) {
+        CameraKeyframe keyframe;
+        keyframe.frame = frameOf(entry);
+        keyframe.anchor = entry.value<std::string>(KeyAnchor);
+        if (!entry.getValue(KeyPosition, keyframe.position)) {
+            throw ghoul::RuntimeError(
+                "Camera keyframe at frame " + std::to_string(keyframe.frame) +
+                " has no Position",
+                "Benchmark"
+            );
+        }
+        // The rotation is given as {w, x, y, z}
+        glm::dvec4 rotation;
+        keyframe.hasRotation = entry.getValue(KeyRotation, rotation);
+        if (keyframe.hasRotation) {
+            keyframe.rotation = glm::normalize(
+                glm::dquat(rotation.x, rotation.y, rotation.z, rotation.w)
+            );
+        }
+        _cameraKeyframes.push_back(std::move(keyframe));
+    }
+
+    for (const ghoul::Dictionary& entry : listEntries(path, KeyTime)) {
+        TimeKeyframe keyframe;
+        keyframe.frame = frameOf(entry);
+        keyframe.hasTime = entry.getValue(KeyTime, keyframe.time);
+        keyframe.hasDeltaTime = entry.getValue(KeyDeltaTime, keyframe.deltaTime);
+        keyframe.hasPause = entry.getValue(KeyPause, keyframe.pause);
+        _timeKeyframes.push_back(std::move(keyframe));
+    }
+
+    for (const ghoul::Dictionary& entry : listEntries(path, KeyScripts)) {
+        ScriptKeyframe keyframe;
+        keyframe.frame = frameOf(entry);
+        keyframe.script = entry.value<std::string>(KeyScript);
+        _scriptKeyframes.push_back(std::move(keyframe));
+    }
+
+    sortByFrame(_cameraKeyframes);
+    sortByFrame(_timeKeyframes);
+    sortByFrame(_scriptKeyframes);
+}
+
+double Benchmark::frameTime() const {
+    return _frameTime;
+}
+
+void Benchmark::run(HeadlessWindowWrapper& window) {
+    // The scene is loaded in the first frame and initialized over the following ones
+    LINFO("Loading scene");
+    Clock::time_point loadStart = Clock::now();
+    do {
+        runFrame(-1);
+    } while (OsEng.renderEngine().scene()->isLoading() && !window.isTerminated());
+    _loadTime = microseconds(loadStart, Clock::now()) / 1e6;
+    LINFO("Loaded scene in " << _loadTime << " s");
+
+    for (const CameraKeyframe& keyframe : _cameraKeyframes) {
+        if (!OsEng.renderEngine().scene()->sceneGraphNode(keyframe.anchor)) {
+            throw ghoul::RuntimeError(
+                "Could not find camera anchor '" + keyframe.anchor + "'",
+                "Benchmark"
+            );
+        }
+    }
+
+    // The measurements of the PerfMeasure scopes are only available through the shared
+    // memory that the PerformanceManager writes to
+    OsEng.renderEngine().setPerformanceMeasurements(true);
+    ghoul::SharedMemory memory(
+        performance::PerformanceManager::PerformanceMeasurementSharedData
+    );
+
+    _records.clear();
+    _records.reserve(_nFrames - _nWarmupFrames);
+    LINFO("Running " << _nFrames << " frames");
+    for (int frame = 0; frame < _nFrames && !window.isTerminated(); ++frame) {
+        OsEng.renderEngine().performanceManager()->resetPerformanceMeasurements();
+
+        FrameRecord record = runFrame(frame);
+        if (frame < _nWarmupFrames)
+            continue;
+
+        // Only the scopes that were measured in this frame are present after the reset
+        memory.acquireLock();
+        const performance::PerformanceLayout* layout =
+            reinterpret_cast<const performance::PerformanceLayout*>(memory.memory());
+        for (int16_t i = 0; i < layout->nFunctionEntries; ++i) {
+            const performance::PerformanceLayout::FunctionPerformanceLayout& entry =
+                layout->functionEntries[i];
+            record.scopes[entry.name] =
+                entry.time[performance::PerformanceLayout::NumberValues - 1];
+        }
+        memory.releaseLock();
+
+        _records.push_back(std::move(record));
+    }
+
+    OsEng.renderEngine().setPerformanceMeasurements(false);
+}
+
+Benchmark::FrameRecord Benchmark::runFrame(int frame) {
+    FrameRecord record;
+    record.frame = frame;
+
+    if (frame >= 0)
+        applyTimeAndScripts(frame);
+    OsEng.setRunTime(std::max(frame, 0) * _frameTime);
+
+    Clock::time_point start = Clock::now();
+    OsEng.preSynchronization();
+    Clock::time_point preSynchronizationEnd = Clock::now();
+
+    // The camera is placed after the interaction handler has updated it and has to be
+    // published again, just as the interaction handler's changes are
+    if (frame >= 0 && !_cameraKeyframes.empty()) {
+        applyCamera(frame);
+        OsEng.renderEngine().camera()->preSynchronization();
+    }
+
+    Clock::time_point encodeStart = Clock::now();
+    // Calls OpenSpaceEngine::encode, which is registered as SGCT's encode function
+    sgct::SharedData::instance()->encode();
+    Clock::time_point encodeEnd = Clock::now();
+
+    OsEng.postSynchronizationPreDraw();
+    Clock::time_point postSynchronizationEnd = Clock::now();
+
+    // The parts of OpenSpaceEngine::postDraw that do not render
+    OsEng.renderEngine().postDraw();
+    properties::PropertyRegistry::ref().finishFrame();
+    Clock::time_point end = Clock::now();
+
+    record.simulationTime = Time::ref().currentTime();
+    record.phases["preSynchronization"] = microseconds(start, preSynchronizationEnd);
+    record.phases["encode"] = microseconds(encodeStart, encodeEnd);
+    record.phases["postSynchronizationPreDraw"] =
+        microseconds(encodeEnd, postSynchronizationEnd);
+    record.phases["postDraw"] = microseconds(postSynchronizationEnd, end);
+    record.total = microseconds(start, preSynchronizationEnd) +
+        microseconds(encodeStart, end);
+
+    if (frame >= _nWarmupFrames) {
+        Scene* scene = OsEng.renderEngine().scene();
+        for (SceneGraphNode* node : scene->allSceneGraphNodes()) {
+            const SceneGraphNode::PerformanceRecord& r = node->performanceRecord();
+            record.nodes[node->name()] = {
+                r.updateTimeEphemeris / 1000.0,
+                r.updateTimeRenderable / 1000.0
+            };
+        }
+    }
+
+    return record;
+}
+
+void Benchmark::applyTimeAndScripts(int frame) {
+    for (const TimeKeyframe& keyframe : _timeKeyframes) {
+        if (keyframe.frame != frame)
+            continue;
+        if (keyframe.hasTime)
+            Time::ref().setTime(keyframe.time);
+        if (keyframe.hasDeltaTime)
+            Time::ref().setDeltaTime(keyframe.deltaTime);
+        if (keyframe.hasPause)
+            Time::ref().setPause(keyframe.pause);
+    }
+
+    for (const ScriptKeyframe& keyframe : _scriptKeyframes) {
+        if (keyframe.frame == frame)
+            OsEng.scriptEngine().queueScript(keyframe.script);
+    }
+}
+
+void Benchmark::applyCamera(int frame) {
+    // The keyframes that enclose the frame; outside of the path, the camera stays at the
+    // first or last keyframe
+    auto next = std::upper_bound(
+        _cameraKeyframes.begin(),
+        _cameraKeyframes.end(),
+        frame,
+        [](int f, const CameraKeyframe& keyframe) { return f < keyframe.frame; }
+    );
+    const CameraKeyframe& k0 = (next == _cameraKeyframes.begin()) ? *next : *(next - 1);
+    const CameraKeyframe& k1 = (next == _cameraKeyframes.end()) ? k0 : *next;
+
+    double t = 0.0;
+    if (k1.frame > k0.frame)
+        t = static_cast<double>(frame - k0.frame) / (k1.frame - k0.frame);
+    t = glm::clamp(t, 0.0, 1.0);
+
+    glm::dvec3 anchor0 = anchorPosition(k0.anchor);
+    glm::dvec3 anchor1 = anchorPosition(k1.anchor);
+    glm::dvec3 position = glm::mix(anchor0 + k0.position, anchor1 + k1.position, t);
+
+    Camera* camera = OsEng.renderEngine().camera();
+    camera->setPositionVec3(position);
+
+    if (k0.hasRotation && k1.hasRotation)
+        camera->setRotation(glm::slerp(k0.rotation, k1.rotation, t));
+    else {
+        glm::dvec3 target = glm::normalize(glm::mix(anchor0, anchor1, t) - position);
+        glm::dmat4 lookAt = glm::lookAt(
+            glm::dvec3(0.0),
+            target,
+            glm::dvec3(camera->lookUpVectorCameraSpace())
+        );
+        camera->setRotation(glm::quat_cast(lookAt));
+    }
+}
+
+glm::dvec3 Benchmark::anchorPosition(const std::string& anchor) const {
+    const SceneGraphNode* node = OsEng.renderEngine().scene()->sceneGraphNode(anchor);
+    return node->worldPosition().dvec3();
+}
+
+void Benchmark::writeResults(std::ostream& stream) const {
+    using nlohmann::json;
+
+    json result = json::object();
+    result["version"] = ResultVersion;
+    result["unit"] = "us";
+    result["frameTime"] = _frameTime;
+    result["warmupFrames"] = _nWarmupFrames;
+    result["loadTime"] = _loadTime;
+
+    std::vector<double> totals;
+    std::map<std::string, std::vector<double>> phases;
+    std::map<std::string, std::vector<double>> scopes;
+    std::map<std::string, std::vector<double>> ephemerisTimes;
+    std::map<std::string, std::vector<double>> renderableTimes;
+
+    json frames = json::array();
+    for (const FrameRecord& record : _records) {
+        json frame = json::object();
+        frame["frame"] = record.frame;
+        frame["simulationTime"] = record.simulationTime;
+        frame["total"] = record.total;
+        totals.push_back(record.total);
+
+        json phasesJson = json::object();
+        for (const std::pair<const std::string, double>& p : record.phases) {
+            phasesJson[p.first] = p.second;
+            phases[p.first].push_back(p.second);
+        }
+        frame["phases"] = phasesJson;
+
+        json scopesJson = json::object();
+        for (const std::pair<const std::string, double>& s : record.scopes) {
+            scopesJson[s.first] = s.second;
+            scopes[s.first].push_back(s.second);
+        }
+        frame["scopes"] = scopesJson;
+
+        json nodesJson = json::object();
+        for (const std::pair<const std::string, NodeTimes>& n : record.nodes) {
+            json node = json::object();
+            node["updateEphemeris"] = n.second.updateEphemeris;
+            node["updateRenderable"] = n.second.updateRenderable;
+            nodesJson[n.first] = node;
+            ephemerisTimes[n.first].push_back(n.second.updateEphemeris);
+            renderableTimes[n.first].push_back(n.second.updateRenderable);
+        }
+        frame["nodes"] = nodesJson;
+
+        frames.push_back(frame);
+    }
+
+    json summary = json::object();
+    summary["total"] = statistics(totals);
+
+    json phasesSummary = json::object();
+    for (const std::pair<const std::string, std::vector<double>>& p : phases)
+        phasesSummary[p.first] = statistics(p.second);
+    summary["phases"] = phasesSummary;
+
+    // Scopes that are not measured in every frame have a lower count
+    json scopesSummary = json::object();
+    for (const std::pair<const std::string, std::vector<double>>& s : scopes)
+        scopesSummary[s.first] = statistics(s.second);
+    summary["scopes"] = scopesSummary;
+
+    json nodesSummary = json::object();
+    for (const std::pair<const std::string, std::vector<double>>& n : ephemerisTimes) {
+        json node = json::object();
+        node["updateEphemeris"] = statistics(n.second);
+        node["updateRenderable"] = statistics(renderableTimes.at(n.first));
+        nodesSummary[n.first] = node;
+    }
+    summary["nodes"] = nodesSummary;
+
+    result["summary"] = summary;
+    result["frames"] = frames;
+
+    stream << result.dump(4) << std::endl;
+}
+
+} // namespace benchmark
+} // namespace openspace
@@ -0,0 +1,152 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <ghoul/glm.h>
+#include <ghoul/misc/dictionary.h>
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace openspace {
+namespace benchmark {
+
+class HeadlessWindowWrapper;
+
+/**
+ * Drives the frame loop of the OpenSpaceEngine without rendering and measures the CPU
+ * time of every frame. The camera and the simulation time follow a path that is read
+ * from a Lua file returning a table with the following keys, all of which are optional:
+ * - <code>FrameTime</code>: the simulated time in seconds between frames (1/60)
+ * - <code>Frames</code>: the number of frames that are run (600)
+ * - <code>WarmupFrames</code>: the number of frames at the beginning that are run but
+ *   not measured (60)
+ * - <code>Camera</code>: a list of keyframes with a <code>Frame</code>, a
+ *   <code>Position</code> in meters relative to the scene graph node
+ *   <code>Anchor</code>, and an optional <code>Rotation</code> quaternion given as
+ *   <code>{w, x, y, z}</code>. Without a rotation, the camera looks at the anchor. The
+ *   camera is interpolated linearly between the keyframes.
+ * - <code>Time</code>: a list of keyframes with a <code>Frame</code> and any of
+ *   <code>Time</code> (a date string), <code>DeltaTime</code>, and <code>Pause</code>,
+ *   which are applied when the frame is reached
+ * - <code>Scripts</code>: a list of entries with a <code>Frame</code> and a Lua
+ *   <code>Script</code> that is queued at that frame
+ *
+ * The frame loop calls the same methods as the SGCT callbacks of the OpenSpace
+ * application, except for the rendering. The measured frames are written as JSON with
+ * the time of each phase of the frame, of the <code>PerfMeasure</code> scopes, and of the
+ * update of each scene graph node.
+ */
+class Benchmark {
+public:
+    /// The default number of simulated seconds between two frames
+    static const double DefaultFrameTime;
+
+    /**
+     * Creates the Benchmark from the dictionary of a path file.
+     * \throw ghoul::RuntimeError If the dictionary contains invalid values
+     */
+    explicit Benchmark(const ghoul::Dictionary& path);
+
+    /// Returns the simulated time in seconds between two frames
+    double frameTime() const;
+
+    /**
+     * Waits for the scene to be loaded and runs all frames of the path. Stops early if
+     * the engine requests the \p window to be terminated.
+     * \throw ghoul::RuntimeError If a camera anchor does not exist in the scene
+     */
+    void run(HeadlessWindowWrapper& window);
+
+    /// Writes the measured frames and their statistics as JSON
+    void writeResults(std::ostream& stream) const;
+
+private:
+    struct CameraKeyframe {
+        int frame;
+        std::string anchor;
+        glm::dvec3 position;
+        bool hasRotation;
+        glm::dquat rotation;
+    };
+
+    struct TimeKeyframe {
+        int frame;
+        bool hasTime;
+        std::string time;
+        bool hasDeltaTime;
+        double deltaTime;
+        bool hasPause;
+        bool pause;
+    };
+
+    struct ScriptKeyframe {
+        int frame;
+        std::string script;
+    };
+
+    struct NodeTimes {
+        double updateEphemeris;
+        double updateRenderable;
+    };
+
+    // All times are in microseconds
+    struct FrameRecord {
+        int frame;
+        double simulationTime;
+        double total;
+        std::map<std::string, double> phases;
+        std::map<std::string, double> scopes;
+        std::map<std::string, NodeTimes> nodes;
+    };
+
+    /// Runs a single frame and returns its measurements
+    FrameRecord runFrame(int frame);
+
+    void applyTimeAndScripts(int frame);
+    void applyCamera(int frame);
+
+    /// Returns the world position of the scene graph node <code>anchor</code>
+    glm::dvec3 anchorPosition(const std::string& anchor) const;
+
+    double _frameTime;
+    int _nFrames;
+    int _nWarmupFrames;
+
+    std::vector<CameraKeyframe> _cameraKeyframes;
+    std::vector<TimeKeyframe> _timeKeyframes;
+    std::vector<ScriptKeyframe> _scriptKeyframes;
+
+    double _loadTime;
+    std::vector<FrameRecord> _records;
+};
+
+} // namespace benchmark
+} // namespace openspace
+
+#endif // __BENCHMARK_H__
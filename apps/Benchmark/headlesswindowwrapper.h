@@ -0,0 +1,65 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __HEADLESSWINDOWWRAPPER_H__
+#define __HEADLESSWINDOWWRAPPER_H__
+
+#include <openspace/engine/wrapper/windowwrapper.h>
+
+namespace openspace {
+namespace benchmark {
+
+/**
+ * A WindowWrapper without any windows that reports a fixed frame time, so that the
+ * simulation advances by the same amount every frame regardless of how long the frame
+ * took to compute. All other methods keep the no-op defaults of the WindowWrapper.
+ */
+class HeadlessWindowWrapper : public WindowWrapper {
+public:
+    /**
+     * \param frameTime The simulated time in seconds between two frames
+     * \param resolution The resolution that is reported for the nonexistent window
+     */
+    HeadlessWindowWrapper(double frameTime, glm::ivec2 resolution);
+
+    void terminate() override;
+    double averageDeltaTime() const override;
+    glm::ivec2 currentWindowSize() const override;
+
+    /// Sets the simulated time in seconds between two frames
+    void setFrameTime(double frameTime);
+
+    /// Returns whether the engine requested the application to terminate
+    bool isTerminated() const;
+
+private:
+    double _frameTime;
+    glm::ivec2 _resolution;
+    bool _isTerminated;
+};
+
+} // namespace benchmark
+} // namespace openspace
+
+#endif // __HEADLESSWINDOWWRAPPER_H__
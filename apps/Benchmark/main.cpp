@@ -0,0 +1,162 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <apps/Benchmark/benchmark.h>
+#include <apps/Benchmark/headlesswindowwrapper.h>
+
+#include <openspace/engine/openspaceengine.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/opengl/ghoul_gl.h>
+
+#include <sgct.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    const std::string _loggerCat = "Benchmark";
+
+    const std::string DefaultOutputFile = "benchmark.json";
+
+    // The size of the nonexistent window that is reported to the engine
+    const glm::ivec2 Resolution = glm::ivec2(1280, 720);
+}
+
+void encodeFunction() {
+    OsEng.encode();
+}
+
+// Creates a hidden window, as the renderables need an OpenGL context to initialize their
+// resources, even though nothing is rendered
+GLFWwindow* createOffscreenContext() {
+    if (!glfwInit())
+        return nullptr;
+
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#endif
+
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    GLFWwindow* offscreen = glfwCreateWindow(Resolution.x, Resolution.y, "", nullptr, nullptr);
+    if (!offscreen)
+        return nullptr;
+    glfwMakeContextCurrent(offscreen);
+
+    glewExperimental = GL_TRUE;
+    glewInit();
+    return offscreen;
+}
+
+int main(int argc, char** argv) {
+    using namespace openspace;
+
+    // The arguments of the benchmark are removed, all others are passed to the engine
+    std::string pathFile;
+    std::string outputFile = DefaultOutputFile;
+    std::vector<char*> engineArguments = { argv[0] };
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if ((argument == "-path" || argument == "-p") && i + 1 < argc)
+            pathFile = argv[++i];
+        else if ((argument == "-output" || argument == "-o") && i + 1 < argc)
+            outputFile = argv[++i];
+        else
+            engineArguments.push_back(argv[i]);
+    }
+
+    if (pathFile.empty()) {
+        std::cerr << "Usage: " << argv[0] << " -path <path file> [-output <json file>] "
+                  << "[-config <configuration file>] [-scene <scene file>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    GLFWwindow* offscreen = createOffscreenContext();
+    if (!offscreen) {
+        std::cerr << "Could not create an OpenGL context" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The path file can only be loaded once the engine has registered the path tokens,
+    // so the frame time of the window is set afterwards
+    std::unique_ptr<benchmark::HeadlessWindowWrapper> window =
+        std::make_unique<benchmark::HeadlessWindowWrapper>(
+            benchmark::Benchmark::DefaultFrameTime,
+            Resolution
+        );
+    benchmark::HeadlessWindowWrapper* windowPtr = window.get();
+
+    std::vector<std::string> sgctArguments;
+    const bool success = OpenSpaceEngine::create(
+        static_cast<int>(engineArguments.size()),
+        engineArguments.data(),
+        std::move(window),
+        sgctArguments
+    );
+    if (!success)
+        return EXIT_FAILURE;
+
+    int result = EXIT_SUCCESS;
+    try {
+        ghoul::Dictionary path;
+        ghoul::lua::loadDictionaryFromFile(absPath(pathFile), path);
+        benchmark::Benchmark benchmark(path);
+        windowPtr->setFrameTime(benchmark.frameTime());
+
+        // There is only a single node, which is the master
+        OsEng.setMaster(true);
+        sgct::SharedData::instance()->setEncodeFunction(encodeFunction);
+
+        if (!OsEng.initialize() || !OsEng.initializeGL())
+            throw ghoul::RuntimeError("Initializing OpenSpaceEngine failed", "Benchmark");
+
+        benchmark.run(*windowPtr);
+
+        std::ofstream file(absPath(outputFile));
+        if (!file.good())
+            throw ghoul::RuntimeError("Could not open '" + outputFile + "'", "Benchmark");
+        benchmark.writeResults(file);
+        LINFO("Wrote results to '" << absPath(outputFile) << "'");
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LFATALC(e.component, e.message);
+        result = EXIT_FAILURE;
+    }
+
+    sgct::SharedData::instance()->setEncodeFunction(nullptr);
+    OpenSpaceEngine::destroy();
+
+    glfwDestroyWindow(offscreen);
+    glfwTerminate();
+    return result;
+}
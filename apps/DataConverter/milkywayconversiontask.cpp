@@ -1,7 +1,7 @@
 #include <apps/DataConverter/milkywayconversiontask.h>
 #include <modules/volume/textureslicevolumereader.h>
 #include <modules/volume/rawvolumewriter.h>
-#include <modules/volume/volumesampler.h>
+#include <modules/volume/volumeresampler.h>
 
 namespace openspace {
 namespace dataconverter {
@@ -33,17 +33,16 @@ void MilkyWayConversionTask::perform(const std::function<void(float)>& onProgres
     RawVolumeWriter<glm::tvec4<GLfloat>> rawWriter(_outFilename);
     rawWriter.setDimensions(_outDimensions);
 
-    glm::vec3 resolutionRatio =
-        static_cast<glm::vec3>(sliceReader.dimensions()) / static_cast<glm::vec3>(rawWriter.dimensions());
+    VolumeResampler<TextureSliceVolumeReader<glm::tvec4<GLfloat>>> resampler(
+        sliceReader,
+        rawWriter.dimensions()
+    );
+    std::function<void(int, glm::tvec4<GLfloat>*)> sliceFunction =
+        [&](int z, glm::tvec4<GLfloat>* slice) {
+            resampler.sampleSlice(z, slice);
+        };
 
-    VolumeSampler<TextureSliceVolumeReader<glm::tvec4<GLfloat>>> sampler(sliceReader, resolutionRatio);
-    std::function<glm::tvec4<GLfloat>(glm::ivec3)> sampleFunction = [&](glm::ivec3 outCoord) {
-        glm::vec3 inCoord = ((glm::vec3(outCoord) + glm::vec3(0.5)) * resolutionRatio) - glm::vec3(0.5);
-        glm::tvec4<GLfloat> value = sampler.sample(inCoord);
-        return value;
-    };
-
-    rawWriter.write(sampleFunction, onProgress);
+    rawWriter.writeSlices(sliceFunction, onProgress);
 }
 
 }
@@ -2,14 +2,22 @@
 #include <modules/volume/textureslicevolumereader.h>
 #include <modules/volume/rawvolumewriter.h>
 #include <modules/volume/volumesampler.h>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <vector>
+
+namespace {
+    // The number of bytes that are read from the point file at a time
+    const size_t ChunkSize = 16 * 1024 * 1024;
+}
 
 namespace openspace {
 namespace dataconverter {
     
 
-
 MilkyWayPointsConversionTask::MilkyWayPointsConversionTask(
     const std::string& inFilename,
     const std::string& outFilename)
@@ -18,39 +26,81 @@ MilkyWayPointsConversionTask::MilkyWayPointsConversionTask(
 
 
 void MilkyWayPointsConversionTask::perform(const std::function<void(float)>& onProgress) {
-    std::ifstream in(_inFilename, std::ios::in);
+    std::ifstream in(_inFilename, std::ios::in | std::ios::binary);
     std::ofstream out(_outFilename, std::ios::out | std::ios::binary);
       
     std::string format;
     int64_t nPoints;
     in >> format >> nPoints;
 
-
- 
     size_t nFloats = nPoints * 7;
+    std::vector<float> pointData(nFloats);
+
+    // The file is read in large chunks and parsed in place. Each chunk is only parsed up
+    // to its last whitespace; the remainder is carried over to the next chunk so that no
+    // number is split
+    std::vector<char> buffer(ChunkSize + 1);
+    size_t nCarried = 0;
+    size_t nParsed = 0;
+    while (nParsed < nFloats) {
+        in.read(buffer.data() + nCarried, ChunkSize - nCarried);
+        size_t nRead = nCarried + static_cast<size_t>(in.gcount());
+        bool isLastChunk = !in.good();
+
+        size_t end = nRead;
+        if (!isLastChunk) {
+            while (end > 0 && !std::isspace(static_cast<unsigned char>(buffer[end - 1]))) {
+                --end;
+            }
+            if (end == 0) {
+                break;
+            }
+        }
+
+        char carried = buffer[end];
+        buffer[end] = '\0';
 
-    float* pointData = new float[nFloats];
-
-    float x, y, z, r, g, b, a;
-    for (size_t i = 0; i < nPoints; ++i) {
-        in >> x >> y >> z >> r >> g >> b >> a;
-        if (in.good()) {
-            pointData[i * 7 + 0] = x;
-            pointData[i * 7 + 1] = y;
-            pointData[i * 7 + 2] = z;
-            pointData[i * 7 + 3] = r;
-            pointData[i * 7 + 4] = g;
-            pointData[i * 7 + 5] = b;
-            pointData[i * 7 + 6] = a;
-            onProgress(static_cast<float>(i + 1) / nPoints);
-        } else {
-            std::cout << "Failed to convert point data.";
-            return;
+        char* p = buffer.data();
+        char* bufferEnd = buffer.data() + end;
+        bool failed = false;
+        while (nParsed < nFloats) {
+            while (p < bufferEnd && std::isspace(static_cast<unsigned char>(*p))) {
+                ++p;
+            }
+            if (p == bufferEnd) {
+                break;
+            }
+            char* next;
+            pointData[nParsed] = std::strtof(p, &next);
+            if (next == p) {
+                failed = true;
+                break;
+            }
+            ++nParsed;
+            p = next;
         }
+
+        buffer[end] = carried;
+        if (failed) {
+            break;
+        }
+
+        nCarried = nRead - end;
+        std::memmove(buffer.data(), buffer.data() + end, nCarried);
+        onProgress(static_cast<float>(nParsed) / nFloats);
+
+        if (isLastChunk) {
+            break;
+        }
+    }
+
+    if (nParsed < nFloats) {
+        std::cout << "Failed to convert point data.";
+        return;
     }
 
     out.write(reinterpret_cast<char*>(&nPoints), sizeof(int64_t));
-    out.write(reinterpret_cast<char*>(pointData), nFloats * sizeof(float));
+    out.write(reinterpret_cast<char*>(pointData.data()), nFloats * sizeof(float));
 
     in.close();
     out.close();
@@ -34,6 +34,7 @@ return {
                 ColorTextureMinimumSize = 1024,
                 OverlayMinimumSize = 2048,
                 HeightMapMinimumSize = 64,
+                ReadThreads = 4,
             },
             Textures = {
                 ColorTextures = {
@@ -95,6 +95,9 @@ public:
     /// The key that sets the request URL that is used to request additional data to be
     /// downloaded
     static const std::string KeyDownloadRequestURL;
+    /// The key that stores the maximum number of status messages per second that are
+    /// sent to the external control applications
+    static const std::string KeyExternalControlStatusRate;
 
     /**
      * Iteratively walks the directory structure starting with \p filename to find the
@@ -88,6 +88,7 @@ public:
     WindowWrapper& windowWrapper();
     ghoul::fontrendering::FontManager& fontManager();
     DownloadManager& downloadManager();
+    SyncBuffer& syncBuffer();
 
 #ifdef OPENSPACE_MODULE_ONSCREENGUI_ENABLED
     gui::GUI& gui();
@@ -26,9 +26,11 @@
 #define __INTERACTIONHANDLER_H__
 
 #include <openspace/interaction/keyboardcontroller.h>
+#include <openspace/interaction/keyframebuffer.h>
 #include <openspace/interaction/mousecontroller.h>
 #include <openspace/network/parallelconnection.h>
 #include <openspace/properties/propertyowner.h>
+#include <openspace/properties/scalarproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/util/mouse.h>
 #include <openspace/util/keys.h>
@@ -166,13 +168,21 @@ public:
     // Mutators
     void addKeyframe(const network::datamessagestructures::PositionKeyframe &kf);
     void clearKeyframes();
+    void setKeyframeLatency(double latency);
 
     // Accessors
     const std::list<std::pair<Key, KeyModifier> >& getPressedKeys();
     const std::list<MouseButton>& getPressedMouseButtons();
     glm::dvec2 getMousePosition();
     double getMouseScrollDelta();
-    std::vector<network::datamessagestructures::PositionKeyframe>& getKeyFrames();
+
+    bool hasKeyframes();
+
+    /**
+     * Samples the buffered keyframes at the current time, see KeyframeBuffer::sample.
+     * The time is taken from the same clock as the arrival times of the keyframes.
+     */
+    KeyframeBuffer::State sampleKeyframes(glm::dvec3& position, glm::dquat& rotation);
 
     bool isKeyPressed(std::pair<Key, KeyModifier> keyModPair);
     bool isMouseButtonPressed(MouseButton mouseButton);
@@ -183,8 +193,8 @@ private:
     glm::dvec2 _mousePosition;
     double _mouseScrollDelta;
 
-    // Remote input via keyframes
-    std::vector<network::datamessagestructures::PositionKeyframe> _keyframes;
+    // Remote input via keyframes, which are added from the network thread
+    KeyframeBuffer _keyframes;
     std::mutex _keyframeMutex;
 };
 
@@ -248,8 +258,6 @@ public:
     ~KeyframeInteractionMode();
 
     virtual void update(double deltaTime);
-private:
-    double _currentKeyframeTime;
 };
 
 class OrbitalInteractionMode : public InteractionMode
@@ -362,6 +370,7 @@ private:
     std::shared_ptr<InteractionMode> _currentInteractionMode;
 
     std::shared_ptr<OrbitalInteractionMode> _orbitalInteractionMode;
+    std::shared_ptr<KeyframeInteractionMode> _keyframeInteractionMode;
 
 #ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
     std::shared_ptr<GlobeBrowsingInteractionMode> _globebrowsingInteractionMode;
@@ -373,6 +382,7 @@ private:
 
     properties::BoolProperty _rotationalFriction;
     properties::BoolProperty _zoomFriction;
+    properties::FloatProperty _keyframeLatency;
 };
 
 #endif // USE_OLD_INTERACTIONHANDLER
@@ -0,0 +1,147 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __KEYFRAMEBUFFER_H__
+#define __KEYFRAMEBUFFER_H__
+
+#include <ghoul/glm.h>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+
+namespace openspace {
+namespace interaction {
+
+/**
+ * A jitter buffer for camera keyframes that are received from a remote host. The
+ * keyframes are stamped with the host's clock and arrive with a varying delay. From the
+ * arrival times, the buffer estimates the offset between the host's clock and the local
+ * clock, including the smallest network delay, and plays the keyframes back a fixed
+ * target latency behind the host. Between keyframes, the position is interpolated with
+ * a cubic Hermite spline and the rotation with slerp. If the next keyframe has not
+ * arrived in time, the motion is extrapolated for a limited time. Afterwards the camera
+ * returns to the last keyframe within the same time and is held there, as the host has
+ * most likely stopped at that keyframe.
+ *
+ * All times are passed in explicitly, so the buffer is deterministic. It is not
+ * thread-safe.
+ */
+class KeyframeBuffer {
+public:
+    struct Keyframe {
+        /// The time on the remote host's clock at which the keyframe was taken
+        double timeStamp;
+        glm::dvec3 position;
+        glm::dquat rotation;
+    };
+
+    enum class State {
+        /// No keyframes have been received
+        Empty,
+        /// The camera is between two keyframes
+        Interpolated,
+        /// The camera is past the last keyframe and continues its motion, or returns to
+        /// the last keyframe after the extrapolation
+        Extrapolated,
+        /// The camera is held at the first or last keyframe
+        Held
+    };
+
+    /**
+     * \param capacity The largest number of keyframes that are buffered; when it is
+     * exceeded, the oldest keyframe is dropped
+     * \param targetLatency The time in seconds that the playback lags behind the
+     * arrival of keyframes that had the smallest delay
+     * \param maximumExtrapolation The longest time in seconds that the motion is
+     * extrapolated past the last keyframe, which is also the time it takes to return to
+     * the last keyframe afterwards
+     */
+    KeyframeBuffer(size_t capacity = 64, double targetLatency = 0.1,
+        double maximumExtrapolation = 0.5);
+
+    /**
+     * Adds a keyframe that arrived at <code>localTime</code>. Keyframes that are not
+     * newer than the last added keyframe are dropped.
+     */
+    void addKeyframe(const Keyframe& keyframe, double localTime);
+
+    /**
+     * Advances the playback to <code>localTime</code> and writes the camera state at
+     * that time to <code>position</code> and <code>rotation</code>, unless the buffer
+     * is empty. <code>localTime</code> must not decrease between calls.
+     */
+    State sample(double localTime, glm::dvec3& position, glm::dquat& rotation);
+
+    void clear();
+
+    bool isEmpty() const;
+    size_t size() const;
+
+    void setTargetLatency(double targetLatency);
+    double targetLatency() const;
+
+    /**
+     * Returns the estimated difference between the local clock and the host's clock,
+     * including the smallest delay of the keyframes
+     */
+    double clockOffset() const;
+
+    /// Returns the smoothed deviation of the keyframe delays from the smallest one
+    double jitter() const;
+
+    /// Returns the time on the host's clock that was last played back
+    double playbackTime() const;
+
+private:
+    const Keyframe& at(size_t i) const;
+    void popFront();
+
+    void updatePlaybackTime(double localTime);
+    void updateClockOffset();
+
+    std::vector<Keyframe> _keyframes;
+    size_t _first;
+    size_t _size;
+
+    // The differences between arrival time and time stamp of the latest keyframes
+    std::vector<double> _delays;
+    size_t _nextDelay;
+    size_t _nDelays;
+
+    double _targetLatency;
+    double _maximumExtrapolation;
+
+    double _clockOffset;
+    double _jitter;
+    double _newestTimeStamp;
+
+    bool _isPlaying;
+    double _playbackTime;
+    double _lastLocalTime;
+};
+
+} // namespace interaction
+} // namespace openspace
+
+#endif // __KEYFRAMEBUFFER_H__
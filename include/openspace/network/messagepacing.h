@@ -0,0 +1,108 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __MESSAGEPACING_H__
+#define __MESSAGEPACING_H__
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace openspace {
+namespace network {
+
+/**
+ * Limits how many messages are sent per second. The time is passed in by the caller, so
+ * that one clock reading can be shared with other checks.
+ */
+class MessageRateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * \param messagesPerSecond The maximum number of messages per second; if it is not
+     * positive, every message is allowed
+     */
+    explicit MessageRateLimiter(double messagesPerSecond);
+
+    /// Sets the maximum number of messages per second, see the constructor
+    void setRate(double messagesPerSecond);
+
+    /**
+     * Returns <code>true</code> if a message may be sent at \p now, in which case the
+     * next message is only allowed once the interval of the rate has passed.
+     */
+    bool allow(Clock::time_point now);
+
+private:
+    Clock::duration _interval;
+    Clock::time_point _lastMessageTime;
+    bool _hasAllowedMessage;
+};
+
+/**
+ * A sequence of messages that are sent with pauses in between, so that the receiver has
+ * time to process each of them. The last message is preceded by an additional pause.
+ */
+class PacedMessageSequence {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * \param interval The pause after each message
+     * \param finalDelay The additional pause before the last message
+     */
+    PacedMessageSequence(Clock::duration interval, Clock::duration finalDelay);
+
+    /// Replaces the sequence with \p messages, the first of which is due at \p now
+    void start(std::vector<std::vector<char>> messages, Clock::time_point now);
+
+    /// Discards the messages that were not sent yet
+    void clear();
+
+    /// Returns <code>true</code> while messages of the sequence are left
+    bool isActive() const;
+
+    /// Returns the time the next message is due, which is only valid while active
+    Clock::time_point nextMessageTime() const;
+
+    /**
+     * Returns the next message if it is due at \p now, or <code>nullptr</code>. The
+     * pause to the message after it is counted from \p now. The returned message stays
+     * valid until the sequence is started or cleared again.
+     */
+    const std::vector<char>* next(Clock::time_point now);
+
+private:
+    Clock::duration _interval;
+    Clock::duration _finalDelay;
+    std::vector<std::vector<char>> _messages;
+    size_t _nextMessage;
+    Clock::time_point _nextMessageTime;
+};
+
+} // namespace network
+} // namespace openspace
+
+#endif // __MESSAGEPACING_H__
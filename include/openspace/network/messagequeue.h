@@ -0,0 +1,118 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __MESSAGEQUEUE_H__
+#define __MESSAGEQUEUE_H__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace openspace {
+namespace network {
+
+/**
+ * A bounded queue of messages from one producing thread to one consuming thread, which
+ * never locks. Each slot keeps its buffer, so once the queue has been filled, messages
+ * are written into memory that was allocated for earlier messages. If the consumer falls
+ * behind, #beginPush fails instead of letting the queue grow.
+ */
+class MessageQueue {
+public:
+    /// \param capacity The maximum number of messages that can be queued
+    explicit MessageQueue(size_t capacity);
+
+    /**
+     * Returns the emptied buffer of the next free slot for the producer to write the
+     * message into, or <code>nullptr</code> if the queue is full. The message is queued
+     * with #endPush. Must only be called by the producer.
+     */
+    std::vector<char>* beginPush();
+
+    /// Queues the message that was written into the buffer returned by #beginPush
+    void endPush();
+
+    /**
+     * Returns the oldest message, or <code>nullptr</code> if the queue is empty. The
+     * message stays valid until #pop is called. Must only be called by the consumer.
+     */
+    const std::vector<char>* front();
+
+    /// Removes the message returned by #front
+    void pop();
+
+    bool isEmpty() const;
+    size_t capacity() const;
+
+private:
+    std::vector<std::vector<char>> _slots;
+
+    // Both indices increase monotonically and are wrapped when used. The producer owns
+    // _tail and the consumer owns _head; they are on separate cache lines
+    alignas(64) std::atomic<size_t> _head;
+    alignas(64) std::atomic<size_t> _tail;
+};
+
+/**
+ * Hands the latest of a series of messages from one producing thread to one consuming
+ * thread, which never locks. A message that is published before the consumer took the
+ * previous one replaces it. This is a triple buffer: the producer and the consumer each
+ * own one buffer, and the third is exchanged between them.
+ */
+class LatestMessageBuffer {
+public:
+    LatestMessageBuffer();
+
+    /**
+     * Returns the buffer that the producer writes the next message into. It contains the
+     * message that was written into it before. Must only be called by the producer.
+     */
+    std::vector<char>& writeBuffer();
+
+    /// Publishes the message in the buffer returned by #writeBuffer
+    void publish();
+
+    /// Returns <code>true</code> if a message was published that was not consumed
+    bool hasMessage() const;
+
+    /**
+     * Returns the latest published message, or <code>nullptr</code> if no message was
+     * published since the last call. The message stays valid until the next call. Must
+     * only be called by the consumer.
+     */
+    const std::vector<char>* consume();
+
+private:
+    std::array<std::vector<char>, 3> _buffers;
+    int _writeIndex;
+    int _readIndex;
+    // The index of the exchanged buffer, with a flag that marks a published message
+    std::atomic<int> _exchangeIndex;
+};
+
+} // namespace network
+} // namespace openspace
+
+#endif // __MESSAGEQUEUE_H__
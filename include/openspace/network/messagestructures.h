@@ -26,7 +26,11 @@
 #define __MESSAGESTRUCTURES_H__
 
 //std includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <string>
+#include <utility>
 #include <vector>
 
 //glm includes
@@ -40,49 +44,239 @@ namespace openspace{
     namespace network{
         
         namespace datamessagestructures{
+            /**
+             * The version of the encoding of data messages. Every data message starts
+             * with it, and messages of other versions are ignored. All values are
+             * written field by field in little endian byte order, so the encoding does
+             * not depend on the memory layout of the structs.
+             */
+            const uint8_t ProtocolVersion = 2;
+
             enum type{
                 PositionData = 0,
                 TimeData,
-                ScriptData
+                ScriptData,
+                PropertyMappingData,
+                PropertyDiffData,
+                NumberOfDataTypes
             };
+
+            //returns true if the host stores the least significant byte first, which
+            //compilers evaluate at compile time
+            inline bool isLittleEndian(){
+                const uint16_t value = 1;
+                return *reinterpret_cast<const char*>(&value) == 1;
+            }
+
+            //appends the bytes of a fundamental value in little endian byte order
+            template <typename T>
+            void writeValue(std::vector<char> &buffer, T value){
+                char bytes[sizeof(T)];
+                memcpy(bytes, &value, sizeof(T));
+                if (!isLittleEndian()){
+                    std::reverse(bytes, bytes + sizeof(T));
+                }
+                buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+            }
+
+            //reads a fundamental value in little endian byte order and advances the
+            //offset, returns false if the data is too short
+            template <typename T>
+            bool readValue(const char* data, size_t length, size_t &offset, T &value){
+                if (offset + sizeof(T) > length){
+                    return false;
+                }
+                char bytes[sizeof(T)];
+                memcpy(bytes, data + offset, sizeof(T));
+                if (!isLittleEndian()){
+                    std::reverse(bytes, bytes + sizeof(T));
+                }
+                memcpy(&value, bytes, sizeof(T));
+                offset += sizeof(T);
+                return true;
+            }
+
+            //appends a string that is prefixed with its length
+            inline void writeString(std::vector<char> &buffer, const std::string &value){
+                writeValue(buffer, static_cast<uint16_t>(value.length()));
+                buffer.insert(buffer.end(), value.begin(), value.end());
+            }
+
+            inline bool readString(const char* data, size_t length, size_t &offset, std::string &value){
+                uint16_t stringLength;
+                if (!readValue(data, length, offset, stringLength) || offset + stringLength > length){
+                    return false;
+                }
+                value.assign(data + offset, stringLength);
+                offset += stringLength;
+                return true;
+            }
+
+            //maps [-1/sqrt(2), 1/sqrt(2)] to the range of int16_t
+            const float QuaternionScale = 1.41421356f * 32767.f;
+
+            /**
+             * Writes a unit quaternion in 7 bytes: the index of the largest component
+             * in the lowest two bits of the first byte, followed by the other three
+             * components as 16 bit fixed point numbers. The largest component is made
+             * positive and recomputed from the others, which are all within
+             * [-1/sqrt(2), 1/sqrt(2)]. The largest error is about 2e-5 per component.
+             */
+            inline void writeQuaternion(std::vector<char> &buffer, uint8_t flags, const glm::quat &quaternion){
+                glm::quat q = glm::normalize(quaternion);
+                float components[4] = { q.x, q.y, q.z, q.w };
+
+                uint8_t largest = 0;
+                for (uint8_t i = 1; i < 4; ++i){
+                    if (std::abs(components[i]) > std::abs(components[largest])){
+                        largest = i;
+                    }
+                }
+                const float sign = components[largest] < 0.f ? -1.f : 1.f;
+
+                writeValue(buffer, static_cast<uint8_t>(flags | largest));
+                for (uint8_t i = 0; i < 4; ++i){
+                    if (i != largest){
+                        float scaled = sign * components[i] * QuaternionScale;
+                        writeValue(buffer, static_cast<int16_t>(std::round(glm::clamp(scaled, -32767.f, 32767.f))));
+                    }
+                }
+            }
+
+            //reads a quaternion written by writeQuaternion and returns the other bits of
+            //the first byte in flags
+            inline bool readQuaternion(const char* data, size_t length, size_t &offset, uint8_t &flags, glm::quat &quaternion){
+                uint8_t first;
+                if (!readValue(data, length, offset, first)){
+                    return false;
+                }
+                const uint8_t largest = first & 3;
+                flags = static_cast<uint8_t>(first & ~3);
+
+                float components[4];
+                float sumOfSquares = 0.f;
+                for (uint8_t i = 0; i < 4; ++i){
+                    if (i != largest){
+                        int16_t value;
+                        if (!readValue(data, length, offset, value)){
+                            return false;
+                        }
+                        components[i] = value / QuaternionScale;
+                        sumOfSquares += components[i] * components[i];
+                    }
+                }
+                components[largest] = std::sqrt(std::max(1.f - sumOfSquares, 0.f));
+
+                quaternion = glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
+                return true;
+            }
         
+            /**
+             * The last position that was written or read in double precision, which
+             * the positions of following keyframes can be written relative to
+             */
+            struct PositionReference{
+                glm::dvec3 _position;
+                bool _isValid = false;
+            };
+
             struct PositionKeyframe{
+                //flags in the byte of the quaternion
+                static const uint8_t RelativePosition = 1 << 2;
+
+                //positions are only encoded relative to a reference position that is at
+                //most this far away (in meters), which keeps the error below 1 cm
+                static constexpr double MaximumRelativeDistance = 1e5;
+
                 glm::quat _viewRotationQuat;
                 psc _position;
                 double _timeStamp;
                 
-                void serialize(std::vector<char> &buffer){
-                    //add position
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_position), reinterpret_cast<char*>(&_position) + sizeof(_position));
-                    
-                    //add orientation
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_viewRotationQuat), reinterpret_cast<char*>(&_viewRotationQuat) + sizeof(_viewRotationQuat));
-                    
+                /**
+                 * Writes the keyframe in 27 bytes if the position is close to a valid
+                 * <code>reference</code>, writing it as the offset from the reference in
+                 * single precision. Otherwise the position is written in double
+                 * precision in 39 bytes and becomes the new reference.
+                 */
+                void serialize(std::vector<char> &buffer, PositionReference &reference){
+                    const glm::dvec3 position = _position.dvec3();
+                    const bool isRelative = reference._isValid &&
+                        glm::length(position - reference._position) < MaximumRelativeDistance;
+
+                    //add orientation with the flags
+                    writeQuaternion(buffer, isRelative ? RelativePosition : 0, _viewRotationQuat);
+
                     //add timestamp
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_timeStamp), reinterpret_cast<char*>(&_timeStamp) + sizeof(_timeStamp));
+                    writeValue(buffer, _timeStamp);
+
+                    //add position
+                    if (isRelative){
+                        const glm::dvec3 offset = position - reference._position;
+                        writeValue(buffer, static_cast<float>(offset.x));
+                        writeValue(buffer, static_cast<float>(offset.y));
+                        writeValue(buffer, static_cast<float>(offset.z));
+                    }
+                    else{
+                        writeValue(buffer, position.x);
+                        writeValue(buffer, position.y);
+                        writeValue(buffer, position.z);
+                        reference._position = position;
+                        reference._isValid = true;
+                    }
                 };
                 
-                void deserialize(const std::vector<char> &buffer){
-                    int offset = 0;
-                    int size = 0;
-                    
-                    //position
-                    size = sizeof(_position);
-                    memcpy(&_position, buffer.data() + offset, size);
-                    offset += size;
-                    
-                    //orientation
-                    size = sizeof(_viewRotationQuat);
-                    memcpy(&_viewRotationQuat, buffer.data() + offset, size);
-                    offset += size;
+                /**
+                 * Reads a keyframe written by serialize, updating the
+                 * <code>reference</code> in the same way. Returns false if the data is
+                 * malformed or if the position is relative and no reference is valid,
+                 * which happens to keyframes that arrive before the first absolute one.
+                 */
+                bool deserialize(const char* data, size_t length, PositionReference &reference){
+                    size_t offset = 0;
+
+                    //orientation and flags
+                    uint8_t flags;
+                    if (!readQuaternion(data, length, offset, flags, _viewRotationQuat)){
+                        return false;
+                    }
                     
                     //timestamp
-                    size = sizeof(_timeStamp);
-                    memcpy(&_timeStamp, buffer.data() + offset, size);
+                    if (!readValue(data, length, offset, _timeStamp)){
+                        return false;
+                    }
+
+                    //position
+                    glm::dvec3 position;
+                    if (flags & RelativePosition){
+                        float x, y, z;
+                        if (!reference._isValid ||
+                            !readValue(data, length, offset, x) ||
+                            !readValue(data, length, offset, y) ||
+                            !readValue(data, length, offset, z))
+                        {
+                            return false;
+                        }
+                        position = reference._position + glm::dvec3(x, y, z);
+                    }
+                    else{
+                        if (!readValue(data, length, offset, position.x) ||
+                            !readValue(data, length, offset, position.y) ||
+                            !readValue(data, length, offset, position.z))
+                        {
+                            return false;
+                        }
+                        reference._position = position;
+                        reference._isValid = true;
+                    }
+                    _position = psc::CreatePowerScaledCoordinate(position.x, position.y, position.z);
+                    return true;
                 };
             };
             
             struct TimeKeyframe{
+                //bits of the flags byte
+                static const uint8_t Paused = 1;
+                static const uint8_t RequiresTimeJump = 2;
 
                 double _time;
                 double _dt;
@@ -90,41 +284,33 @@ namespace openspace{
                 bool _requiresTimeJump;
                 
                 void serialize(std::vector<char> &buffer){
+                    //add wether time is paused and wether a time jump is necessary
+                    //(recompute paths etc)
+                    writeValue(buffer, static_cast<uint8_t>(
+                        (_paused ? Paused : 0) | (_requiresTimeJump ? RequiresTimeJump : 0)
+                    ));
+
                     //add current time
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_time), reinterpret_cast<char*>(&_time) + sizeof(_time));
+                    writeValue(buffer, _time);
                     
                     //add delta time
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_dt), reinterpret_cast<char*>(&_dt) + sizeof(_dt));
-                    
-                    //add wether time is paused or not
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_paused), reinterpret_cast<char*>(&_paused) + sizeof(_paused));
-                    
-                    //add wether a time jump is necessary (recompute paths etc)
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_requiresTimeJump), reinterpret_cast<char*>(&_requiresTimeJump) + sizeof(_requiresTimeJump));
+                    writeValue(buffer, _dt);
                 };
                 
-                void deserialize(const std::vector<char> &buffer){
-                    int offset = 0;
-                    int size = 0;
-                    
-                    //current time
-                    size = sizeof(_time);
-                    memcpy(&_time, buffer.data() + offset, size);
-                    offset += size;
-                    
-                    //delta time
-                    size = sizeof(_dt);
-                    memcpy(&_dt, buffer.data() + offset, size);
-                    offset += size;
+                bool deserialize(const char* data, size_t length){
+                    size_t offset = 0;
+
+                    //flags
+                    uint8_t flags;
+                    if (!readValue(data, length, offset, flags)){
+                        return false;
+                    }
+                    _paused = (flags & Paused) != 0;
+                    _requiresTimeJump = (flags & RequiresTimeJump) != 0;
                     
-                    //is time paused?
-                    size = sizeof(_paused);
-                    memcpy(&_paused, buffer.data() + offset, size);
-                    offset += sizeof(_paused);
-    
-                    //is a time jump required?
-                    size = sizeof(_requiresTimeJump);
-                    memcpy(&_requiresTimeJump, buffer.data() + offset, size);
+                    //current time and delta time
+                    return readValue(data, length, offset, _time) &&
+                           readValue(data, length, offset, _dt);
                 };
             };
             
@@ -135,24 +321,95 @@ namespace openspace{
                 
                 void serialize(std::vector<char> &buffer){
                     //add script length
-                    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_scriptlen), reinterpret_cast<char*>(&_scriptlen) + sizeof(_scriptlen));
+                    writeValue(buffer, _scriptlen);
                     
                     //add script
                     buffer.insert(buffer.end(), _script.begin(), _script.end());
                     
                 };
                 
-                void deserialize(const std::vector<char> &buffer){
-                    int offset = 0;
-                    int size = 0;
+                bool deserialize(const char* data, size_t length){
+                    size_t offset = 0;
                     
                     //size of script
-                    size = sizeof(uint16_t);
-                    memcpy(&_scriptlen, buffer.data() + offset, size);
-                    offset += size;
+                    if (!readValue(data, length, offset, _scriptlen)){
+                        return false;
+                    }
                     
                     //actual script
-                    _script.assign(buffer.begin() + offset, buffer.end());
+                    _script.assign(data + offset, data + length);
+                    return true;
+                };
+            };
+
+            /**
+             * Assigns identifiers to the names of properties, so that changes of the
+             * properties can be sent with the identifier instead of the full name. An
+             * identifier keeps its name until a new host assigns it again.
+             */
+            struct PropertyMapping{
+
+                std::vector<std::pair<uint16_t, std::string>> _entries;
+
+                void serialize(std::vector<char> &buffer){
+                    writeValue(buffer, static_cast<uint16_t>(_entries.size()));
+                    for (const auto& entry : _entries){
+                        writeValue(buffer, entry.first);
+                        writeString(buffer, entry.second);
+                    }
+                };
+
+                bool deserialize(const char* data, size_t length){
+                    size_t offset = 0;
+                    uint16_t nEntries;
+                    if (!readValue(data, length, offset, nEntries)){
+                        return false;
+                    }
+
+                    _entries.resize(nEntries);
+                    for (auto& entry : _entries){
+                        if (!readValue(data, length, offset, entry.first) ||
+                            !readString(data, length, offset, entry.second))
+                        {
+                            return false;
+                        }
+                    }
+                    return true;
+                };
+            };
+
+            /**
+             * A batch of property changes, each with the identifier of the property
+             * from a PropertyMapping and the new value as a Lua expression
+             */
+            struct PropertyDiff{
+
+                std::vector<std::pair<uint16_t, std::string>> _entries;
+
+                void serialize(std::vector<char> &buffer){
+                    writeValue(buffer, static_cast<uint16_t>(_entries.size()));
+                    for (const auto& entry : _entries){
+                        writeValue(buffer, entry.first);
+                        writeString(buffer, entry.second);
+                    }
+                };
+
+                bool deserialize(const char* data, size_t length){
+                    size_t offset = 0;
+                    uint16_t nEntries;
+                    if (!readValue(data, length, offset, nEntries)){
+                        return false;
+                    }
+
+                    _entries.resize(nEntries);
+                    for (auto& entry : _entries){
+                        if (!readValue(data, length, offset, entry.first) ||
+                            !readString(data, length, offset, entry.second))
+                        {
+                            return false;
+                        }
+                    }
+                    return true;
                 };
             };
             
@@ -162,4 +419,4 @@ namespace openspace{
     
 } // namespace openspace
 
-#endif // __MESSAGESTRUCTURES_H__
\ No newline at end of file
+#endif // __MESSAGESTRUCTURES_H__
@@ -0,0 +1,182 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __MESSAGETRANSPORT_H__
+#define __MESSAGETRANSPORT_H__
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <windows.h>
+#include <ws2tcpip.h>
+#endif
+
+#if defined(WIN32) || defined(__MING32__) || defined(__MING64__)
+typedef size_t _SOCKET;
+#else
+typedef int _SOCKET;
+#include <netdb.h>
+#endif
+
+namespace openspace {
+namespace network {
+
+/**
+ * A TCP connection to a server that exchanges messages whose length can be determined
+ * from their first bytes. All socket I/O happens on a single thread, which waits for the
+ * socket and for queued messages at the same time (with epoll on Linux and poll on other
+ * platforms). Received bytes are collected in one buffer and each complete message is
+ * handed to the MessageCallback in place. Queued messages are sent together with one
+ * gathering write, and their buffers are kept in a pool and reused for new messages.
+ */
+class MessageTransport {
+public:
+    /**
+     * Returns the size of the message that starts at <code>data</code>, which contains
+     * the <code>size</code> bytes received so far, or 0 if more bytes are needed to
+     * determine it. Returns MessageTransport::InvalidMessage if the data can not be the
+     * start of a message, which closes the connection.
+     */
+    using MessageSizeFunction = std::function<size_t(const char* data, size_t size)>;
+
+    /// Called on the I/O thread with a complete message that is only valid during the call
+    using MessageCallback = std::function<void(const char* message, size_t size)>;
+
+    /**
+     * Called on the I/O thread when the connection has been established and when it
+     * has been closed or could not be established
+     */
+    using ConnectionCallback = std::function<void(bool isConnected)>;
+
+    static const size_t InvalidMessage;
+
+    struct Statistics {
+        size_t messagesSent = 0;
+        size_t bytesSent = 0;
+        size_t messagesReceived = 0;
+        size_t bytesReceived = 0;
+        /// The number of gathering writes that sent the messages
+        size_t writeCalls = 0;
+    };
+
+    MessageTransport(MessageSizeFunction messageSize, MessageCallback onMessage,
+        ConnectionCallback onConnection);
+
+    /// Closes the connection and waits for the I/O thread to finish
+    ~MessageTransport();
+
+    /**
+     * Starts the I/O thread, which connects to <code>address</code> on
+     * <code>port</code>. Does nothing if the I/O thread is already running.
+     */
+    void connect(const std::string& address, const std::string& port);
+
+    /**
+     * Tells the I/O thread to close the connection without waiting for it. Can be
+     * called from any thread, including from the callbacks.
+     */
+    void close();
+
+    /// Closes the connection and waits for the I/O thread. Must not be called from the
+    /// callbacks
+    void disconnect();
+
+    bool isRunning() const;
+    bool isConnected() const;
+
+    /// Returns an empty buffer from the pool, which keeps the capacity it had before
+    std::vector<char> acquireBuffer();
+
+    /**
+     * Queues <code>message</code> to be sent by the I/O thread. Once it is sent, its
+     * buffer is returned to the pool. Messages that are queued while no connection is
+     * established are discarded when the next connection is made.
+     */
+    void send(std::vector<char> message);
+
+    Statistics statistics() const;
+
+private:
+    void run(std::string address, std::string port);
+
+    /// Reads all available bytes and handles the complete messages. Returns
+    /// <code>false</code> if the connection was closed or broken
+    bool receive();
+
+    /// Sends as much of the queued messages as the socket accepts. Returns
+    /// <code>false</code> if the connection is broken
+    bool flush();
+
+    void wakeUp();
+    void releaseBuffer(std::vector<char> buffer);
+
+    MessageSizeFunction _messageSize;
+    MessageCallback _onMessage;
+    ConnectionCallback _onConnection;
+
+    std::thread _ioThread;
+    std::atomic<bool> _isRunning;
+    std::atomic<bool> _isConnected;
+    std::atomic<bool> _isStopping;
+
+    _SOCKET _socket;
+    // Used to wake the I/O thread when messages are queued or the connection is closed;
+    // an eventfd on Linux and a loopback UDP socket that is connected to itself elsewhere
+    int _wakeUpDescriptor;
+#ifndef __linux__
+    _SOCKET _wakeUpSocket;
+    // Set while a datagram that has not been received by the I/O thread may be pending
+    std::atomic<bool> _hasPendingWakeUp;
+#endif
+
+    std::mutex _sendMutex;
+    std::deque<std::vector<char>> _sendQueue;
+
+    // Only accessed by the I/O thread
+    std::deque<std::vector<char>> _sending;
+    size_t _sendOffset;
+    std::vector<char> _receiveBuffer;
+    size_t _receivedBytes;
+
+    std::mutex _poolMutex;
+    std::vector<std::vector<char>> _bufferPool;
+
+    mutable std::mutex _statisticsMutex;
+    Statistics _statistics;
+};
+
+} // namespace network
+} // namespace openspace
+
+#endif // __MESSAGETRANSPORT_H__
@@ -25,18 +25,43 @@
 #ifndef __NETWORKENGINE_H__
 #define __NETWORKENGINE_H__
 
+#include <openspace/network/messagepacing.h>
+#include <openspace/network/messagequeue.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace openspace {
 
+/**
+ * The NetworkEngine exchanges messages with the external control applications. Messages
+ * are handed to a dedicated thread, which sends them so that the main thread never waits
+ * for slow clients. Status messages are published at most at the rate set with
+ * #setStatusMessageRate and only the latest one is sent; other messages are dropped if
+ * more of them are waiting than the outbound queue can hold.
+ */
 class NetworkEngine {
 public:
     typedef uint16_t MessageIdentifier;
 
+    /// The default number of status messages that are published per second
+    static const double DefaultStatusMessageRate;
+
     NetworkEngine();
+    ~NetworkEngine();
+
+    /// Starts the thread that sends the messages
+    void initialize();
+
+    /// Stops the thread that sends the messages, discarding the unsent ones
+    void deinitialize();
 
     // Receiving messages
     bool handleMessage(const std::string& message);
@@ -47,6 +72,12 @@ public:
     void publishMessage(MessageIdentifier identifier, std::vector<char> message);
     void sendMessages();
 
+    /// Sets the maximum number of status messages per second
+    void setStatusMessageRate(double messagesPerSecond);
+
+    /// Returns the number of messages that were dropped because the queue was full
+    size_t numberOfDroppedMessages() const;
+
     // Initial Connection Messages
     void setInitialConnectionMessage(MessageIdentifier identifier, std::vector<char> message);
     void sendInitialInformation();
@@ -55,24 +86,63 @@ public:
     MessageIdentifier identifier(std::string name);
 
 private:
-    std::map<std::string, MessageIdentifier> _identifiers;
-    MessageIdentifier _lastAssignedIdentifier;
+    using Clock = std::chrono::steady_clock;
 
     struct Message {
         MessageIdentifier identifer;
         std::vector<char> body;
     };
+
+    // Protocol:
+    // 2 bytes: identifier of the message as uint16_t
+    // 8 bytes: time as a ET double
+    // 24 bytes: time as a UTC string
+    // 8 bytes: delta time as double
+    static const size_t StatusTimeStringSize = 24;
+    static const size_t StatusMessageSize = 42;
+
+    /// The loop of the thread that sends the messages
+    void run();
+
+    /// Wakes up the sending thread after the state it waits for was changed
+    void wakeUpSendThread();
+
+    std::vector<char> identifierMappingMessage();
+
+    std::map<std::string, MessageIdentifier> _identifiers;
+    MessageIdentifier _lastAssignedIdentifier;
+
     std::vector<Message> _messagesToSend;
 
     std::vector<Message> _initialConnectionMessages;
 
-    bool _shouldPublishStatusMessage;
+    // Guards _identifiers and _initialConnectionMessages, which the sending thread reads
+    std::mutex _mutex;
+
+    std::atomic<bool> _shouldPublishStatusMessage;
 
     MessageIdentifier _statusMessageIdentifier;
     MessageIdentifier _identifierMappingIdentifier;
     MessageIdentifier _initialMessageFinishedIdentifier;
+
+    // Main thread
+    network::MessageRateLimiter _statusRateLimiter;
+    network::MessageQueue _outboundQueue;
+    std::atomic<size_t> _nDroppedMessages;
+    bool _isDropping;
+
+    // Only the latest status message is sent, older ones are replaced
+    network::LatestMessageBuffer _statusMessages;
+
+    // Sending thread
+    std::thread _sendThread;
+    std::atomic<bool> _isRunning;
+    std::atomic<bool> _isInitialInformationRequested;
+    std::mutex _wakeUpMutex;
+    std::condition_variable _wakeUp;
+    network::PacedMessageSequence _initialMessages;
 };
 
 } // namespace openspace
 
-#endif // __NETWORKENGINE_H__
\ No newline at end of file
+#endif // __NETWORKENGINE_H__
@@ -29,35 +29,18 @@
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/util/powerscaledcoordinate.h>
 #include <openspace/network/messagestructures.h>
+#include <openspace/network/messagetransport.h>
 
 //glm includes
 #include <glm/gtx/quaternion.hpp>
 
 //std includes
+#include <functional>
 #include <string>
 #include <vector>
 #include <atomic>
-#include <thread>
-#include <sstream>
 #include <mutex>
 #include <map>
-#include <condition_variable>
-
-#ifdef WIN32
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-#include <winsock2.h>
-#include <windows.h>
-#include <ws2tcpip.h>
-#endif
-
-#if defined(WIN32) || defined(__MING32__) || defined(__MING64__)
-typedef size_t _SOCKET;
-#else
-typedef int _SOCKET;
-#include <netdb.h>
-#endif
 
 namespace openspace{
     
@@ -88,7 +71,32 @@ namespace openspace{
             
             void preSynchronization();
             
+            /**
+             * Stores the new value of a property as part of the state that new clients
+             * are initialized with. If this instance is the host, the change is also
+             * sent to the clients in a batch with the other changes of this frame.
+             */
             void scriptMessage(const std::string propIdentifier, const std::string propValue);
+
+            /**
+             * The number of data messages and bytes of one type of data message that
+             * have been sent and received, including the message headers
+             */
+            struct DataStatistics{
+                size_t messagesSent = 0;
+                size_t bytesSent = 0;
+                size_t messagesReceived = 0;
+                size_t bytesReceived = 0;
+                //averaged over the last second
+                double bytesSentPerSecond = 0.0;
+                double bytesReceivedPerSecond = 0.0;
+            };
+
+            /// Returns the statistics for each datamessagestructures::type
+            std::vector<DataStatistics> dataStatistics();
+
+            /// Logs the statistics of each type of data message
+            void printDataStatistics();
             
             enum MessageTypes{
                 Authentication=0,
@@ -132,74 +140,108 @@ namespace openspace{
             };
             
             void queueMessage(std::vector<char> message);
-            
-            void disconnect();
-            
-            void writeHeader(std::vector<char> &buffer, uint32_t messageType);
 
-            void closeSocket();
+            /**
+             * Queues a Data message of <code>type</code> whose payload is written into a
+             * pooled buffer by <code>serialize</code>, after the protocol version
+             */
+            void queueDataMessage(datamessagestructures::type type,
+                const std::function<void(std::vector<char>&)>& serialize);
 
-            bool initNetworkAPI();
+            template <typename T>
+            void queueDataMessage(datamessagestructures::type type, T& message);
 
-            void establishConnection(addrinfo *info);
+            /**
+             * Queues the property entries in as few messages of <code>type</code> as
+             * possible without exceeding the largest size of a Data message
+             */
+            template <typename T>
+            void queuePropertyMessages(datamessagestructures::type type,
+                const std::vector<std::pair<uint16_t, std::string>>& entries);
+
+            /// Sends the property changes that were made since the last frame
+            void sendPropertyChanges();
+
+            void countDataMessage(datamessagestructures::type type, size_t size, bool isSent);
+
+            void updateDataStatistics();
+            
+            void writeHeader(std::vector<char> &buffer, uint32_t messageType);
 
             void sendAuthentication();
 
-            void listenCommunication();
+            /// Returns the size of the message at the start of the received data, see
+            /// MessageTransport::MessageSizeFunction
+            size_t messageSize(const char* data, size_t size);
+
+            void handleMessage(const char* message, size_t size);
 
-            void delegateDecoding(uint32_t type);
+            void handleConnectionChange(bool isConnected);
 
-            void initializationMessageReceived();
+            void initializationMessageReceived(const char* data, size_t size);
 
-            void dataMessageReceived();
+            void dataMessageReceived(const char* data, size_t size);
 
-            void hostInfoMessageReceived();
+            void hostInfoMessageReceived(const char* data, size_t size);
             
-            void initializationRequestMessageReceived();
+            void initializationRequestMessageReceived(const char* data, size_t size);
 
-            void broadcast();
+            /**
+             * Sends a keyframe of the camera if it has moved since the last one and
+             * the minimum interval has passed, or if the maximum interval has passed
+             */
+            void sendPositionKeyframe();
             
             int headerSize();
 
-            int receiveData(_SOCKET & socket, std::vector<char> &buffer, int length, int flags);
-            
-            void sendFunc();
-            
-            bool parseHints(addrinfo &info);
-            
-            void threadManagement();
-            
             std::string scriptFromPropertyAndValue(const std::string property, const std::string value);
             
             uint32_t _passCode;
             std::string _port;
             std::string _address;
             std::string _name;
-            _SOCKET _clientSocket;
-            std::thread *_connectionThread;
-            std::thread *_broadcastThread;
-            std::thread *_sendThread;
-            std::thread *_listenThread;
-            std::thread *_handlerThread;
             std::atomic<bool> _isHost;
-            std::atomic<bool> _isConnected;
-            std::atomic<bool> _performDisconnect;
-            std::atomic<bool> _isRunning;
-            std::atomic<bool> _tryConnect;
             std::atomic<bool> _initializationTimejumpRequired;
 
-            std::condition_variable _disconnectCondition;
-            std::mutex _disconnectMutex;
-            
-            std::vector<std::vector<char>> _sendBuffer;
-            std::mutex _sendBufferMutex;
-            std::condition_variable _sendCondition;
+            //the last sent keyframe, only accessed by the main thread. The I/O thread
+            //requests a new start of the keyframes through _shouldResetPositionKeyframes
+            network::datamessagestructures::PositionKeyframe _lastPositionKeyframe;
+            bool _hasSentPositionKeyframe;
+            bool _isCameraMoving;
+            std::atomic<bool> _shouldResetPositionKeyframes;
             
             network::datamessagestructures::TimeKeyframe _latestTimeKeyframe;
             std::mutex _timeKeyframeMutex;
             std::atomic<bool> _latestTimeKeyframeValid;
             std::map<std::string, std::string> _currentState;
             std::mutex _currentStateMutex;
+
+            //the identifiers that properties are sent with while we're the host, the
+            //mappings that have not been sent yet and the changes since the last frame
+            //(also protected by _currentStateMutex)
+            std::map<std::string, uint16_t> _propertyIds;
+            std::vector<std::pair<uint16_t, std::string>> _unsentPropertyMappings;
+            std::map<uint16_t, std::string> _propertyChanges;
+
+            //the property names of the identifiers received from the host, only
+            //accessed by the I/O thread
+            std::map<uint16_t, std::string> _propertyNames;
+
+            //the positions that relative position keyframes are encoded against; the sent
+            //reference is only accessed by the main thread
+            network::datamessagestructures::PositionReference _sentPositionReference;
+            double _sentPositionReferenceTime;
+            network::datamessagestructures::PositionReference _receivedPositionReference;
+            bool _hasReportedProtocolMismatch;
+
+            std::vector<DataStatistics> _dataStatistics;
+            std::vector<DataStatistics> _previousDataStatistics;
+            double _previousDataStatisticsTime;
+            std::mutex _dataStatisticsMutex;
+
+            // Declared last, so that the I/O thread is stopped before the members that
+            // its callbacks use are destroyed
+            MessageTransport _transport;
         };
     } // namespace network
     
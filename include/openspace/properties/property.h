@@ -30,6 +30,8 @@
 #include <ghoul/misc/dictionary.h>
 #include <functional>
 #include <string>
+#include <utility>
+#include <vector>
 
 struct lua_State;
 
@@ -184,6 +186,26 @@ public:
      */
     virtual void onChange(std::function<void()> callback);
 
+    /// The handle that identifies a listener added with #addOnChangeListener
+    typedef size_t OnChangeHandle;
+
+    /**
+     * Adds a <code>callback</code> function that is called every time the encapsulated
+     * value changes, in addition to the callback registered with #onChange. Any number of
+     * listeners can be added to the same Property.
+     * \param callback The callback function that is called when the value changed
+     * \return The handle that removes the listener with #removeOnChangeListener
+     */
+    OnChangeHandle addOnChangeListener(std::function<void()> callback);
+
+    /**
+     * Removes the listener that was added with #addOnChangeListener and returned the
+     * <code>handle</code>. Unknown handles are ignored. A listener that is removed while
+     * the listeners are notified of a change is still notified of that change.
+     * \param handle The handle of the listener that is removed
+     */
+    void removeOnChangeListener(OnChangeHandle handle);
+
     /**
      * This method returns the unique identifier of this Property.
      * \return The unique identifier of this Property
@@ -371,6 +393,10 @@ protected:
 
     /// The callback function that will be invoked whenever the encapsulated value changes
     std::function<void()> _onChangeCallback;
+
+    /// The listeners added with #addOnChangeListener and their handles
+    std::vector<std::pair<OnChangeHandle, std::function<void()>>> _onChangeListeners;
+    OnChangeHandle _nextOnChangeHandle;
 };
 
 } // namespace properties
@@ -0,0 +1,114 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __PROPERTYREGISTRY_H__
+#define __PROPERTYREGISTRY_H__
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace openspace {
+namespace properties {
+
+class Property;
+
+/**
+ * The PropertyRegistry keeps track of all Property%s across the PropertyOwner
+ * hierarchies. It caches the Property that a fully qualified URI resolves to in a hash
+ * map, so that repeated lookups of the same URI do not have to walk the hierarchy. Any
+ * change to the structure of a hierarchy (adding, removing or renaming a Property or a
+ * PropertyOwner) invalidates the cache, which is then refilled lazily.
+ *
+ * The registry also collects the Property%s whose value changed. The Property%s that
+ * changed during a frame are available from #changedProperties after #finishFrame has
+ * been called at the end of that frame, so that consumers can process only those
+ * instead of polling all Property%s. All methods are thread-safe.
+ */
+class PropertyRegistry {
+public:
+    /// Returns the registry, which is created on first use
+    static PropertyRegistry& ref();
+
+    /**
+     * Returns the Property that <code>uri</code> has been resolved to since the last
+     * structural change, or <code>nullptr</code> if it is not cached
+     */
+    Property* property(const std::string& uri);
+
+    /**
+     * Returns the number of structural changes so far. A lookup that walks the
+     * hierarchies gets it before it starts, so that its result is only cached if the
+     * hierarchies have not changed in the meantime.
+     */
+    size_t generation() const;
+
+    /**
+     * Caches that <code>uri</code> resolves to <code>property</code>, unless the
+     * structure of a hierarchy has changed since <code>generation</code> was returned
+     * by #generation
+     */
+    void cacheProperty(const std::string& uri, Property* property, size_t generation);
+
+    /// Invalidates the cached URIs after a change to the structure of a hierarchy
+    void invalidateUris();
+
+    /// Called by a Property whose value changed
+    void markChanged(Property* property);
+
+    /// Called by a Property when it is destroyed
+    void removeProperty(Property* property);
+
+    /// Returns the Property%s whose value changed during the last finished frame
+    std::vector<Property*> changedProperties() const;
+
+    /// Makes the Property%s that changed since the last call the #changedProperties
+    void finishFrame();
+
+    /// Returns the number of lookups that were answered from the cache and that missed
+    size_t numberOfCacheHits() const;
+    size_t numberOfCacheMisses() const;
+
+private:
+    PropertyRegistry();
+
+    mutable std::mutex _mutex;
+
+    std::unordered_map<std::string, Property*> _uris;
+    bool _isUriCacheValid;
+    size_t _generation;
+    size_t _nCacheHits;
+    size_t _nCacheMisses;
+
+    std::vector<Property*> _changingProperties;
+    std::unordered_set<Property*> _isChanging;
+    std::vector<Property*> _changedProperties;
+};
+
+} // namespace properties
+} // namespace openspace
+
+#endif // __PROPERTYREGISTRY_H__
@@ -58,6 +58,17 @@ public:
     Renderable(const ghoul::Dictionary& dictionary);
     virtual ~Renderable();
 
+    /**
+     * Loads and prepares all data that does not need an OpenGL context, for example
+     * reading and parsing files. This is called on a worker thread while the scene is
+     * loading, possibly concurrently with other Renderables that do not depend on this
+     * one, and is always finished before #initialize is called on the rendering
+     * thread. It must not use OpenGL, SPICE or the cache manager of the file system,
+     * none of which are thread-safe. The default implementation does nothing.
+     * \return <code>true</code> if the data was loaded successfully
+     */
+    virtual bool initializeData();
+
     virtual bool initialize() = 0;
     virtual bool deinitialize() = 0;
 
@@ -187,6 +187,9 @@ private:
 
     void renderInformation();
 
+    /// Shows the progress of the scene that is loading in place of the scene
+    void renderLoadingInformation();
+
     Camera* _mainCamera;
     Scene* _sceneGraph;
     RaycasterManager* _raycasterManager;
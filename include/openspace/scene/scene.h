@@ -28,6 +28,7 @@
 // std includes
 #include <vector>
 #include <map>
+#include <memory>
 #include <set>
 #include <mutex>
 
@@ -42,6 +43,7 @@
 namespace openspace {
 
 class SceneGraphNode;
+class SceneInitializer;
 
 // Notifications:
 // SceneGraphFinishedLoading
@@ -67,6 +69,18 @@ public:
     void scheduleLoadSceneFile(const std::string& sceneDescriptionFilePath);
     void clearSceneGraph();
 
+    /**
+     * Returns whether the nodes of a loaded scene are still being initialized. While
+     * they are, the nodes are neither updated nor rendered.
+     */
+    bool isLoading() const;
+
+    /**
+     * Returns the SceneInitializer of the scene that is loading or <code>nullptr</code>
+     * if no scene is loading
+     */
+    const SceneInitializer* initializer() const;
+
     void loadModule(const std::string& modulePath);
 
     /*
@@ -118,7 +132,12 @@ public:
     static scripting::LuaLibrary luaLibrary();
 
 private:
+    /**
+     * Loads the scene graph and starts initializing its nodes. The loading is completed
+     * by #finishLoadingScene once all nodes are initialized.
+     */
     bool loadSceneInternal(const std::string& sceneDescriptionFilePath);
+    void finishLoadingScene();
 
     void writePropertyDocumentation(const std::string& filename, const std::string& type);
 
@@ -132,6 +151,11 @@ private:
 
     std::string _sceneGraphToLoad;
 
+    // State of the scene that is being initialized
+    std::unique_ptr<SceneInitializer> _initializer;
+    std::string _loadingSceneFile;
+    ghoul::Dictionary _cameraDictionary;
+
     std::mutex _programUpdateLock;
     std::set<ghoul::opengl::ProgramObject*> _programsToUpdate;
     std::vector<std::unique_ptr<ghoul::opengl::ProgramObject>> _programs;
@@ -45,6 +45,13 @@ public:
 
     const std::vector<SceneGraphNode*>& nodes() const;
 
+    /**
+     * Returns the nodes that <code>node</code> depends on, that is its parent and all
+     * nodes listed in its <code>Dependencies</code>. All of them precede
+     * <code>node</code> in #nodes.
+     */
+    std::vector<SceneGraphNode*> dependencies(SceneGraphNode* node) const;
+
     SceneGraphNode* rootNode() const;
     SceneGraphNode* sceneGraphNode(const std::string& name) const;
 
@@ -61,6 +61,11 @@ public:
 
     static SceneGraphNode* createFromDictionary(const ghoul::Dictionary& dictionary);
 
+    /**
+     * Runs the part of the initialization that does not need the rendering thread, see
+     * Renderable::initializeData. Has to be called before #initialize.
+     */
+    bool initializeData();
     bool initialize();
     bool deinitialize();
 
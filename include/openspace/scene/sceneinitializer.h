@@ -0,0 +1,141 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __SCENEINITIALIZER_H__
+#define __SCENEINITIALIZER_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+class SceneGraph;
+class SceneGraphNode;
+
+/**
+ * Initializes the nodes of a loaded SceneGraph in two phases. The first phase,
+ * SceneGraphNode::initializeData, runs on a pool of worker threads; a node is started
+ * as soon as all nodes it depends on have finished their first phase. The second phase,
+ * SceneGraphNode::initialize, uploads data to the GPU and runs on the rendering thread
+ * in the topological order of the SceneGraph through repeated calls to #update, so
+ * that the application can keep rendering while the scene is loading.
+ */
+class SceneInitializer {
+public:
+    struct NodeTiming {
+        std::string name;
+        /// The time spent in the first phase on a worker thread
+        std::chrono::microseconds dataTime;
+        /// The time spent in the second phase on the rendering thread
+        std::chrono::microseconds uploadTime;
+    };
+
+    /**
+     * Starts the first phase for all nodes of <code>graph</code>, which must not be
+     * changed until this SceneInitializer is finished or destroyed.
+     * \param graph The SceneGraph whose nodes are initialized
+     * \param nThreads The number of worker threads. If it is 0, one thread less than the
+     * number of hardware threads is used
+     */
+    SceneInitializer(const SceneGraph& graph, unsigned int nThreads = 0);
+
+    /// Returns the nodes that the passed node depends on
+    using DependencyFunction =
+        std::function<std::vector<SceneGraphNode*>(SceneGraphNode*)>;
+
+    /**
+     * Starts the first phase for all <code>nodes</code>, which are initialized in the
+     * order in which they are passed. Each node has to follow all nodes it depends on.
+     * \param nodes The nodes that are initialized, in topological order
+     * \param dependencies Returns the nodes that a node depends on. Nodes that are not
+     * part of <code>nodes</code> are ignored
+     * \param nThreads The number of worker threads. If it is 0, one thread less than the
+     * number of hardware threads is used
+     */
+    SceneInitializer(const std::vector<SceneGraphNode*>& nodes,
+        const DependencyFunction& dependencies, unsigned int nThreads = 0);
+
+    /// Waits for the running first phases to finish; nodes that were not started are
+    /// left uninitialized
+    ~SceneInitializer();
+
+    /**
+     * Runs the second phase for nodes whose first phase has finished until either
+     * a node is reached that is still waiting for its first phase or more than
+     * <code>budget</code> has been spent. Must be called on the rendering thread.
+     * \return <code>true</code> if all nodes are initialized
+     */
+    bool update(std::chrono::microseconds budget);
+
+    bool isFinished() const;
+
+    size_t numberOfNodes() const;
+    size_t numberOfInitializedNodes() const;
+
+    /// Returns the timing of each node, in the topological order of the SceneGraph
+    std::vector<NodeTiming> timings() const;
+
+    /**
+     * Logs the time spent on each node, the total time it would have taken to
+     * initialize the nodes one after the other and the time it actually took.
+     */
+    void logTimingReport() const;
+
+private:
+    struct NodeState {
+        SceneGraphNode* node;
+        // Indices of the nodes that depend on this one
+        std::vector<size_t> dependents;
+        size_t nUnfinishedDependencies;
+        bool dataFinished;
+        NodeTiming timing;
+    };
+
+    void work();
+    void initializeNodeData(size_t index);
+    void initializeNode(size_t index);
+
+    std::vector<NodeState> _nodes;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _nodeIsReady;
+    std::deque<size_t> _readyNodes;
+    bool _isStopping;
+    std::vector<std::thread> _workers;
+
+    // Only accessed from the rendering thread
+    size_t _nextNode;
+    std::chrono::high_resolution_clock::time_point _startTime;
+    std::chrono::microseconds _totalTime;
+};
+
+} // namespace openspace
+
+#endif // __SCENEINITIALIZER_H__
@@ -0,0 +1,121 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __PROPERTYASSIGNMENT_H__
+#define __PROPERTYASSIGNMENT_H__
+
+#include <ghoul/lua/ghoul_lua.h>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+class SyncBuffer;
+
+namespace scripting {
+
+/**
+ * A PropertyAssignment sets the Property identified by a URI to a typed value. It has
+ * the same effect as the script <code>openspace.setPropertyValueSingle(uri, value)</code>
+ * but is applied without the Lua interpreter, see ScriptEngine::runPropertyAssignment.
+ * Values are booleans, numbers, strings, or tables of numbers, which are the Lua types
+ * that all Property types are read from.
+ */
+class PropertyAssignment {
+public:
+    enum class Type : uint8_t {
+        Boolean = 0,
+        Number,
+        String,
+        NumberTable
+    };
+
+    PropertyAssignment();
+    PropertyAssignment(std::string uri, bool value);
+    PropertyAssignment(std::string uri, int value);
+    PropertyAssignment(std::string uri, double value);
+    PropertyAssignment(std::string uri, std::string value);
+    PropertyAssignment(std::string uri, const char* value);
+    PropertyAssignment(std::string uri, std::vector<double> values);
+
+    /**
+     * Creates the assignment from a <code>script</code> that consists of a single
+     * <code>openspace.setPropertyValueSingle</code> call, or a
+     * <code>openspace.setPropertyValue</code> call whose URI contains no wildcards, with
+     * a string literal URI and a literal value.
+     * \return <code>true</code> if the script has this form, <code>false</code> if it has
+     * to be run by the Lua interpreter
+     */
+    static bool fromScript(const std::string& script, PropertyAssignment& assignment);
+
+    /**
+     * Creates the assignment of the Lua <code>literal</code>, for example a value
+     * returned by Property::getStringValue, to the Property <code>uri</code>.
+     * \return <code>true</code> if the literal is a value that an assignment can hold
+     */
+    static bool fromLiteral(std::string uri, const std::string& literal,
+        PropertyAssignment& assignment);
+
+    const std::string& uri() const;
+    Type type() const;
+
+    /// Returns the Lua type of the value, which has to match Property::typeLua
+    int luaType() const;
+
+    /// Pushes the value onto the stack of <code>state</code>
+    void pushValue(lua_State* state) const;
+
+    /// Returns the Lua literal of the value
+    std::string literal() const;
+
+    /// Returns the script that is equivalent to this assignment
+    std::string script() const;
+
+    /// Returns the number of bytes that #serialize writes
+    size_t serializedSize() const;
+
+    void serialize(SyncBuffer& buffer) const;
+
+    /**
+     * Reads an assignment that was written by #serialize.
+     * \return <code>false</code> if the type of the value is unknown, in which case the
+     * rest of the <code>buffer</code> can not be read
+     */
+    bool deserialize(SyncBuffer& buffer);
+
+private:
+    std::string _uri;
+    Type _type;
+    bool _boolean;
+    // A single number for Type::Number
+    std::vector<double> _numbers;
+    std::string _string;
+};
+
+} // namespace scripting
+} // namespace openspace
+
+#endif // __PROPERTYASSIGNMENT_H__
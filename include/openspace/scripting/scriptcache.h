@@ -0,0 +1,121 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __SCRIPTCACHE_H__
+#define __SCRIPTCACHE_H__
+
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/lua/ghoul_lua.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace ghoul { class Dictionary; }
+
+namespace openspace {
+namespace scripting {
+
+/**
+ * The ScriptCache keeps the compiled chunks of the most recently run scripts of a single
+ * Lua state, so that scripts that are run repeatedly are only parsed once. The chunks
+ * are stored in the registry of the Lua state and are keyed by the script text. If more
+ * than the capacity of scripts are cached, the least recently used one is discarded.
+ * The cache has to be #clear%ed before the Lua state is closed.
+ */
+class ScriptCache {
+public:
+    /// The default maximum number of compiled chunks that are kept
+    static const size_t DefaultCapacity = 256;
+
+    explicit ScriptCache(size_t capacity = DefaultCapacity);
+
+    /**
+     * Pushes the compiled chunk of <code>script</code> onto the stack of
+     * <code>state</code>, compiling it first if it is not cached. All calls have to use
+     * the same Lua state until the cache is cleared.
+     * \throw ghoul::lua::LuaLoadingException If the script could not be compiled
+     */
+    void loadScript(lua_State* state, const std::string& script);
+
+    /// Releases all cached chunks. The Lua state has to still be valid
+    void clear();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    size_t numberOfHits() const;
+    size_t numberOfMisses() const;
+
+private:
+    typedef std::list<std::pair<std::string, int>> ChunkList;
+
+    lua_State* _state;
+    size_t _capacity;
+    bool _isEnabled;
+
+    // The chunks ordered from most to least recently used with their registry references
+    ChunkList _chunks;
+    std::unordered_map<std::string, ChunkList::iterator> _chunkIndex;
+
+    size_t _nHits;
+    size_t _nMisses;
+};
+
+/**
+ * Pushes the compiled chunk of the Lua file <code>filename</code> onto the stack of
+ * <code>state</code>. The compiled bytecode is stored in the cache of the FileSystem
+ * under the path of the file, together with the modification date of the file and the
+ * Lua version, and is reused as long as both are unchanged.
+ * \param persistent Whether the cached bytecode is kept between runs of the application
+ * \throw ghoul::lua::LuaLoadingException If the file could not be compiled
+ */
+void loadFile(lua_State* state, const std::string& filename,
+    ghoul::filesystem::CacheManager::Persistent persistent =
+        ghoul::filesystem::CacheManager::Persistent::Yes);
+
+/**
+ * Runs the Lua file <code>filename</code> in <code>state</code>, using the bytecode
+ * cache of #loadFile.
+ * \throw ghoul::lua::LuaLoadingException If the file could not be compiled
+ * \throw ghoul::lua::LuaExecutionException If the file could not be executed
+ */
+void runScriptFile(lua_State* state, const std::string& filename);
+
+/**
+ * Loads the table that the Lua file <code>filename</code> returns into
+ * <code>dictionary</code>, using the bytecode cache of #loadFile. This is a drop-in
+ * replacement for <code>ghoul::lua::loadDictionaryFromFile</code>.
+ * \throw ghoul::lua::LuaRuntimeException If the file could not be loaded or does not
+ * return a table
+ */
+void loadDictionaryFromFile(const std::string& filename, ghoul::Dictionary& dictionary,
+    lua_State* state,
+    ghoul::filesystem::CacheManager::Persistent persistent =
+        ghoul::filesystem::CacheManager::Persistent::Yes);
+
+} // namespace scripting
+} // namespace openspace
+
+#endif // __SCRIPTCACHE_H__
@@ -26,11 +26,15 @@
 #define __SCRIPTENGINE_H__
 
 #include <openspace/scripting/lualibrary.h>
+#include <openspace/scripting/propertyassignment.h>
+#include <openspace/scripting/scriptcache.h>
 
 #include <ghoul/lua/ghoul_lua.h>
 
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 
 namespace openspace {
@@ -66,7 +70,18 @@ public:
     void addLibrary(LuaLibrary library);
     bool hasLibrary(const std::string& name);
     
+    /**
+     * Runs the <code>script</code>. Scripts that only assign a literal value to a
+     * single Property are applied with #runPropertyAssignment instead of the Lua
+     * interpreter.
+     */
     bool runScript(const std::string& script);
+
+    /**
+     * Applies the <code>assignment</code> directly to the Property, with the same effect
+     * as the equivalent <code>setPropertyValueSingle</code> script.
+     */
+    bool runPropertyAssignment(const PropertyAssignment& assignment);
     bool runScriptFile(const std::string& filename);
 
     bool writeDocumentation(const std::string& filename, const std::string& type) const;
@@ -79,15 +94,30 @@ public:
 
     void postSynchronizationPreDraw();
 
+    /**
+     * Moves the queued scripts into the batch that is synchronized in this frame. The
+     * batch is limited in size to fit into the SyncBuffer; remaining scripts are kept
+     * for the following frames. Repeated <code>setPropertyValue</code> calls for the same
+     * URI within a batch are coalesced into the last one.
+     */
     void preSynchronization();
 
     void queueScript(const std::string &script);
 
+    /**
+     * Queues the <code>assignment</code> in the same order as the queued scripts. It is
+     * synchronized in binary form and applied without the Lua interpreter.
+     */
+    void queuePropertyAssignment(PropertyAssignment assignment);
+
     void setLogFile(const std::string& filename, const std::string& type);
 
     std::vector<std::string> cachedScripts();
 
     std::vector<std::string> allLuaFunctions() const;
+
+    /// The cache of compiled chunks that is used by #runScript
+    ScriptCache& scriptCache();
     
     //parallel functions
     bool parseLibraryAndFunctionNames(std::string &library, std::string &function, const std::string &script);
@@ -106,12 +136,25 @@ private:
     
     lua_State* _state = nullptr;
     std::set<LuaLibrary> _registeredLibraries;
+    ScriptCache _scriptCache;
     
+    /// A queued script or PropertyAssignment
+    struct QueuedCommand {
+        enum class Type : uint8_t {
+            Script = 0,
+            Assignment
+        };
+
+        Type type;
+        std::string script;
+        PropertyAssignment assignment;
+    };
+
     //sync variables
     std::mutex _mutex;
-    std::vector<std::string> _queuedScripts;
-    std::vector<std::string> _receivedScripts;
-    std::string _currentSyncedScript;
+    std::deque<QueuedCommand> _queuedScripts;
+    std::vector<QueuedCommand> _receivedScripts;
+    std::vector<QueuedCommand> _currentSyncedScripts;
     
     //parallel variables
     std::map<std::string, std::map<std::string, std::string>> _cachedScripts;
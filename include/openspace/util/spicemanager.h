@@ -193,6 +193,13 @@ public:
      * \sa http://naif.jpl.nasa.gov/pub/naif/toolkit_docs/C/cspice/unload_c.html
      */
     void unloadKernel(std::string filePath);
+
+    /**
+     * Returns the absolute paths of all currently loaded kernels in the order in which
+     * they were loaded. Kernels that were loaded multiple times are only listed once.
+     * \return The paths of all loaded kernels
+     */
+    std::vector<std::string> loadedKernels() const;
     
     /**
      * Returns whether a given \p target has an Spk kernel covering it at the designated
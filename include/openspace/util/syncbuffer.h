@@ -26,11 +26,12 @@
 #define SYNCBUFFER_H
 
 #include <ghoul/opengl/ghoul_gl.h>
-#include <ghoul/misc/assert.h>
 
+#include <chrono>
 #include <cstring>
 #include <memory>
 #include <stdint.h>
+#include <string>
 #include <vector>
 
 namespace sgct {
@@ -40,80 +41,193 @@ namespace sgct {
 
 namespace openspace {
 
+/**
+ * Collects the state that the master sends to all cluster nodes each frame. Only the
+ * bytes that were encoded in a frame are transmitted. Values that rarely change can be
+ * delta-encoded with #encodeDelta, in which case they only take up a single byte in
+ * frames in which they did not change. Every frame starts with its number and whether it
+ * is a keyframe, in which all delta-encoded values are sent in full. Keyframes are sent
+ * periodically and on #requestKeyframe, so that nodes that missed frames, joined late,
+ * or restarted receive all values again.
+ */
 class SyncBuffer {
 public:
-
+    /// A string inside the received buffer, which is valid until the next #read
+    struct StringView {
+        const char* data;
+        size_t size;
+    };
+
+    struct Statistics {
+        /// The number of bytes sent or received in the last frame
+        size_t bytesPerFrame = 0;
+        /// The number of delta-encoded values that were unchanged in the last frame
+        size_t unchangedValues = 0;
+        /// The number of delta-encoded values that could not be decoded in the last
+        /// frame, as their previous value was not received
+        size_t missingValues = 0;
+        /// The time from the first encode of the last frame until it was sent
+        std::chrono::microseconds encodeTime = std::chrono::microseconds(0);
+        /// The time from receiving the last frame until all of it was decoded
+        std::chrono::microseconds decodeTime = std::chrono::microseconds(0);
+    };
+
+    /// \param n The maximum number of bytes that can be encoded per frame
     SyncBuffer(size_t n);
 
     ~SyncBuffer();
 
     void encode(const std::string& s) {
-        const size_t size = sizeof(char) * s.size() + sizeof(int32_t);
-        ghoul_assert(_encodeOffset + size < _n, "");
-
         int32_t length = static_cast<int32_t>(s.length());
-        memcpy(_dataStream.data() + _encodeOffset, reinterpret_cast<const char*>(&length), sizeof(int32_t));
-        _encodeOffset += sizeof(int32_t);
-        memcpy(_dataStream.data() + _encodeOffset, s.c_str(), length);
-        _encodeOffset += length;
+        char* destination = reserve(sizeof(int32_t) + length);
+        memcpy(destination, &length, sizeof(int32_t));
+        memcpy(destination + sizeof(int32_t), s.c_str(), length);
     }
 
     template <typename T>
     void encode(const T& v) {
-        const size_t size = sizeof(T);
-        ghoul_assert(_encodeOffset + size < _n, "");
+        memcpy(reserve(sizeof(T)), &v, sizeof(T));
+    }
 
-        memcpy(_dataStream.data() + _encodeOffset, &v, size);
-        _encodeOffset += size;
+    /**
+     * Encodes <code>v</code> if it differs from the value that was passed to the
+     * same call of this function in the previous frame or if this frame is a keyframe.
+     * Otherwise only a marker is written, and #decodeDelta returns the previous value.
+     */
+    template <typename T>
+    void encodeDelta(const T& v) {
+        std::vector<char>& previous = deltaValue();
+        const bool isUnchanged = !_isKeyframe && previous.size() == sizeof(T) &&
+            memcmp(previous.data(), &v, sizeof(T)) == 0;
+        if (isUnchanged) {
+            encode(static_cast<uint8_t>(0));
+            ++_nUnchangedValues;
+        }
+        else {
+            encode(static_cast<uint8_t>(1));
+            encode(v);
+            previous.resize(sizeof(T));
+            memcpy(previous.data(), &v, sizeof(T));
+        }
     }
 
-    std::string decode() {
+    /// Decodes the string in place, see StringView
+    StringView decodeView() {
         int32_t length;
-        memcpy(reinterpret_cast<char*>(&length), _dataStream.data() + _decodeOffset, sizeof(int32_t));
-        char* tmp = new char[length + 1];
-        _decodeOffset += sizeof(int32_t);
-        memcpy(tmp, _dataStream.data() + _decodeOffset, length);
-        _decodeOffset += length;
-        tmp[length] = '\0';
-        std::string ret(tmp);
-        delete[] tmp;
-        return ret;
+        memcpy(&length, consume(sizeof(int32_t)), sizeof(int32_t));
+        return { consume(length), static_cast<size_t>(length) };
+    }
+
+    std::string decode() {
+        StringView view = decodeView();
+        return std::string(view.data, view.size);
     }
 
     template <typename T>
     T decode() {
-        const size_t size = sizeof(T);
-        ghoul_assert(_decodeOffset + size < _n, "");
         T value;
-        memcpy(&value, _dataStream.data() + _decodeOffset, size);
-        _decodeOffset += size;
+        memcpy(&value, consume(sizeof(T)), sizeof(T));
         return value;
     }
 
     void decode(std::string& s) {
-        s = decode();
+        StringView view = decodeView();
+        s.assign(view.data, view.size);
     }
 
     template <typename T>
     void decode(T& value) {
-        const size_t size = sizeof(T);
-        ghoul_assert(_decodeOffset + size < _n, "");
-        memcpy(&value, _dataStream.data() + _decodeOffset, size);
-        _decodeOffset += size;
+        memcpy(&value, consume(sizeof(T)), sizeof(T));
+    }
+
+    /**
+     * Decodes a value that was encoded with #encodeDelta. If the value is unchanged, but
+     * its previous value was not received, because this node missed frames or started
+     * after the last keyframe, <code>value</code> is left untouched until the next
+     * keyframe.
+     * \return <code>true</code> if <code>value</code> was decoded
+     */
+    template <typename T>
+    bool decodeDelta(T& value) {
+        std::vector<char>& previous = deltaValue();
+        if (decode<uint8_t>() != 0) {
+            decode(value);
+            previous.resize(sizeof(T));
+            memcpy(previous.data(), &value, sizeof(T));
+            return true;
+        }
+        if (previous.size() != sizeof(T)) {
+            ++_statistics.missingValues;
+            return false;
+        }
+        memcpy(&value, previous.data(), sizeof(T));
+        ++_statistics.unchangedValues;
+        return true;
     }
 
+    /// Sends the encoded frame to all nodes and starts the next frame
     void write();
 
+    /// Receives the frame that the master sent with #write
     void read();
 
+    /**
+     * Finishes the encoded frame and returns its bytes instead of sending them, and
+     * starts the next frame. The frame can be decoded with #readFrame.
+     */
+    std::vector<char> writeFrame();
+
+    /// Starts decoding the <code>frame</code> that was created by #writeFrame
+    void readFrame(std::vector<char> frame);
+
+    /**
+     * Sends all delta-encoded values in full in the current frame, or in the next one if
+     * values were already encoded in the current frame.
+     */
+    void requestKeyframe();
+
+    const Statistics& statistics() const;
+
 private:
+    using Clock = std::chrono::high_resolution_clock;
+
+    /// Writes the frame header and the statistics of the encoded frame
+    void finishFrame();
+
+    /// Clears the encoded frame and decides whether the next frame is a keyframe
+    void startFrame();
+
+    /// Appends <code>size</code> bytes to the frame and returns a pointer to them
+    char* reserve(size_t size);
+
+    /// Returns a pointer to the next <code>size</code> bytes of the received frame
+    const char* consume(size_t size);
+
+    /// Returns the value of the next delta-encoded value in the previous frame
+    std::vector<char>& deltaValue();
+
     size_t _n;
-    size_t _encodeOffset;
     size_t _decodeOffset;
     std::vector<char> _dataStream;
     std::unique_ptr<sgct::SharedVector<char>> _synchronizationBuffer;
+
+    // The previous value of each delta-encoded value in the order they are encoded
+    std::vector<std::vector<char>> _deltaValues;
+    size_t _deltaIndex;
+    size_t _nUnchangedValues;
+
+    uint32_t _frameNumber;
+    bool _isKeyframe;
+    bool _isKeyframeRequested;
+    // The number of the last received frame, for detecting missed frames
+    uint32_t _receivedFrameNumber;
+    bool _hasReceivedFrame;
+
+    Statistics _statistics;
+    Clock::time_point _encodeStart;
+    Clock::time_point _decodeStart;
 };
 
 } // namespace openspace
 
-#endif // SYNCBUFFER_H
\ No newline at end of file
+#endif // SYNCBUFFER_H
@@ -119,6 +119,13 @@ RenderableStars::RenderableStars(const ghoul::Dictionary& dictionary)
     }
     _speckFile = absPath(_speckFile);
 
+    // The cache manager is not thread-safe and the data is loaded on a worker thread by
+    // initializeData, so the cache file is looked up here on the main thread
+    _cachedFile = FileSys.cacheManager()->cachedFilename(
+        _speckFile,
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+
     _colorOption.addOption(ColorOption::Color, "Color");
     _colorOption.addOption(ColorOption::Velocity, "Velocity");
     _colorOption.addOption(ColorOption::Speed, "Speed");
@@ -147,6 +154,10 @@ bool RenderableStars::isReady() const {
     return (_program != nullptr) && (!_fullData.empty());
 }
 
+bool RenderableStars::initializeData() {
+    return loadData();
+}
+
 bool RenderableStars::initialize() {
     bool completeSuccess = true;
 
@@ -158,7 +169,7 @@ bool RenderableStars::initialize() {
 
     if (!_program)
         return false;
-    completeSuccess &= loadData();
+    completeSuccess &= !_fullData.empty();
     completeSuccess &= (_pointSpreadFunctionTexture != nullptr);
 
     return completeSuccess;
@@ -350,22 +361,18 @@ void RenderableStars::update(const UpdateData& data) {
 
 bool RenderableStars::loadData() {
     std::string _file = _speckFile;
-    std::string cachedFile = FileSys.cacheManager()->cachedFilename(
-        _file,
-        ghoul::filesystem::CacheManager::Persistent::Yes
-    );
+    if (_cachedFile.empty())
+        return false;
 
-    bool hasCachedFile = FileSys.fileExists(cachedFile);
+    bool hasCachedFile = FileSys.fileExists(_cachedFile);
     if (hasCachedFile) {
-        LINFO("Cached file '" << cachedFile << "' used for Speck file '" << _file << "'");
+        LINFO("Cached file '" << _cachedFile << "' used for Speck file '" << _file << "'");
 
-        bool success = loadCachedFile(cachedFile);
+        bool success = loadCachedFile(_cachedFile);
         if (success)
             return true;
-        else
-            FileSys.cacheManager()->removeCacheFile(_file);
-            // Intentional fall-through to the 'else' computation to generate the cache
-            // file for the next run
+        // Intentional fall-through to the 'else' computation to overwrite the invalid
+        // cache file for the next run
     }
     else {
         LINFO("Cache for Speck file '" << _file << "' not found");
@@ -377,7 +384,7 @@ bool RenderableStars::loadData() {
         return false;
 
     LINFO("Saving cache");
-    success = saveCachedFile(cachedFile);
+    success = saveCachedFile(_cachedFile);
 
     return success;
 }
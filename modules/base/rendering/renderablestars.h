@@ -40,6 +40,7 @@ public:
     RenderableStars(const ghoul::Dictionary& dictionary);
     ~RenderableStars();
 
+    bool initializeData() override;
     bool initialize() override;
     bool deinitialize() override;
 
@@ -80,6 +81,8 @@ private:
     std::unique_ptr<ghoul::opengl::ProgramObject> _program;
 
     std::string _speckFile;
+    // Determined on the main thread, since the cache manager is not thread-safe
+    std::string _cachedFile;
 
     std::vector<float> _slicedData;
     std::vector<float> _fullData;
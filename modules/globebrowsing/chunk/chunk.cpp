@@ -30,8 +30,10 @@
 #include <modules/globebrowsing/chunk/chunk.h>
 #include <modules/globebrowsing/chunk/chunkedlodglobe.h>
 #include <modules/globebrowsing/tile/layeredtextures.h>
+#include <modules/globebrowsing/tile/tileselector.h>
 
 #include <algorithm>
+#include <cmath>
 
 namespace {
     const std::string _loggerCat = "Chunk";
@@ -44,6 +46,12 @@ namespace openspace {
         , _surfacePatch(chunkIndex)
         , _index(chunkIndex)
         , _isVisible(initVisible) 
+        , _isCullable(false)
+        , _boundsAreValid(false)
+        , _geometricError(-1.0f)
+        , _heightTileProvider(nullptr)
+        , _heightTileUpdateCount(0)
+        , _heightTileLevel(-1)
     {
 
     }
@@ -67,10 +75,16 @@ namespace openspace {
     void Chunk::setIndex(const ChunkIndex& index) {
         _index = index;
         _surfacePatch = GeodeticPatch(index);
+        _boundsAreValid = false;
     }
 
     void Chunk::setOwner(ChunkedLodGlobe* newOwner) {
         _owner = newOwner;
+        _boundsAreValid = false;
+    }
+
+    void Chunk::setCullable(bool isCullable) {
+        _isCullable = isCullable;
     }
 
     Chunk::Status Chunk::update(const RenderData& data) {
@@ -80,7 +94,7 @@ namespace openspace {
 
 
         _isVisible = true;
-        if (_owner->testIfCullable(*this, myRenderData)) {
+        if (_isCullable) {
             _isVisible = false;
             return Status::WANT_MERGE;
         }
@@ -92,41 +106,112 @@ namespace openspace {
         else return Status::DO_NOTHING;
     }
 
-    Chunk::BoundingHeights Chunk::getBoundingHeights() const {
-        BoundingHeights boundingHeights;
-        boundingHeights.max = _owner->chunkHeight;
-        boundingHeights.min = 0;
-        boundingHeights.available = false;
+    const Chunk::BoundingHeights& Chunk::getBoundingHeights() const {
+        if (!_boundsAreValid) {
+            computeBounds();
+        }
+        return _boundingHeights;
+    }
+
+    float Chunk::getGeometricError() const {
+        if (!_boundsAreValid) {
+            computeBounds();
+        }
+        return _geometricError;
+    }
+
+    const std::array<glm::dvec4, 8>& Chunk::getBoundingPolyhedronCorners() const {
+        if (!_boundsAreValid) {
+            computeBounds();
+        }
+        return _boundingCorners;
+    }
+
+    void Chunk::updateBounds() {
+        if (!_boundsAreValid) {
+            computeBounds();
+            return;
+        }
+
+        TileProvider* heightMapProvider = _owner->getHeightMapProvider();
+        if (heightMapProvider != _heightTileProvider) {
+            computeBounds();
+            return;
+        }
+
+        // Without a height tile, the bounds depend on the chunk height of the owner
+        if (!_boundingHeights.available && _boundingHeights.max != _owner->chunkHeight) {
+            computeBounds();
+            return;
+        }
+
+        if (heightMapProvider == nullptr ||
+            heightMapProvider->getUpdateCount() == _heightTileUpdateCount)
+        {
+            return;
+        }
+
+        // New tiles have arrived; only chunks that can get a better height tile than the
+        // one that they currently use have to look for it
+        int maximumLevel = heightMapProvider->getAsyncTileReader()->
+            getTextureDataProvider()->getMaximumLevel();
+        int bestLevel = std::min(_index.level, maximumLevel);
+        if (bestLevel > 1 && _heightTileLevel < bestLevel) {
+            computeBounds();
+        }
+        else {
+            _heightTileUpdateCount = heightMapProvider->getUpdateCount();
+        }
+    }
+
+    void Chunk::computeBounds() const {
+        _boundingHeights.max = _owner->chunkHeight;
+        _boundingHeights.min = 0;
+        _boundingHeights.available = false;
+        _geometricError = -1.0f;
+        _heightTileLevel = -1;
 
         // In the future, this should be abstracted away and more easily queryable.
         // One must also handle how to sample pick one out of multiplte heightmaps
-        auto tileProvidermanager = owner()->getTileProviderManager();
-        auto heightMapProviders = tileProvidermanager->getActivatedLayerCategory(LayeredTextures::HeightMaps);
-        if (heightMapProviders.size() > 0) {
-            TileAndTransform tileAndTransform = TileSelector::getHighestResolutionTile(heightMapProviders[0].get(), _index);
+        TileProvider* heightMapProvider = _owner->getHeightMapProvider();
+        _heightTileProvider = heightMapProvider;
+        _heightTileUpdateCount = 0;
+        if (heightMapProvider != nullptr) {
+            _heightTileUpdateCount = heightMapProvider->getUpdateCount();
+            TileAndTransform tileAndTransform = TileSelector::getHighestResolutionTile(heightMapProvider, _index);
             if (tileAndTransform.tile.status == Tile::Status::OK) {
+                // Every level above the chunk halves the uv scale
+                _heightTileLevel = _index.level + std::ilogb(tileAndTransform.uvTransform.uvScale.x);
+
                 std::shared_ptr<TilePreprocessData> preprocessData = tileAndTransform.tile.preprocessData;
                 if ((preprocessData != nullptr) && preprocessData->maxValues.size() > 0) {
-                    boundingHeights.max = preprocessData->maxValues[0];
-                    boundingHeights.min = preprocessData->minValues[0];
-                    boundingHeights.available = true;
+                    _boundingHeights.max = preprocessData->maxValues[0];
+                    _boundingHeights.min = preprocessData->minValues[0];
+                    _boundingHeights.available = true;
+                }
+                if ((preprocessData != nullptr) &&
+                    preprocessData->geometricErrors.size() > 0)
+                {
+                    _geometricError = std::ldexp(preprocessData->geometricErrors[0],
+                        _heightTileLevel - _index.level);
                 }
             }
         }
 
-        return boundingHeights;
+        _boundingCorners = computeBoundingPolyhedronCorners(
+            _owner->ellipsoid(), _surfacePatch, _boundingHeights);
+        _boundsAreValid = true;
     }
 
-    std::vector<glm::dvec4> Chunk::getBoundingPolyhedronCorners() const {
+    std::array<glm::dvec4, 8> Chunk::computeBoundingPolyhedronCorners(
+                                                  const Ellipsoid& ellipsoid,
+                                                  const GeodeticPatch& patch,
+                                                  const BoundingHeights& boundingHeight)
+    {
         // OBS!
         // This implementation needs to be fixed! Its not completely bounding
         // See DebugRenderer::renderBoxFaces to see whats wrong
 
-        const Ellipsoid& ellipsoid = owner()->ellipsoid();
-        const GeodeticPatch& patch = surfacePatch();
-
-        BoundingHeights boundingHeight = getBoundingHeights();
-
         // assume worst case
         double patchCenterRadius = ellipsoid.maximumRadius();
 
@@ -143,7 +228,7 @@ namespace openspace {
 
         // The minimum height offset, however, we can simply 
         double minCornerHeight = boundingHeight.min;
-        std::vector<glm::dvec4> corners(8);
+        std::array<glm::dvec4, 8> corners;
         
         Scalar latCloseToEquator = patch.edgeLatitudeNearestEquator();
         Geodetic3 p1Geodetic = { { latCloseToEquator, patch.minLon() }, maxCornerHeight };
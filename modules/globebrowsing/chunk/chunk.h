@@ -26,6 +26,7 @@
 #define __CHUNK_H__
 
 #include <glm/glm.hpp>
+#include <array>
 #include <vector>
 #include <memory>
 #include <ostream>
@@ -42,6 +43,8 @@
 namespace openspace {
 
     class ChunkedLodGlobe;
+    class Ellipsoid;
+    class TileProvider;
 
     class Chunk {
     public:
@@ -63,25 +66,60 @@ namespace openspace {
         void render(const RenderData& data) const;
 
 
-        std::vector<glm::dvec4> getBoundingPolyhedronCorners() const;
+        const std::array<glm::dvec4, 8>& getBoundingPolyhedronCorners() const;
 
         const GeodeticPatch& surfacePatch() const;
         ChunkedLodGlobe* const owner() const;
         const ChunkIndex index() const;
         bool isVisible() const;
-        BoundingHeights getBoundingHeights() const;
+        const BoundingHeights& getBoundingHeights() const;
+
+        /**
+         * Returns the geometric error of the height tile of this chunk in the same
+         * units as the bounding heights, or a negative value if it is not known. If the
+         * chunk uses the tile of an ancestor, the error of that tile is halved for each
+         * level between them.
+         */
+        float getGeometricError() const;
 
         void setIndex(const ChunkIndex& index);
         void setOwner(ChunkedLodGlobe* newOwner);
 
+        /**
+         * Recomputes the cached bounding heights and polyhedron corners if the height
+         * map provider of the owner has changed, or if it has loaded new tiles and the
+         * bounds were not computed from the best height tile for this chunk.
+         */
+        void updateBounds();
+
+        /**
+         * Sets the result of the culling tests for this frame. The owner culls all
+         * chunks of the tree in one batch before updating them.
+         */
+        void setCullable(bool isCullable);
+
+        static std::array<glm::dvec4, 8> computeBoundingPolyhedronCorners(
+            const Ellipsoid& ellipsoid, const GeodeticPatch& patch,
+            const BoundingHeights& boundingHeights);
 
     private:
+        void computeBounds() const;
 
         ChunkedLodGlobe* _owner;
         ChunkIndex _index;
         bool _isVisible;
+        bool _isCullable;
         GeodeticPatch _surfacePatch;
 
+        // Cached bounds together with the state of the height tiles they were computed
+        // from. _heightTileLevel is -1 if no height tile was available
+        mutable bool _boundsAreValid;
+        mutable BoundingHeights _boundingHeights;
+        mutable float _geometricError;
+        mutable std::array<glm::dvec4, 8> _boundingCorners;
+        mutable const TileProvider* _heightTileProvider;
+        mutable int _heightTileUpdateCount;
+        mutable int _heightTileLevel;
     };
 
 
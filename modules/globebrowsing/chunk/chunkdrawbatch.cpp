@@ -0,0 +1,124 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/chunk/chunkdrawbatch.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+
+namespace {
+    const std::string _loggerCat = "ChunkDrawBatch";
+}
+
+namespace openspace {
+
+    void ChunkDrawBatch::clear(const dmat4& localModelViewTransform,
+        size_t tilesPerChunk)
+    {
+        _localModelViewTransform = localModelViewTransform;
+        _tilesPerChunk = tilesPerChunk;
+
+        // Keep the capacity of the previous frame
+        _chunks.clear();
+        _tiles.clear();
+        for (auto& chunks : _chunksOfVariant) {
+            chunks.clear();
+        }
+    }
+
+    size_t ChunkDrawBatch::addChunk(const GeodeticPatch& patch, int level,
+        const Ellipsoid& ellipsoid)
+    {
+        ghoul_assert(_tiles.size() == _chunks.size() * _tilesPerChunk,
+            "All tiles of the previous chunk must be added before the next chunk");
+
+        ChunkData chunk;
+        chunk.level = level;
+        // The length of the skirts is proportional to its size
+        chunk.skirtLength = std::min(
+            static_cast<float>(patch.halfSize().lat * 1000000), 8700.0f);
+        chunk.firstTile = _tiles.size();
+
+        Variant v = variant(level);
+        if (v == Variant::Global) {
+            chunk.minLatLon = vec2(patch.getCorner(Quad::SOUTH_WEST).toLonLatVec2());
+            chunk.lonLatScalingFactor = vec2(patch.size().toLonLatVec2());
+        }
+        else {
+            const Quad quads[4] = {
+                Quad::SOUTH_WEST, Quad::SOUTH_EAST, Quad::NORTH_WEST, Quad::NORTH_EAST
+            };
+            std::array<Vec3, 4> cornersCameraSpace;
+            for (int i = 0; i < 4; ++i) {
+                Vec3 cornerModelSpace =
+                    ellipsoid.cartesianSurfacePosition(patch.getCorner(quads[i]));
+                cornersCameraSpace[i] =
+                    Vec3(_localModelViewTransform * dvec4(cornerModelSpace, 1));
+                chunk.corners[i] = vec3(cornersCameraSpace[i]);
+            }
+            chunk.patchNormal = vec3(normalize(
+                cross(cornersCameraSpace[1] - cornersCameraSpace[0],
+                    cornersCameraSpace[2] - cornersCameraSpace[0])));
+        }
+
+        size_t index = _chunks.size();
+        _chunks.push_back(chunk);
+        _chunksOfVariant[static_cast<int>(v)].push_back(index);
+        return index;
+    }
+
+    void ChunkDrawBatch::addTile(ghoul::opengl::Texture* texture, const vec2& uvOffset,
+        const vec2& uvScale)
+    {
+        _tiles.push_back({ texture, uvOffset, uvScale });
+    }
+
+    ChunkDrawBatch::Variant ChunkDrawBatch::variant(int level) {
+        return level < LocalRenderingLevel ? Variant::Global : Variant::Local;
+    }
+
+    const std::vector<size_t>& ChunkDrawBatch::chunksOfVariant(Variant variant) const {
+        return _chunksOfVariant[static_cast<int>(variant)];
+    }
+
+    const ChunkDrawBatch::ChunkData& ChunkDrawBatch::chunk(size_t i) const {
+        return _chunks[i];
+    }
+
+    const ChunkDrawBatch::TileData& ChunkDrawBatch::tile(size_t chunk,
+        size_t tileInChunk) const
+    {
+        return _tiles[_chunks[chunk].firstTile + tileInChunk];
+    }
+
+    size_t ChunkDrawBatch::size() const {
+        return _chunks.size();
+    }
+
+    size_t ChunkDrawBatch::tilesPerChunk() const {
+        return _tilesPerChunk;
+    }
+
+}  // namespace openspace
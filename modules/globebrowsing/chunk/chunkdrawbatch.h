@@ -0,0 +1,126 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __CHUNK_DRAW_BATCH_H__
+#define __CHUNK_DRAW_BATCH_H__
+
+#include <array>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include <modules/globebrowsing/geometry/geodetic2.h>
+#include <modules/globebrowsing/geometry/ellipsoid.h>
+
+namespace ghoul {
+namespace opengl {
+    class Texture;
+}
+}
+
+namespace openspace {
+
+    using namespace glm;
+
+    /**
+     * Gathers the per chunk data needed to draw all visible chunks of a globe in one
+     * frame. The data is packed into contiguous arrays before any GL calls are made, so
+     * that the renderer can activate each shader variant once and only upload the values
+     * that actually differ between chunks. Packing does not touch OpenGL and can be
+     * measured without a context.
+     *
+     * Chunks below #LocalRenderingLevel are drawn with the global shader, that maps
+     * the grid to the ellipsoid in the vertex shader. Closer chunks are drawn with the
+     * local shader, that interpolates between the four corners of the patch given in
+     * camera space to avoid precision problems.
+     */
+    class ChunkDrawBatch {
+    public:
+        static const int LocalRenderingLevel = 9;
+
+        enum class Variant { Global, Local };
+
+        struct TileData {
+            /// The texture is not owned and has to live until the batch is drawn
+            ghoul::opengl::Texture* texture;
+            vec2 uvOffset;
+            vec2 uvScale;
+        };
+
+        struct ChunkData {
+            int level;
+            float skirtLength;
+
+            // Global variant
+            vec2 minLatLon;
+            vec2 lonLatScalingFactor;
+
+            // Local variant; the corners are given in camera space in the order
+            // south west, south east, north west, north east
+            std::array<vec3, 4> corners;
+            vec3 patchNormal;
+
+            /// Index of the first tile of the chunk in #tiles
+            size_t firstTile;
+        };
+
+        /**
+         * Removes all chunks and sets up the batch for a new frame.
+         * \param localModelViewTransform the transform from the model space of the
+         *        globe, without its rotation, to camera space used by the local variant
+         * \param tilesPerChunk the number of tiles that are added for each chunk
+         */
+        void clear(const dmat4& localModelViewTransform, size_t tilesPerChunk);
+
+        /**
+         * Adds a chunk and returns its index. The tiles of the chunk have to be added
+         * with #addTile directly afterwards.
+         */
+        size_t addChunk(const GeodeticPatch& patch, int level, const Ellipsoid& ellipsoid);
+
+        void addTile(ghoul::opengl::Texture* texture, const vec2& uvOffset,
+            const vec2& uvScale);
+
+        static Variant variant(int level);
+
+        /// The indices of the chunks of a variant in the order that they were added
+        const std::vector<size_t>& chunksOfVariant(Variant variant) const;
+
+        const ChunkData& chunk(size_t i) const;
+        const TileData& tile(size_t chunk, size_t tileInChunk) const;
+
+        size_t size() const;
+        size_t tilesPerChunk() const;
+
+    private:
+        dmat4 _localModelViewTransform;
+        size_t _tilesPerChunk;
+
+        std::vector<ChunkData> _chunks;
+        std::vector<TileData> _tiles;
+        std::array<std::vector<size_t>, 2> _chunksOfVariant;
+    };
+
+}  // namespace openspace
+
+#endif  // __CHUNK_DRAW_BATCH_H__
@@ -42,6 +42,7 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <memory>
 
 namespace {
     const std::string _loggerCat = "ChunkLodGlobe";
@@ -52,21 +53,19 @@ namespace openspace {
     const GeodeticPatch ChunkedLodGlobe::LEFT_HEMISPHERE = GeodeticPatch(0, -M_PI/2, M_PI/2, M_PI/2);
     const GeodeticPatch ChunkedLodGlobe::RIGHT_HEMISPHERE = GeodeticPatch(0, M_PI/2, M_PI/2, M_PI/2);
 
-    const ChunkIndex ChunkedLodGlobe::LEFT_HEMISPHERE_INDEX = ChunkIndex(0, 0, 1);
-    const ChunkIndex ChunkedLodGlobe::RIGHT_HEMISPHERE_INDEX = ChunkIndex(1, 0, 1);
-
 
     ChunkedLodGlobe::ChunkedLodGlobe(
         const Ellipsoid& ellipsoid,
         size_t segmentsPerPatch,
         std::shared_ptr<TileProviderManager> tileProviderManager)
         : _ellipsoid(ellipsoid)
-        , _leftRoot(new ChunkNode(Chunk(this, LEFT_HEMISPHERE_INDEX)))
-        , _rightRoot(new ChunkNode(Chunk(this, RIGHT_HEMISPHERE_INDEX)))
+        , _chunkTree(new ChunkTree(this))
         , minSplitDepth(2)
         , maxSplitDepth(22)
+        , segmentsPerPatch(static_cast<int>(segmentsPerPatch))
         , _savedCamera(nullptr)
         , _tileProviderManager(tileProviderManager)
+        , _batchedChunkCuller(AABB3(vec3(-1, -1, 0), vec3(1, 1, 1e35)))
     {
 
         auto geometry = std::make_shared<SkirtedGrid>(
@@ -84,6 +83,7 @@ namespace openspace {
         _chunkEvaluatorByAvailableTiles = std::make_unique<EvaluateChunkLevelByAvailableTileData>();
         _chunkEvaluatorByProjectedArea = std::make_unique<EvaluateChunkLevelByProjectedArea>();
         _chunkEvaluatorByDistance = std::make_unique<EvaluateChunkLevelByDistance>();
+        _chunkEvaluatorByScreenSpaceError = std::make_unique<EvaluateChunkLevelByScreenSpaceError>();
 
         _patchRenderer = std::make_unique<ChunkRenderer>(geometry, tileProviderManager);
     }
@@ -110,6 +110,31 @@ namespace openspace {
     }
 
 
+    TileProvider* ChunkedLodGlobe::getHeightMapProvider() const {
+        return _heightMapProvider.get();
+    }
+
+    HeightQueryResult ChunkedLodGlobe::getHeight(const Geodetic2& position) const {
+        std::shared_ptr<HeightTileCache> heightTileCache =
+            std::atomic_load(&_heightTileCache);
+        if (heightTileCache == nullptr) {
+            return { 0.0f, -1 };
+        }
+        return heightTileCache->getHeight(position);
+    }
+
+    void ChunkedLodGlobe::getHeights(const std::vector<Geodetic2>& positions,
+        std::vector<HeightQueryResult>& results) const
+    {
+        std::shared_ptr<HeightTileCache> heightTileCache =
+            std::atomic_load(&_heightTileCache);
+        if (heightTileCache == nullptr) {
+            results.assign(positions.size(), { 0.0f, -1 });
+            return;
+        }
+        heightTileCache->getHeights(positions, results);
+    }
+
     ChunkRenderer& ChunkedLodGlobe::getPatchRenderer() const{
         return *_patchRenderer;
     }
@@ -126,7 +151,10 @@ namespace openspace {
 
     int ChunkedLodGlobe::getDesiredLevel(const Chunk& chunk, const RenderData& renderData) const {
         int desiredLevel = 0;
-        if (levelByProjArea) {
+        if (levelByScreenSpaceError) {
+            desiredLevel = _chunkEvaluatorByScreenSpaceError->getDesiredLevel(chunk, renderData);
+        }
+        else if (levelByProjArea) {
             desiredLevel = _chunkEvaluatorByProjectedArea->getDesiredLevel(chunk, renderData);
         }
         else {
@@ -149,11 +177,22 @@ namespace openspace {
         minDistToCamera = INFINITY;
         ChunkNode::renderedChunks = 0;
 
-        _leftRoot->updateChunkTree(data);
-        _rightRoot->updateChunkTree(data);
+        // Only the first height map is used for the bounds of the chunks
+        auto heightMapProviders = _tileProviderManager->getActivatedLayerCategory(LayeredTextures::HeightMaps);
+        _heightMapProvider = heightMapProviders.size() > 0 ? heightMapProviders[0] : nullptr;
+
+        // Only the last height map is used when rendering, so heights are queried from it
+        std::atomic_store(&_heightTileCache, heightMapProviders.size() > 0 ?
+            heightMapProviders.back()->getHeightTileCache() : nullptr);
 
-        renderChunkTree(_leftRoot.get(), data);
-        renderChunkTree(_rightRoot.get(), data);
+        cullChunkTree(data);
+
+        _chunkTree->update(data);
+
+        // The chunks are gathered by the renderer and drawn together
+        _patchRenderer->beginBatch(*this, data);
+        _chunkTree->render(data, renderSmallChunksFirst);
+        _patchRenderer->endBatch(data);
 
 
         // Calculate the MVP matrix
@@ -163,10 +202,10 @@ namespace openspace {
             * viewTransform * modelTransform;
 
         if (showChunkBounds) {
-            std::function<void(const ChunkNode&)> chunkDebugRenderer = [&data, &mvp](const ChunkNode& chunkNode) {
+            _chunkTree->forEachLeaf([&data, &mvp](const ChunkNode& chunkNode) {
                 const Chunk& chunk = chunkNode.getChunk();
-                if (chunkNode.isLeaf() && chunk.isVisible()) {
-                    const std::vector<glm::dvec4> modelSpaceCorners = chunk.getBoundingPolyhedronCorners();
+                if (chunk.isVisible()) {
+                    const std::array<glm::dvec4, 8>& modelSpaceCorners = chunk.getBoundingPolyhedronCorners();
                     std::vector<glm::vec4> clippingSpaceCorners(8);
                     for (size_t i = 0; i < 8; i++) {
                         clippingSpaceCorners[i] = mvp * modelSpaceCorners[i];
@@ -182,10 +221,7 @@ namespace openspace {
                     glPointSize(20.0f);
                     DebugRenderer::ref()->renderVertices(clippingSpaceCorners, GL_POINTS, color);
                 }
-            };
-
-            _leftRoot->depthFirst(chunkDebugRenderer);
-            _rightRoot->depthFirst(chunkDebugRenderer);
+            });
         }
        
 
@@ -199,14 +235,35 @@ namespace openspace {
         //LDEBUG(ChunkNode::renderedChunks << " / " << ChunkNode::chunkNodeCount << " chunks rendered");
     }
 
-    void ChunkedLodGlobe::renderChunkTree(ChunkNode* node, const RenderData& data) const {
-        if (renderSmallChunksFirst) {
-            node->renderReversedBreadthFirst(data);
+    void ChunkedLodGlobe::cullChunkTree(const RenderData& data) {
+        // Use the same camera as Chunk::update
+        const Camera& camera = _savedCamera != nullptr ? *_savedCamera : data.camera;
+
+        _chunksToCull.clear();
+        _chunkTree->forEachNode([this](ChunkNode& chunkNode) {
+            _chunksToCull.push_back(&chunkNode.getChunk());
+        });
+
+        Vec3 cameraPosition = camera.positionVec3();
+        Vec3 globePosition = data.position.dvec3();
+
+        _batchedChunkCuller.clear();
+        for (Chunk* chunk : _chunksToCull) {
+            chunk->updateBounds();
+            _batchedChunkCuller.add(*chunk, cameraPosition, globePosition);
         }
-        else {
-            node->renderDepthFirst(data);
+
+        dmat4 modelTransform = translate(dmat4(1), globePosition);
+        dmat4 viewTransform = dmat4(camera.combinedViewMatrix());
+        dmat4 modelViewProjectionTransform = dmat4(camera.projectionMatrix())
+            * viewTransform * modelTransform;
+
+        _batchedChunkCuller.cull(modelViewProjectionTransform, cameraPosition, globePosition,
+            _ellipsoid.minimumRadius(), doHorizonCulling, doFrustumCulling);
+
+        for (size_t i = 0; i < _chunksToCull.size(); ++i) {
+            _chunksToCull[i]->setCullable(_batchedChunkCuller.isCullable(i));
         }
-        
     }
 
     void ChunkedLodGlobe::update(const UpdateData& data) {
@@ -41,7 +41,9 @@
 #include <modules/globebrowsing/geometry/ellipsoid.h>
 
 #include <modules/globebrowsing/chunk/chunknode.h>
+#include <modules/globebrowsing/chunk/chunktree.h>
 #include <modules/globebrowsing/chunk/chunkrenderer.h>
+#include <modules/globebrowsing/chunk/culling.h>
 
 #include <modules/globebrowsing/tile/tileprovider.h>
 
@@ -87,10 +89,28 @@ namespace openspace {
 
         const int minSplitDepth;
         const int maxSplitDepth;
+        const int segmentsPerPatch;
 
 
         std::shared_ptr<TileProviderManager> getTileProviderManager() const;
 
+        /**
+         * Returns the height map provider that bounding heights are read from, or
+         * <code>nullptr</code> if no height map is active. Updated once per frame.
+         */
+        TileProvider* getHeightMapProvider() const;
+
+        /**
+         * Returns the terrain height at <code>position</code> from the CPU copies of the
+         * tiles of the height map that is rendered, which is the last active one. Can
+         * be called from any thread.
+         */
+        HeightQueryResult getHeight(const Geodetic2& position) const;
+
+        /// Answers a batch of height queries, see #getHeight
+        void getHeights(const std::vector<Geodetic2>& positions,
+            std::vector<HeightQueryResult>& results) const;
+
 
         Camera* getSavedCamera() const { return _savedCamera; }
         void setSaveCamera(Camera* c) { 
@@ -114,18 +134,20 @@ namespace openspace {
         bool showChunkEdges;
         bool showChunkBounds;
         bool levelByProjArea;
+        bool levelByScreenSpaceError;
+        float screenSpaceErrorThreshold;
         bool limitLevelByAvailableHeightData;
         
 
     private:
 
-        void renderChunkTree(ChunkNode* node, const RenderData& data) const;
-
-        // Covers all negative longitudes
-        std::unique_ptr<ChunkNode> _leftRoot;
+        /**
+         * Updates the bounds of all chunks in the tree and culls them in one batch. The
+         * results are stored in the chunks and used when the tree is updated.
+         */
+        void cullChunkTree(const RenderData& data);
 
-        // Covers all positive longitudes
-        std::unique_ptr<ChunkNode> _rightRoot;
+        std::unique_ptr<ChunkTree> _chunkTree;
 
         // the patch used for actual rendering
         std::unique_ptr<ChunkRenderer> _patchRenderer;
@@ -133,14 +155,15 @@ namespace openspace {
         static const GeodeticPatch LEFT_HEMISPHERE;
         static const GeodeticPatch RIGHT_HEMISPHERE;
 
-        static const ChunkIndex LEFT_HEMISPHERE_INDEX;
-        static const ChunkIndex RIGHT_HEMISPHERE_INDEX;
-
         std::vector<ChunkCuller*> _chunkCullers;
 
+        BatchedChunkCuller _batchedChunkCuller;
+        std::vector<Chunk*> _chunksToCull;
+
         std::unique_ptr<ChunkLevelEvaluator> _chunkEvaluatorByAvailableTiles;
         std::unique_ptr<ChunkLevelEvaluator> _chunkEvaluatorByProjectedArea;
         std::unique_ptr<ChunkLevelEvaluator> _chunkEvaluatorByDistance;
+        std::unique_ptr<ChunkLevelEvaluator> _chunkEvaluatorByScreenSpaceError;
 
         const Ellipsoid& _ellipsoid;
         glm::dmat3 _stateMatrix;
@@ -148,6 +171,11 @@ namespace openspace {
         Camera* _savedCamera;
         
         std::shared_ptr<TileProviderManager> _tileProviderManager;
+        std::shared_ptr<TileProvider> _heightMapProvider;
+
+        // Replaced by the render thread and read by height queries from any thread, so
+        // it is only accessed through std::atomic_load and std::atomic_store
+        std::shared_ptr<HeightTileCache> _heightTileCache;
     };
 
 }  // namespace openspace
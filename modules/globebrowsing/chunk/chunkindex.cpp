@@ -29,6 +29,28 @@
 
 namespace {
     const std::string _loggerCat = "ChunkIndex";
+
+    // Moves the bits of v to the even bit positions
+    uint64_t spreadBits(uint32_t v) {
+        uint64_t x = v;
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+        x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x << 2)) & 0x3333333333333333ull;
+        x = (x | (x << 1)) & 0x5555555555555555ull;
+        return x;
+    }
+
+    // Inverse of spreadBits
+    uint32_t compactBits(uint64_t x) {
+        x &= 0x5555555555555555ull;
+        x = (x | (x >> 1)) & 0x3333333333333333ull;
+        x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+        x = (x | (x >> 4)) & 0x00FF00FF00FF00FFull;
+        x = (x | (x >> 8)) & 0x0000FFFF0000FFFFull;
+        x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+        return static_cast<uint32_t>(x);
+    }
 }
 
 namespace openspace {
@@ -100,6 +122,20 @@ namespace openspace {
     }
 
 
+    MortonKey ChunkIndex::mortonKey() const {
+        return (MortonKey(1) << (2 * level)) | spreadBits(x) | (spreadBits(y) << 1);
+    }
+
+    ChunkIndex ChunkIndex::fromMortonKey(MortonKey key) {
+        int level = 0;
+        while ((key >> (2 * (level + 1))) != 0) {
+            level++;
+        }
+        MortonKey bits = key & ~(MortonKey(1) << (2 * level));
+        return ChunkIndex(compactBits(bits), compactBits(bits >> 1), level);
+    }
+
+
     std::string ChunkIndex::toString() const {
         std::stringstream ss;
         for (int i = level; i > 0; i--){
@@ -26,6 +26,7 @@
 #define __CHUNK_INDEX_H__
 
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <vector>
 
 
@@ -53,6 +54,13 @@ enum CardinalDirection {
 
 using HashKey = unsigned long;
 
+/**
+ * Identifies a chunk by interleaving the bits of its x and y index (z-order) below a
+ * marker bit at position 2 * level. The key of the parent is the key shifted two bits
+ * to the right and the two lowest bits are the Quad of the chunk within its parent.
+ */
+using MortonKey = uint64_t;
+
 
 struct ChunkIndex {
     
@@ -109,6 +117,9 @@ struct ChunkIndex {
 
     HashKey hashKey() const;
 
+    MortonKey mortonKey() const;
+    static ChunkIndex fromMortonKey(MortonKey key);
+
     bool operator==(const ChunkIndex& other) const;
 };
 
@@ -34,6 +34,7 @@
 
 
 #include <algorithm>
+#include <cmath>
 
 namespace {
     const std::string _loggerCat = "ChunkLevelEvaluator";
@@ -44,24 +45,28 @@ namespace openspace {
     
     int EvaluateChunkLevelByDistance::getDesiredLevel(const Chunk& chunk, const RenderData& data) const {
         ChunkedLodGlobe const * globe = chunk.owner();
-        const Ellipsoid& ellipsoid = globe->ellipsoid();
+        Vec3 cameraPosition = data.camera.positionVec3() - data.position.dvec3();
+        return desiredLevel(globe->ellipsoid(), chunk.index(), chunk.getBoundingHeights(),
+            cameraPosition, globe->lodScaleFactor);
+    }
 
-        Vec3 cameraPosition = data.camera.positionVec3();
-        Geodetic2 pointOnPatch = chunk.surfacePatch().closestPoint(
+    int EvaluateChunkLevelByDistance::desiredLevel(const Ellipsoid& ellipsoid,
+        const ChunkIndex& chunkIndex, const Chunk::BoundingHeights& heights,
+        const Vec3& cameraPosition, Scalar lodScaleFactor)
+    {
+        Geodetic2 pointOnPatch = GeodeticPatch(chunkIndex).closestPoint(
             ellipsoid.cartesianToGeodetic2(cameraPosition));
-        
-        Chunk::BoundingHeights heights = chunk.getBoundingHeights();
-
-        Vec3 globePosition = data.position.dvec3();
-        Vec3 patchPosition = globePosition + ellipsoid.cartesianSurfacePosition(pointOnPatch);
-        Vec3 cameraToChunk = patchPosition - cameraPosition;
-
+        Vec3 cameraToChunk = ellipsoid.cartesianSurfacePosition(pointOnPatch) - cameraPosition;
 
         // Calculate desired level based on distance
         Scalar distanceToPatch = glm::length(cameraToChunk);
         Scalar distance = distanceToPatch - heights.min; // distance to actual minimum heights
 
-        Scalar scaleFactor = globe->lodScaleFactor * ellipsoid.minimumRadius();
+        Scalar scaleFactor = lodScaleFactor * ellipsoid.minimumRadius();
+        return desiredLevel(distance, scaleFactor);
+    }
+
+    int EvaluateChunkLevelByDistance::desiredLevel(Scalar distance, Scalar scaleFactor) {
         Scalar projectedScaleFactor = scaleFactor / distance;
         int desiredLevel = ceil(log2(projectedScaleFactor));
         return desiredLevel;
@@ -69,12 +74,17 @@ namespace openspace {
 
     int EvaluateChunkLevelByProjectedArea::getDesiredLevel(const Chunk& chunk, const RenderData& data) const {
         ChunkedLodGlobe const * globe = chunk.owner();
-        const Ellipsoid& ellipsoid = globe->ellipsoid();
-        Vec3 cameraPosition = data.camera.positionVec3();
-        Vec3 globePosition = data.position.dvec3();
-        Vec3 cameraToEllipseCenter = globePosition - cameraPosition;
+        Vec3 cameraPosition = data.camera.positionVec3() - data.position.dvec3();
+        return desiredLevel(globe->ellipsoid(), chunk.index(), chunk.getBoundingHeights(),
+            cameraPosition, globe->lodScaleFactor);
+    }
 
-        Geodetic2 camPos = ellipsoid.cartesianToGeodetic2(cameraPosition);
+    int EvaluateChunkLevelByProjectedArea::desiredLevel(const Ellipsoid& ellipsoid,
+        const ChunkIndex& chunkIndex, const Chunk::BoundingHeights& heights,
+        const Vec3& cameraPosition, Scalar lodScaleFactor)
+    {
+        Vec3 cameraToEllipseCenter = -cameraPosition;
+        GeodeticPatch patch(chunkIndex);
         /*
         struct CornerDist {
             Geodetic2 corner;
@@ -107,18 +117,24 @@ namespace openspace {
         const Geodetic3 c3 = { cornerDists[3].corner, heights.max };
         */
 
-        Chunk::BoundingHeights heights = chunk.getBoundingHeights();
-
-        const Geodetic3 c0 = { chunk.surfacePatch().getCorner((Quad)0), heights.min };
-        const Geodetic3 c1 = { chunk.surfacePatch().getCorner((Quad)1), heights.min };
-        const Geodetic3 c2 = { chunk.surfacePatch().getCorner((Quad)2), heights.min };
-        const Geodetic3 c3 = { chunk.surfacePatch().getCorner((Quad)3), heights.min };
+        const Geodetic3 c0 = { patch.getCorner((Quad)0), heights.min };
+        const Geodetic3 c1 = { patch.getCorner((Quad)1), heights.min };
+        const Geodetic3 c2 = { patch.getCorner((Quad)2), heights.min };
+        const Geodetic3 c3 = { patch.getCorner((Quad)3), heights.min };
 
         Vec3 A = cameraToEllipseCenter + ellipsoid.cartesianPosition(c0);
         Vec3 B = cameraToEllipseCenter + ellipsoid.cartesianPosition(c1);
         Vec3 C = cameraToEllipseCenter + ellipsoid.cartesianPosition(c2);
         Vec3 D = cameraToEllipseCenter + ellipsoid.cartesianPosition(c3);
 
+        double projectedChunkAreaApprox = projectedArea(A, B, C, D);
+        double scaledArea = lodScaleFactor * projectedChunkAreaApprox;
+        return chunkIndex.level + round(scaledArea - 1);
+    }
+
+    Scalar EvaluateChunkLevelByProjectedArea::projectedArea(Vec3 A, Vec3 B, Vec3 C,
+        Vec3 D)
+    {
         // Project points onto unit sphere
         A = glm::normalize(A);
         B = glm::normalize(B);
@@ -141,20 +157,16 @@ namespace openspace {
 
         double areaTriangle1 = 0.5 * glm::length(glm::cross(AC, AB));
         double areaTriangle2 = 0.5 * glm::length(glm::cross(DC, DB));
-        double projectedChunkAreaApprox = areaTriangle1 + areaTriangle2;
-
-        double scaledArea = globe->lodScaleFactor * projectedChunkAreaApprox;
-        return chunk.index().level + round(scaledArea - 1);
+        return areaTriangle1 + areaTriangle2;
     }
 
     int EvaluateChunkLevelByAvailableTileData::getDesiredLevel(const Chunk& chunk, const RenderData& data) const {
-        auto tileProvidermanager = chunk.owner()->getTileProviderManager();
-        auto heightMapProviders = tileProvidermanager->getActivatedLayerCategory(LayeredTextures::HeightMaps);
+        TileProvider* heightMapProvider = chunk.owner()->getHeightMapProvider();
         int currLevel = chunk.index().level;
 
         // simply check the first heigtmap
-        if (heightMapProviders.size() > 0) {
-            Tile::Status heightTileStatus = heightMapProviders[0]->getTileStatus(chunk.index());
+        if (heightMapProvider != nullptr) {
+            Tile::Status heightTileStatus = heightMapProvider->getTileStatus(chunk.index());
             if (heightTileStatus == Tile::Status::IOError || heightTileStatus == Tile::Status::OutOfRange) {
                 return currLevel-1;
             }
@@ -165,4 +177,79 @@ namespace openspace {
         return UNKNOWN_DESIRED_LEVEL;
     }
 
+    int EvaluateChunkLevelByScreenSpaceError::getDesiredLevel(const Chunk& chunk,
+        const RenderData& data) const
+    {
+        float heightError = chunk.getGeometricError();
+        if (heightError < 0.0f) {
+            return _distanceEvaluator.getDesiredLevel(chunk, data);
+        }
+
+        ChunkedLodGlobe const * globe = chunk.owner();
+        Vec3 cameraPosition = data.camera.positionVec3() - data.position.dvec3();
+
+        // The projection matrix scales y by 1 / tan(fovy / 2)
+        Scalar viewportHeight = OsEng.windowWrapper().currentWindowResolution().y;
+        Scalar projectionScale = 0.5 * viewportHeight *
+            data.camera.sgctInternal.projectionMatrix()[1][1];
+
+        return desiredLevel(globe->ellipsoid(), chunk.index(), chunk.getBoundingHeights(),
+            heightError, cameraPosition, globe->segmentsPerPatch, projectionScale,
+            globe->screenSpaceErrorThreshold);
+    }
+
+    int EvaluateChunkLevelByScreenSpaceError::desiredLevel(const Ellipsoid& ellipsoid,
+        const ChunkIndex& chunkIndex, const Chunk::BoundingHeights& heights,
+        float heightError, const Vec3& cameraPosition, int segmentsPerPatch,
+        Scalar projectionScale, Scalar threshold)
+    {
+        GeodeticPatch patch(chunkIndex);
+        Geodetic2 pointOnPatch = patch.closestPoint(
+            ellipsoid.cartesianToGeodetic2(cameraPosition));
+        Vec3 patchPosition = ellipsoid.cartesianSurfacePosition(pointOnPatch);
+
+        // Distance to the highest point the chunk can reach
+        Scalar distance = glm::length(patchPosition - cameraPosition) - heights.max;
+        if (distance <= 0.0) {
+            return chunkIndex.level + 1;
+        }
+
+        Geodetic2 patchSize = patch.size();
+        Scalar geometricError = heightError + curvatureError(
+            ellipsoid.maximumRadius(),
+            std::max(patchSize.lat, patchSize.lon),
+            segmentsPerPatch);
+
+        return desiredLevel(
+            chunkIndex.level,
+            screenSpaceError(geometricError, distance, projectionScale),
+            threshold);
+    }
+
+    Scalar EvaluateChunkLevelByScreenSpaceError::curvatureError(Scalar radius,
+        Scalar angularSize, int segments)
+    {
+        // Height of the circular segment between two neighbouring vertices
+        Scalar segmentAngle = angularSize / std::max(segments, 1);
+        return radius * (1.0 - cos(0.5 * segmentAngle));
+    }
+
+    Scalar EvaluateChunkLevelByScreenSpaceError::screenSpaceError(Scalar geometricError,
+        Scalar distance, Scalar projectionScale)
+    {
+        return geometricError * projectionScale / distance;
+    }
+
+    int EvaluateChunkLevelByScreenSpaceError::desiredLevel(int level,
+        Scalar screenSpaceError, Scalar threshold)
+    {
+        if (screenSpaceError > threshold) {
+            return level + 1;
+        }
+        if (2.0 * screenSpaceError <= threshold) {
+            return level - 1;
+        }
+        return level;
+    }
+
 } // namespace openspace
@@ -31,6 +31,9 @@
 #include <ostream>
 
 #include <modules/globebrowsing/chunk/chunk.h>
+#include <modules/globebrowsing/chunk/chunkindex.h>
+#include <modules/globebrowsing/geometry/ellipsoid.h>
+#include <modules/globebrowsing/geometry/geodetic2.h>
 
 
 namespace openspace {
@@ -46,11 +49,38 @@ namespace openspace {
     class EvaluateChunkLevelByDistance : public ChunkLevelEvaluator {
     public:
         virtual int getDesiredLevel(const Chunk& chunk, const RenderData& data) const;
+
+        /// The level for a chunk at <code>distance</code> from the camera
+        static int desiredLevel(Scalar distance, Scalar scaleFactor);
+
+        /**
+         * The level for the chunk at <code>chunkIndex</code> with the bounding
+         * <code>heights</code>. <code>cameraPosition</code> is given relative to the
+         * center of <code>ellipsoid</code>.
+         */
+        static int desiredLevel(const Ellipsoid& ellipsoid, const ChunkIndex& chunkIndex,
+            const Chunk::BoundingHeights& heights, const Vec3& cameraPosition,
+            Scalar lodScaleFactor);
     };
 
     class EvaluateChunkLevelByProjectedArea : public ChunkLevelEvaluator {
     public:
         virtual int getDesiredLevel(const Chunk& chunk, const RenderData& data) const;
+
+        /**
+         * Approximates the area of the quad ABDC, given relative to the camera, when
+         * projected onto a unit sphere around the camera
+         */
+        static Scalar projectedArea(Vec3 A, Vec3 B, Vec3 C, Vec3 D);
+
+        /**
+         * The level for the chunk at <code>chunkIndex</code> with the bounding
+         * <code>heights</code>. <code>cameraPosition</code> is given relative to the
+         * center of <code>ellipsoid</code>.
+         */
+        static int desiredLevel(const Ellipsoid& ellipsoid, const ChunkIndex& chunkIndex,
+            const Chunk::BoundingHeights& heights, const Vec3& cameraPosition,
+            Scalar lodScaleFactor);
     };
 
     class EvaluateChunkLevelByAvailableTileData : public ChunkLevelEvaluator {
@@ -58,6 +88,54 @@ namespace openspace {
         virtual int getDesiredLevel(const Chunk& chunk, const RenderData& data) const;
     };
 
+    /**
+     * Splits a chunk only if the geometric error of its height tile, together with the
+     * error of approximating the curved surface with the chunk mesh, covers more pixels
+     * on the screen than the threshold of the owner. Flat regions are therefore refined
+     * less than rough terrain. Chunks without preprocessed height data fall back on the
+     * distance to the camera.
+     */
+    class EvaluateChunkLevelByScreenSpaceError : public ChunkLevelEvaluator {
+    public:
+        virtual int getDesiredLevel(const Chunk& chunk, const RenderData& data) const;
+
+        /**
+         * Returns the largest distance between a sphere with radius <code>radius</code>
+         * and a mesh that covers <code>angularSize</code> radians of it with
+         * <code>segments</code> segments.
+         */
+        static Scalar curvatureError(Scalar radius, Scalar angularSize, int segments);
+
+        /**
+         * Returns the number of pixels covered by <code>geometricError</code> seen at
+         * <code>distance</code>. <code>projectionScale</code> is the number of pixels
+         * covered by one unit at unit distance.
+         */
+        static Scalar screenSpaceError(Scalar geometricError, Scalar distance,
+            Scalar projectionScale);
+
+        /**
+         * Returns the desired level of a chunk at <code>level</code>. The chunk is split
+         * if its error is larger than <code>threshold</code> and merged if the error of
+         * its parent, which is estimated to be twice as large, is not.
+         */
+        static int desiredLevel(int level, Scalar screenSpaceError, Scalar threshold);
+
+        /**
+         * The level for the chunk at <code>chunkIndex</code> with the bounding
+         * <code>heights</code> and the geometric error <code>heightError</code> of its
+         * height tile, which must be known. <code>cameraPosition</code> is given
+         * relative to the center of <code>ellipsoid</code>.
+         */
+        static int desiredLevel(const Ellipsoid& ellipsoid, const ChunkIndex& chunkIndex,
+            const Chunk::BoundingHeights& heights, float heightError,
+            const Vec3& cameraPosition, int segmentsPerPatch, Scalar projectionScale,
+            Scalar threshold);
+
+    private:
+        EvaluateChunkLevelByDistance _distanceEvaluator;
+    };
+
 }
 
 
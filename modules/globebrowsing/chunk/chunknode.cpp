@@ -22,17 +22,7 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
-#include <queue>
-
-#include <ghoul/misc/assert.h>
-
-#include <openspace/engine/wrapper/windowwrapper.h>
-#include <openspace/engine/openspaceengine.h>
-
 #include <modules/globebrowsing/chunk/chunknode.h>
-#include <modules/globebrowsing/chunk/chunkedlodglobe.h>
-#include <modules/globebrowsing/chunk/culling.h>
-
 
 namespace {
     const std::string _loggerCat = "ChunkNode";
@@ -43,149 +33,71 @@ namespace openspace {
 int ChunkNode::chunkNodeCount = 0;
 int ChunkNode::renderedChunks = 0;
 
-ChunkNode::ChunkNode(const Chunk& chunk, ChunkNode* parent)
-: _chunk(chunk)
-, _parent(parent)
+ChunkNode::ChunkNode(const Chunk& chunk, int parent)
+    : _chunk(chunk)
+    , _key(chunk.index().mortonKey())
+    , _parent(parent)
+    , _firstChild(-1)
+    , _leafPosition(-1)
+    , _isUsed(true)
 {
-    _children[0] = nullptr;
-    _children[1] = nullptr;
-    _children[2] = nullptr;
-    _children[3] = nullptr;
     chunkNodeCount++;
 }
 
-ChunkNode::~ChunkNode() {
-    chunkNodeCount--;
-}
-
-bool ChunkNode::isRoot() const {
-    return _parent == nullptr;
-}
-
-bool ChunkNode::isLeaf() const {
-    return _children[0] == nullptr;
-}
-
-
-// Returns true or false wether this node can be merge or not
-bool ChunkNode::updateChunkTree(const RenderData& data) {
-    //Geodetic2 center = _chunk.surfacePatch.center();
-    //LDEBUG("x: " << patch.x << " y: " << patch.y << " level: " << patch.level << "  lat: " << center.lat << " lon: " << center.lon);
-
-    if (isLeaf()) {
-        Chunk::Status status = _chunk.update(data);
-        if (status == Chunk::Status::WANT_SPLIT) {
-            split();
-        }
-        return status == Chunk::Status::WANT_MERGE;
-    }
-    else {
-        char requestedMergeMask = 0;
-        for (int i = 0; i < 4; ++i) {
-            if (_children[i]->updateChunkTree(data)) {
-                requestedMergeMask |= (1 << i);
-            }
-        }
-
-        bool allChildrenWantsMerge = requestedMergeMask == 0xf;
-        bool thisChunkWantsSplit = _chunk.update(data) == Chunk::Status::WANT_SPLIT;
-
-        if (allChildrenWantsMerge && !thisChunkWantsSplit) {
-            merge();
-        }
-
-        return false;
+ChunkNode::ChunkNode(const ChunkNode& other)
+    : _chunk(other._chunk)
+    , _key(other._key)
+    , _parent(other._parent)
+    , _firstChild(other._firstChild)
+    , _leafPosition(other._leafPosition)
+    , _isUsed(other._isUsed)
+{
+    if (_isUsed) {
+        chunkNodeCount++;
     }
 }
 
-void ChunkNode::depthFirst(const std::function<void(const ChunkNode&)>& f) const {
-    f(*this);
-    if (!isLeaf()) {
-        for (int i = 0; i < 4; ++i) {
-            _children[i]->depthFirst(f);
-        }
+ChunkNode::~ChunkNode() {
+    if (_isUsed) {
+        chunkNodeCount--;
     }
 }
 
-
-
-void ChunkNode::renderReversedBreadthFirst(const RenderData& data) {
-    std::stack<ChunkNode*> S;
-    std::queue<ChunkNode*> Q;
-    Q.push(this);
-    while (Q.size() > 0) {
-        ChunkNode* node = Q.front(); 
-        Q.pop();
-        if (node->isLeaf()) {
-            if (node->_chunk.isVisible()) {
-                S.push(node);
-            }
-        }
-        else {
-            for (int i = 0; i < 4; ++i) {
-                Q.push(node->_children[i].get());
-            }
-        }
-    }
-
-    while (S.size() > 0) {
-        S.top()->renderThisChunk(data);
-        S.pop();
-    }
+ChunkNode& ChunkNode::operator=(const ChunkNode& other) {
+    setUsed(other._isUsed);
+    _chunk = other._chunk;
+    _key = other._key;
+    _parent = other._parent;
+    _firstChild = other._firstChild;
+    _leafPosition = other._leafPosition;
+    return *this;
 }
 
-void ChunkNode::renderThisChunk(const RenderData& data) {
-    _chunk.render(data);
-    ChunkNode::renderedChunks++;
+bool ChunkNode::isRoot() const {
+    return _parent == -1;
 }
 
-void ChunkNode::renderDepthFirst(const RenderData& data) {
-    if (isLeaf()) {
-        if (_chunk.isVisible()) {
-            renderThisChunk(data);
-        }
-    }
-    else {
-        for (int i = 0; i < 4; ++i) {
-            _children[i]->renderDepthFirst(data);
-        }
-    }
+bool ChunkNode::isLeaf() const {
+    return _firstChild == -1;
 }
 
-void ChunkNode::split(int depth) {
-    if (depth > 0 && isLeaf()) {
-        for (size_t i = 0; i < 4; i++) {
-            Chunk chunk(_chunk.owner(), _chunk.index().child((Quad)i), _chunk.owner()->initChunkVisible);
-            _children[i] = std::unique_ptr<ChunkNode>(new ChunkNode(chunk, this));
-        }
-    }
-
-    if (depth - 1 > 0) {
-        for (int i = 0; i < 4; ++i) {
-            _children[i]->split(depth - 1);
-        }
-    }
+const Chunk& ChunkNode::getChunk() const {
+    return _chunk;
 }
 
-void ChunkNode::merge() {
-    for (int i = 0; i < 4; ++i) {
-        if (_children[i] != nullptr) {
-            _children[i]->merge();
-        }
-        _children[i] = nullptr;
-    }
-    
-    ghoul_assert(isLeaf(), "ChunkNode must be leaf after merge");
+Chunk& ChunkNode::getChunk() {
+    return _chunk;
 }
 
-const ChunkNode& ChunkNode::getChild(Quad quad) const {
-    return *_children[quad];
+MortonKey ChunkNode::key() const {
+    return _key;
 }
 
-const Chunk& ChunkNode::getChunk() const {
-    return _chunk;
+void ChunkNode::setUsed(bool isUsed) {
+    if (isUsed != _isUsed) {
+        chunkNodeCount += isUsed ? 1 : -1;
+        _isUsed = isUsed;
+    }
 }
 
-
-
 } // namespace openspace
@@ -25,67 +25,54 @@
 #ifndef __QUADTREE_H__
 #define __QUADTREE_H__
 
-#include <glm/glm.hpp>
-#include <vector>
-#include <stack>
-#include <memory>
-#include <ostream>
-
 #include <modules/globebrowsing/chunk/chunkindex.h>
 #include <modules/globebrowsing/chunk/chunk.h>
-#include <modules/globebrowsing/chunk/chunkrenderer.h>
-
-#include <modules/globebrowsing/geometry/geodetic2.h>
-
-#include <functional>
-
-
-
-// forward declaration
-namespace openspace {
-    class ChunkedLodGlobe;
-}
-
 
 namespace openspace {
 
-
+/**
+ * A node of a ChunkTree. The nodes are stored in a pool owned by the tree and refer to
+ * their parent and children by their position in the pool. The four children of a node
+ * are stored next to each other.
+ */
 class ChunkNode {
 public:
-    ChunkNode(const Chunk& chunk, ChunkNode* parent = nullptr);
+    ChunkNode(const Chunk& chunk, int parent = -1);
+    ChunkNode(const ChunkNode& other);
     ~ChunkNode();
 
-
-    void split(int depth = 1);
-    void merge();
+    ChunkNode& operator=(const ChunkNode& other);
 
     bool isRoot() const;
     bool isLeaf() const;
 
-    void depthFirst(const std::function<void(const ChunkNode&)>& f) const;
-    
-    const ChunkNode& getChild(Quad quad) const;
     const Chunk& getChunk() const;
+    Chunk& getChunk();
 
-    void renderDepthFirst(const RenderData& data);
-    void renderReversedBreadthFirst(const RenderData& data);
-    void renderThisChunk(const RenderData& data);
-    bool updateChunkTree(const RenderData& data);
+    MortonKey key() const;
 
+    /// The number of nodes that are used by a tree
     static int chunkNodeCount;
     static int renderedChunks;
 
-
 private:
-    
-    ChunkNode* _parent;
-    std::unique_ptr<ChunkNode> _children[4];    
+    friend class ChunkTree;
+
+    /// Nodes that are not used stay in the pool but are not counted
+    void setUsed(bool isUsed);
 
     Chunk _chunk;
-};
+    MortonKey _key;
 
-} // namespace openspace
+    // Positions in the pool of the tree, -1 if there is none
+    int _parent;
+    int _firstChild;
 
+    // Position in the leaf list of the tree, -1 if the node is not a leaf
+    int _leafPosition;
+    bool _isUsed;
+};
 
+} // namespace openspace
 
 #endif // __QUADTREE_H__
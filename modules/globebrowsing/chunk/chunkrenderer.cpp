@@ -55,396 +55,316 @@ namespace {
 
 namespace openspace {
 
-
     ChunkRenderer::ChunkRenderer(
         std::shared_ptr<Grid> grid,
         std::shared_ptr<TileProviderManager> tileProviderManager)
         : _tileProviderManager(tileProviderManager)
         , _grid(grid)
+        , _globe(nullptr)
+        , _setBlendingUniforms(false)
     {
-        _globalRenderingShaderProvider = std::shared_ptr<LayeredTextureShaderProvider>
+        VariantProgram& global = _programs[static_cast<int>(ChunkDrawBatch::Variant::Global)];
+        global.shaderProvider = std::shared_ptr<LayeredTextureShaderProvider>
             (new LayeredTextureShaderProvider(
                 "GlobalChunkedLodPatch",
                 "${MODULE_GLOBEBROWSING}/shaders/globalchunkedlodpatch_vs.glsl",
                 "${MODULE_GLOBEBROWSING}/shaders/globalchunkedlodpatch_fs.glsl"));
 
-        _localRenderingShaderProvider = std::shared_ptr<LayeredTextureShaderProvider>
+        VariantProgram& local = _programs[static_cast<int>(ChunkDrawBatch::Variant::Local)];
+        local.shaderProvider = std::shared_ptr<LayeredTextureShaderProvider>
             (new LayeredTextureShaderProvider(
                 "LocalChunkedLodPatch",
                 "${MODULE_GLOBEBROWSING}/shaders/localchunkedlodpatch_vs.glsl",
                 "${MODULE_GLOBEBROWSING}/shaders/localchunkedlodpatch_fs.glsl"));
 
-        _globalProgramUniformHandler = std::shared_ptr<LayeredTextureShaderUniformIdHandler>
-            (new LayeredTextureShaderUniformIdHandler());
-
-        _localProgramUniformHandler = std::shared_ptr<LayeredTextureShaderUniformIdHandler>
-            (new LayeredTextureShaderUniformIdHandler());
-
-    }
-
-    void ChunkRenderer::renderChunk(const Chunk& chunk, const RenderData& data) {
-        if (chunk.index().level < 9) {
-            renderChunkGlobally(chunk, data);
-        }
-        else {
-            renderChunkLocally(chunk, data);
+        for (VariantProgram& program : _programs) {
+            program.uniformHandler = std::shared_ptr<LayeredTextureShaderUniformIdHandler>
+                (new LayeredTextureShaderUniformIdHandler());
+            program.programObject = nullptr;
         }
     }
 
-    void ChunkRenderer::update() {
-        // unued atm. Could be used for caching or precalculating
-    }
-
-
-    void ChunkRenderer::setDepthTransformUniforms(
-        std::shared_ptr<LayeredTextureShaderUniformIdHandler> uniformIdHandler,
-        LayeredTextures::TextureCategory textureCategory,
-        LayeredTextureShaderUniformIdHandler::BlendLayerSuffix blendLayerSuffix,
-        size_t layerIndex,
-        const TileDepthTransform& tileDepthTransform)
-    {   
-        uniformIdHandler->programObject().setUniform(
-            uniformIdHandler->getId(
-                textureCategory,
-                blendLayerSuffix,
-                layerIndex,
-                LayeredTextureShaderUniformIdHandler::GlslTileDataId::depthTransform_depthScale),
-            tileDepthTransform.depthScale);
-
-        uniformIdHandler->programObject().setUniform(
-            uniformIdHandler->getId(
-                textureCategory,
-                blendLayerSuffix,
-                layerIndex,
-                LayeredTextureShaderUniformIdHandler::GlslTileDataId::depthTransform_depthOffset),
-            tileDepthTransform.depthOffset);
-
-    }
-
-    void ChunkRenderer::activateTileAndSetTileUniforms(
-        std::shared_ptr<LayeredTextureShaderUniformIdHandler> uniformIdHandler,
-        LayeredTextures::TextureCategory textureCategory,
-        LayeredTextureShaderUniformIdHandler::BlendLayerSuffix blendLayerSuffix,
-        size_t layerIndex,
-        ghoul::opengl::TextureUnit& texUnit,
-        const TileAndTransform& tileAndTransform)
-    {
-
-        // Blend tile with two parents
-        // The texture needs a unit to sample from
-        texUnit.activate();
-        tileAndTransform.tile.texture->bind();
-
-        uniformIdHandler->programObject().setUniform(
-            uniformIdHandler->getId(
-                textureCategory,
-                blendLayerSuffix,
-                layerIndex,
-                LayeredTextureShaderUniformIdHandler::GlslTileDataId::textureSampler),
-            texUnit);
-        uniformIdHandler->programObject().setUniform(
-            uniformIdHandler->getId(
-                textureCategory,
-                blendLayerSuffix,
-                layerIndex,
-                LayeredTextureShaderUniformIdHandler::GlslTileDataId::uvTransform_uvScale),
-            tileAndTransform.uvTransform.uvScale);
-        uniformIdHandler->programObject().setUniform(
-            uniformIdHandler->getId(
-                textureCategory,
-                blendLayerSuffix,
-                layerIndex,
-                LayeredTextureShaderUniformIdHandler::GlslTileDataId::uvTransform_uvOffset),
-            tileAndTransform.uvTransform.uvOffset);
-    }
-
-
-    ProgramObject* ChunkRenderer::getActivatedProgramWithTileData(
-        LayeredTextureShaderProvider* layeredTextureShaderProvider,
-        std::shared_ptr<LayeredTextureShaderUniformIdHandler> programUniformHandler,
-        const Chunk& chunk)
-    {
-        const ChunkIndex& chunkIndex = chunk.index();
-
-        std::array<std::vector<std::shared_ptr<TileProvider> >,
-            LayeredTextures::NUM_TEXTURE_CATEGORIES> tileProviders;
-        LayeredTexturePreprocessingData layeredTexturePreprocessingData;
+    void ChunkRenderer::beginBatch(ChunkedLodGlobe& globe, const RenderData& data) {
+        _globe = &globe;
 
+        // The layers and the shader preprocessing data are the same for all chunks of
+        // the frame, so they are only gathered once
+        bool anyProviders = false;
+        _preprocessingData.keyValuePairs.clear();
+        _tileSlots.clear();
         for (size_t category = 0; category < LayeredTextures::NUM_TEXTURE_CATEGORIES; category++)
         {
-            tileProviders[category] = _tileProviderManager->getActivatedLayerCategory(
+            _tileProviders[category] = _tileProviderManager->getActivatedLayerCategory(
                 LayeredTextures::TextureCategory(category));
+            anyProviders |= !_tileProviders[category].empty();
 
             LayeredTextureInfo layeredTextureInfo;
-            layeredTextureInfo.lastLayerIdx = tileProviders[category].size() - 1;
-            layeredTextureInfo.layerBlendingEnabled = chunk.owner()->blendProperties[category];
-
-            layeredTexturePreprocessingData.layeredTextureInfo[category] = layeredTextureInfo;
+            layeredTextureInfo.lastLayerIdx = _tileProviders[category].size() - 1;
+            layeredTextureInfo.layerBlendingEnabled = globe.blendProperties[category];
+            _preprocessingData.layeredTextureInfo[category] = layeredTextureInfo;
+
+            // If blending is enabled, two more textures are needed per layer
+            for (size_t i = 0; i < _tileProviders[category].size(); i++) {
+                LayeredTextures::TextureCategory c = LayeredTextures::TextureCategory(category);
+                _tileSlots.push_back(
+                    { c, i, LayeredTextureShaderUniformIdHandler::BlendLayerSuffix::none });
+                if (layeredTextureInfo.layerBlendingEnabled) {
+                    _tileSlots.push_back(
+                        { c, i, LayeredTextureShaderUniformIdHandler::BlendLayerSuffix::Parent1 });
+                    _tileSlots.push_back(
+                        { c, i, LayeredTextureShaderUniformIdHandler::BlendLayerSuffix::Parent2 });
+                }
+            }
         }
 
-        layeredTexturePreprocessingData.keyValuePairs.push_back(
+        _preprocessingData.keyValuePairs.push_back(
             std::pair<std::string, std::string>(
                 "useAtmosphere",
-                std::to_string(chunk.owner()->atmosphereEnabled)));
+                std::to_string(globe.atmosphereEnabled)));
 
-        layeredTexturePreprocessingData.keyValuePairs.push_back(
+        _preprocessingData.keyValuePairs.push_back(
             std::pair<std::string, std::string>(
                 "showChunkEdges",
-                std::to_string(chunk.owner()->showChunkEdges)));
-
-
-        // Now the shader program can be accessed
-        ProgramObject* programObject =
-            layeredTextureShaderProvider->getUpdatedShaderProgram(
-                layeredTexturePreprocessingData);
-
-        programUniformHandler->updateIdsIfNecessary(layeredTextureShaderProvider);
+                std::to_string(globe.showChunkEdges)));
 
-        // Activate the shader program
-        programObject->activate();
-
-        // Initialize all texture units
-        struct BlendTexUnits {
-            ghoul::opengl::TextureUnit blendTexture0;
-            ghoul::opengl::TextureUnit blendTexture1;
-            ghoul::opengl::TextureUnit blendTexture2;
-        };
-        std::array<std::vector<BlendTexUnits>,
-            LayeredTextures::NUM_TEXTURE_CATEGORIES> texUnits;
+        // This information is only needed when doing blending
+        bool blendAny = false;
         for (size_t category = 0; category < LayeredTextures::NUM_TEXTURE_CATEGORIES; category++) {
-            texUnits[category].resize(tileProviders[category].size());
+            blendAny |= globe.blendProperties[category];
         }
+        _setBlendingUniforms = blendAny && anyProviders;
 
-        // Go through all the categories
-        for (size_t category = 0; category < LayeredTextures::NUM_TEXTURE_CATEGORIES; category++)
-        {
-            // Go through all the providers in this category
-            int i = 0;
-            for (auto it = tileProviders[category].begin(); it != tileProviders[category].end(); it++)
-            {
-                auto tileProvider = it->get();
-
-                // Get the texture that should be used for rendering
-                TileAndTransform tileAndTransform = TileSelector::getHighestResolutionTile(tileProvider, chunkIndex);
-                if (tileAndTransform.tile.status == Tile::Status::Unavailable) {
-                    // don't render if no tile was available
-                    programObject->deactivate();
-                    return nullptr;
-                }
-
-                activateTileAndSetTileUniforms(
-                    programUniformHandler,
-                    LayeredTextures::TextureCategory(category),
-                    LayeredTextureShaderUniformIdHandler::BlendLayerSuffix::none,
-                    i,
-                    texUnits[category][i].blendTexture0,
-                    tileAndTransform);
-
-                // If blending is enabled, two more textures are needed
-                if (layeredTexturePreprocessingData.layeredTextureInfo[category].layerBlendingEnabled) {
-                    TileAndTransform tileAndTransformParent1 = TileSelector::getHighestResolutionTile(tileProvider, chunkIndex, 1);
-                    if (tileAndTransformParent1.tile.status == Tile::Status::Unavailable) {
-                        tileAndTransformParent1 = tileAndTransform;
-                    }
-                    activateTileAndSetTileUniforms(
-                        programUniformHandler,
-                        LayeredTextures::TextureCategory(category),
-                        LayeredTextureShaderUniformIdHandler::BlendLayerSuffix::Parent1,
-                        i,
-                        texUnits[category][i].blendTexture1,
-                        tileAndTransformParent1);
-
-                    TileAndTransform tileAndTransformParent2 = TileSelector::getHighestResolutionTile(tileProvider, chunkIndex, 2);
-                    if (tileAndTransformParent2.tile.status == Tile::Status::Unavailable) {
-                        tileAndTransformParent2 = tileAndTransformParent1;
-                    }
-                    activateTileAndSetTileUniforms(
-                        programUniformHandler,
-                        LayeredTextures::TextureCategory(category),
-                        LayeredTextureShaderUniformIdHandler::BlendLayerSuffix::Parent2,
-                        i,
-                        texUnits[category][i].blendTexture2,
-                        tileAndTransformParent2);
-                }
-                i++;
-            }
-        }
-
-        // Go through all the height maps and set depth tranforms
-        int i = 0;
-        for (auto it = tileProviders[LayeredTextures::HeightMaps].begin();
-            it != tileProviders[LayeredTextures::HeightMaps].end(); it++) {
-            auto tileProvider = *it;
-
-            TileDepthTransform depthTransform = tileProvider->depthTransform();
-            setDepthTransformUniforms(
-                programUniformHandler,
-                LayeredTextures::TextureCategory::HeightMaps,
-                LayeredTextureShaderUniformIdHandler::BlendLayerSuffix::none,
-                i,
-                depthTransform);
-            i++;
-        }
-
-        // The length of the skirts is proportional to its size
-        programObject->setUniform("skirtLength", min(static_cast<float>(chunk.surfacePatch().halfSize().lat * 1000000), 8700.0f));
-        programObject->setUniform("xSegments", _grid->xSegments());
-
-        return programObject;
+        // TODO : Model transform should be fetched as a matrix directly.
+        dmat4 modelTransform = translate(dmat4(1), data.position.dvec3());
+        dmat4 viewTransform = data.camera.combinedViewMatrix();
+        _drawBatch.clear(viewTransform * modelTransform, _tileSlots.size());
     }
 
-    void ChunkRenderer::renderChunkGlobally(const Chunk& chunk, const RenderData& data){
-
-        ProgramObject* programObject = getActivatedProgramWithTileData(
-            _globalRenderingShaderProvider.get(),
-            _globalProgramUniformHandler,
-            chunk);
-        if (programObject == nullptr) {
+    void ChunkRenderer::renderChunk(const Chunk& chunk, const RenderData& data) {
+        if (!gatherTiles(chunk.index())) {
+            // don't render if no tile was available
             return;
         }
 
-        auto heightMapProviders = _tileProviderManager->getActivatedLayerCategory(LayeredTextures::HeightMaps);
-        auto colorTextureProviders = _tileProviderManager->getActivatedLayerCategory(LayeredTextures::ColorTextures);
-        auto nightTextureProviders = _tileProviderManager->getActivatedLayerCategory(LayeredTextures::NightTextures);
-        auto overlayProviders = _tileProviderManager->getActivatedLayerCategory(LayeredTextures::Overlays);
-        auto waterMaskProviders = _tileProviderManager->getActivatedLayerCategory(LayeredTextures::WaterMasks);
-        const Ellipsoid& ellipsoid = chunk.owner()->ellipsoid();
-
-        // This information is only needed when doing blending
-        bool blendAny = false;
-        for (size_t category = 0; category < LayeredTextures::NUM_TEXTURE_CATEGORIES; category++) {
-            blendAny |= chunk.owner()->blendProperties[category];
-        }
-        if (blendAny &&
-            ((heightMapProviders.size() > 0 ) ||
-            (colorTextureProviders.size() > 0 ) ||
-            (nightTextureProviders.size() > 0 ) ||
-            (overlayProviders.size() > 0 ) ||
-            (waterMaskProviders.size() > 0))) {
-            float distanceScaleFactor = chunk.owner()->lodScaleFactor * ellipsoid.minimumRadius();
-            programObject->setUniform("cameraPosition", vec3(data.camera.positionVec3()));
-            programObject->setUniform("distanceScaleFactor", distanceScaleFactor);
-            programObject->setUniform("chunkLevel", chunk.index().level);
+        _drawBatch.addChunk(chunk.surfacePatch(), chunk.index().level, _globe->ellipsoid());
+        for (const TileAndTransform& tileAndTransform : _chunkTiles) {
+            _drawBatch.addTile(
+                tileAndTransform.tile.texture.get(),
+                tileAndTransform.uvTransform.uvOffset,
+                tileAndTransform.uvTransform.uvScale);
         }
-        
-        // Calculate other uniform variables needed for rendering
-        Geodetic2 swCorner = chunk.surfacePatch().getCorner(Quad::SOUTH_WEST);
-        auto patchSize = chunk.surfacePatch().size();
-        
-        // TODO : Model transform should be fetched as a matrix directly.
-        dmat4 modelTransform = dmat4(chunk.owner()->stateMatrix()); // Rotation
-        modelTransform = translate(dmat4(1), data.position.dvec3()) * modelTransform; // Translation
-        dmat4 viewTransform = data.camera.combinedViewMatrix();
-        mat4 modelViewTransform = mat4(viewTransform * modelTransform);
-        mat4 modelViewProjectionTransform = data.camera.projectionMatrix() * modelViewTransform;
-
-        // Upload the uniform variables
-        programObject->setUniform("modelViewProjectionTransform", modelViewProjectionTransform);
-        programObject->setUniform("minLatLon", vec2(swCorner.toLonLatVec2()));
-        programObject->setUniform("lonLatScalingFactor", vec2(patchSize.toLonLatVec2()));
-        programObject->setUniform("radiiSquared", vec3(ellipsoid.radiiSquared()));
+    }
 
-        if (nightTextureProviders.size() > 0) {
-            programObject->setUniform("modelViewTransform", modelViewTransform);
+    void ChunkRenderer::endBatch(const RenderData& data) {
+        if (_drawBatch.size() == 0) {
+            return;
         }
 
-        
         // OpenGL rendering settings
         glEnable(GL_DEPTH_TEST);
         glEnable(GL_CULL_FACE);
         glCullFace(GL_BACK);
 
-        // render
-        _grid->geometry().drawUsingActiveProgram();
+        // The locally rendered chunks are the ones closest to the camera, drawing them
+        // first keeps the chunks roughly in front to back order
+        for (ChunkDrawBatch::Variant variant :
+            { ChunkDrawBatch::Variant::Local, ChunkDrawBatch::Variant::Global })
+        {
+            if (_drawBatch.chunksOfVariant(variant).empty()) {
+                continue;
+            }
+            VariantProgram& program = _programs[static_cast<int>(variant)];
+            activateProgram(program);
+            setPerFrameUniforms(variant, program, data);
+            drawChunks(variant, program);
 
-        // disable shader
-        programObject->deactivate();
+            // disable shader
+            program.programObject->deactivate();
+        }
     }
 
+    void ChunkRenderer::update() {
+        // unued atm. Could be used for caching or precalculating
+    }
 
+    const ChunkDrawBatch& ChunkRenderer::getDrawBatch() const {
+        return _drawBatch;
+    }
 
-    void ChunkRenderer::renderChunkLocally(const Chunk& chunk, const RenderData& data) {
-        
-        ProgramObject* programObject = getActivatedProgramWithTileData(
-            _localRenderingShaderProvider.get(),
-            _localProgramUniformHandler,
-            chunk);
-        if (programObject == nullptr) {
-            return;
+    bool ChunkRenderer::gatherTiles(const ChunkIndex& chunkIndex) {
+        _chunkTiles.clear();
+        for (const TileSlot& slot : _tileSlots) {
+            TileProvider* tileProvider = _tileProviders[slot.category][slot.layerIndex].get();
+
+            // The blend layer suffix is the number of parents to ascend. Unavailable parent
+            // tiles fall back to the tile of the previous slot, which is the tile of the
+            // same layer one level further down
+            TileAndTransform tileAndTransform = TileSelector::getHighestResolutionTile(
+                tileProvider, chunkIndex, static_cast<int>(slot.blendLayerSuffix));
+            if (tileAndTransform.tile.status == Tile::Status::Unavailable) {
+                if (slot.blendLayerSuffix ==
+                    LayeredTextureShaderUniformIdHandler::BlendLayerSuffix::none)
+                {
+                    return false;
+                }
+                tileAndTransform = _chunkTiles.back();
+            }
+            _chunkTiles.push_back(tileAndTransform);
         }
+        return true;
+    }
 
-        using namespace glm;
-
-        auto heightMapProviders = _tileProviderManager->getActivatedLayerCategory(LayeredTextures::HeightMaps);
-        auto colorTextureProviders = _tileProviderManager->getActivatedLayerCategory(LayeredTextures::ColorTextures);
-        auto nightTextureProviders = _tileProviderManager->getActivatedLayerCategory(LayeredTextures::NightTextures);
-        auto overlayProviders = _tileProviderManager->getActivatedLayerCategory(LayeredTextures::Overlays);
-        auto waterMaskProviders = _tileProviderManager->getActivatedLayerCategory(LayeredTextures::WaterMasks);
-        const Ellipsoid& ellipsoid = chunk.owner()->ellipsoid();
-
-        // This information is only needed when doing blending
-        bool blendAny = false;
-        for (size_t category = 0; category < LayeredTextures::NUM_TEXTURE_CATEGORIES; category++) {
-            blendAny |= chunk.owner()->blendProperties[category];
-        }
-        if (blendAny &&
-            ((heightMapProviders.size() > 0) ||
-                (colorTextureProviders.size() > 0) ||
-                (nightTextureProviders.size() > 0) ||
-                (overlayProviders.size() > 0) ||
-                (waterMaskProviders.size() > 0))) {
-            float distanceScaleFactor = chunk.owner()->lodScaleFactor * chunk.owner()->ellipsoid().minimumRadius();
-            programObject->setUniform("distanceScaleFactor", distanceScaleFactor);
-            programObject->setUniform("chunkLevel", chunk.index().level);
+    void ChunkRenderer::activateProgram(VariantProgram& program) {
+        program.programObject =
+            program.shaderProvider->getUpdatedShaderProgram(_preprocessingData);
+        program.uniformHandler->updateIdsIfNecessary(program.shaderProvider.get());
+
+        if (program.shaderProvider->updatedOnLastCall()) {
+            // Each variant only uses some of the uniforms, the others get location -1
+            // and are ignored when set
+            ProgramObject& programObject = *program.programObject;
+            programObject.setIgnoreUniformLocationError(ProgramObject::IgnoreError::Yes);
+            ChunkUniformLocations& locations = program.locations;
+            locations.skirtLength = programObject.uniformLocation("skirtLength");
+            locations.chunkLevel = programObject.uniformLocation("chunkLevel");
+            locations.minLatLon = programObject.uniformLocation("minLatLon");
+            locations.lonLatScalingFactor =
+                programObject.uniformLocation("lonLatScalingFactor");
+            locations.corners = {
+                programObject.uniformLocation("p00"),
+                programObject.uniformLocation("p10"),
+                programObject.uniformLocation("p01"),
+                programObject.uniformLocation("p11")
+            };
+            locations.patchNormalCameraSpace =
+                programObject.uniformLocation("patchNormalCameraSpace");
+            programObject.setIgnoreUniformLocationError(ProgramObject::IgnoreError::No);
         }
 
-        // Calculate other uniform variables needed for rendering
-
-        // TODO : Model transform should be fetched as a matrix directly.
-        dmat4 modelTransform = translate(dmat4(1), data.position.dvec3());
-        dmat4 viewTransform = data.camera.combinedViewMatrix();
-        dmat4 modelViewTransform = viewTransform * modelTransform;
+        // Activate the shader program
+        program.programObject->activate();
+    }
 
-        Geodetic2 sw = chunk.surfacePatch().getCorner(Quad::SOUTH_WEST);
-        Geodetic2 se = chunk.surfacePatch().getCorner(Quad::SOUTH_EAST);
-        Geodetic2 nw = chunk.surfacePatch().getCorner(Quad::NORTH_WEST);
-        Geodetic2 ne = chunk.surfacePatch().getCorner(Quad::NORTH_EAST);
+    void ChunkRenderer::setPerFrameUniforms(ChunkDrawBatch::Variant variant,
+        VariantProgram& program, const RenderData& data)
+    {
+        ProgramObject* programObject = program.programObject;
+        const Ellipsoid& ellipsoid = _globe->ellipsoid();
 
-        // Get model space positions of the four control points
-        Vec3 patchSwModelSpace = ellipsoid.cartesianSurfacePosition(sw);
-        Vec3 patchSeModelSpace = ellipsoid.cartesianSurfacePosition(se);
-        Vec3 patchNwModelSpace = ellipsoid.cartesianSurfacePosition(nw);
-        Vec3 patchNeModelSpace = ellipsoid.cartesianSurfacePosition(ne);
+        if (_setBlendingUniforms) {
+            float distanceScaleFactor = _globe->lodScaleFactor * ellipsoid.minimumRadius();
+            programObject->setUniform("distanceScaleFactor", distanceScaleFactor);
+            if (variant == ChunkDrawBatch::Variant::Global) {
+                programObject->setUniform("cameraPosition", vec3(data.camera.positionVec3()));
+            }
+        }
 
-        // Transform all control points to camera space
-        Vec3 patchSwCameraSpace = Vec3(dmat4(modelViewTransform) * glm::dvec4(patchSwModelSpace, 1));
-        Vec3 patchSeCameraSpace = Vec3(dmat4(modelViewTransform) * glm::dvec4(patchSeModelSpace, 1));
-        Vec3 patchNwCameraSpace = Vec3(dmat4(modelViewTransform) * glm::dvec4(patchNwModelSpace, 1));
-        Vec3 patchNeCameraSpace = Vec3(dmat4(modelViewTransform) * glm::dvec4(patchNeModelSpace, 1));
+        if (variant == ChunkDrawBatch::Variant::Global) {
+            // TODO : Model transform should be fetched as a matrix directly.
+            dmat4 modelTransform = dmat4(_globe->stateMatrix()); // Rotation
+            modelTransform = translate(dmat4(1), data.position.dvec3()) * modelTransform; // Translation
+            dmat4 viewTransform = data.camera.combinedViewMatrix();
+            mat4 modelViewTransform = mat4(viewTransform * modelTransform);
+            mat4 modelViewProjectionTransform = data.camera.projectionMatrix() * modelViewTransform;
+
+            programObject->setUniform("modelViewProjectionTransform", modelViewProjectionTransform);
+            programObject->setUniform("radiiSquared", vec3(ellipsoid.radiiSquared()));
+            if (!_tileProviders[LayeredTextures::NightTextures].empty()) {
+                programObject->setUniform("modelViewTransform", modelViewTransform);
+            }
+        }
+        else {
+            programObject->setUniform("projectionTransform", data.camera.projectionMatrix());
+        }
 
-        // Send control points to shader
-        programObject->setUniform("p00", vec3(patchSwCameraSpace));
-        programObject->setUniform("p10", vec3(patchSeCameraSpace));
-        programObject->setUniform("p01", vec3(patchNwCameraSpace));
-        programObject->setUniform("p11", vec3(patchNeCameraSpace));
+        // Go through all the height maps and set depth tranforms
+        const auto& heightMapProviders = _tileProviders[LayeredTextures::HeightMaps];
+        for (size_t i = 0; i < heightMapProviders.size(); i++) {
+            TileDepthTransform depthTransform = heightMapProviders[i]->depthTransform();
+            programObject->setUniform(
+                program.uniformHandler->getId(
+                    LayeredTextures::HeightMaps,
+                    LayeredTextureShaderUniformIdHandler::BlendLayerSuffix::none,
+                    i,
+                    LayeredTextureShaderUniformIdHandler::GlslTileDataId::depthTransform_depthScale),
+                depthTransform.depthScale);
+            programObject->setUniform(
+                program.uniformHandler->getId(
+                    LayeredTextures::HeightMaps,
+                    LayeredTextureShaderUniformIdHandler::BlendLayerSuffix::none,
+                    i,
+                    LayeredTextureShaderUniformIdHandler::GlslTileDataId::depthTransform_depthOffset),
+                depthTransform.depthOffset);
+        }
 
-        vec3 patchNormalCameraSpace = normalize(
-            cross(patchSeCameraSpace - patchSwCameraSpace,
-                patchNwCameraSpace - patchSwCameraSpace));
+        programObject->setUniform("xSegments", _grid->xSegments());
+    }
 
-        programObject->setUniform("patchNormalCameraSpace", patchNormalCameraSpace);
-        programObject->setUniform("projectionTransform", data.camera.projectionMatrix());
+    void ChunkRenderer::drawChunks(ChunkDrawBatch::Variant variant,
+        VariantProgram& program)
+    {
+        using GlslTileDataId = LayeredTextureShaderUniformIdHandler::GlslTileDataId;
+
+        ProgramObject* programObject = program.programObject;
+        const ChunkUniformLocations& locations = program.locations;
+        LayeredTextureShaderUniformIdHandler& uniformHandler = *program.uniformHandler;
+
+        // Every tile slot keeps its texture unit for the whole batch, so the samplers
+        // are only set once and textures are only rebound when they change
+        const size_t nTileSlots = _tileSlots.size();
+        std::vector<ghoul::opengl::TextureUnit> texUnits(nTileSlots);
+        std::vector<ghoul::opengl::Texture*> boundTextures(nTileSlots, nullptr);
+        std::vector<std::array<GLint, 2>> uvTransformIds(nTileSlots);
+        for (size_t s = 0; s < nTileSlots; s++) {
+            const TileSlot& slot = _tileSlots[s];
+            programObject->setUniform(
+                uniformHandler.getId(slot.category, slot.blendLayerSuffix, slot.layerIndex,
+                    GlslTileDataId::textureSampler),
+                texUnits[s]);
+            uvTransformIds[s] = {
+                uniformHandler.getId(slot.category, slot.blendLayerSuffix, slot.layerIndex,
+                    GlslTileDataId::uvTransform_uvOffset),
+                uniformHandler.getId(slot.category, slot.blendLayerSuffix, slot.layerIndex,
+                    GlslTileDataId::uvTransform_uvScale)
+            };
+        }
 
+        TriangleSoup& geometry = _grid->geometry();
+        geometry.bindVertexArray();
+        for (size_t i : _drawBatch.chunksOfVariant(variant)) {
+            const ChunkDrawBatch::ChunkData& chunk = _drawBatch.chunk(i);
+
+            for (size_t s = 0; s < nTileSlots; s++) {
+                const ChunkDrawBatch::TileData& tile = _drawBatch.tile(i, s);
+                if (boundTextures[s] != tile.texture) {
+                    texUnits[s].activate();
+                    tile.texture->bind();
+                    boundTextures[s] = tile.texture;
+                }
+                programObject->setUniform(uvTransformIds[s][0], tile.uvOffset);
+                programObject->setUniform(uvTransformIds[s][1], tile.uvScale);
+            }
 
-        // OpenGL rendering settings
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_BACK);
+            programObject->setUniform(locations.skirtLength, chunk.skirtLength);
+            if (_setBlendingUniforms) {
+                programObject->setUniform(locations.chunkLevel, chunk.level);
+            }
 
-        // render
-        _grid->geometry().drawUsingActiveProgram();
+            if (variant == ChunkDrawBatch::Variant::Global) {
+                programObject->setUniform(locations.minLatLon, chunk.minLatLon);
+                programObject->setUniform(locations.lonLatScalingFactor,
+                    chunk.lonLatScalingFactor);
+            }
+            else {
+                for (int c = 0; c < 4; c++) {
+                    programObject->setUniform(locations.corners[c], chunk.corners[c]);
+                }
+                programObject->setUniform(locations.patchNormalCameraSpace,
+                    chunk.patchNormal);
+            }
 
-        // disable shader
-        programObject->deactivate();
+            geometry.drawBoundElements();
+        }
+        geometry.unbindVertexArray();
     }
 }  // namespace openspace
@@ -25,7 +25,9 @@
 #ifndef __CHUNK_RENDERER_H__
 #define __CHUNK_RENDERER_H__
 
+#include <array>
 #include <memory>
+#include <vector>
 #include <glm/glm.hpp>
 
 // open space includes
@@ -41,6 +43,7 @@
 #include <modules/globebrowsing/tile/tileselector.h>
 
 #include <modules/globebrowsing/chunk/chunknode.h>
+#include <modules/globebrowsing/chunk/chunkdrawbatch.h>
 
 
 
@@ -51,39 +54,69 @@ namespace opengl {
 }
 
 namespace openspace {
-    
+
+    class ChunkedLodGlobe;
+
+    /**
+     * Renders the chunks of a globe. The chunks of a frame are gathered between
+     * #beginBatch and #endBatch: the activated layers, the shader programs and the per
+     * frame uniforms are set up once, the data of each chunk is packed into a
+     * ChunkDrawBatch and the chunks are then drawn one shader variant at a time with
+     * uniform locations that are resolved when the programs are recompiled.
+     */
     class ChunkRenderer {
     public:
         ChunkRenderer(std::shared_ptr<Grid> grid,
             std::shared_ptr<TileProviderManager> tileProviderManager);
 
+        /// Starts gathering the chunks of a frame
+        void beginBatch(ChunkedLodGlobe& globe, const RenderData& data);
+
+        /**
+         * Adds a chunk to the current batch. Chunks for which not all layers have a
+         * tile available are skipped.
+         */
         void renderChunk(const Chunk& chunk, const RenderData& data);
+
+        /// Draws all chunks that have been added since #beginBatch
+        void endBatch(const RenderData& data);
+
         void update();
 
+        const ChunkDrawBatch& getDrawBatch() const;
+
     private:
 
-        void renderChunkGlobally(const Chunk& chunk, const RenderData& data);
-        void renderChunkLocally(const Chunk& chunk, const RenderData& data);
-
-        void setDepthTransformUniforms(
-            std::shared_ptr<LayeredTextureShaderUniformIdHandler> uniformIdHandler,
-            LayeredTextures::TextureCategory textureCategory,
-            LayeredTextureShaderUniformIdHandler::BlendLayerSuffix blendLayerSuffix,
-            size_t layerIndex,
-            const TileDepthTransform& tileDepthTransform);
-
-        void activateTileAndSetTileUniforms(
-            std::shared_ptr<LayeredTextureShaderUniformIdHandler> uniformIdHandler,
-            LayeredTextures::TextureCategory textureCategory,
-            LayeredTextureShaderUniformIdHandler::BlendLayerSuffix blendLayerSuffix,
-            size_t layerIndex,
-            ghoul::opengl::TextureUnit& texUnit,
-            const TileAndTransform& tileAndTransform);
-
-        ProgramObject* getActivatedProgramWithTileData(
-            LayeredTextureShaderProvider* layeredTextureShaderProvider,
-            std::shared_ptr<LayeredTextureShaderUniformIdHandler> programUniformHandler,
-            const Chunk& chunk);
+        // Locations of the uniforms that are set for every chunk
+        struct ChunkUniformLocations {
+            GLint skirtLength;
+            GLint chunkLevel;
+            GLint minLatLon;
+            GLint lonLatScalingFactor;
+            std::array<GLint, 4> corners;
+            GLint patchNormalCameraSpace;
+        };
+
+        struct VariantProgram {
+            std::shared_ptr<LayeredTextureShaderProvider> shaderProvider;
+            std::shared_ptr<LayeredTextureShaderUniformIdHandler> uniformHandler;
+            ProgramObject* programObject;
+            ChunkUniformLocations locations;
+        };
+
+        // The layer, category and blend layer of each tile slot of a chunk
+        struct TileSlot {
+            LayeredTextures::TextureCategory category;
+            size_t layerIndex;
+            LayeredTextureShaderUniformIdHandler::BlendLayerSuffix blendLayerSuffix;
+        };
+
+        bool gatherTiles(const ChunkIndex& chunkIndex);
+
+        void activateProgram(VariantProgram& program);
+        void setPerFrameUniforms(ChunkDrawBatch::Variant variant, VariantProgram& program,
+            const RenderData& data);
+        void drawChunks(ChunkDrawBatch::Variant variant, VariantProgram& program);
 
         //////////////////////////////////////////////////////////////////////////////////
         //                              Member variables                                //
@@ -92,12 +125,19 @@ namespace openspace {
         std::shared_ptr<Grid> _grid;
         std::shared_ptr<TileProviderManager> _tileProviderManager;
 
-        std::shared_ptr<LayeredTextureShaderProvider> _globalRenderingShaderProvider;
-        std::shared_ptr<LayeredTextureShaderProvider> _localRenderingShaderProvider;
+        std::array<VariantProgram, 2> _programs;
 
-        std::shared_ptr<LayeredTextureShaderUniformIdHandler> _globalProgramUniformHandler;
-        std::shared_ptr<LayeredTextureShaderUniformIdHandler> _localProgramUniformHandler;
+        // State of the current batch
+        ChunkedLodGlobe* _globe;
+        std::array<std::vector<std::shared_ptr<TileProvider>>,
+            LayeredTextures::NUM_TEXTURE_CATEGORIES> _tileProviders;
+        LayeredTexturePreprocessingData _preprocessingData;
+        std::vector<TileSlot> _tileSlots;
+        bool _setBlendingUniforms;
 
+        ChunkDrawBatch _drawBatch;
+        // Reused for every chunk to look up its tiles before it is added to the batch
+        std::vector<TileAndTransform> _chunkTiles;
     };
 
 }  // namespace openspace
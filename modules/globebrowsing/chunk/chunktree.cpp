@@ -0,0 +1,239 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/chunk/chunktree.h>
+#include <modules/globebrowsing/chunk/chunkedlodglobe.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+
+namespace {
+    const std::string _loggerCat = "ChunkTree";
+
+    const int MaximumLevel = 30;
+
+    // Enough for the trees of most views, so that splitting rarely grows the pool or
+    // the key map
+    const size_t InitialNodeCapacity = 4096;
+}
+
+namespace openspace {
+
+ChunkTree::ChunkTree(ChunkedLodGlobe* owner)
+    : _owner(owner)
+    , _nodesByKey(InitialNodeCapacity)
+{
+    _nodes.reserve(InitialNodeCapacity);
+    // The two roots are the only nodes that are not part of a block
+    _nodes.push_back(ChunkNode(Chunk(owner, ChunkIndex(0, 0, 1))));
+    _nodes.push_back(ChunkNode(Chunk(owner, ChunkIndex(1, 0, 1))));
+    for (int root = 0; root < 2; ++root) {
+        _nodesByKey.insert(_nodes[root]._key, root);
+        addLeaf(root);
+    }
+}
+
+void ChunkTree::update(const RenderData& data) {
+    updateNode(0, data);
+    updateNode(1, data);
+}
+
+bool ChunkTree::updateNode(int node, const RenderData& data) {
+    // Splitting may grow the pool, so nodes are only referred to by their position
+    if (_nodes[node].isLeaf()) {
+        Chunk::Status status = _nodes[node]._chunk.update(data);
+        if (status == Chunk::Status::WANT_SPLIT) {
+            split(node, _owner->initChunkVisible);
+        }
+        return status == Chunk::Status::WANT_MERGE;
+    }
+
+    char requestedMergeMask = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (updateNode(_nodes[node]._firstChild + i, data)) {
+            requestedMergeMask |= (1 << i);
+        }
+    }
+
+    bool allChildrenWantsMerge = requestedMergeMask == 0xf;
+    bool thisChunkWantsSplit =
+        _nodes[node]._chunk.update(data) == Chunk::Status::WANT_SPLIT;
+
+    if (allChildrenWantsMerge && !thisChunkWantsSplit) {
+        merge(node);
+    }
+    return false;
+}
+
+void ChunkTree::render(const RenderData& data, bool renderSmallChunksFirst) {
+    _renderList.clear();
+    for (int leaf : _leaves) {
+        if (_nodes[leaf]._chunk.isVisible()) {
+            _renderList.push_back(leaf);
+        }
+    }
+
+    if (renderSmallChunksFirst) {
+        std::sort(_renderList.begin(), _renderList.end(), [this](int a, int b) {
+            return _nodes[a]._key > _nodes[b]._key;
+        });
+    }
+    else {
+        // Keys extended to the same depth are ordered as a depth first traversal
+        std::sort(_renderList.begin(), _renderList.end(), [this](int a, int b) {
+            int levelA = _nodes[a]._chunk.index().level;
+            int levelB = _nodes[b]._chunk.index().level;
+            return (_nodes[a]._key << (2 * (MaximumLevel - levelA))) <
+                (_nodes[b]._key << (2 * (MaximumLevel - levelB)));
+        });
+    }
+
+    for (int node : _renderList) {
+        _nodes[node]._chunk.render(data);
+        ChunkNode::renderedChunks++;
+    }
+}
+
+void ChunkTree::split(int node, bool initChunksVisible) {
+    ghoul_assert(_nodes[node].isLeaf(), "Only leaves can be split");
+
+    int block = allocateBlock();
+    ChunkIndex chunkIndex = _nodes[node]._chunk.index();
+    for (int i = 0; i < 4; ++i) {
+        ChunkNode& child = _nodes[block + i];
+        child = ChunkNode(
+            Chunk(_owner, chunkIndex.child(static_cast<Quad>(i)), initChunksVisible),
+            node);
+        _nodesByKey.insert(child._key, block + i);
+        addLeaf(block + i);
+    }
+
+    removeLeaf(node);
+    _nodes[node]._firstChild = block;
+}
+
+void ChunkTree::merge(int node) {
+    int block = _nodes[node]._firstChild;
+    if (block == -1) {
+        return;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        ChunkNode& child = _nodes[block + i];
+        merge(block + i);
+        removeLeaf(block + i);
+        _nodesByKey.erase(child._key);
+        child.setUsed(false);
+    }
+    _freeBlocks.push_back(block);
+
+    _nodes[node]._firstChild = -1;
+    addLeaf(node);
+}
+
+int ChunkTree::findNode(const ChunkIndex& chunkIndex) const {
+    return _nodesByKey.find(chunkIndex.mortonKey());
+}
+
+int ChunkTree::getParent(int node) const {
+    return _nodes[node]._parent;
+}
+
+int ChunkTree::getNeighbor(int node, CardinalDirection direction) const {
+    ChunkIndex chunkIndex = _nodes[node]._chunk.index();
+    int numX = 1 << chunkIndex.level;
+    int numY = 1 << (chunkIndex.level - 1);
+
+    int x = chunkIndex.x;
+    int y = chunkIndex.y;
+    switch (direction) {
+    case WEST:  x = (x + numX - 1) % numX; break;
+    case EAST:  x = (x + 1) % numX; break;
+    case NORTH: y--; break;
+    case SOUTH: y++; break;
+    }
+    if (y < 0 || y >= numY) {
+        return -1;
+    }
+
+    // Walk up until a node that exists in the tree is found
+    MortonKey key = ChunkIndex(x, y, chunkIndex.level).mortonKey();
+    for (int level = chunkIndex.level; level >= 1; --level) {
+        int neighbor = _nodesByKey.find(key);
+        if (neighbor != -1) {
+            return neighbor;
+        }
+        key >>= 2;
+    }
+    return -1;
+}
+
+ChunkNode& ChunkTree::getNode(int node) {
+    return _nodes[node];
+}
+
+const ChunkNode& ChunkTree::getNode(int node) const {
+    return _nodes[node];
+}
+
+size_t ChunkTree::numNodes() const {
+    return _nodesByKey.size();
+}
+
+size_t ChunkTree::numLeaves() const {
+    return _leaves.size();
+}
+
+int ChunkTree::allocateBlock() {
+    if (!_freeBlocks.empty()) {
+        int block = _freeBlocks.back();
+        _freeBlocks.pop_back();
+        return block;
+    }
+
+    int block = static_cast<int>(_nodes.size());
+    for (int i = 0; i < 4; ++i) {
+        _nodes.push_back(ChunkNode(Chunk(_owner, ChunkIndex())));
+    }
+    return block;
+}
+
+void ChunkTree::addLeaf(int node) {
+    _nodes[node]._leafPosition = static_cast<int>(_leaves.size());
+    _leaves.push_back(node);
+}
+
+void ChunkTree::removeLeaf(int node) {
+    // Moves the last leaf into the position of the removed one
+    int position = _nodes[node]._leafPosition;
+    ghoul_assert(position != -1, "The node is not a leaf");
+    int last = _leaves.back();
+    _leaves[position] = last;
+    _nodes[last]._leafPosition = position;
+    _leaves.pop_back();
+    _nodes[node]._leafPosition = -1;
+}
+
+} // namespace openspace
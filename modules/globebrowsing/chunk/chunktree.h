@@ -0,0 +1,137 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __CHUNK_TREE_H__
+#define __CHUNK_TREE_H__
+
+#include <modules/globebrowsing/chunk/chunkindex.h>
+#include <modules/globebrowsing/chunk/chunknode.h>
+#include <modules/globebrowsing/chunk/mortonkeymap.h>
+
+#include <vector>
+
+namespace openspace {
+
+class ChunkedLodGlobe;
+
+/**
+ * The chunk tree of a globe, covering the western and the eastern hemisphere with one
+ * root each. The nodes are kept in a pool that grows but never shrinks; the four
+ * children of a split node take a free block of the pool, so that splitting and merging
+ * reuses the memory of earlier nodes. Nodes can be looked up by their Morton key in a
+ * flat hash map, which makes finding the parent or a neighbour of a chunk cheap.
+ *
+ * The leaves of the tree are kept in a list that is updated by #split and #merge
+ * instead of being collected every frame, and none of the traversals allocate memory
+ * once the tree has been built.
+ */
+class ChunkTree {
+public:
+    ChunkTree(ChunkedLodGlobe* owner);
+
+    /**
+     * Updates the chunks of the tree and splits and merges nodes according to the
+     * desired levels of the chunks. Nodes are merged when all their children want to
+     * merge and the node itself does not want to split.
+     */
+    void update(const RenderData& data);
+
+    /**
+     * Renders the visible leaves; either the most detailed chunks first or in the order
+     * of a depth first traversal.
+     */
+    void render(const RenderData& data, bool renderSmallChunksFirst);
+
+    /// Splits a leaf into four children
+    void split(int node, bool initChunksVisible = true);
+
+    /// Removes all descendants of a node, which makes it a leaf
+    void merge(int node);
+
+    /// Returns the node of <code>chunkIndex</code> or -1 if it is not in the tree
+    int findNode(const ChunkIndex& chunkIndex) const;
+
+    /// Returns the parent of a node or -1 for the roots
+    int getParent(int node) const;
+
+    /**
+     * Returns the deepest node that covers the neighbouring area of a node in the
+     * given direction, which is at most as deep as the node itself. Returns -1 across
+     * the poles.
+     */
+    int getNeighbor(int node, CardinalDirection direction) const;
+
+    ChunkNode& getNode(int node);
+    const ChunkNode& getNode(int node) const;
+
+    /// Calls <code>f</code> for every node in the tree, in no particular order
+    template <typename F>
+    void forEachNode(F f);
+
+    /// Calls <code>f</code> for every leaf in the tree, in no particular order
+    template <typename F>
+    void forEachLeaf(F f);
+
+    size_t numNodes() const;
+    size_t numLeaves() const;
+
+private:
+    bool updateNode(int node, const RenderData& data);
+
+    int allocateBlock();
+    void addLeaf(int node);
+    void removeLeaf(int node);
+
+    ChunkedLodGlobe* _owner;
+
+    // Nodes and the first positions of unused blocks of four nodes
+    std::vector<ChunkNode> _nodes;
+    std::vector<int> _freeBlocks;
+    MortonKeyMap _nodesByKey;
+
+    std::vector<int> _leaves;
+
+    // Reused every frame to sort the chunks before they are rendered
+    std::vector<int> _renderList;
+};
+
+template <typename F>
+void ChunkTree::forEachNode(F f) {
+    for (ChunkNode& node : _nodes) {
+        if (node._isUsed) {
+            f(node);
+        }
+    }
+}
+
+template <typename F>
+void ChunkTree::forEachLeaf(F f) {
+    for (int leaf : _leaves) {
+        f(_nodes[leaf]);
+    }
+}
+
+} // namespace openspace
+
+#endif // __CHUNK_TREE_H__
@@ -37,6 +37,9 @@
 
 #include <modules/debugging/rendering/debugrenderer.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace {
     const std::string _loggerCat = "FrustrumCuller";
 }
@@ -62,15 +65,16 @@ namespace openspace {
         dmat4 modelViewProjectionTransform = dmat4(data.camera.projectionMatrix())
             * viewTransform * modelTransform;
 
-        const std::vector<glm::dvec4>& corners = chunk.getBoundingPolyhedronCorners();
-        
+        return isCullable(chunk.getBoundingPolyhedronCorners(), modelViewProjectionTransform);
+    }
 
+    bool FrustumCuller::isCullable(const std::array<dvec4, 8>& corners,
+                                   const dmat4& modelViewProjectionTransform) const
+    {
         // Create a bounding box that fits the patch corners
         AABB3 bounds; // in screen space
-        std::vector<vec4> clippingSpaceCorners(8);
         for (size_t i = 0; i < 8; i++) {
             dvec4 cornerClippingSpace = modelViewProjectionTransform * corners[i];
-            clippingSpaceCorners[i] = cornerClippingSpace;
 
             dvec3 cornerScreenSpace = (1.0f / glm::abs(cornerClippingSpace.w)) * cornerClippingSpace.xyz();
             bounds.expand(cornerScreenSpace);
@@ -94,22 +98,29 @@ namespace openspace {
     bool HorizonCuller::isCullable(const Chunk& chunk, const RenderData& data) {
         //return !isVisible(data, chunk.surfacePatch(), chunk.owner()->ellipsoid(), chunk.owner()->chunkHeight);
         const Ellipsoid& ellipsoid = chunk.owner()->ellipsoid();
-        const GeodeticPatch& patch = chunk.surfacePatch();
         float maxHeight = chunk.getBoundingHeights().max;
         Vec3 globePosition = data.position.dvec3();
         Scalar minimumGlobeRadius = ellipsoid.minimumRadius();
 
         Vec3 cameraPosition = data.camera.positionVec3();
 
+        Vec3 objectPosition = closestSurfacePosition(chunk, cameraPosition, globePosition);
+
+        return isCullable(cameraPosition, globePosition, objectPosition,
+            maxHeight, minimumGlobeRadius);
+    }
+
+    Vec3 HorizonCuller::closestSurfacePosition(const Chunk& chunk,
+                                               const Vec3& cameraPosition,
+                                               const Vec3& globePosition)
+    {
+        const Ellipsoid& ellipsoid = chunk.owner()->ellipsoid();
         Vec3 globeToCamera = cameraPosition - globePosition;
 
         Geodetic2 cameraPositionOnGlobe =
             ellipsoid.cartesianToGeodetic2(globeToCamera);
-        Geodetic2 closestPatchPoint = patch.closestPoint(cameraPositionOnGlobe);
-        const Vec3& objectPosition = ellipsoid.cartesianSurfacePosition(closestPatchPoint);
-
-        return isCullable(cameraPosition, globePosition, objectPosition,
-            maxHeight, minimumGlobeRadius);
+        Geodetic2 closestPatchPoint = chunk.surfacePatch().closestPoint(cameraPositionOnGlobe);
+        return ellipsoid.cartesianSurfacePosition(closestPatchPoint);
     }
 
     bool HorizonCuller::isCullable(
@@ -119,17 +130,177 @@ namespace openspace {
         Scalar objectBoundingSphereRadius,
         Scalar minimumGlobeRadius)
     {
-        Scalar distanceToHorizon =
-            sqrt(pow(length(cameraPosition - globePosition), 2) - pow(minimumGlobeRadius, 2));
+        // The squared lengths are computed directly; the BatchedChunkCuller uses the same
+        // expressions so that both give identical results
+        Vec3 globeToCamera = cameraPosition - globePosition;
+        Vec3 globeToObject = objectPosition - globePosition;
+        Vec3 cameraToObject = objectPosition - cameraPosition;
+        Scalar minimumObjectRadius = minimumGlobeRadius - objectBoundingSphereRadius;
+
+        Scalar distanceToHorizon = sqrt(
+            dot(globeToCamera, globeToCamera) - minimumGlobeRadius * minimumGlobeRadius);
         Scalar minimumAllowedDistanceToObjectFromHorizon = sqrt(
-            pow(length(objectPosition - globePosition), 2) -
-            pow(minimumGlobeRadius - objectBoundingSphereRadius, 2));
+            dot(globeToObject, globeToObject) - minimumObjectRadius * minimumObjectRadius);
         // Minimum allowed for the object to be occluded
-        Scalar minimumAllowedDistanceToObjectSquared =
-            pow(distanceToHorizon + minimumAllowedDistanceToObjectFromHorizon, 2)
-            + pow(objectBoundingSphereRadius, 2);
-        Scalar distanceToObjectSquared = pow(length(objectPosition - cameraPosition), 2);
+        Scalar horizonDistance = distanceToHorizon + minimumAllowedDistanceToObjectFromHorizon;
+        Scalar minimumAllowedDistanceToObjectSquared = horizonDistance * horizonDistance
+            + objectBoundingSphereRadius * objectBoundingSphereRadius;
+        Scalar distanceToObjectSquared = dot(cameraToObject, cameraToObject);
         return distanceToObjectSquared > minimumAllowedDistanceToObjectSquared;
     }
 
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    //							BATCHED CULLER											//
+    //////////////////////////////////////////////////////////////////////////////////////
+    BatchedChunkCuller::BatchedChunkCuller(const AABB3& viewFrustum)
+        : _viewFrustum(viewFrustum)
+    {
+
+    }
+
+    void BatchedChunkCuller::clear() {
+        for (int corner = 0; corner < 8; ++corner) {
+            _cornerX[corner].clear();
+            _cornerY[corner].clear();
+            _cornerZ[corner].clear();
+        }
+        _surfaceX.clear();
+        _surfaceY.clear();
+        _surfaceZ.clear();
+        _maxHeight.clear();
+        _isCullable.clear();
+    }
+
+    void BatchedChunkCuller::add(const std::array<dvec4, 8>& corners,
+                                 const Vec3& surfacePosition, Scalar maxHeight)
+    {
+        for (int corner = 0; corner < 8; ++corner) {
+            _cornerX[corner].push_back(corners[corner].x);
+            _cornerY[corner].push_back(corners[corner].y);
+            _cornerZ[corner].push_back(corners[corner].z);
+        }
+        _surfaceX.push_back(surfacePosition.x);
+        _surfaceY.push_back(surfacePosition.y);
+        _surfaceZ.push_back(surfacePosition.z);
+        _maxHeight.push_back(maxHeight);
+    }
+
+    void BatchedChunkCuller::add(const Chunk& chunk, const Vec3& cameraPosition,
+                                 const Vec3& globePosition)
+    {
+        add(chunk.getBoundingPolyhedronCorners(),
+            HorizonCuller::closestSurfacePosition(chunk, cameraPosition, globePosition),
+            chunk.getBoundingHeights().max);
+    }
+
+    size_t BatchedChunkCuller::size() const {
+        return _maxHeight.size();
+    }
+
+    bool BatchedChunkCuller::isCullable(size_t i) const {
+        return _isCullable[i] != 0;
+    }
+
+    void BatchedChunkCuller::cull(const dmat4& modelViewProjectionTransform,
+                                  const Vec3& cameraPosition, const Vec3& globePosition,
+                                  Scalar minimumGlobeRadius, bool horizonCulling,
+                                  bool frustumCulling)
+    {
+        _isCullable.assign(size(), 0);
+        if (horizonCulling) {
+            cullByHorizon(cameraPosition, globePosition, minimumGlobeRadius);
+        }
+        if (frustumCulling) {
+            cullByFrustum(modelViewProjectionTransform);
+        }
+    }
+
+    void BatchedChunkCuller::cullByHorizon(const Vec3& cameraPosition,
+                                           const Vec3& globePosition,
+                                           Scalar minimumGlobeRadius)
+    {
+        const Vec3 globeToCamera = cameraPosition - globePosition;
+        const Scalar distanceToHorizon = sqrt(
+            dot(globeToCamera, globeToCamera) - minimumGlobeRadius * minimumGlobeRadius);
+
+        const size_t n = size();
+        const double* surfaceX = _surfaceX.data();
+        const double* surfaceY = _surfaceY.data();
+        const double* surfaceZ = _surfaceZ.data();
+        const double* maxHeight = _maxHeight.data();
+        char* isCullable = _isCullable.data();
+
+        for (size_t i = 0; i < n; ++i) {
+            // Same expressions as HorizonCuller::isCullable
+            double height = maxHeight[i];
+            double gx = surfaceX[i] - globePosition.x;
+            double gy = surfaceY[i] - globePosition.y;
+            double gz = surfaceZ[i] - globePosition.z;
+            double cx = surfaceX[i] - cameraPosition.x;
+            double cy = surfaceY[i] - cameraPosition.y;
+            double cz = surfaceZ[i] - cameraPosition.z;
+            double minimumObjectRadius = minimumGlobeRadius - height;
+
+            double minimumAllowedDistanceToObjectFromHorizon = sqrt(
+                (gx * gx + gy * gy + gz * gz) - minimumObjectRadius * minimumObjectRadius);
+            double horizonDistance =
+                distanceToHorizon + minimumAllowedDistanceToObjectFromHorizon;
+            double minimumAllowedDistanceToObjectSquared =
+                horizonDistance * horizonDistance + height * height;
+            double distanceToObjectSquared = cx * cx + cy * cy + cz * cz;
+
+            isCullable[i] |= distanceToObjectSquared > minimumAllowedDistanceToObjectSquared;
+        }
+    }
+
+    void BatchedChunkCuller::cullByFrustum(const dmat4& modelViewProjectionTransform) {
+        const dmat4& m = modelViewProjectionTransform;
+        const size_t n = size();
+
+        // Screen space bounds of every chunk, stored as floats like the AABB3
+        std::vector<float> minX(n, 1e35f), minY(n, 1e35f), minZ(n, 1e35f);
+        std::vector<float> maxX(n, -1e35f), maxY(n, -1e35f), maxZ(n, -1e35f);
+
+        for (int corner = 0; corner < 8; ++corner) {
+            const double* cornerX = _cornerX[corner].data();
+            const double* cornerY = _cornerY[corner].data();
+            const double* cornerZ = _cornerZ[corner].data();
+
+            for (size_t i = 0; i < n; ++i) {
+                double x = cornerX[i];
+                double y = cornerY[i];
+                double z = cornerZ[i];
+
+                // Same order of operations as the matrix-vector product in glm
+                double clipX = (m[0][0] * x + m[1][0] * y) + (m[2][0] * z + m[3][0]);
+                double clipY = (m[0][1] * x + m[1][1] * y) + (m[2][1] * z + m[3][1]);
+                double clipZ = (m[0][2] * x + m[1][2] * y) + (m[2][2] * z + m[3][2]);
+                double clipW = (m[0][3] * x + m[1][3] * y) + (m[2][3] * z + m[3][3]);
+
+                double invW = 1.0 / std::abs(clipW);
+                float screenX = static_cast<float>(invW * clipX);
+                float screenY = static_cast<float>(invW * clipY);
+                float screenZ = static_cast<float>(invW * clipZ);
+
+                minX[i] = std::min(minX[i], screenX);
+                minY[i] = std::min(minY[i], screenY);
+                minZ[i] = std::min(minZ[i], screenZ);
+                maxX[i] = std::max(maxX[i], screenX);
+                maxY[i] = std::max(maxY[i], screenY);
+                maxZ[i] = std::max(maxZ[i], screenZ);
+            }
+        }
+
+        const vec3& frustumMin = _viewFrustum.min;
+        const vec3& frustumMax = _viewFrustum.max;
+        char* isCullable = _isCullable.data();
+        for (size_t i = 0; i < n; ++i) {
+            bool intersects = (frustumMin.x <= maxX[i]) && (minX[i] <= frustumMax.x)
+                && (frustumMin.y <= maxY[i]) && (minY[i] <= frustumMax.y)
+                && (frustumMin.z <= maxZ[i]) && (minZ[i] <= frustumMax.z);
+            isCullable[i] |= !intersects;
+        }
+    }
+
 }  // namespace openspace
@@ -25,7 +25,9 @@
 #ifndef __CULLING_H__
 #define __CULLING_H__
 
+#include <array>
 #include <memory>
+#include <vector>
 #include <glm/glm.hpp>
 
 // open space includes
@@ -60,6 +62,9 @@ namespace openspace {
 
         virtual bool isCullable(const Chunk& chunk, const RenderData& renderData);
 
+        bool isCullable(const std::array<dvec4, 8>& corners,
+            const dmat4& modelViewProjectionTransform) const;
+
     private:
         const AABB3 _viewFrustum;
 
@@ -83,6 +88,71 @@ namespace openspace {
             const Vec3& objectPosition, Scalar objectBoundingSphereRadius,
             Scalar minimumGlobeRadius);
 
+        /**
+         * Returns the point on the surface of the chunk that is closest to the camera,
+         * which is the position that the horizon test is performed for.
+         */
+        static Vec3 closestSurfacePosition(const Chunk& chunk, const Vec3& cameraPosition,
+            const Vec3& globePosition);
+    };
+
+
+    /**
+     * Performs the horizon and frustum tests for many chunks in one pass. The bounds of
+     * the chunks are gathered into flat arrays with one array per component, so that the
+     * tests run as tight loops over contiguous memory that the compiler can vectorize.
+     * The results are the same as for the HorizonCuller and the FrustumCuller.
+     */
+    class BatchedChunkCuller {
+    public:
+        BatchedChunkCuller(const AABB3& viewFrustum);
+
+        /// Removes all chunks from the batch
+        void clear();
+
+        /**
+         * Adds the bounds of a chunk to the batch. <code>surfacePosition</code> is the
+         * point of the chunk closest to the camera as returned by
+         * HorizonCuller::closestSurfacePosition.
+         */
+        void add(const std::array<dvec4, 8>& corners, const Vec3& surfacePosition,
+            Scalar maxHeight);
+
+        void add(const Chunk& chunk, const Vec3& cameraPosition,
+            const Vec3& globePosition);
+
+        size_t size() const;
+
+        /**
+         * Culls all chunks in the batch. The result for each chunk can be retrieved
+         * with #isCullable in the order that they were added.
+         */
+        void cull(const dmat4& modelViewProjectionTransform, const Vec3& cameraPosition,
+            const Vec3& globePosition, Scalar minimumGlobeRadius, bool horizonCulling,
+            bool frustumCulling);
+
+        bool isCullable(size_t i) const;
+
+    private:
+        void cullByHorizon(const Vec3& cameraPosition, const Vec3& globePosition,
+            Scalar minimumGlobeRadius);
+        void cullByFrustum(const dmat4& modelViewProjectionTransform);
+
+        const AABB3 _viewFrustum;
+
+        // The coordinates of corner j of all chunks are stored contiguously in
+        // _cornerX[j], _cornerY[j] and _cornerZ[j]
+        std::array<std::vector<double>, 8> _cornerX;
+        std::array<std::vector<double>, 8> _cornerY;
+        std::array<std::vector<double>, 8> _cornerZ;
+
+        std::vector<double> _surfaceX;
+        std::vector<double> _surfaceY;
+        std::vector<double> _surfaceZ;
+        std::vector<double> _maxHeight;
+
+        // char instead of bool so that the results can be written in vectorized loops
+        std::vector<char> _isCullable;
     };
 
 
@@ -0,0 +1,138 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/chunk/mortonkeymap.h>
+
+#include <ghoul/misc/assert.h>
+
+namespace {
+    const size_t MinimumNumSlots = 16;
+}
+
+namespace openspace {
+
+MortonKeyMap::MortonKeyMap(size_t capacity)
+    : _mask(0)
+    , _shift(64)
+    , _size(0)
+{
+    reserve(capacity);
+}
+
+void MortonKeyMap::reserve(size_t capacity) {
+    size_t nSlots = MinimumNumSlots;
+    while (nSlots < 2 * capacity) {
+        nSlots *= 2;
+    }
+    if (nSlots > _slots.size()) {
+        rehash(nSlots);
+    }
+}
+
+void MortonKeyMap::insert(MortonKey key, int value) {
+    ghoul_assert(key != 0, "Key 0 marks empty slots");
+    if (2 * (_size + 1) > _slots.size()) {
+        rehash(2 * _slots.size());
+    }
+    size_t i = homeSlot(key);
+    while (_slots[i].key != 0 && _slots[i].key != key) {
+        i = (i + 1) & _mask;
+    }
+    if (_slots[i].key == 0) {
+        _slots[i].key = key;
+        ++_size;
+    }
+    _slots[i].value = value;
+}
+
+bool MortonKeyMap::erase(MortonKey key) {
+    size_t i = homeSlot(key);
+    while (_slots[i].key != key) {
+        if (_slots[i].key == 0) {
+            return false;
+        }
+        i = (i + 1) & _mask;
+    }
+
+    // Move later entries of the probe sequence into the hole unless that would place
+    // them before their home slot
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & _mask;
+        if (_slots[j].key == 0) {
+            break;
+        }
+        size_t home = homeSlot(_slots[j].key);
+        bool homeInHoleToJ = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (!homeInHoleToJ) {
+            _slots[i] = _slots[j];
+            i = j;
+        }
+    }
+    _slots[i].key = 0;
+    --_size;
+    return true;
+}
+
+int MortonKeyMap::find(MortonKey key) const {
+    size_t i = homeSlot(key);
+    while (_slots[i].key != 0) {
+        if (_slots[i].key == key) {
+            return _slots[i].value;
+        }
+        i = (i + 1) & _mask;
+    }
+    return -1;
+}
+
+size_t MortonKeyMap::size() const {
+    return _size;
+}
+
+size_t MortonKeyMap::capacity() const {
+    return _slots.size() / 2;
+}
+
+size_t MortonKeyMap::homeSlot(MortonKey key) const {
+    // Fibonacci hashing spreads the keys of neighbouring chunks over the whole table
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> _shift);
+}
+
+void MortonKeyMap::rehash(size_t nSlots) {
+    std::vector<Slot> oldSlots(nSlots, Slot{ 0, -1 });
+    _slots.swap(oldSlots);
+    _mask = nSlots - 1;
+    _shift = 64;
+    for (size_t n = nSlots; n > 1; n /= 2) {
+        --_shift;
+    }
+    _size = 0;
+    for (const Slot& slot : oldSlots) {
+        if (slot.key != 0) {
+            insert(slot.key, slot.value);
+        }
+    }
+}
+
+} // namespace openspace
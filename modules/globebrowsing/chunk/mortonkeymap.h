@@ -0,0 +1,85 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __MORTON_KEY_MAP_H__
+#define __MORTON_KEY_MAP_H__
+
+#include <modules/globebrowsing/chunk/chunkindex.h>
+
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Maps the Morton keys of chunks to the positions of their nodes. All entries live in a
+ * single array that is searched by linear probing, so a lookup touches one or two cache
+ * lines and inserting and erasing entries does not allocate as long as the reserved
+ * capacity is not exceeded. Erasing shifts the following entries back instead of
+ * leaving tombstones, so the map does not degrade when the same keys are inserted and
+ * erased every frame.
+ *
+ * Every valid Morton key has its marker bit set, so key 0 denotes an empty slot and
+ * cannot be stored in the map.
+ */
+class MortonKeyMap {
+public:
+    /// Creates a map that can hold <code>capacity</code> entries before growing
+    MortonKeyMap(size_t capacity = 0);
+
+    /// Makes room for at least <code>capacity</code> entries
+    void reserve(size_t capacity);
+
+    /// Maps <code>key</code> to <code>value</code>, replacing any earlier value
+    void insert(MortonKey key, int value);
+
+    /// Removes <code>key</code> and returns whether it was in the map
+    bool erase(MortonKey key);
+
+    /// Returns the value of <code>key</code> or -1 if it is not in the map
+    int find(MortonKey key) const;
+
+    size_t size() const;
+
+    /// Returns the number of entries that fit before the map grows
+    size_t capacity() const;
+
+private:
+    struct Slot {
+        MortonKey key;
+        int value;
+    };
+
+    size_t homeSlot(MortonKey key) const;
+    void rehash(size_t nSlots);
+
+    // The number of slots is a power of two and at least twice the number of entries
+    std::vector<Slot> _slots;
+    size_t _mask;
+    int _shift;
+    size_t _size;
+};
+
+} // namespace openspace
+
+#endif // __MORTON_KEY_MAP_H__
@@ -28,6 +28,8 @@
 
 #include <ghoul/misc/assert.h>
 
+#include <algorithm>
+
 
 
 namespace {
@@ -62,6 +64,12 @@ namespace openspace {
         return Vec2(lon, lat);
     }
 
+    Scalar Geodetic2::angularDistance(const Geodetic2& other) const {
+        Scalar cosAngle = sin(lat) * sin(other.lat) +
+            cos(lat) * cos(other.lat) * cos(lon - other.lon);
+        return acos(std::max(-1.0, std::min(1.0, cosAngle)));
+    }
+
     bool Geodetic2::operator==(const Geodetic2& other) const {
         return lat == other.lat && lon == other.lon;
     }
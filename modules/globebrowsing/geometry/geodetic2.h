@@ -65,6 +65,12 @@ struct Geodetic2 {
 
     Vec2 toLonLatVec2() const;
 
+    /**
+        Returns the angle in radians between this point and <code>other</code> along a
+        great circle of the unit sphere.
+    */
+    Scalar angularDistance(const Geodetic2& other) const;
+
     bool operator==(const Geodetic2& other) const;
     bool operator!=(const Geodetic2& other) const { return !(*this == (other)); }
 
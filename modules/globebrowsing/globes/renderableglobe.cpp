@@ -79,6 +79,8 @@ namespace openspace {
         , showChunkEdges(properties::BoolProperty("showChunkEdges", "showChunkEdges", false))
         , showChunkBounds(properties::BoolProperty("showChunkBounds", "showChunkBounds", false))
         , levelByProjArea(properties::BoolProperty("levelByProjArea", "levelByProjArea", true))
+        , levelByScreenSpaceError(properties::BoolProperty("levelByScreenSpaceError", "levelByScreenSpaceError", false))
+        , screenSpaceErrorThreshold(properties::FloatProperty("screenSpaceErrorThreshold", "screenSpaceErrorThreshold", 2.0f, 0.5f, 16.0f))
         , limitLevelByAvailableHeightData(properties::BoolProperty("limitLevelByAvailableHeightData", "limitLevelByAvailableHeightData", true))
     {
         setName("RenderableGlobe");
@@ -108,6 +110,8 @@ namespace openspace {
         addProperty(showChunkEdges);
         addProperty(showChunkBounds);
         addProperty(levelByProjArea);
+        addProperty(levelByScreenSpaceError);
+        addProperty(screenSpaceErrorThreshold);
         addProperty(limitLevelByAvailableHeightData);
 
         doFrustumCulling.setValue(true);
@@ -245,6 +249,8 @@ namespace openspace {
         _chunkedLodGlobe->showChunkEdges = showChunkEdges.value();
         _chunkedLodGlobe->showChunkBounds = showChunkBounds.value();
         _chunkedLodGlobe->levelByProjArea = levelByProjArea.value();
+        _chunkedLodGlobe->levelByScreenSpaceError = levelByScreenSpaceError.value();
+        _chunkedLodGlobe->screenSpaceErrorThreshold = screenSpaceErrorThreshold.value();
         _chunkedLodGlobe->limitLevelByAvailableHeightData = limitLevelByAvailableHeightData.value();
         /*
         std::vector<TileProviderManager::TileProviderWithName>& colorTextureProviders =
@@ -287,6 +293,20 @@ namespace openspace {
         return _chunkedLodGlobe;
     }
 
+    const Ellipsoid& RenderableGlobe::ellipsoid() const {
+        return _ellipsoid;
+    }
+
+    HeightQueryResult RenderableGlobe::getHeight(const Geodetic2& position) const {
+        return _chunkedLodGlobe->getHeight(position);
+    }
+
+    void RenderableGlobe::getHeights(const std::vector<Geodetic2>& positions,
+        std::vector<HeightQueryResult>& results) const
+    {
+        _chunkedLodGlobe->getHeights(positions, results);
+    }
+
     void RenderableGlobe::selectionChanged(
         properties::SelectionProperty selectionProperty,
         LayeredTextures::TextureCategory textureCategory)
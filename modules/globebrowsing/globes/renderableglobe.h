@@ -70,6 +70,17 @@ public:
 
     glm::dvec3 geodeticSurfaceProjection(glm::dvec3 position);
     std::shared_ptr<ChunkedLodGlobe> chunkedLodGlobe();
+    const Ellipsoid& ellipsoid() const;
+
+    /**
+     * Returns the terrain height above the ellipsoid at <code>position</code> together
+     * with the level of the height tile that answered, without involving the GPU. The
+     * height is only as detailed as the tiles that have been read for rendering. Can be
+     * called from any thread.
+     */
+    HeightQueryResult getHeight(const Geodetic2& position) const;
+    void getHeights(const std::vector<Geodetic2>& positions,
+        std::vector<HeightQueryResult>& results) const;
 
     properties::BoolProperty doFrustumCulling;
     properties::BoolProperty doHorizonCulling;
@@ -96,6 +107,8 @@ public:
     properties::BoolProperty showChunkEdges;
     properties::BoolProperty showChunkBounds;
     properties::BoolProperty levelByProjArea;
+    properties::BoolProperty levelByScreenSpaceError;
+    properties::FloatProperty screenSpaceErrorThreshold;
     properties::BoolProperty limitLevelByAvailableHeightData;
 
 
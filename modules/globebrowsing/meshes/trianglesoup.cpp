@@ -175,4 +175,20 @@ void TriangleSoup::drawUsingActiveProgram() {
 	glBindVertexArray(0);
 }
 
+void TriangleSoup::bindVertexArray() {
+	if (_gpuDataNeedUpdate) {
+		updateDataInGPU();
+	}
+	glBindVertexArray(_vaoID);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _elementBufferID);
+}
+
+void TriangleSoup::drawBoundElements() {
+	glDrawElements(GL_TRIANGLES, _elementData.size(), GL_UNSIGNED_INT, 0);
+}
+
+void TriangleSoup::unbindVertexArray() {
+	glBindVertexArray(0);
+}
+
 } // namespace openspace
\ No newline at end of file
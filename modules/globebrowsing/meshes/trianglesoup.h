@@ -68,6 +68,13 @@ public:
 	
 	void drawUsingActiveProgram();
 
+	// Draws the soup several times in a row with the vertex array bound only once.
+	// drawBoundElements may only be called between bindVertexArray and
+	// unbindVertexArray.
+	void bindVertexArray();
+	void drawBoundElements();
+	void unbindVertexArray();
+
 protected:
 	// Determines what attribute data is in use
 	bool _useVertexPositions;
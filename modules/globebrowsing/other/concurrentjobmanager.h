@@ -59,46 +59,59 @@ namespace openspace {
 
     /* 
      * Templated Concurrent Job Manager
-     * This class is used execute specific jobs on one (1) parallell thread
+     * This class is used execute specific jobs on the threads of a thread pool. The 
+     * pool may be shared between several job managers; clearing the enqueued jobs
+     * only removes the jobs of this manager.
      */
     template<typename P>
     class ConcurrentJobManager{
     public:
-        ConcurrentJobManager(std::shared_ptr<ThreadPool> pool) : threadPool(pool)
+        ConcurrentJobManager(std::shared_ptr<ThreadPool> pool)
+            : _finishedJobs(std::make_shared<ConcurrentQueue<std::shared_ptr<Job<P>>>>())
+            , threadPool(pool)
         {
 
         }
 
         ~ConcurrentJobManager() {
-
+            clearEnqueuedJobs();
         }
 
 
         void enqueueJob(std::shared_ptr<Job<P>> job) {
-            threadPool->enqueue([this, job]() {
+            // Jobs that are already running when the manager is destroyed still have
+            // a queue to push their results to
+            auto finishedJobs = _finishedJobs;
+            threadPool->enqueue([finishedJobs, job]() {
                 job->execute();
-                _finishedJobs.push(job);
-            });
+                finishedJobs->push(job);
+            }, this);
         }
 
-        void clearEnqueuedJobs() {
-            threadPool->clearTasks();
+        // Returns the number of jobs that were removed before they were started
+        size_t clearEnqueuedJobs() {
+            return threadPool->clearTasks(this);
         }
 
         std::shared_ptr<Job<P>> popFinishedJob() {
-            ghoul_assert(_finishedJobs.size() > 0, "There is no finished job to pop!");
-            return _finishedJobs.pop();
+            ghoul_assert(_finishedJobs->size() > 0, "There is no finished job to pop!");
+            return _finishedJobs->pop();
+        }
+
+        // Blocks until a job is finished
+        std::shared_ptr<Job<P>> waitForFinishedJob() {
+            return _finishedJobs->pop();
         }
 
         size_t numFinishedJobs() const{
-            return _finishedJobs.size();
+            return _finishedJobs->size();
         }
 
 
     
     private:
 
-        ConcurrentQueue<std::shared_ptr<Job<P>>> _finishedJobs;
+        std::shared_ptr<ConcurrentQueue<std::shared_ptr<Job<P>>>> _finishedJobs;
         std::shared_ptr<ThreadPool> threadPool;
     };
 
@@ -30,12 +30,15 @@
 #include <ostream>
 #include <unordered_map>
 #include <list>
+#include <vector>
 
 
 
 namespace openspace {
 
-    // Templated class implementing a Least-Recently-Used Cache
+    // Templated class implementing a Least-Recently-Used Cache. Every item has a cost,
+    // which is 1 unless specified otherwise, and the least recently used items are
+    // removed when the total cost exceeds the size of the cache.
     template<typename KeyType, typename ValueType>
     class LRUCache {
     public:
@@ -44,21 +47,35 @@ namespace openspace {
 
 
         void put(const KeyType& key, const ValueType& value);
+
+        /**
+            Same as put but moves the values that no longer fit in the cache to
+            <code>evicted</code> so that their resources can be reused.
+        */
+        void put(const KeyType& key, const ValueType& value,
+            std::vector<ValueType>& evicted, size_t cost = 1);
         bool exist(const KeyType& key) const;
         ValueType get(const KeyType& key);
         size_t size() const;
+        size_t totalCost() const;
 
 
     private:
-        void clean();
+        void clean(std::vector<ValueType>* evicted = nullptr);
 
 
     // Member varialbes
     private:
         
         std::list<std::pair<KeyType, ValueType>> _itemList;
-        std::unordered_map<KeyType, decltype(_itemList.begin())> _itemMap;
+
+        struct ItemPosition {
+            decltype(_itemList.begin()) position;
+            size_t cost;
+        };
+        std::unordered_map<KeyType, ItemPosition> _itemMap;
         size_t _cacheSize;
+        size_t _totalCost;
 
     };
 
@@ -35,7 +35,8 @@ namespace openspace {
     
     template<typename KeyType, typename ValueType>
     LRUCache<KeyType, ValueType>::LRUCache(size_t size)
-        : _cacheSize(size) { }
+        : _cacheSize(size)
+        , _totalCost(0) { }
 
     template<typename KeyType, typename ValueType>
     LRUCache<KeyType, ValueType>::~LRUCache() {	
@@ -52,14 +53,33 @@ namespace openspace {
     {
         auto it = _itemMap.find(key);
         if (it != _itemMap.end()) {
-            _itemList.erase(it->second);
+            _totalCost -= it->second.cost;
+            _itemList.erase(it->second.position);
             _itemMap.erase(it);
         }
         _itemList.push_front(std::make_pair(key, value));
-        _itemMap.insert(std::make_pair(key, _itemList.begin()));
+        _itemMap.insert(std::make_pair(key, ItemPosition{ _itemList.begin(), 1 }));
+        _totalCost += 1;
         clean();
     }
 
+    template<typename KeyType, typename ValueType>
+    void LRUCache<KeyType, ValueType>::put(const KeyType& key, const ValueType& value,
+        std::vector<ValueType>& evicted, size_t cost)
+    {
+        auto it = _itemMap.find(key);
+        if (it != _itemMap.end()) {
+            evicted.push_back(it->second.position->second);
+            _totalCost -= it->second.cost;
+            _itemList.erase(it->second.position);
+            _itemMap.erase(it);
+        }
+        _itemList.push_front(std::make_pair(key, value));
+        _itemMap.insert(std::make_pair(key, ItemPosition{ _itemList.begin(), cost }));
+        _totalCost += cost;
+        clean(&evicted);
+    }
+
 
     template<typename KeyType, typename ValueType>
     bool LRUCache<KeyType, ValueType>::exist(const KeyType& key) const
@@ -74,8 +94,8 @@ namespace openspace {
         //ghoul_assert(exist(key), "Key " << key << " must exist");
         auto it = _itemMap.find(key);
         // Move list iterator pointing to value
-        _itemList.splice(_itemList.begin(), _itemList, it->second);
-        return it->second->second;
+        _itemList.splice(_itemList.begin(), _itemList, it->second.position);
+        return it->second.position->second;
     }
 
     template<typename KeyType, typename ValueType>
@@ -84,17 +104,29 @@ namespace openspace {
         return _itemMap.size();
     }
 
+    template<typename KeyType, typename ValueType>
+    size_t LRUCache<KeyType, ValueType>::totalCost() const
+    {
+        return _totalCost;
+    }
+
 
 
     //////////////////////////////
     //		PRIVATE HELPERS		//
     //////////////////////////////
     template<typename KeyType, typename ValueType>
-    void LRUCache<KeyType, ValueType>::clean()
+    void LRUCache<KeyType, ValueType>::clean(std::vector<ValueType>* evicted)
     {
-        while (_itemMap.size() > _cacheSize) {
+        // The most recently added item is kept even if it exceeds the size on its own
+        while (_totalCost > _cacheSize && _itemMap.size() > 1) {
             auto last_it = _itemList.end(); last_it--;
-            _itemMap.erase(last_it->first);
+            if (evicted) {
+                evicted->push_back(last_it->second);
+            }
+            auto item = _itemMap.find(last_it->first);
+            _totalCost -= item->second.cost;
+            _itemMap.erase(item);
             _itemList.pop_back();
         }
     }
@@ -34,6 +34,7 @@
 #include <modules/globebrowsing/other/threadpool.h>
 
 #include <ghoul/misc/assert.h>
+#include <algorithm>
 #include <iostream>
 
 
@@ -65,7 +66,7 @@ namespace openspace {
                 }
 
                 // get the task from the queue
-                task = pool.tasks.front();
+                task = pool.tasks.front().second;
                 pool.tasks.pop_front();
 
             }// release lock
@@ -103,12 +104,12 @@ namespace openspace {
     
 
     // add new work item to the pool
-    void ThreadPool::enqueue(std::function<void()> f) {
+    void ThreadPool::enqueue(std::function<void()> f, const void* owner) {
         { // acquire lock
             std::unique_lock<std::mutex> lock(queue_mutex);
 
             // add the task
-            tasks.push_back(f);
+            tasks.push_back(std::make_pair(owner, f));
         } // release lock
 
           // wake up one thread
@@ -122,5 +123,27 @@ namespace openspace {
         } // release lock
     }
 
+    size_t ThreadPool::numThreads() const {
+        return workers.size();
+    }
+
+    size_t ThreadPool::clearTasks(const void* owner) {
+        { // acquire lock
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            size_t numTasks = tasks.size();
+            tasks.erase(
+                std::remove_if(
+                    tasks.begin(),
+                    tasks.end(),
+                    [owner](const std::pair<const void*, std::function<void()>>& task) {
+                        return task.first == owner;
+                    }
+                ),
+                tasks.end()
+            );
+            return numTasks - tasks.size();
+        } // release lock
+    }
+
 
 } // namespace openspace
\ No newline at end of file
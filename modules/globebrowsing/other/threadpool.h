@@ -26,6 +26,7 @@
 #define __THREAD_POOL_H__
 
 #include <glm/glm.hpp>
+#include <functional>
 #include <memory>
 #include <ostream>
 #include <thread>
@@ -57,15 +58,29 @@ namespace openspace {
         ThreadPool(size_t numThreads);
         ~ThreadPool();
 
-        void enqueue(std::function<void()> f);
+        /**
+         * Adds a task to the pool. The optional <code>owner</code> can be used to
+         * remove only the tasks of one owner when the pool is shared.
+         */
+        void enqueue(std::function<void()> f, const void* owner = nullptr);
+
+        /// Removes all tasks that have not been started yet
         void clearTasks();
 
+        /**
+         * Removes the tasks of <code>owner</code> that have not been started yet and
+         * returns how many were removed
+         */
+        size_t clearTasks(const void* owner);
+
+        size_t numThreads() const;
+
     private:
         friend class Worker;
 
         std::vector<std::thread> workers;
 
-        std::deque<std::function<void()>> tasks;
+        std::deque<std::pair<const void*, std::function<void()>>> tasks;
 
         std::mutex queue_mutex;
         std::condition_variable condition;
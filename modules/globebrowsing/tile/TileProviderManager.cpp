@@ -28,6 +28,9 @@
 
 #include "cpl_minixml.h"
 
+#include <algorithm>
+#include <unordered_set>
+
 
 namespace {
     const std::string _loggerCat = "TileProviderManager";
@@ -41,6 +44,15 @@ namespace openspace {
     TileProviderManager::TileProviderManager(
         const ghoul::Dictionary& textureCategoriesDictionary,
         const ghoul::Dictionary& textureInitDictionary){
+        // Each reading thread uses its own handle to the GDAL dataset, so tile
+        // reads scale with the number of threads
+        double threads = 1;
+        textureInitDictionary.getValue("ReadThreads", threads);
+        _threadPool = std::make_shared<ThreadPool>(std::max(static_cast<int>(threads), 1));
+        _uploadBudget = std::make_shared<TileUploadScheduler::FrameBudget>();
+        _tileReadBatcher = std::unique_ptr<TileReadBatcher>(
+            new TileReadBatcher(_threadPool, _uploadBudget));
+
         // Create all the categories of tile providers
         for (size_t i = 0; i < textureCategoriesDictionary.size(); i++) {
             ghoul::Dictionary texturesDict = textureCategoriesDictionary.value<ghoul::Dictionary>(
@@ -68,10 +80,10 @@ namespace openspace {
                 initData.minimumPixelSize = 512;
             }
 
-            initData.threads = 1;
-            initData.cacheSize = 500;
-            initData.framesUntilRequestQueueFlush = 60;
+            initData.threads = static_cast<int>(_threadPool->numThreads());
+            initData.cacheSize = 256 * 1024 * 1024;
             initData.preprocessTiles = i == LayeredTextures::HeightMaps; // Only preprocess height maps.
+            initData.uploadBudget = _uploadBudget;
 
             initTexures(
                 _layerCategories[i],
@@ -98,13 +110,39 @@ namespace openspace {
             texDict.getValue("FilePath", path);
             texDict.getValue("Enabled", enabled);
 
+            // Layers that read the same dataset in the same way share one provider, so
+            // that each tile is only requested, read and cached once
+            std::string datasetKey = path + "|" +
+                std::to_string(initData.minimumPixelSize) + "|" +
+                std::to_string(initData.preprocessTiles);
+
             std::shared_ptr<TileProvider> tileProvider;
-            try {
-                tileProvider = initProvider(path, initData);
+            auto it = _tileProvidersByDataset.find(datasetKey);
+            if (it != _tileProvidersByDataset.end()) {
+                tileProvider = it->second;
             }
-            catch (const ghoul::RuntimeError& e) {
-                LERROR(e.message);
-                continue;
+            else {
+                try {
+                    tileProvider = initProvider(path, initData, _threadPool);
+                }
+                catch (const ghoul::RuntimeError& e) {
+                    LERROR(e.message);
+                    continue;
+                }
+                _tileProvidersByDataset[datasetKey] = tileProvider;
+
+                // Temporal providers read their time steps on their own
+                std::shared_ptr<CachingTileProvider> cachingTileProvider =
+                    std::dynamic_pointer_cast<CachingTileProvider>(tileProvider);
+                if (cachingTileProvider) {
+                    _batchedLayers[tileProvider.get()] = _tileReadBatcher->addLayer(
+                        cachingTileProvider->getAsyncTileReader(),
+                        [cachingTileProvider](std::shared_ptr<TileIOResult> tileIOResult) {
+                            return cachingTileProvider->initializeAndAddToCache(
+                                tileIOResult);
+                        }
+                    );
+                }
             }
             dest.push_back({ name, tileProvider, enabled });
         }
@@ -112,7 +150,7 @@ namespace openspace {
 
 
     std::shared_ptr<TileProvider> TileProviderManager::initProvider(const std::string& file,
-        const TileProviderInitData& initData)
+        const TileProviderInitData& initData, std::shared_ptr<ThreadPool> threadPool)
     {
         std::shared_ptr<TileProvider> tileProvider;
         CPLXMLNode * node = CPLParseXMLFile(file.c_str());
@@ -128,16 +166,13 @@ namespace openspace {
         std::shared_ptr<TileDataset> tileDataset = std::shared_ptr<TileDataset>(
             new TileDataset(file, initData.minimumPixelSize, initData.preprocessTiles));
 
-        std::shared_ptr<ThreadPool> threadPool = std::shared_ptr<ThreadPool>(
-            new ThreadPool(1));
-
         std::shared_ptr<AsyncTileDataProvider> tileReader = std::shared_ptr<AsyncTileDataProvider>(
             new AsyncTileDataProvider(tileDataset, threadPool));
 
         std::shared_ptr<TileCache> tileCache = std::shared_ptr<TileCache>(new TileCache(initData.cacheSize));
 
         tileProvider = std::shared_ptr<TileProvider>(
-            new CachingTileProvider(tileReader, tileCache, initData.framesUntilRequestQueueFlush));
+            new CachingTileProvider(tileReader, tileCache, initData.uploadBudget));
 
         return tileProvider;
     }
@@ -148,13 +183,41 @@ namespace openspace {
     }
 
     void TileProviderManager::prerender() {
-        for (auto layerCategory : _layerCategories) {
-            for (auto tileProviderWithName : layerCategory) {
-                if (tileProviderWithName.isActive) {
-                    tileProviderWithName.tileProvider->prerender();
+        // All layers and time steps upload within one budget per frame
+        _uploadBudget->startFrame();
+
+        // Providers that are shared between layers are active if any of them is
+        std::vector<TileProvider*> activeProviders;
+        std::unordered_set<TileProvider*> uniqueProviders;
+        for (const auto& layerCategory : _layerCategories) {
+            for (const auto& tileProviderWithName : layerCategory) {
+                TileProvider* tileProvider = tileProviderWithName.tileProvider.get();
+                if (tileProviderWithName.isActive &&
+                    uniqueProviders.insert(tileProvider).second)
+                {
+                    activeProviders.push_back(tileProvider);
                 }
             }
         }
+
+        // Disabled layers are not updated, so their requests would never expire
+        for (const auto& batchedLayer : _batchedLayers) {
+            _tileReadBatcher->setLayerActive(
+                batchedLayer.second,
+                uniqueProviders.find(batchedLayer.first) != uniqueProviders.end()
+            );
+        }
+
+        // Publishes and starts the batched reads before the providers start a new frame
+        _tileReadBatcher->update();
+
+        for (TileProvider* tileProvider : activeProviders) {
+            tileProvider->prerender();
+        }
+    }
+
+    const TileReadBatcher& TileProviderManager::getTileReadBatcher() const {
+        return *_tileReadBatcher;
     }
 
     const std::vector<std::shared_ptr<TileProvider> >
@@ -29,6 +29,7 @@
 #include <modules/globebrowsing/tile/temporaltileprovider.h>
 #include <modules/globebrowsing/tile/tileprovider.h>
 #include <modules/globebrowsing/tile/layeredtextures.h>
+#include <modules/globebrowsing/tile/tilereadbatcher.h>
 
 #include <modules/globebrowsing/other/threadpool.h>
 
@@ -38,6 +39,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 
 namespace openspace {
@@ -66,14 +68,35 @@ namespace openspace {
 
         void prerender();
 
+        /**
+            The batcher that reads the tiles of all layers that are not temporal. Its
+            statistics contain the latency from requesting a chunk until the tiles of
+            all layers are available.
+        */
+        const TileReadBatcher& getTileReadBatcher() const;
+
     private:
-        static void initTexures(std::vector<TileProviderWithName>& destination,
+        void initTexures(std::vector<TileProviderWithName>& destination,
             const ghoul::Dictionary& dict, const TileProviderInitData& initData);
 
         static std::shared_ptr<TileProvider> initProvider(const std::string& file, 
-            const TileProviderInitData& initData);
+            const TileProviderInitData& initData, std::shared_ptr<ThreadPool> threadPool);
 
         std::array<LayerCategory, LayeredTextures::NUM_TEXTURE_CATEGORIES> _layerCategories;
+
+        // Providers by dataset file and read settings, used to share providers between
+        // layers that show the same dataset
+        std::unordered_map<std::string, std::shared_ptr<TileProvider>> _tileProvidersByDataset;
+
+        // The index in the batcher of each provider whose tiles are read in batches
+        std::unordered_map<TileProvider*, size_t> _batchedLayers;
+
+        // Limits the tile uploads of the batcher and all providers in a frame
+        std::shared_ptr<TileUploadScheduler::FrameBudget> _uploadBudget;
+
+        // Reads the same chunk for all layers that are not temporal in one job
+        std::shared_ptr<ThreadPool> _threadPool;
+        std::unique_ptr<TileReadBatcher> _tileReadBatcher;
     };
 
 } // namespace openspace
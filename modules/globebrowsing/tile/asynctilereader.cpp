@@ -32,6 +32,9 @@
 
 #include <modules/globebrowsing/geometry/angle.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace {
     const std::string _loggerCat = "AsyncTextureDataProvider";
 }
@@ -47,12 +50,18 @@ namespace openspace {
         std::shared_ptr<ThreadPool> pool)
         : _tileDataset(tileDataset)
         , _concurrentJobManager(pool)
+        , _maximumNumActiveReads(std::max<size_t>(2 * pool->numThreads(), 1))
+        , _numActiveReads(0)
+        , _frame(0)
+        , _isBatched(false)
     {
 
     }
 
     AsyncTileDataProvider::~AsyncTileDataProvider() {
-        
+        for (std::shared_ptr<TileIOResult> tileIOResult : _loadedTiles) {
+            delete[] static_cast<char*>(tileIOResult->imageData);
+        }
     }
 
 
@@ -60,49 +69,200 @@ namespace openspace {
         return _tileDataset;
     }
 
+    const AsyncTileDataProvider::RequestStatistics&
+        AsyncTileDataProvider::getRequestStatistics() const
+    {
+        return _statistics;
+    }
+
+    void AsyncTileDataProvider::setBatched(bool isBatched) {
+        _isBatched = isBatched;
+    }
+
+    bool AsyncTileDataProvider::isBatched() const {
+        return _isBatched;
+    }
+
+    std::vector<ChunkIndex> AsyncTileDataProvider::getQueuedRequests() const {
+        std::vector<ChunkIndex> queuedRequests;
+        for (const auto& request : _enqueuedTileRequests) {
+            if (!request.second.isReading && request.second.lastRequestedFrame == _frame) {
+                queuedRequests.push_back(request.second.chunkIndex);
+            }
+        }
+        return queuedRequests;
+    }
+
+    bool AsyncTileDataProvider::isRequested(const ChunkIndex& chunkIndex) const {
+        auto it = _enqueuedTileRequests.find(chunkIndex.hashKey());
+        return it != _enqueuedTileRequests.end() &&
+            it->second.lastRequestedFrame == _frame;
+    }
+
+    void AsyncTileDataProvider::markAsReading(const ChunkIndex& chunkIndex) {
+        auto it = _enqueuedTileRequests.find(chunkIndex.hashKey());
+        ghoul_assert(it != _enqueuedTileRequests.end(), "The tile is not requested");
+        it->second.isReading = true;
+    }
+
+    void AsyncTileDataProvider::finishBatchedRead(const ChunkIndex& chunkIndex,
+        bool isUsed)
+    {
+        _statistics.numReads++;
+        if (!isUsed) {
+            _statistics.numWastedReads++;
+        }
+        // The request may have been removed by clearRequestQueue in the meantime
+        _enqueuedTileRequests.erase(chunkIndex.hashKey());
+    }
+
     bool AsyncTileDataProvider::enqueueTextureData(const ChunkIndex& chunkIndex) {
-        if (satisfiesEnqueueCriteria(chunkIndex)) {
-            std::shared_ptr<TileLoadJob> job = std::shared_ptr<TileLoadJob>(
-                new TileLoadJob(_tileDataset, chunkIndex));
+        auto it = _enqueuedTileRequests.find(chunkIndex.hashKey());
+        if (it != _enqueuedTileRequests.end()) {
+            it->second.lastRequestedFrame = _frame;
+            _statistics.numRepeatedRequests++;
+            return false;
+        }
 
-            _concurrentJobManager.enqueueJob(job);
-            _enqueuedTileRequests[chunkIndex.hashKey()] = chunkIndex;
+        if (satisfiesEnqueueCriteria(chunkIndex)) {
+            _enqueuedTileRequests[chunkIndex.hashKey()] = { chunkIndex, _frame, false };
+            _statistics.numRequests++;
             return true;
         }
         return false;
     }
 
+    void AsyncTileDataProvider::update() {
+        collectFinishedReads();
+        cancelOldRequests();
+        startReads();
+        _frame++;
+    }
+
     bool AsyncTileDataProvider::hasLoadedTextureData() const{
-        return _concurrentJobManager.numFinishedJobs() > 0;
+        return !_loadedTiles.empty();
     }
     
     std::shared_ptr<TileIOResult> AsyncTileDataProvider::nextTileIOResult() {
-        auto tileIOResult = _concurrentJobManager.popFinishedJob()->product();
-        HashKey key = tileIOResult->chunkIndex.hashKey();
-        if (_enqueuedTileRequests.find(key) != _enqueuedTileRequests.end()) {
-            _enqueuedTileRequests.erase(key);
-        }
+        ghoul_assert(!_loadedTiles.empty(), "There is no loaded tile");
+        std::shared_ptr<TileIOResult> tileIOResult = _loadedTiles.front();
+        _loadedTiles.pop_front();
         return tileIOResult;
     }
 
 
     bool AsyncTileDataProvider::satisfiesEnqueueCriteria(const ChunkIndex& chunkIndex) const {
+        return _enqueuedTileRequests.find(chunkIndex.hashKey()) == _enqueuedTileRequests.end();
+    }
+
+
+    void AsyncTileDataProvider::clearRequestQueue() {
+        size_t numRemovedJobs = _concurrentJobManager.clearEnqueuedJobs();
+        _numActiveReads -= numRemovedJobs;
+        for (const auto& request : _enqueuedTileRequests) {
+            if (!request.second.isReading) {
+                _statistics.numCancelledRequests++;
+            }
+        }
+        _statistics.numCancelledRequests += numRemovedJobs;
+        _enqueuedTileRequests.clear();
+    }
+
+    void AsyncTileDataProvider::collectFinishedReads() {
+        while (_concurrentJobManager.numFinishedJobs() > 0) {
+            std::shared_ptr<TileIOResult> tileIOResult =
+                _concurrentJobManager.popFinishedJob()->product();
+            _numActiveReads--;
+            _statistics.numReads++;
+
+            // Tiles that were not requested in the last frame are no longer needed
+            auto it = _enqueuedTileRequests.find(tileIOResult->chunkIndex.hashKey());
+            bool isRequested = it != _enqueuedTileRequests.end() &&
+                it->second.lastRequestedFrame == _frame;
+            if (it != _enqueuedTileRequests.end()) {
+                _enqueuedTileRequests.erase(it);
+            }
+
+            if (isRequested) {
+                _loadedTiles.push_back(tileIOResult);
+            }
+            else {
+                _statistics.numWastedReads++;
+                delete[] static_cast<char*>(tileIOResult->imageData);
+            }
+        }
+    }
+
+    void AsyncTileDataProvider::cancelOldRequests() {
+        // Requests that are being read can not be cancelled, instead their result is
+        // discarded when it arrives if the tile is still not requested by then
         auto it = _enqueuedTileRequests.begin();
-        auto end = _enqueuedTileRequests.end();
-        for (; it != end; it++) {
-            const ChunkIndex& otherChunk = it->second;
-            if (chunkIndex.level == otherChunk.level &&
-                chunkIndex.manhattan(otherChunk) < 1) {
-                return false;
+        while (it != _enqueuedTileRequests.end()) {
+            if (!it->second.isReading && it->second.lastRequestedFrame != _frame) {
+                it = _enqueuedTileRequests.erase(it);
+                _statistics.numCancelledRequests++;
+            }
+            else {
+                ++it;
             }
         }
-        return true;
     }
 
+    void AsyncTileDataProvider::startReads() {
+        if (_isBatched || _numActiveReads >= _maximumNumActiveReads) {
+            return;
+        }
 
-    void AsyncTileDataProvider::clearRequestQueue() {
-        _concurrentJobManager.clearEnqueuedJobs();
-        _enqueuedTileRequests.clear();
+        // The most detailed requested tile is where the camera is closest to the globe
+        const Request* finestRequest = nullptr;
+        for (const auto& request : _enqueuedTileRequests) {
+            if (!finestRequest ||
+                request.second.chunkIndex.level > finestRequest->chunkIndex.level)
+            {
+                finestRequest = &request.second;
+            }
+        }
+        if (!finestRequest) {
+            return;
+        }
+        Geodetic2 focus = GeodeticPatch(finestRequest->chunkIndex).center();
+
+        std::vector<std::pair<Scalar, Request*>> queuedRequests;
+        for (auto& request : _enqueuedTileRequests) {
+            if (!request.second.isReading) {
+                Scalar distance = GeodeticPatch(request.second.chunkIndex).center()
+                    .angularDistance(focus);
+                queuedRequests.push_back({ distance, &request.second });
+            }
+        }
+
+        size_t numReads = std::min(
+            queuedRequests.size(),
+            _maximumNumActiveReads - _numActiveReads
+        );
+        std::partial_sort(
+            queuedRequests.begin(),
+            queuedRequests.begin() + numReads,
+            queuedRequests.end(),
+            [](const std::pair<Scalar, Request*>& a, const std::pair<Scalar, Request*>& b) {
+                // Parents before children
+                int levelA = a.second->chunkIndex.level;
+                int levelB = b.second->chunkIndex.level;
+                if (levelA != levelB) {
+                    return levelA < levelB;
+                }
+                return a.first < b.first;
+            }
+        );
+
+        for (size_t i = 0; i < numReads; i++) {
+            Request& request = *queuedRequests[i].second;
+            std::shared_ptr<TileLoadJob> job = std::shared_ptr<TileLoadJob>(
+                new TileLoadJob(_tileDataset, request.chunkIndex));
+            _concurrentJobManager.enqueueJob(job);
+            request.isReading = true;
+            _numActiveReads++;
+        }
     }
 
 }  // namespace openspace
@@ -37,9 +37,11 @@
 
 #include <modules/globebrowsing/tile/tiledataset.h>
 
+#include <deque>
 #include <memory>
 #include <queue>
 #include <unordered_map>
+#include <vector>
 
 
 
@@ -79,8 +81,28 @@ namespace openspace {
 
 
 
+    /**
+        Reads tiles of a TileDataset on the threads of a ThreadPool. Requests are kept
+        in a queue that is ordered once per frame in #update and only a few reads are
+        handed to the thread pool at a time. Tiles that are needed have to be requested
+        every frame; requests that are not repeated are cancelled.
+    */
     class AsyncTileDataProvider {
     public:
+        /// Counters that describe how much of the reading was useful
+        struct RequestStatistics {
+            /// Requests that were added to the queue
+            size_t numRequests = 0;
+            /// Requests for tiles that were already queued or being read, usually
+            /// because the tile is still needed in a later frame
+            size_t numRepeatedRequests = 0;
+            /// Requests that were removed from the queue before being read
+            size_t numCancelledRequests = 0;
+            /// Tiles that were read
+            size_t numReads = 0;
+            /// Tiles that were read but no longer requested when the read finished
+            size_t numWastedReads = 0;
+        };
 
         AsyncTileDataProvider(std::shared_ptr<TileDataset> textureDataProvider, 
             std::shared_ptr<ThreadPool> pool);
@@ -88,8 +110,22 @@ namespace openspace {
         ~AsyncTileDataProvider();
 
 
-
+        /**
+            Requests the tile for <code>chunkIndex</code> in the current frame. Returns
+            <code>true</code> if the tile was not requested before.
+        */
         bool enqueueTextureData(const ChunkIndex& chunkIndex);
+
+        /**
+            Starts a new frame. Collects the finished reads, cancels the requests that
+            were not repeated since the previous call and starts reading the most
+            important of the remaining ones: parent tiles before their children, and
+            tiles close to the most detailed requested tile, which is where the camera
+            is closest to the globe, before tiles further away. Batched providers leave
+            the reading to their TileReadBatcher.
+        */
+        void update();
+
         bool hasLoadedTextureData() const;
         std::shared_ptr<TileIOResult> nextTileIOResult();
         
@@ -97,17 +133,57 @@ namespace openspace {
 
         std::shared_ptr<TileDataset> getTextureDataProvider() const;
 
+        const RequestStatistics& getRequestStatistics() const;
+
+        /**
+            Hands the reading over to a TileReadBatcher, which reads the tiles of
+            several providers together. A batched provider keeps track of its requests
+            but does not start any reads of its own.
+        */
+        void setBatched(bool isBatched);
+        bool isBatched() const;
+
+        /// Returns the tiles requested in the current frame that are not being read
+        std::vector<ChunkIndex> getQueuedRequests() const;
+
+        /// Returns <code>true</code> if the tile was requested in the current frame
+        bool isRequested(const ChunkIndex& chunkIndex) const;
+
+        /// Marks a queued request as being read by a TileReadBatcher
+        void markAsReading(const ChunkIndex& chunkIndex);
+
+        /**
+            Ends a read that was started by a TileReadBatcher. The result is published
+            by the batcher and does not end up in the loaded tiles of this provider.
+            \param isUsed <code>false</code> if the read tile is discarded
+        */
+        void finishBatchedRead(const ChunkIndex& chunkIndex, bool isUsed);
+
     protected:
 
         virtual bool satisfiesEnqueueCriteria(const ChunkIndex&) const;
 
     private:
+        struct Request {
+            ChunkIndex chunkIndex;
+            unsigned int lastRequestedFrame;
+            bool isReading;
+        };
+
+        void collectFinishedReads();
+        void cancelOldRequests();
+        void startReads();
 
         std::shared_ptr<TileDataset> _tileDataset;
         ConcurrentJobManager<TileIOResult> _concurrentJobManager;
-        std::unordered_map<HashKey, ChunkIndex> _enqueuedTileRequests;
-
-
+        std::unordered_map<HashKey, Request> _enqueuedTileRequests;
+        std::deque<std::shared_ptr<TileIOResult>> _loadedTiles;
+
+        size_t _maximumNumActiveReads;
+        size_t _numActiveReads;
+        unsigned int _frame;
+        bool _isBatched;
+        RequestStatistics _statistics;
     };
 
 
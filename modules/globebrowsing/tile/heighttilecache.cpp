@@ -0,0 +1,135 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/tile/heighttilecache.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const std::string _loggerCat = "HeightTileCache";
+}
+
+namespace openspace {
+
+    size_t HeightTile::numBytes() const {
+        return heights.size() * sizeof(float);
+    }
+
+    HeightTileCache::HeightTileCache(size_t maximumNumBytes)
+        : _tiles(maximumNumBytes)
+        , _maximumLevel(0)
+    {
+
+    }
+
+    void HeightTileCache::put(std::shared_ptr<const HeightTile> heightTile) {
+        // Declared before the lock so that evicted tiles are freed after unlocking
+        std::vector<std::shared_ptr<const HeightTile>> evicted;
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tiles.put(heightTile->chunkIndex.mortonKey(), heightTile, evicted,
+            heightTile->numBytes());
+        _maximumLevel = std::max(_maximumLevel, heightTile->chunkIndex.level);
+    }
+
+    HeightQueryResult HeightTileCache::getHeight(const Geodetic2& position) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return findHeight(position);
+    }
+
+    void HeightTileCache::getHeights(const std::vector<Geodetic2>& positions,
+        std::vector<HeightQueryResult>& results)
+    {
+        results.resize(positions.size());
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 0; i < positions.size(); ++i) {
+            results[i] = findHeight(positions[i]);
+        }
+    }
+
+    size_t HeightTileCache::numTiles() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _tiles.size();
+    }
+
+    size_t HeightTileCache::numBytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _tiles.totalCost();
+    }
+
+    HeightQueryResult HeightTileCache::findHeight(const Geodetic2& position) {
+        if (_maximumLevel < 1) {
+            return { 0.0f, -1 };
+        }
+
+        // The chunk at the most detailed level, clamped so that positions on the
+        // date line and at the south pole belong to a chunk
+        ChunkIndex chunkIndex(position, _maximumLevel);
+        chunkIndex.x = glm::clamp(chunkIndex.x, 0, (1 << _maximumLevel) - 1);
+        chunkIndex.y = glm::clamp(chunkIndex.y, 0, (1 << (_maximumLevel - 1)) - 1);
+
+        // Walk towards the roots until a tile covering the position is found
+        MortonKey key = chunkIndex.mortonKey();
+        for (int level = _maximumLevel; level >= 1; --level, key >>= 2) {
+            if (_tiles.exist(key)) {
+                std::shared_ptr<const HeightTile> heightTile = _tiles.get(key);
+                return { sampleBilinear(*heightTile, position), level };
+            }
+        }
+        return { 0.0f, -1 };
+    }
+
+    float HeightTileCache::sampleBilinear(const HeightTile& heightTile,
+        const Geodetic2& position)
+    {
+        GeodeticPatch patch(heightTile.chunkIndex);
+        Geodetic2 northWest = patch.getCorner(Quad::NORTH_WEST);
+        Geodetic2 size = patch.size();
+
+        // Texel centers are at half integer coordinates, as for a texture lookup
+        double u = (position.lon - northWest.lon) / size.lon;
+        double v = (northWest.lat - position.lat) / size.lat;
+        double px = u * heightTile.dimensions.x - 0.5;
+        double py = v * heightTile.dimensions.y - 0.5;
+
+        int maxX = static_cast<int>(heightTile.dimensions.x) - 1;
+        int maxY = static_cast<int>(heightTile.dimensions.y) - 1;
+        px = glm::clamp(px, 0.0, static_cast<double>(maxX));
+        py = glm::clamp(py, 0.0, static_cast<double>(maxY));
+
+        int x0 = static_cast<int>(std::floor(px));
+        int y0 = static_cast<int>(std::floor(py));
+        int x1 = std::min(x0 + 1, maxX);
+        int y1 = std::min(y0 + 1, maxY);
+        float fx = static_cast<float>(px - x0);
+        float fy = static_cast<float>(py - y0);
+
+        const std::vector<float>& h = heightTile.heights;
+        size_t width = heightTile.dimensions.x;
+        float north = h[y0 * width + x0] * (1 - fx) + h[y0 * width + x1] * fx;
+        float south = h[y1 * width + x0] * (1 - fx) + h[y1 * width + x1] * fx;
+        return north * (1 - fy) + south * fy;
+    }
+
+} // namespace openspace
@@ -0,0 +1,105 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __HEIGHT_TILE_CACHE_H__
+#define __HEIGHT_TILE_CACHE_H__
+
+#include <modules/globebrowsing/chunk/chunkindex.h>
+#include <modules/globebrowsing/geometry/geodetic2.h>
+#include <modules/globebrowsing/other/lrucache.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace openspace {
+
+    /**
+        The heights of a tile of a height map, kept on the CPU after the tile has been
+        read. Only the first raster is kept and the values are converted to meters.
+    */
+    struct HeightTile {
+        ChunkIndex chunkIndex;
+        glm::uvec2 dimensions;
+
+        // Row by row, starting at the northern edge of the chunk
+        std::vector<float> heights;
+
+        size_t numBytes() const;
+    };
+
+    struct HeightQueryResult {
+        float height;
+
+        // The level of the tile that the height was sampled from or -1 if no tile
+        // covering the position has been read
+        int level;
+    };
+
+    /**
+        Answers height queries for a height map from the tiles that have been read for
+        rendering, without going through the GPU. The cache is bounded in bytes and
+        the least recently used tiles are removed first. A query uses the most detailed
+        tile that covers the position and interpolates bilinearly between its samples
+        in the same way as the texture lookup in the shaders.
+
+        All methods are thread safe, so queries can be made from worker threads while
+        the render thread adds tiles.
+    */
+    class HeightTileCache {
+    public:
+        static const size_t DefaultSize = 32 * 1024 * 1024;
+
+        HeightTileCache(size_t maximumNumBytes = DefaultSize);
+
+        void put(std::shared_ptr<const HeightTile> heightTile);
+
+        HeightQueryResult getHeight(const Geodetic2& position);
+
+        /**
+            Answers a batch of queries while locking the cache only once.
+            <code>results</code> is resized to the number of positions.
+        */
+        void getHeights(const std::vector<Geodetic2>& positions,
+            std::vector<HeightQueryResult>& results);
+
+        size_t numTiles() const;
+        size_t numBytes() const;
+
+        /// Samples the tile bilinearly, clamping to the edges of the tile
+        static float sampleBilinear(const HeightTile& heightTile, const Geodetic2& position);
+
+    private:
+        HeightQueryResult findHeight(const Geodetic2& position);
+
+        mutable std::mutex _mutex;
+        LRUCache<MortonKey, std::shared_ptr<const HeightTile>> _tiles;
+
+        // The most detailed level of any tile that has been added
+        int _maximumLevel;
+    };
+
+} // namespace openspace
+
+#endif  // __HEIGHT_TILE_CACHE_H__
@@ -55,7 +55,14 @@ namespace openspace {
     TemporalTileProvider::TemporalTileProvider(const std::string& datasetFile, 
         const TileProviderInitData& tileProviderInitData)
         : _datasetFile(datasetFile)
+        , _tileProviderMap(tileProviderInitData.maximumTimeSteps)
         , _tileProviderInitData(tileProviderInitData)
+        , _threadPool(std::make_shared<ThreadPool>(tileProviderInitData.threads))
+        , _tileCache(std::make_shared<TileCache>(tileProviderInitData.cacheSize))
+        , _nextCacheId(0)
+        , _hasUnavailableTiles(false)
+        , _updateCount(0)
+        , _currentProviderUpdateCount(0)
     {
         std::ifstream in(datasetFile.c_str());
         ghoul_assert(errno == 0, strerror(errno) << std::endl << datasetFile);
@@ -131,14 +138,70 @@ namespace openspace {
             prerender();
         }
 
-        return _currentTileProvider->getTile(chunkIndex);
+        Tile tile = _currentTileProvider->getTile(chunkIndex);
+        _requestedChunks[chunkIndex.hashKey()] = chunkIndex;
+        if (tile.status == Tile::Status::Unavailable) {
+            _hasUnavailableTiles = true;
+        }
+        return tile;
     }
 
 
 
     void TemporalTileProvider::prerender() {
+        std::shared_ptr<TileProvider> previousTileProvider = _currentTileProvider;
         _currentTileProvider = getTileProvider();
         _currentTileProvider->prerender();
+
+        int currentProviderUpdateCount = _currentTileProvider->getUpdateCount();
+        if (_currentTileProvider != previousTileProvider ||
+            currentProviderUpdateCount != _currentProviderUpdateCount)
+        {
+            _currentProviderUpdateCount = currentProviderUpdateCount;
+            _updateCount++;
+        }
+
+        prefetchTimeSteps();
+        _requestedChunks.clear();
+        _hasUnavailableTiles = false;
+    }
+
+    void TemporalTileProvider::prefetchTimeSteps() {
+        const Time& time = Time::ref();
+        if (_tileProviderInitData.prefetchTimeSteps <= 0 || time.paused() ||
+            time.deltaTime() == 0.0)
+        {
+            return;
+        }
+
+        double step = time.deltaTime() > 0.0 ?
+            _timeQuantizer.resolution() : -_timeQuantizer.resolution();
+
+        std::shared_ptr<TileProvider> previousProvider = _currentTileProvider;
+        for (int i = 1; i <= _tileProviderInitData.prefetchTimeSteps; i++) {
+            std::shared_ptr<CachingTileProvider> provider = getTileProvider(
+                Time(time.unsyncedJ2000Seconds() + i * step));
+
+            // Time steps beyond the end of the dataset are clamped to the last one
+            if (!provider || provider == previousProvider) {
+                break;
+            }
+            previousProvider = provider;
+
+            // Upload the tiles that have been read since the last frame
+            provider->prerender();
+
+            // Tiles of the current time step are read first
+            if (!_hasUnavailableTiles) {
+                for (const auto& requested : _requestedChunks) {
+                    provider->getTile(requested.second);
+                }
+            }
+        }
+    }
+
+    int TemporalTileProvider::getUpdateCount() {
+        return _updateCount;
     }
 
     std::shared_ptr<AsyncTileDataProvider> TemporalTileProvider::getAsyncTileReader() {
@@ -150,6 +213,15 @@ namespace openspace {
         return _currentTileProvider->getAsyncTileReader();
     }
 
+    std::shared_ptr<HeightTileCache> TemporalTileProvider::getHeightTileCache() {
+        if (_currentTileProvider == nullptr) {
+            LDEBUG("Warning: had to call prerender from getHeightTileCache()");
+            prerender();
+        }
+
+        return _currentTileProvider->getHeightTileCache();
+    }
+
 
     std::shared_ptr<CachingTileProvider> TemporalTileProvider::getTileProvider(Time t) {
         Time tCopy(t);
@@ -168,13 +240,13 @@ namespace openspace {
 
 
     std::shared_ptr<CachingTileProvider> TemporalTileProvider::getTileProvider(TimeKey timekey) {
-        auto it = _tileProviderMap.find(timekey);
-        if (it != _tileProviderMap.end()) {
-            return it->second;
+        if (_tileProviderMap.exist(timekey)) {
+            return _tileProviderMap.get(timekey);
         }
         else {
+            // Evicts the least recently used time step if there are too many
             auto tileProvider = initTileProvider(timekey);
-            _tileProviderMap[timekey] = tileProvider;
+            _tileProviderMap.put(timekey, tileProvider);
             return tileProvider;
         }
     }
@@ -188,17 +260,14 @@ namespace openspace {
                 _tileProviderInitData.minimumPixelSize,
                 _tileProviderInitData.preprocessTiles));
 
-        std::shared_ptr<ThreadPool> threadPool = std::shared_ptr<ThreadPool>(
-            new ThreadPool(_tileProviderInitData.threads));
-
         std::shared_ptr<AsyncTileDataProvider> tileReader = std::shared_ptr<AsyncTileDataProvider>(
-            new AsyncTileDataProvider(tileDataset, threadPool));
-
-        std::shared_ptr<TileCache> tileCache = std::shared_ptr<TileCache>(new TileCache(_tileProviderInitData.cacheSize));
+            new AsyncTileDataProvider(tileDataset, _threadPool));
 
+        // Cache ids are never reused. The tiles of an evicted time step can not be
+        // reached anymore and age out of the shared cache
         std::shared_ptr<CachingTileProvider> tileProvider= std::shared_ptr<CachingTileProvider>(
-            new CachingTileProvider(tileReader, tileCache,
-                _tileProviderInitData.framesUntilRequestQueueFlush));
+            new CachingTileProvider(tileReader, _tileCache,
+                _tileProviderInitData.uploadBudget, _nextCacheId++));
 
         return tileProvider;
     }
@@ -302,6 +371,10 @@ namespace openspace {
         }
     }
 
+    double TimeQuantizer::resolution() const {
+        return _resolution;
+    }
+
     bool TimeQuantizer::quantize(Time& t) const {
         double unquantized = t.unsyncedJ2000Seconds();
         if (_start <= unquantized && unquantized <= _end) {
@@ -51,9 +51,17 @@ namespace openspace {
     struct TileProviderInitData {
         int minimumPixelSize;
         int threads;
-        int cacheSize;
-        int framesUntilRequestQueueFlush;
+        // Maximum size of the tile cache in bytes
+        size_t cacheSize;
         bool preprocessTiles = false;
+
+        // Number of upcoming time steps that are prefetched by temporal providers
+        int prefetchTimeSteps = 2;
+        // Maximum number of time steps for which temporal providers keep datasets open
+        int maximumTimeSteps = 8;
+
+        // Upload budget shared by all providers of a globe, started once per frame
+        std::shared_ptr<TileUploadScheduler::FrameBudget> uploadBudget;
     };
 
 
@@ -100,6 +108,9 @@ namespace openspace {
 
         bool quantize(Time& t) const;
 
+        /// Returns the length of a time step in seconds
+        double resolution() const;
+
     private:
         double _start;
         double _end;
@@ -113,6 +124,13 @@ namespace openspace {
     //                              Temporal tile Provider                              //
     //////////////////////////////////////////////////////////////////////////////////////
 
+    /**
+        Provides tiles of a GDAL dataset whose contents depend on time. Each quantized
+        time step has its own CachingTileProvider, but they all read tiles on the same
+        threads and share a tile cache that is bounded in bytes. Only the most recently
+        used time steps are kept and tiles for the next time steps in the direction of
+        playback are prefetched.
+    */
     class TemporalTileProvider : public TileProvider {
     public:
         TemporalTileProvider(const std::string& datasetFile, const TileProviderInitData& tileProviderInitData);
@@ -125,6 +143,8 @@ namespace openspace {
         virtual TileDepthTransform depthTransform();
         virtual void prerender();
         virtual std::shared_ptr<AsyncTileDataProvider> getAsyncTileReader();
+        virtual std::shared_ptr<HeightTileCache> getHeightTileCache();
+        virtual int getUpdateCount();
 
 
 
@@ -145,6 +165,12 @@ namespace openspace {
         
         std::shared_ptr<CachingTileProvider> initTileProvider(TimeKey timekey);
 
+        /**
+            Requests the tiles that were used in the last frame from the providers of
+            the upcoming time steps.
+        */
+        void prefetchTimeSteps();
+
         std::string consumeTemporalMetaData(const std::string &xml);
         std::string getXMLValue(CPLXMLNode*, const std::string& key, const std::string& defaultVal);
 
@@ -155,11 +181,24 @@ namespace openspace {
         const std::string _datasetFile;
         std::string _gdalXmlTemplate;
 
-        std::unordered_map<TimeKey, std::shared_ptr<CachingTileProvider> > _tileProviderMap;
+        LRUCache<TimeKey, std::shared_ptr<CachingTileProvider> > _tileProviderMap;
         TileProviderInitData _tileProviderInitData;
 
+        // Shared by the providers of all time steps
+        std::shared_ptr<ThreadPool> _threadPool;
+        std::shared_ptr<TileCache> _tileCache;
+        unsigned int _nextCacheId;
+
+        // Tiles requested from the current provider since the last prerender
+        std::unordered_map<HashKey, ChunkIndex> _requestedChunks;
+        bool _hasUnavailableTiles;
+
         std::shared_ptr<TileProvider> _currentTileProvider;
 
+        // Changes when the current provider changes or when it reports new tiles
+        int _updateCount;
+        int _currentProviderUpdateCount;
+
         TimeFormat * _timeFormat;
         TimeQuantizer _timeQuantizer;
     };
@@ -34,6 +34,9 @@
 
 #include <float.h>
 
+#include <algorithm>
+#include <cmath>
+
 
 
 namespace {
@@ -52,6 +55,8 @@ namespace openspace {
         : _minimumPixelSize(minimumPixelSize)
         , _doPreprocessing(doPreprocessing)
         , _maxLevel(-1)
+        , _gdalDatasetDesc(gdalDatasetDesc)
+        , _numOpenDatasets(0)
     {
         if (!GdalHasBeenInitialized) {
             GDALAllRegister();
@@ -60,21 +65,80 @@ namespace openspace {
             GdalHasBeenInitialized = true;
         }
 
-        _dataset = (GDALDataset *)GDALOpen(gdalDatasetDesc.c_str(), GA_ReadOnly);
-        if (!_dataset) {
+        GDALDataset* dataset = openDataset();
+        if (!dataset) {
             throw ghoul::RuntimeError("Failed to load dataset:\n" + gdalDatasetDesc);
         }
-        //ghoul_assert(_dataset != nullptr, "Failed to load dataset:\n" << gdalDatasetDesc);
-        _dataLayout = DataLayout(_dataset, dataType);
 
-        _depthTransform = calculateTileDepthTransform();
-        _tileLevelDifference = calculateTileLevelDifference(_dataset, minimumPixelSize);
+        // All meta data is computed once from the first handle and shared by all
+        // handles that are opened later on
+        _dataLayout = DataLayout(dataset, dataType);
+
+        CPLErr err = dataset->GetGeoTransform(_geoTransform.data());
+        ghoul_assert(err != CE_Failure, "Failed to get transform");
+
+        GDALRasterBand* firstBand = dataset->GetRasterBand(1);
+        _numOverviews = firstBand->GetOverviewCount();
+        _sizeLevel0 = firstBand->GetOverview(_numOverviews - 1)->GetXSize();
+
+        _depthTransform = calculateTileDepthTransform(dataset);
+        _tileLevelDifference = calculateTileLevelDifference(dataset, minimumPixelSize);
         _maxLevel = calculateMaxLevel(_tileLevelDifference);
+
+        _numOpenDatasets = 1;
+        _idleDatasets.push_back(dataset);
     }
 
 
     TileDataset::~TileDataset() {
-        delete _dataset;
+        std::lock_guard<std::mutex> lock(_datasetMutex);
+        ghoul_assert(
+            _idleDatasets.size() == _numOpenDatasets,
+            "Datasets must not be in use when the TileDataset is destroyed"
+        );
+        for (GDALDataset* dataset : _idleDatasets) {
+            GDALClose(dataset);
+        }
+    }
+
+    GDALDataset* TileDataset::openDataset() const {
+        return static_cast<GDALDataset*>(GDALOpen(_gdalDatasetDesc.c_str(), GA_ReadOnly));
+    }
+
+    GDALDataset* TileDataset::checkOutDataset() {
+        std::unique_lock<std::mutex> lock(_datasetMutex);
+        if (_idleDatasets.empty()) {
+            // Open the new handle without holding the lock as opening a dataset might
+            // take a while, for example for remote datasets
+            ++_numOpenDatasets;
+            lock.unlock();
+            GDALDataset* dataset = openDataset();
+            if (dataset) {
+                return dataset;
+            }
+
+            LWARNING("Failed to open additional handle to dataset: " << _gdalDatasetDesc);
+            lock.lock();
+            --_numOpenDatasets;
+            _datasetReturned.wait(lock, [this]() { return !_idleDatasets.empty(); });
+        }
+
+        GDALDataset* dataset = _idleDatasets.back();
+        _idleDatasets.pop_back();
+        return dataset;
+    }
+
+    void TileDataset::checkInDataset(GDALDataset* dataset) {
+        {
+            std::lock_guard<std::mutex> lock(_datasetMutex);
+            _idleDatasets.push_back(dataset);
+        }
+        _datasetReturned.notify_one();
+    }
+
+    size_t TileDataset::getNumberOfOpenDatasets() const {
+        std::lock_guard<std::mutex> lock(_datasetMutex);
+        return _numOpenDatasets;
     }
 
     int TileDataset::calculateTileLevelDifference(GDALDataset* dataset, int minimumPixelSize) {
@@ -85,13 +149,12 @@ namespace openspace {
     }
 
     int TileDataset::calculateMaxLevel(int calculateMaxLevel) {
-        int numOverviews = _dataset->GetRasterBand(1)->GetOverviewCount();
-        _maxLevel = numOverviews - 1 - _tileLevelDifference;
+        _maxLevel = _numOverviews - 1 - _tileLevelDifference;
         return _maxLevel;
     }
 
-    TileDepthTransform TileDataset::calculateTileDepthTransform() {
-        GDALRasterBand* firstBand = _dataset->GetRasterBand(1);
+    TileDepthTransform TileDataset::calculateTileDepthTransform(GDALDataset* dataset) {
+        GDALRasterBand* firstBand = dataset->GetRasterBand(1);
         // Floating point types does not have a fix maximum or minimum value and
         // can not be normalized when sampling a texture. Hence no rescaling is needed.
         double maximumValue = (_dataLayout.gdalType == GDT_Float32 || _dataLayout.gdalType == GDT_Float64) ?
@@ -113,16 +176,20 @@ namespace openspace {
 
     std::shared_ptr<TileIOResult> TileDataset::readTileData(ChunkIndex chunkIndex)
     {               
-        GdalDataRegion region(_dataset, chunkIndex, _tileLevelDifference);
+        GdalDataRegion region(*this, chunkIndex);
         size_t bytesPerLine = _dataLayout.bytesPerPixel * region.numPixels.x;
         size_t totalNumBytes = bytesPerLine * region.numPixels.y;
         char* imageData = new char[totalNumBytes];
 
         CPLErr worstError = CPLErr::CE_None;
 
+        // Each thread reads through its own handle as a GDALDataset must not be
+        // accessed concurrently
+        GDALDataset* dataset = checkOutDataset();
+
         // Read the data (each rasterband is a separate channel)
         for (size_t i = 0; i < _dataLayout.numRasters; i++) {
-            GDALRasterBand* rasterBand = _dataset->GetRasterBand(i + 1)->GetOverview(region.overview);
+            GDALRasterBand* rasterBand = dataset->GetRasterBand(i + 1)->GetOverview(region.overview);
             
             char* dataDestination = imageData + (i * _dataLayout.bytesPerDatum);
             
@@ -143,12 +210,17 @@ namespace openspace {
             worstError = std::max(worstError, err);
         }
 
+        checkInDataset(dataset);
+
         std::shared_ptr<TileIOResult> result(new TileIOResult);
         result->chunkIndex = chunkIndex;
         result->imageData = getImageDataFlippedY(region, _dataLayout, imageData);
         result->dimensions = glm::uvec3(region.numPixels, 1);
         if (_doPreprocessing) {
             result->preprocessData = preprocess(imageData, region, _dataLayout);
+            if (worstError == CE_None) {
+                result->heightTile = createHeightTile(imageData, region);
+            }
         }
         result->error = worstError;
 
@@ -156,6 +228,31 @@ namespace openspace {
         return result;
     }
 
+    std::shared_ptr<HeightTile> TileDataset::createHeightTile(const char* imageData,
+        const GdalDataRegion& region) const
+    {
+        std::shared_ptr<HeightTile> heightTile(new HeightTile);
+        heightTile->chunkIndex = region.chunkIndex;
+        heightTile->dimensions = region.numPixels;
+        heightTile->heights.resize(region.numPixels.x * region.numPixels.y);
+
+        // Integer data is normalized when sampled as a texture, and the depth transform
+        // is scaled accordingly
+        bool isFloat =
+            _dataLayout.gdalType == GDT_Float32 || _dataLayout.gdalType == GDT_Float64;
+        float normalization = isFloat ?
+            1.0f : 1.0f / getMaximumValue(_dataLayout.gdalType);
+
+        // The image data is read top to bottom, which is the order of the heights
+        for (size_t i = 0; i < heightTile->heights.size(); i++) {
+            float value = readFloat(_dataLayout.gdalType,
+                imageData + i * _dataLayout.bytesPerPixel);
+            heightTile->heights[i] = _depthTransform.depthOffset +
+                _depthTransform.depthScale * value * normalization;
+        }
+        return heightTile;
+    }
+
     char* TileDataset::getImageDataFlippedY(const GdalDataRegion& region,
         const DataLayout& dataLayout, const char* imageData) 
     {
@@ -219,6 +316,40 @@ namespace openspace {
             }
         }
 
+        // Compares the values at odd rows or columns with the interpolation of their
+        // neighbours at even rows and columns
+        preprocessData->geometricErrors.assign(dataLayout.numRasters, 0.0f);
+        auto value = [&](size_t x, size_t y, size_t c) {
+            return readFloat(dataLayout.gdalType, &(imageData[y * bytesPerLine +
+                x * dataLayout.bytesPerPixel + c * dataLayout.bytesPerDatum]));
+        };
+        for (size_t y = 0; y + 1 < region.numPixels.y; y++) {
+            for (size_t x = 0; x + 1 < region.numPixels.x; x++) {
+                bool oddX = x % 2 == 1;
+                bool oddY = y % 2 == 1;
+                if (!oddX && !oddY) {
+                    continue;
+                }
+                for (size_t c = 0; c < dataLayout.numRasters; c++) {
+                    float interpolated;
+                    if (oddX && oddY) {
+                        interpolated = 0.25f * (
+                            value(x - 1, y - 1, c) + value(x + 1, y - 1, c) +
+                            value(x - 1, y + 1, c) + value(x + 1, y + 1, c));
+                    }
+                    else if (oddX) {
+                        interpolated = 0.5f * (value(x - 1, y, c) + value(x + 1, y, c));
+                    }
+                    else {
+                        interpolated = 0.5f * (value(x, y - 1, c) + value(x, y + 1, c));
+                    }
+                    float error = std::abs(value(x, y, c) - interpolated);
+                    preprocessData->geometricErrors[c] =
+                        std::max(error, preprocessData->geometricErrors[c]);
+                }
+            }
+        }
+
         return std::shared_ptr < TilePreprocessData>(preprocessData);
     }
 
@@ -288,11 +419,8 @@ namespace openspace {
 
 
     
-    glm::uvec2 TileDataset::geodeticToPixel(GDALDataset* dataSet, const Geodetic2& geo) {
-        double padfTransform[6];
-        CPLErr err = dataSet->GetGeoTransform(padfTransform);
-
-        ghoul_assert(err != CE_Failure, "Failed to get transform");
+    glm::uvec2 TileDataset::geodeticToPixel(const Geodetic2& geo) const {
+        const double* padfTransform = _geoTransform.data();
 
         Scalar Y = Angle<Scalar>::fromRadians(geo.lat).asDegrees();
         Scalar X = Angle<Scalar>::fromRadians(geo.lon).asDegrees();
@@ -302,8 +430,8 @@ namespace openspace {
         // Yp = padfTransform[3] + P*padfTransform[4] + L*padfTransform[5];
 
         // <=>
-        double* a = &(padfTransform[0]);
-        double* b = &(padfTransform[3]);
+        const double* a = &(padfTransform[0]);
+        const double* b = &(padfTransform[3]);
 
         // Xp = a[0] + P*a[1] + L*a[2];
         // Yp = b[0] + P*b[1] + L*b[2];
@@ -427,17 +555,14 @@ namespace openspace {
     }
 
 
-    TileDataset::GdalDataRegion::GdalDataRegion(GDALDataset * dataSet,
-        const ChunkIndex& chunkIndex, int tileLevelDifference)
+    TileDataset::GdalDataRegion::GdalDataRegion(const TileDataset& tileDataset,
+        const ChunkIndex& chunkIndex)
         : chunkIndex(chunkIndex)
     {
-
-        GDALRasterBand* firstBand = dataSet->GetRasterBand(1);
-
         // Assume all raster bands have the same data type
 
         // Level = overviewCount - overview (default, levels may be overridden)
-        int numOverviews = firstBand->GetOverviewCount();
+        int numOverviews = tileDataset._numOverviews;
 
 
         // Generate a patch from the chunkIndex, extract the bounds which
@@ -446,14 +571,15 @@ namespace openspace {
         // at overview 0
         GeodeticPatch patch = GeodeticPatch(chunkIndex);
 
-        glm::uvec2 pixelStart0 = geodeticToPixel(dataSet, patch.getCorner(Quad::NORTH_WEST));
-        glm::uvec2 pixelEnd0 = geodeticToPixel(dataSet, patch.getCorner(Quad::SOUTH_EAST));
+        glm::uvec2 pixelStart0 = tileDataset.geodeticToPixel(patch.getCorner(Quad::NORTH_WEST));
+        glm::uvec2 pixelEnd0 = tileDataset.geodeticToPixel(patch.getCorner(Quad::SOUTH_EAST));
         glm::uvec2 numPixels0 = pixelEnd0 - pixelStart0;
 
         // Calculate a suitable overview to choose from the GDAL dataset
         int minNumPixels0 = glm::min(numPixels0.x, numPixels0.y);
-        int sizeLevel0 = firstBand->GetOverview(numOverviews - 1)->GetXSize();
-        int ov = std::log2(minNumPixels0) - std::log2(sizeLevel0 + 1) - tileLevelDifference;
+        int sizeLevel0 = tileDataset._sizeLevel0;
+        int ov = std::log2(minNumPixels0) - std::log2(sizeLevel0 + 1) -
+            tileDataset._tileLevelDifference;
         ov = glm::clamp(ov, 0, numOverviews - 1);
 
         // Convert the interval [pixelStart0, pixelEnd0] to pixel space at 
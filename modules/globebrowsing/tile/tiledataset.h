@@ -31,13 +31,18 @@
 
 #include <modules/globebrowsing/geometry/geodetic2.h>
 #include <modules/globebrowsing/other/threadpool.h>
+#include <modules/globebrowsing/tile/heighttilecache.h>
 
 #include "gdal_priv.h"
 
 
+#include <array>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <queue>
+#include <vector>
 
 
 
@@ -47,6 +52,14 @@ namespace openspace {
     struct TilePreprocessData {
         std::vector<float> maxValues;
         std::vector<float> minValues;
+
+        /**
+         * The largest difference between a value and the bilinear interpolation of its
+         * neighbours at half the resolution of the tile. A measure of how much detail
+         * is lost if the tile is represented with fewer samples, which is close to zero
+         * for flat regions.
+         */
+        std::vector<float> geometricErrors;
     };
 
     struct TextureFormat {
@@ -58,6 +71,9 @@ namespace openspace {
         void* imageData;
         glm::uvec3 dimensions;
         std::shared_ptr<TilePreprocessData> preprocessData;
+
+        // CPU copy of the heights, only for preprocessed tiles which are height maps
+        std::shared_ptr<HeightTile> heightTile;
         ChunkIndex chunkIndex;
         CPLErr error;
     };
@@ -77,7 +93,9 @@ namespace openspace {
         
         /**
         * Opens a GDALDataset in readonly mode and calculates meta data required for 
-        * reading tile using a ChunkIndex.
+        * reading tile using a ChunkIndex. GDAL datasets can not be used from several 
+        * threads at once, so additional handles to the same dataset are opened when
+        * tiles are read concurrently. The meta data is shared between all handles.
         *
         * \param gdalDatasetDesc  - A path to a specific file or raw XML describing the dataset 
         * \param minimumPixelSize - minimum number of pixels per side per tile requested 
@@ -105,10 +123,17 @@ namespace openspace {
 
 
        
+        /**
+        * Reads the tile for <code>chunkIndex</code>. This method is thread-safe; every
+        * concurrent call reads through its own GDALDataset handle.
+        */
         std::shared_ptr<TileIOResult> readTileData(ChunkIndex chunkIndex);
 
         int getMaximumLevel() const;
 
+        /// Returns the number of GDALDataset handles that are currently open
+        size_t getNumberOfOpenDatasets() const;
+
         TileDepthTransform getDepthTransform() const;
 
         const DataLayout& getDataLayout() const;
@@ -118,8 +143,7 @@ namespace openspace {
 
         struct GdalDataRegion {
 
-            GdalDataRegion(GDALDataset* dataSet, const ChunkIndex& chunkIndex,
-                int tileLevelDifference);
+            GdalDataRegion(const TileDataset& tileDataset, const ChunkIndex& chunkIndex);
 
             const ChunkIndex chunkIndex;
 
@@ -139,14 +163,25 @@ namespace openspace {
         //                             HELPER FUNCTIONS                                 //
         //////////////////////////////////////////////////////////////////////////////////
 
+        GDALDataset* openDataset() const;
+
+        /**
+        * Returns a dataset handle that is not used by any other thread, opening a new
+        * one if all are in use. If no new handle can be opened, this waits until
+        * another thread returns one.
+        */
+        GDALDataset* checkOutDataset();
+
+        void checkInDataset(GDALDataset* dataset);
+
         int calculateMaxLevel(int calculateMaxLevel);
 
-        TileDepthTransform calculateTileDepthTransform();
+        TileDepthTransform calculateTileDepthTransform(GDALDataset* dataset);
 
 
         static int calculateTileLevelDifference(GDALDataset* dataset, int minimumPixelSize);
 
-        static glm::uvec2 geodeticToPixel(GDALDataset* dataSet, const Geodetic2& geo);
+        glm::uvec2 geodeticToPixel(const Geodetic2& geo) const;
 
         static GLuint getOpenGLDataType(GDALDataType gdalType);
 
@@ -159,6 +194,10 @@ namespace openspace {
         std::shared_ptr<TilePreprocessData> preprocess(const char* imageData,
             const GdalDataRegion& region, const DataLayout& dataLayout);
 
+        /// Converts the first raster to heights in meters using the depth transform
+        std::shared_ptr<HeightTile> createHeightTile(const char* imageData,
+            const GdalDataRegion& region) const;
+
         typedef std::function<float(const char*)> ValueReader;
         static ValueReader getValueReader(GDALDataType gdalType);
 
@@ -183,9 +222,18 @@ namespace openspace {
 
         TileDepthTransform _depthTransform;
 
-        GDALDataset* _dataset;
+        // Meta data that is shared between all handles
+        std::string _gdalDatasetDesc;
+        std::array<double, 6> _geoTransform;
+        int _numOverviews;
+        int _sizeLevel0;
         DataLayout _dataLayout;
 
+        mutable std::mutex _datasetMutex;
+        std::condition_variable _datasetReturned;
+        std::vector<GDALDataset*> _idleDatasets;
+        size_t _numOpenDatasets;
+
         bool _doPreprocessing;
     };
 
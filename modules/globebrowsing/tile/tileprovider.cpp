@@ -35,6 +35,7 @@
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 
+#include <algorithm>
 #include <sstream>
 
 
@@ -42,6 +43,8 @@
 
 namespace {
     const std::string _loggerCat = "TileProvider";
+
+    const size_t MaximumTexturePoolSize = 64;
 }
 
 
@@ -53,10 +56,15 @@ namespace openspace {
 
     CachingTileProvider::CachingTileProvider(std::shared_ptr<AsyncTileDataProvider> tileReader, 
         std::shared_ptr<TileCache> tileCache,
-        int framesUntilFlushRequestQueue)
+        std::shared_ptr<TileUploadScheduler::FrameBudget> uploadBudget,
+        unsigned int cacheId)
         : _asyncTextureDataProvider(tileReader)
         , _tileCache(tileCache)
-        , _framesSinceLastRequestFlush(0)
+        , _cacheId(cacheId)
+        , _updateCount(0)
+        , _uploadScheduler(uploadBudget ?
+            TileUploadScheduler(uploadBudget) : TileUploadScheduler())
+        , _heightTileCache(std::make_shared<HeightTileCache>())
     {
         
     }
@@ -68,16 +76,23 @@ namespace openspace {
 
 
     void CachingTileProvider::prerender() {
+        // Cancels the requests for tiles that were not needed in the last frame
+        _asyncTextureDataProvider->update();
         initTexturesFromLoadedData();
-        if (_framesSinceLastRequestFlush++ > _framesUntilRequestFlush) {
-            clearRequestQueue();
-        }
     }
 
     std::shared_ptr<AsyncTileDataProvider> CachingTileProvider::getAsyncTileReader() {
         return _asyncTextureDataProvider;
     }
 
+    std::shared_ptr<HeightTileCache> CachingTileProvider::getHeightTileCache() {
+        return _heightTileCache;
+    }
+
+    int CachingTileProvider::getUpdateCount() {
+        return _updateCount;
+    }
+
     Tile CachingTileProvider::getTile(const ChunkIndex& chunkIndex) {
         Tile tile = Tile::TileUnavailable;
 
@@ -87,29 +102,39 @@ namespace openspace {
             return tile;
         }
 
-        HashKey key = chunkIndex.hashKey();
+        TileCacheKey key = cacheKey(chunkIndex);
 
         if (_tileCache->exist(key)) {
             return _tileCache->get(key);
         }
         else {
-            _asyncTextureDataProvider->enqueueTextureData(chunkIndex);
+            requestTile(chunkIndex);
         }
         
         return tile;
     }
 
+    void CachingTileProvider::requestTile(const ChunkIndex& chunkIndex) {
+        // The reader forgets a request once the tile is read, so tiles that wait for
+        // their upload must not be enqueued again
+        if (_uploadScheduler.markRequested(chunkIndex)) {
+            _asyncTextureDataProvider->enqueueTextureData(chunkIndex);
+        }
+    }
+
 
     void CachingTileProvider::initTexturesFromLoadedData() {
         while (_asyncTextureDataProvider->hasLoadedTextureData()) {
-            std::shared_ptr<TileIOResult> tileIOResult = _asyncTextureDataProvider->nextTileIOResult();
-            initializeAndAddToCache(tileIOResult);
+            _uploadScheduler.add(_asyncTextureDataProvider->nextTileIOResult());
         }
+
+        _uploadScheduler.upload([this](std::shared_ptr<TileIOResult> tileIOResult) {
+            return initializeAndAddToCache(tileIOResult);
+        });
     }
 
     void CachingTileProvider::clearRequestQueue() {
         _asyncTextureDataProvider->clearRequestQueue();
-        _framesSinceLastRequestFlush = 0;
     }
 
     Tile::Status CachingTileProvider::getTileStatus(const ChunkIndex& chunkIndex) {
@@ -118,7 +143,7 @@ namespace openspace {
             return Tile::Status::OutOfRange;
         }
 
-        HashKey key = chunkIndex.hashKey();
+        TileCacheKey key = cacheKey(chunkIndex);
 
         if (_tileCache->exist(key)) {
             return _tileCache->get(key).status;
@@ -129,12 +154,12 @@ namespace openspace {
 
 
     Tile CachingTileProvider::getOrStartFetchingTile(ChunkIndex chunkIndex) {
-        HashKey hashkey = chunkIndex.hashKey();
+        TileCacheKey hashkey = cacheKey(chunkIndex);
         if (_tileCache->exist(hashkey)) {
             return _tileCache->get(hashkey);
         }
         else {
-            _asyncTextureDataProvider->enqueueTextureData(chunkIndex);
+            requestTile(chunkIndex);
             return Tile::TileUnavailable;
         }
     }
@@ -144,21 +169,27 @@ namespace openspace {
     }
 
 
-    void CachingTileProvider::initializeAndAddToCache(std::shared_ptr<TileIOResult> tileIOResult) {
-        HashKey key = tileIOResult->chunkIndex.hashKey();
+    size_t CachingTileProvider::initializeAndAddToCache(std::shared_ptr<TileIOResult> tileIOResult) {
+        TileCacheKey key = cacheKey(tileIOResult->chunkIndex);
         TileDataset::DataLayout dataLayout = _asyncTextureDataProvider->getTextureDataProvider()->getDataLayout();
-        Texture* texturePtr = new Texture(
-            tileIOResult->imageData,
-            tileIOResult->dimensions,
-            dataLayout.textureFormat.ghoulFormat,
-            dataLayout.textureFormat.glFormat,
-            dataLayout.glType,
-            Texture::FilterMode::Linear,
-            Texture::WrappingMode::ClampToEdge);
-        
-        // The texture should take ownership of the data
-        std::shared_ptr<Texture> texture = std::shared_ptr<Texture>(texturePtr);
-        //texture->setFilter(ghoul::opengl::Texture::FilterMode::AnisotropicMipMap);
+
+        std::shared_ptr<Texture> texture = getRecycledTexture(tileIOResult->dimensions);
+        if (texture) {
+            // The texture should take ownership of the data
+            texture->setPixelData(tileIOResult->imageData, Texture::TakeOwnership::Yes);
+        }
+        else {
+            // The texture should take ownership of the data
+            texture = std::shared_ptr<Texture>(new Texture(
+                tileIOResult->imageData,
+                tileIOResult->dimensions,
+                dataLayout.textureFormat.ghoulFormat,
+                dataLayout.textureFormat.glFormat,
+                dataLayout.glType,
+                Texture::FilterMode::Linear,
+                Texture::WrappingMode::ClampToEdge));
+            //texture->setFilter(ghoul::opengl::Texture::FilterMode::AnisotropicMipMap);
+        }
 
         texture->uploadTexture();
         
@@ -169,7 +200,53 @@ namespace openspace {
             tileIOResult->error == CE_None ? Tile::Status::OK : Tile::Status::IOError
         };
 
-        _tileCache->put(key, tile);
+        size_t numBytes = dataLayout.bytesPerPixel * tileIOResult->dimensions.x *
+            tileIOResult->dimensions.y;
+
+        std::vector<Tile> evictedTiles;
+        _tileCache->put(key, tile, evictedTiles, numBytes);
+        recycleTextures(evictedTiles);
+        _updateCount++;
+
+        if (tileIOResult->heightTile) {
+            _heightTileCache->put(tileIOResult->heightTile);
+        }
+
+        return numBytes;
+    }
+
+    TileCacheKey CachingTileProvider::cacheKey(const ChunkIndex& chunkIndex) const {
+        return { _cacheId, chunkIndex.hashKey() };
+    }
+
+    std::shared_ptr<Texture> CachingTileProvider::getRecycledTexture(
+        const glm::uvec3& dimensions)
+    {
+        auto it = std::find_if(
+            _texturePool.begin(),
+            _texturePool.end(),
+            [&dimensions](const std::shared_ptr<Texture>& texture) {
+                return texture->dimensions() == dimensions;
+            }
+        );
+        if (it == _texturePool.end()) {
+            return nullptr;
+        }
+        std::shared_ptr<Texture> texture = *it;
+        *it = _texturePool.back();
+        _texturePool.pop_back();
+        return texture;
+    }
+
+    void CachingTileProvider::recycleTextures(const std::vector<Tile>& evictedTiles) {
+        for (const Tile& tile : evictedTiles) {
+            // Only reuse textures that are not referenced from anywhere else
+            if (tile.texture && tile.texture.use_count() == 1 &&
+                _texturePool.size() < MaximumTexturePoolSize)
+            {
+                _texturePool.push_back(tile.texture);
+            }
+        }
     }
 
 
@@ -38,6 +38,8 @@
 #include <modules/globebrowsing/geometry/geodetic2.h>
 
 #include <modules/globebrowsing/tile/asynctilereader.h>
+#include <modules/globebrowsing/tile/heighttilecache.h>
+#include <modules/globebrowsing/tile/tileuploadscheduler.h>
 
 #include <modules/globebrowsing/other/lrucache.h>
 
@@ -72,10 +74,52 @@ namespace openspace {
         virtual TileDepthTransform depthTransform() = 0;
         virtual void prerender() = 0;
         virtual std::shared_ptr<AsyncTileDataProvider> getAsyncTileReader() = 0;
+
+        /**
+            Returns the CPU copies of the heights of the tiles that have been read. They
+            are only kept for height maps, for other layers the cache stays empty.
+        */
+        virtual std::shared_ptr<HeightTileCache> getHeightTileCache() = 0;
+
+        /**
+            Returns a number that changes whenever new tiles have become available
+            from this provider. Data derived from the tiles only needs to be
+            recomputed when this number has changed.
+        */
+        virtual int getUpdateCount() = 0;
     };
 
 
-    typedef LRUCache<HashKey, Tile> TileCache;
+    /**
+        Identifies a tile in a TileCache that may be shared between several providers,
+        for example the time steps of a TemporalTileProvider.
+    */
+    struct TileCacheKey {
+        unsigned int providerId;
+        HashKey chunkHashKey;
+
+        bool operator==(const TileCacheKey& other) const {
+            return providerId == other.providerId && chunkHashKey == other.chunkHashKey;
+        }
+    };
+
+}  // namespace openspace
+
+namespace std {
+    template<> struct hash<openspace::TileCacheKey> {
+        size_t operator()(const openspace::TileCacheKey& key) const {
+            return hash<openspace::HashKey>()(key.chunkHashKey) ^
+                (hash<unsigned int>()(key.providerId) * 2654435761u);
+        }
+    };
+}  // namespace std
+
+namespace openspace {
+
+    /**
+        Cache of tiles whose size is measured in bytes of texture data
+    */
+    typedef LRUCache<TileCacheKey, Tile> TileCache;
 
 
     /**
@@ -86,10 +130,18 @@ namespace openspace {
     public:
 
 
+        /**
+            \param tileCache The cache may be shared between several providers, as long
+            as each uses a different <code>cacheId</code>
+            \param uploadBudget The upload budget shared with the other providers, whose
+            frames are started by its owner. Without one, the provider uploads within a
+            default budget of its own
+        */
         CachingTileProvider(
             std::shared_ptr<AsyncTileDataProvider> tileReader, 
             std::shared_ptr<TileCache> tileCache,
-            int framesUntilFlushRequestQueue);
+            std::shared_ptr<TileUploadScheduler::FrameBudget> uploadBudget = nullptr,
+            unsigned int cacheId = 0);
 
         virtual ~CachingTileProvider();
         
@@ -98,6 +150,15 @@ namespace openspace {
         virtual TileDepthTransform depthTransform();
         virtual void prerender();
         virtual std::shared_ptr<AsyncTileDataProvider> getAsyncTileReader();
+        virtual std::shared_ptr<HeightTileCache> getHeightTileCache();
+        virtual int getUpdateCount();
+
+        /**
+            Creates an OpenGL texture, or reuses a recycled one, and pushes the data to
+            the GPU. Returns the number of uploaded bytes. Called directly by a
+            TileReadBatcher that reads the tiles of this provider.
+        */
+        size_t initializeAndAddToCache(std::shared_ptr<TileIOResult> uninitedTexture);
 
 
     private:
@@ -109,12 +170,18 @@ namespace openspace {
         
         Tile getOrStartFetchingTile(ChunkIndex chunkIndex);
 
-
-        
         /**
-            Creates an OpenGL texture and pushes the data to the GPU.
+            Requests a tile that is not in the cache, unless it has already been read
+            and is waiting to be uploaded.
         */
-        void initializeAndAddToCache(std::shared_ptr<TileIOResult> uninitedTexture);
+        void requestTile(const ChunkIndex& chunkIndex);
+
+
+        
+        TileCacheKey cacheKey(const ChunkIndex& chunkIndex) const;
+
+        std::shared_ptr<Texture> getRecycledTexture(const glm::uvec3& dimensions);
+        void recycleTextures(const std::vector<Tile>& evictedTiles);
 
         void clearRequestQueue();
 
@@ -127,12 +194,21 @@ namespace openspace {
         //////////////////////////////////////////////////////////////////////////////////
 
         std::shared_ptr<TileCache> _tileCache;
+        unsigned int _cacheId;
+
+        int _updateCount;
 
-        int _framesSinceLastRequestFlush;
-        int _framesUntilRequestFlush;
+        // Loaded tiles are uploaded within a budget per frame
+        TileUploadScheduler _uploadScheduler;
+
+        // Textures of tiles that were evicted from the cache. All textures of a
+        // provider share the same format, so only the dimensions have to match
+        std::vector<std::shared_ptr<Texture>> _texturePool;
 
 
         std::shared_ptr<AsyncTileDataProvider> _asyncTextureDataProvider;
+
+        std::shared_ptr<HeightTileCache> _heightTileCache;
     };
 
     
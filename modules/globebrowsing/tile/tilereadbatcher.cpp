@@ -0,0 +1,308 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/tile/tilereadbatcher.h>
+
+#include <modules/globebrowsing/geometry/geodetic2.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+
+namespace {
+    const std::string _loggerCat = "TileReadBatcher";
+}
+
+namespace openspace {
+
+    TileReadBatcher::TileReadBatcher(std::shared_ptr<ThreadPool> pool,
+        const TileUploadScheduler::Budget& publishBudget)
+        : _concurrentJobManager(pool)
+        , _publishBudget(
+            std::make_shared<TileUploadScheduler::FrameBudget>(publishBudget))
+        , _ownsPublishBudget(true)
+        , _maximumNumActiveReads(std::max<size_t>(2 * pool->numThreads(), 1))
+        , _numActiveReads(0)
+    {
+
+    }
+
+    TileReadBatcher::TileReadBatcher(std::shared_ptr<ThreadPool> pool,
+        std::shared_ptr<TileUploadScheduler::FrameBudget> frameBudget)
+        : _concurrentJobManager(pool)
+        , _publishBudget(frameBudget)
+        , _ownsPublishBudget(false)
+        , _maximumNumActiveReads(std::max<size_t>(2 * pool->numThreads(), 1))
+        , _numActiveReads(0)
+    {
+        ghoul_assert(_publishBudget != nullptr, "Frame budget must not be null");
+    }
+
+    TileReadBatcher::~TileReadBatcher() {
+        // Reads that have not started are dropped, the running ones are waited for so
+        // that no job outlives the batcher
+        _numActiveReads -= _concurrentJobManager.clearEnqueuedJobs();
+        while (_numActiveReads > 0) {
+            _finishedBatches.push_back(_concurrentJobManager.waitForFinishedJob()->product());
+            _numActiveReads--;
+        }
+
+        // Batches that were read but never published still own their image data
+        for (const std::shared_ptr<ChunkTileBatch>& batch : _finishedBatches) {
+            for (const std::shared_ptr<TileIOResult>& tileIOResult : batch->tileIOResults) {
+                delete[] static_cast<char*>(tileIOResult->imageData);
+            }
+        }
+    }
+
+    size_t TileReadBatcher::addLayer(std::shared_ptr<AsyncTileDataProvider> tileReader,
+        const PublishFunction& publish)
+    {
+        tileReader->setBatched(true);
+        _layers.push_back({ tileReader, publish, true });
+        return _layers.size() - 1;
+    }
+
+    size_t TileReadBatcher::numLayers() const {
+        return _layers.size();
+    }
+
+    void TileReadBatcher::setLayerActive(size_t layer, bool isActive) {
+        ghoul_assert(layer < _layers.size(), "Invalid layer");
+        if (_layers[layer].isActive && !isActive) {
+            _layers[layer].tileReader->clearRequestQueue();
+        }
+        _layers[layer].isActive = isActive;
+    }
+
+    bool TileReadBatcher::isLayerActive(size_t layer) const {
+        ghoul_assert(layer < _layers.size(), "Invalid layer");
+        return _layers[layer].isActive;
+    }
+
+    size_t TileReadBatcher::numPendingBatches() const {
+        return _finishedBatches.size();
+    }
+
+    const TileReadBatcher::BatchStatistics& TileReadBatcher::getBatchStatistics() const {
+        return _statistics;
+    }
+
+    void TileReadBatcher::update() {
+        collectFinishedBatches();
+        publishBatches();
+        startReads();
+    }
+
+    void TileReadBatcher::collectFinishedBatches() {
+        while (_concurrentJobManager.numFinishedJobs() > 0) {
+            _finishedBatches.push_back(_concurrentJobManager.popFinishedJob()->product());
+            _numActiveReads--;
+        }
+    }
+
+    void TileReadBatcher::publishBatches() {
+        // Coarse chunks first, since their children can not be rendered without them
+        std::stable_sort(
+            _finishedBatches.begin(),
+            _finishedBatches.end(),
+            [](const std::shared_ptr<ChunkTileBatch>& a,
+                const std::shared_ptr<ChunkTileBatch>& b)
+            {
+                if (a->chunkIndex.level != b->chunkIndex.level) {
+                    return a->chunkIndex.level < b->chunkIndex.level;
+                }
+                return a->requestTime < b->requestTime;
+            }
+        );
+
+        if (_ownsPublishBudget) {
+            _publishBudget->startFrame();
+        }
+
+        auto it = _finishedBatches.begin();
+        while (it != _finishedBatches.end()) {
+            const ChunkTileBatch& batch = **it;
+
+            if (!isRequested(batch)) {
+                finishBatch(batch, false);
+                for (const auto& tileIOResult : batch.tileIOResults) {
+                    delete[] static_cast<char*>(tileIOResult->imageData);
+                }
+                _statistics.numDiscardedChunks++;
+                it = _finishedBatches.erase(it);
+            }
+            else if (!_publishBudget->isUsedUp()) {
+                // All active layers of the chunk are published in the same frame, even
+                // the ones that no longer request it, to keep the layers consistent
+                auto startTime = std::chrono::steady_clock::now();
+                finishBatch(batch, true);
+                size_t numPublishedBytes = 0;
+                for (size_t i = 0; i < batch.layers.size(); i++) {
+                    const Layer& layer = _layers[batch.layers[i]];
+                    if (layer.isActive) {
+                        numPublishedBytes += layer.publish(batch.tileIOResults[i]);
+                    }
+                    else {
+                        delete[] static_cast<char*>(batch.tileIOResults[i]->imageData);
+                    }
+                }
+                double milliseconds = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - startTime).count();
+                _publishBudget->use(numPublishedBytes, milliseconds);
+                recordLatency(batch);
+                it = _finishedBatches.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    bool TileReadBatcher::isRequested(const ChunkTileBatch& batch) const {
+        return std::any_of(
+            batch.layers.begin(),
+            batch.layers.end(),
+            [this, &batch](size_t layer) {
+                return _layers[layer].tileReader->isRequested(batch.chunkIndex);
+            }
+        );
+    }
+
+    void TileReadBatcher::finishBatch(const ChunkTileBatch& batch, bool isUsed) {
+        for (size_t layer : batch.layers) {
+            _layers[layer].tileReader->finishBatchedRead(batch.chunkIndex, isUsed);
+        }
+    }
+
+    void TileReadBatcher::recordLatency(const ChunkTileBatch& batch) {
+        double latency = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - batch.requestTime).count();
+
+        _statistics.numPublishedChunks++;
+        _statistics.lastLatencyMilliseconds = latency;
+        _statistics.averageLatencyMilliseconds +=
+            (latency - _statistics.averageLatencyMilliseconds) /
+            _statistics.numPublishedChunks;
+        _statistics.maximumLatencyMilliseconds =
+            std::max(_statistics.maximumLatencyMilliseconds, latency);
+    }
+
+    void TileReadBatcher::startReads() {
+        auto now = std::chrono::steady_clock::now();
+
+        // Group the queued requests of all layers by chunk
+        std::vector<std::shared_ptr<ChunkTileBatch>> queuedBatches;
+        std::unordered_map<HashKey, size_t> batchIndices;
+        std::unordered_map<HashKey, std::chrono::steady_clock::time_point> requestTimes;
+        for (size_t layer = 0; layer < _layers.size(); layer++) {
+            if (!_layers[layer].isActive) {
+                continue;
+            }
+            for (const ChunkIndex& chunkIndex : _layers[layer].tileReader->getQueuedRequests()) {
+                HashKey key = chunkIndex.hashKey();
+                auto it = batchIndices.find(key);
+                if (it == batchIndices.end()) {
+                    // Requests that are still waiting keep the time they were first seen
+                    auto timeIt = _requestTimes.find(key);
+                    std::shared_ptr<ChunkTileBatch> batch =
+                        std::make_shared<ChunkTileBatch>();
+                    batch->chunkIndex = chunkIndex;
+                    batch->requestTime = timeIt != _requestTimes.end() ?
+                        timeIt->second : now;
+
+                    it = batchIndices.insert({ key, queuedBatches.size() }).first;
+                    queuedBatches.push_back(batch);
+                    requestTimes[key] = batch->requestTime;
+                }
+                queuedBatches[it->second]->layers.push_back(layer);
+            }
+        }
+        _requestTimes = std::move(requestTimes);
+
+        if (queuedBatches.empty() || _numActiveReads >= _maximumNumActiveReads) {
+            return;
+        }
+
+        // The most detailed requested chunk is where the camera is closest to the globe
+        auto finestBatch = std::max_element(
+            queuedBatches.begin(),
+            queuedBatches.end(),
+            [](const std::shared_ptr<ChunkTileBatch>& a,
+                const std::shared_ptr<ChunkTileBatch>& b)
+            {
+                return a->chunkIndex.level < b->chunkIndex.level;
+            }
+        );
+        Geodetic2 focus = GeodeticPatch((*finestBatch)->chunkIndex).center();
+
+        std::vector<std::pair<Scalar, std::shared_ptr<ChunkTileBatch>>> prioritizedBatches;
+        for (const std::shared_ptr<ChunkTileBatch>& batch : queuedBatches) {
+            Scalar distance = GeodeticPatch(batch->chunkIndex).center()
+                .angularDistance(focus);
+            prioritizedBatches.push_back({ distance, batch });
+        }
+
+        size_t numReads = std::min(
+            prioritizedBatches.size(),
+            _maximumNumActiveReads - _numActiveReads
+        );
+        std::partial_sort(
+            prioritizedBatches.begin(),
+            prioritizedBatches.begin() + numReads,
+            prioritizedBatches.end(),
+            [](const std::pair<Scalar, std::shared_ptr<ChunkTileBatch>>& a,
+                const std::pair<Scalar, std::shared_ptr<ChunkTileBatch>>& b)
+            {
+                // Parents before children
+                int levelA = a.second->chunkIndex.level;
+                int levelB = b.second->chunkIndex.level;
+                if (levelA != levelB) {
+                    return levelA < levelB;
+                }
+                return a.first < b.first;
+            }
+        );
+
+        for (size_t i = 0; i < numReads; i++) {
+            std::shared_ptr<ChunkTileBatch> batch = prioritizedBatches[i].second;
+
+            std::vector<std::shared_ptr<TileDataset>> tileDatasets;
+            for (size_t layer : batch->layers) {
+                AsyncTileDataProvider& tileReader = *_layers[layer].tileReader;
+                tileReader.markAsReading(batch->chunkIndex);
+                tileDatasets.push_back(tileReader.getTextureDataProvider());
+            }
+            batch->tileIOResults.reserve(tileDatasets.size());
+            _requestTimes.erase(batch->chunkIndex.hashKey());
+
+            _concurrentJobManager.enqueueJob(std::shared_ptr<ChunkTileBatchJob>(
+                new ChunkTileBatchJob(batch, tileDatasets)));
+            _numActiveReads++;
+            _statistics.numBatches++;
+            _statistics.numTileReads += tileDatasets.size();
+        }
+    }
+
+}  // namespace openspace
@@ -0,0 +1,198 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __TILE_READ_BATCHER_H__
+#define __TILE_READ_BATCHER_H__
+
+#include <modules/globebrowsing/chunk/chunkindex.h>
+
+#include <modules/globebrowsing/other/concurrentjobmanager.h>
+#include <modules/globebrowsing/other/threadpool.h>
+
+#include <modules/globebrowsing/tile/asynctilereader.h>
+#include <modules/globebrowsing/tile/tiledataset.h>
+#include <modules/globebrowsing/tile/tileuploadscheduler.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace {
+
+    /**
+        The tiles of one chunk for all layers that requested it
+    */
+    struct ChunkTileBatch {
+        ChunkIndex chunkIndex;
+        /// Indices of the layers that requested the chunk
+        std::vector<size_t> layers;
+        /// One result per layer, in the same order as #layers
+        std::vector<std::shared_ptr<TileIOResult>> tileIOResults;
+        /// The frame in which the chunk was first seen requested by any layer
+        std::chrono::steady_clock::time_point requestTime;
+    };
+
+    struct ChunkTileBatchJob : public Job<ChunkTileBatch> {
+        ChunkTileBatchJob(std::shared_ptr<ChunkTileBatch> batch,
+            std::vector<std::shared_ptr<TileDataset>> tileDatasets)
+            : _batch(batch)
+            , _tileDatasets(tileDatasets)
+        {
+
+        }
+
+        virtual ~ChunkTileBatchJob() { }
+
+        virtual void execute() {
+            for (const std::shared_ptr<TileDataset>& tileDataset : _tileDatasets) {
+                _batch->tileIOResults.push_back(
+                    tileDataset->readTileData(_batch->chunkIndex));
+            }
+        }
+
+        virtual std::shared_ptr<ChunkTileBatch> product() {
+            return _batch;
+        }
+
+    private:
+        std::shared_ptr<ChunkTileBatch> _batch;
+        std::vector<std::shared_ptr<TileDataset>> _tileDatasets;
+    };
+
+
+    /**
+        Reads the tiles of several layers together. Requests for the same chunk from
+        all layers are grouped into a single job that reads every layer, instead of
+        each layer paying for its own job. When the job is done, the tiles of all
+        layers are published in the same frame so that a chunk is never rendered with
+        layers from different levels. Publishing is limited by a per frame budget, but
+        a chunk is always published as a whole.
+
+        The layers are AsyncTileDataProviders in batched mode; they keep track of the
+        requests while the batcher does the reading.
+    */
+    class TileReadBatcher {
+    public:
+        /**
+            Makes the tile available to the layer, for example by uploading it to the
+            cache of a CachingTileProvider, and returns the number of published bytes.
+            The function takes ownership of the image data.
+        */
+        using PublishFunction = std::function<size_t(std::shared_ptr<TileIOResult>)>;
+
+        struct BatchStatistics {
+            /// Jobs that were started, one per chunk
+            size_t numBatches = 0;
+            /// Tiles that were read in the jobs
+            size_t numTileReads = 0;
+            /// Chunks whose tiles were published
+            size_t numPublishedChunks = 0;
+            /// Chunks that were no longer requested by any layer when read
+            size_t numDiscardedChunks = 0;
+
+            /// Time from the first request until all layers of a chunk were published
+            double lastLatencyMilliseconds = 0.0;
+            double averageLatencyMilliseconds = 0.0;
+            double maximumLatencyMilliseconds = 0.0;
+        };
+
+        /**
+            Creates a batcher with a publish budget of its own, which starts a new frame
+            in every call to #update
+        */
+        TileReadBatcher(std::shared_ptr<ThreadPool> pool,
+            const TileUploadScheduler::Budget& publishBudget = TileUploadScheduler::Budget());
+
+        /**
+            Creates a batcher that publishes within the shared <code>frameBudget</code>,
+            whose frames are started by its owner
+        */
+        TileReadBatcher(std::shared_ptr<ThreadPool> pool,
+            std::shared_ptr<TileUploadScheduler::FrameBudget> frameBudget);
+        ~TileReadBatcher();
+
+        /**
+            Adds a layer and puts its tile reader in batched mode
+            \returns the index of the layer
+        */
+        size_t addLayer(std::shared_ptr<AsyncTileDataProvider> tileReader,
+            const PublishFunction& publish);
+
+        size_t numLayers() const;
+
+        /**
+            Enables or disables a layer. The tile reader of a disabled layer is not
+            updated and would keep its requests forever, so they are cancelled and the
+            layer is left out of new batches. Tiles of a disabled layer that are still
+            being read are released instead of published.
+        */
+        void setLayerActive(size_t layer, bool isActive);
+        bool isLayerActive(size_t layer) const;
+
+        /**
+            Publishes the chunks that have been read and starts reading the chunks
+            requested in the current frame. Has to be called before the tile readers
+            of the layers are updated, since those start a new frame.
+        */
+        void update();
+
+        /// Returns the number of chunks that have been read but not published yet
+        size_t numPendingBatches() const;
+
+        const BatchStatistics& getBatchStatistics() const;
+
+    private:
+        struct Layer {
+            std::shared_ptr<AsyncTileDataProvider> tileReader;
+            PublishFunction publish;
+            bool isActive;
+        };
+
+        void collectFinishedBatches();
+        void publishBatches();
+        void startReads();
+
+        /// Returns <code>true</code> if any layer requested the chunk in this frame
+        bool isRequested(const ChunkTileBatch& batch) const;
+        void finishBatch(const ChunkTileBatch& batch, bool isUsed);
+        void recordLatency(const ChunkTileBatch& batch);
+
+        std::vector<Layer> _layers;
+        ConcurrentJobManager<ChunkTileBatch> _concurrentJobManager;
+        std::shared_ptr<TileUploadScheduler::FrameBudget> _publishBudget;
+        bool _ownsPublishBudget;
+
+        std::vector<std::shared_ptr<ChunkTileBatch>> _finishedBatches;
+        std::unordered_map<HashKey, std::chrono::steady_clock::time_point> _requestTimes;
+
+        size_t _maximumNumActiveReads;
+        size_t _numActiveReads;
+        BatchStatistics _statistics;
+    };
+
+}  // namespace openspace
+
+#endif  // __TILE_READ_BATCHER_H__
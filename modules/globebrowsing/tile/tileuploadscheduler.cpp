@@ -0,0 +1,200 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/tile/tileuploadscheduler.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    // Requests for tiles that have not arrived after this many frames are forgotten
+    const unsigned int MaximumRequestAge = 600;
+}
+
+namespace openspace {
+
+    TileUploadScheduler::FrameBudget::FrameBudget(const Budget& budget)
+        : _budget(budget)
+        , _usedBytes(0)
+        , _usedMilliseconds(0.0)
+        , _hasUploaded(false)
+    {
+
+    }
+
+    void TileUploadScheduler::FrameBudget::startFrame() {
+        _usedBytes = 0;
+        _usedMilliseconds = 0.0;
+        _hasUploaded = false;
+    }
+
+    void TileUploadScheduler::FrameBudget::use(size_t numBytes, double milliseconds) {
+        _usedBytes += numBytes;
+        _usedMilliseconds += milliseconds;
+        _hasUploaded = true;
+    }
+
+    bool TileUploadScheduler::FrameBudget::isUsedUp() const {
+        return _hasUploaded && (_usedBytes >= _budget.bytesPerFrame ||
+            _usedMilliseconds >= _budget.millisecondsPerFrame);
+    }
+
+    const TileUploadScheduler::Budget& TileUploadScheduler::FrameBudget::budget() const {
+        return _budget;
+    }
+
+    void TileUploadScheduler::FrameBudget::setBudget(const Budget& budget) {
+        _budget = budget;
+    }
+
+    TileUploadScheduler::TileUploadScheduler(const Budget& budget)
+        : _frameBudget(std::make_shared<FrameBudget>(budget))
+        , _ownsFrameBudget(true)
+        , _frame(1)
+        , _hasFinestRequest(false)
+    {
+
+    }
+
+    TileUploadScheduler::TileUploadScheduler(std::shared_ptr<FrameBudget> frameBudget)
+        : _frameBudget(frameBudget)
+        , _ownsFrameBudget(false)
+        , _frame(1)
+        , _hasFinestRequest(false)
+    {
+        ghoul_assert(_frameBudget != nullptr, "Frame budget must not be null");
+    }
+
+    bool TileUploadScheduler::markRequested(const ChunkIndex& chunkIndex) {
+        _requestFrames[chunkIndex.hashKey()] = _frame;
+        if (!_hasFinestRequest || chunkIndex.level > _finestRequest.level) {
+            _finestRequest = chunkIndex;
+            _hasFinestRequest = true;
+        }
+        return !isPending(chunkIndex);
+    }
+
+    void TileUploadScheduler::add(std::shared_ptr<TileIOResult> tileIOResult) {
+        // Frame 0 is never current, so tiles that were not requested are least important
+        _pendingUploads.push_back({ tileIOResult, 0, 0.0 });
+        _pendingKeys.insert(tileIOResult->chunkIndex.hashKey());
+    }
+
+    size_t TileUploadScheduler::upload(const UploadFunction& uploadFunction) {
+        if (_hasFinestRequest) {
+            _focus = GeodeticPatch(_finestRequest).center();
+            _hasFinestRequest = false;
+        }
+
+        sortPendingUploads();
+
+        if (_ownsFrameBudget) {
+            _frameBudget->startFrame();
+        }
+
+        using Clock = std::chrono::steady_clock;
+        size_t nUploaded = 0;
+
+        // The most important tiles are at the back of the sorted list
+        while (!_pendingUploads.empty() && !_frameBudget->isUsedUp()) {
+            std::shared_ptr<TileIOResult> tileIOResult =
+                _pendingUploads.back().tileIOResult;
+            _pendingUploads.pop_back();
+            _requestFrames.erase(tileIOResult->chunkIndex.hashKey());
+            _pendingKeys.erase(tileIOResult->chunkIndex.hashKey());
+
+            Clock::time_point start = Clock::now();
+            size_t numBytes = uploadFunction(tileIOResult);
+            std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+            _frameBudget->use(numBytes, elapsed.count());
+            nUploaded++;
+        }
+
+        removeOldRequests();
+        _frame++;
+        return nUploaded;
+    }
+
+    size_t TileUploadScheduler::numPendingUploads() const {
+        return _pendingUploads.size();
+    }
+
+    bool TileUploadScheduler::isPending(const ChunkIndex& chunkIndex) const {
+        return _pendingKeys.find(chunkIndex.hashKey()) != _pendingKeys.end();
+    }
+
+    const TileUploadScheduler::Budget& TileUploadScheduler::budget() const {
+        return _frameBudget->budget();
+    }
+
+    void TileUploadScheduler::setBudget(const Budget& budget) {
+        _frameBudget->setBudget(budget);
+    }
+
+    void TileUploadScheduler::sortPendingUploads() {
+        for (PendingUpload& pending : _pendingUploads) {
+            const ChunkIndex& chunkIndex = pending.tileIOResult->chunkIndex;
+            auto it = _requestFrames.find(chunkIndex.hashKey());
+            if (it != _requestFrames.end()) {
+                pending.lastRequestedFrame = std::max(pending.lastRequestedFrame, it->second);
+            }
+            pending.distance = GeodeticPatch(chunkIndex).center().angularDistance(_focus);
+        }
+
+        // Sort in increasing importance so that the next upload can be popped from the
+        // back of the list
+        std::stable_sort(
+            _pendingUploads.begin(),
+            _pendingUploads.end(),
+            [](const PendingUpload& a, const PendingUpload& b) {
+                if (a.lastRequestedFrame != b.lastRequestedFrame) {
+                    return a.lastRequestedFrame < b.lastRequestedFrame;
+                }
+                int levelA = a.tileIOResult->chunkIndex.level;
+                int levelB = b.tileIOResult->chunkIndex.level;
+                if (levelA != levelB) {
+                    return levelA > levelB;
+                }
+                return a.distance > b.distance;
+            }
+        );
+    }
+
+    void TileUploadScheduler::removeOldRequests() {
+        if (_frame <= MaximumRequestAge) {
+            return;
+        }
+        for (auto it = _requestFrames.begin(); it != _requestFrames.end(); ) {
+            if (it->second < _frame - MaximumRequestAge) {
+                it = _requestFrames.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+}  // namespace openspace
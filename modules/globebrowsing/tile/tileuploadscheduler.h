@@ -0,0 +1,170 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __TILE_UPLOAD_SCHEDULER_H__
+#define __TILE_UPLOAD_SCHEDULER_H__
+
+#include <modules/globebrowsing/chunk/chunkindex.h>
+#include <modules/globebrowsing/geometry/geodetic2.h>
+#include <modules/globebrowsing/tile/tiledataset.h>
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace openspace {
+
+    /**
+        Decides which loaded tiles are uploaded to the GPU in a frame. Uploads are
+        limited by a per frame budget in bytes and time and the remaining tiles are
+        carried over to later frames. Tiles are uploaded in order of importance:
+        tiles that were requested most recently come first, followed by coarser levels
+        and then by the distance to the most detailed tile requested in the previous
+        frame, which is where the camera is closest to the globe.
+
+        The budget can be shared between schedulers, so that the upload time of a
+        frame does not grow with the number of layers and time steps.
+
+        The scheduler does not touch OpenGL itself; the actual upload is performed by
+        the function passed to #upload.
+    */
+    class TileUploadScheduler {
+    public:
+        struct Budget {
+            Budget(size_t bytesPerFrame = 8 * 1024 * 1024,
+                double millisecondsPerFrame = 4.0)
+                : bytesPerFrame(bytesPerFrame)
+                , millisecondsPerFrame(millisecondsPerFrame)
+            { }
+
+            size_t bytesPerFrame;
+            double millisecondsPerFrame;
+        };
+
+        /**
+            Keeps track of how much of a Budget has been used in the current frame. One
+            instance is shared by all schedulers and batchers of a globe and its owner
+            calls #startFrame once per frame. The first upload of a frame is always
+            allowed, so that uploads make progress even with a tiny budget.
+        */
+        class FrameBudget {
+        public:
+            FrameBudget(const Budget& budget = Budget());
+
+            /// Makes the whole budget available again
+            void startFrame();
+
+            /// Records an upload of <code>numBytes</code> that took the given time
+            void use(size_t numBytes, double milliseconds);
+
+            /// Returns <code>true</code> if no more uploads fit into the current frame
+            bool isUsedUp() const;
+
+            const Budget& budget() const;
+            void setBudget(const Budget& budget);
+
+        private:
+            Budget _budget;
+            size_t _usedBytes;
+            double _usedMilliseconds;
+            bool _hasUploaded;
+        };
+
+        /**
+            Uploads the tile and returns the number of bytes that were uploaded
+        */
+        using UploadFunction = std::function<size_t(std::shared_ptr<TileIOResult>)>;
+
+        /**
+            Creates a scheduler with a budget of its own, which starts a new frame in
+            every call to #upload
+        */
+        TileUploadScheduler(const Budget& budget = Budget());
+
+        /**
+            Creates a scheduler that uses the shared <code>frameBudget</code>. The owner
+            of the budget is responsible for starting the frames.
+        */
+        TileUploadScheduler(std::shared_ptr<FrameBudget> frameBudget);
+
+        /**
+            Records that the tile for <code>chunkIndex</code> was requested in the
+            current frame but is not available yet.
+            \returns <code>true</code> if the tile has to be read, <code>false</code> if
+            it has already been read and is waiting to be uploaded. Reading it again
+            would only produce a duplicate upload
+        */
+        bool markRequested(const ChunkIndex& chunkIndex);
+
+        /**
+            Adds a loaded tile that is waiting to be uploaded.
+        */
+        void add(std::shared_ptr<TileIOResult> tileIOResult);
+
+        /**
+            Calls <code>uploadFunction</code> for the most important pending tiles until
+            the budget for this frame is used up and starts a new frame. At least one
+            tile is uploaded per frame of the budget if any is pending, so that uploads
+            always make progress.
+            \returns the number of uploaded tiles
+        */
+        size_t upload(const UploadFunction& uploadFunction);
+
+        size_t numPendingUploads() const;
+
+        /// Returns <code>true</code> if the tile has been added but not uploaded yet
+        bool isPending(const ChunkIndex& chunkIndex) const;
+
+        const Budget& budget() const;
+        void setBudget(const Budget& budget);
+
+    private:
+        struct PendingUpload {
+            std::shared_ptr<TileIOResult> tileIOResult;
+            unsigned int lastRequestedFrame;
+            Scalar distance;
+        };
+
+        void sortPendingUploads();
+        void removeOldRequests();
+
+        std::shared_ptr<FrameBudget> _frameBudget;
+        bool _ownsFrameBudget;
+        unsigned int _frame;
+
+        std::vector<PendingUpload> _pendingUploads;
+        std::unordered_set<HashKey> _pendingKeys;
+        std::unordered_map<HashKey, unsigned int> _requestFrames;
+
+        // The most detailed tile requested in the current and the previous frame
+        ChunkIndex _finestRequest;
+        bool _hasFinestRequest;
+        Geodetic2 _focus;
+    };
+
+}  // namespace openspace
+
+#endif  // __TILE_UPLOAD_SCHEDULER_H__
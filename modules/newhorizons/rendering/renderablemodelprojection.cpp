@@ -173,7 +173,8 @@ void RenderableModelProjection::render(const RenderData& data) {
     _programObject->activate();
 
     attitudeParameters(_time);
-    _imageTimes.clear();
+    if (!_projectionComponent.doesPerformProjection())
+        _imageTimes.clear();
         
     _programObject->setUniform("_performShading", _performShading);
     _programObject->setUniform("sun_pos", _sunPosition.vec3());
@@ -210,13 +211,10 @@ void RenderableModelProjection::update(const UpdateData& data) {
     if (openspace::ImageSequencer::ref().isReady()) {
         openspace::ImageSequencer::ref().updateSequencer(_time);
         if (_projectionComponent.doesPerformProjection()) {
-            _capture = openspace::ImageSequencer::ref().getImagePaths(
-                _imageTimes,
-                _projectionComponent.projecteeId(),
-                _projectionComponent.instrumentId()
-            );
+            _projectionComponent.updateImageBacklog(_imageTimes, data);
         }
     }
+    _capture = !_imageTimes.empty();
         
     // set spice-orientation in accordance to timestamp
     if (!_source.empty()) {
@@ -323,11 +321,19 @@ void RenderableModelProjection::attitudeParameters(double time) {
 }
 
 void RenderableModelProjection::project() {
-    for (auto img : _imageTimes) {
-        attitudeParameters(img.startTime);
-        imageProjectGPU(_projectionComponent.loadProjectionTexture(img.path));
-    }
-    _capture = false;
+    // Only images that have already been read in the background are projected; the
+    // remaining ones are carried over to the next frame
+    ProjectionComponent::projectReadyImages(
+        _imageTimes,
+        [this](const Image& img) {
+            return _projectionComponent.isProjectionImageReady(img.path);
+        },
+        [this](const Image& img) {
+            attitudeParameters(img.startTime);
+            imageProjectGPU(_projectionComponent.loadProjectionTexture(img.path));
+        }
+    );
+    _capture = !_imageTimes.empty();
 }
 
 bool RenderableModelProjection::loadTextures() {
@@ -312,14 +312,23 @@ void RenderablePlanetProjection::render(const RenderData& data) {
     _up = data.camera.lookUpVectorCameraSpace();
 
     if (_capture && _projectionComponent.doesPerformProjection()) {
-        for (const Image& img : _imageTimes) {
-            RenderablePlanetProjection::attitudeParameters(img.startTime);
-            imageProjectGPU(_projectionComponent.loadProjectionTexture(img.path));
-        }
-        _capture = false;
+        // Only images that have already been read in the background are projected; the
+        // remaining ones are carried over to the next frame
+        ProjectionComponent::projectReadyImages(
+            _imageTimes,
+            [this](const Image& img) {
+                return _projectionComponent.isProjectionImageReady(img.path);
+            },
+            [this](const Image& img) {
+                RenderablePlanetProjection::attitudeParameters(img.startTime);
+                imageProjectGPU(_projectionComponent.loadProjectionTexture(img.path));
+            }
+        );
+        _capture = !_imageTimes.empty();
     }
     attitudeParameters(_time);
-    _imageTimes.clear();
+    if (!_projectionComponent.doesPerformProjection())
+        _imageTimes.clear();
 
     double  lt;
     glm::dvec3 p =
@@ -368,18 +377,14 @@ void RenderablePlanetProjection::update(const UpdateData& data) {
         _programObject->rebuildFromFile();
 
     _time = Time::ref().currentTime();
-    _capture = false;
 
     if (openspace::ImageSequencer::ref().isReady()){
         openspace::ImageSequencer::ref().updateSequencer(_time);
         if (_projectionComponent.doesPerformProjection()) {
-            _capture = openspace::ImageSequencer::ref().getImagePaths(
-                _imageTimes,
-                _projectionComponent.projecteeId(),
-                _projectionComponent.instrumentId()
-            );
+            _projectionComponent.updateImageBacklog(_imageTimes, data);
         }
     }
+    _capture = !_imageTimes.empty();
 
 }
 
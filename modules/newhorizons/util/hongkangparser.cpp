@@ -40,6 +40,9 @@ namespace {
     const std::string keyTranslation = "DataInputTranslation";
 
     const std::string PlaybookIdentifierName = "HongKang";
+
+    // The date at which the mission elapsed time _metRef is specified
+    const std::string ReferenceDate = "2015-07-14T11:50:00.00";
 }
 
 namespace openspace {
@@ -49,6 +52,7 @@ HongKangParser::HongKangParser(std::string name, const std::string& fileName,
                                std::vector<std::string> potentialTargets)
     : _name(std::move(name))
     , _defaultCaptureImage(absPath("${OPENSPACE_DATA}/scene/common/textures/placeholder.png"))
+    , _referenceET(0.0)
 {
     _fileName          = fileName;
     _spacecraft        = spacecraft;
@@ -83,10 +87,9 @@ HongKangParser::HongKangParser(std::string name, const std::string& fileName,
 
 void HongKangParser::findPlaybookSpecifiedTarget(std::string line, std::string& target){
     //remembto add this lua later... 
-    std::vector<std::string> ptarg = _potentialTargets;
-    for (auto p : ptarg){
+    std::transform(line.begin(), line.end(), line.begin(), toupper);
+    for (const auto& p : _potentialTargets){
         // loop over all targets and determine from 4th col which target this instrument points to
-        std::transform(line.begin(), line.end(), line.begin(), toupper);
         if (line.find(p) != std::string::npos){
             target = p;
             break;
@@ -129,6 +132,24 @@ bool HongKangParser::create(){
                << "please check modfile");
     }
 
+    _referenceET = SpiceManager::ref().ephemerisTimeFromDate(ReferenceDate);
+
+    std::string information = translationInformation(_fileTranslation);
+    information += _spacecraft + ";";
+    for (const std::string& t : _potentialTargets)
+        information += t + ";";
+    information += ghoul::filesystem::File(_fileName).lastModifiedDate() + ";";
+    // The instrument and target times are computed with the loaded kernels
+    information += kernelInformation();
+    information = std::to_string(std::hash<std::string>()(information));
+
+    const std::string cacheName = "HongKangParser_" + _name;
+    if (loadCachedData(cacheName, information)) {
+        LINFO("Using cached playbook data for '" << _fileName << "'");
+        sendPlaybookInformation(PlaybookIdentifierName);
+        return true;
+    }
+
     _eventsAsUTCFile.open("utcEvents.txt");
 
     if (size_t position = _fileName.find_last_of(".") + 1){
@@ -263,6 +284,8 @@ bool HongKangParser::create(){
     }
 
 
+    saveCachedData(cacheName, information);
+
     sendPlaybookInformation(PlaybookIdentifierName);
     return true;
 }
@@ -323,8 +346,7 @@ double HongKangParser::getETfromMet(std::string line){
 
 double HongKangParser::getETfromMet(double met){
     double diff;
-    double referenceET =
-        SpiceManager::ref().ephemerisTimeFromDate("2015-07-14T11:50:00.00");
+    double referenceET = _referenceET;
     double et = referenceET;
 
     //_metRef += 3; // MET reference time is off by 3 sec? 
@@ -341,8 +363,7 @@ double HongKangParser::getETfromMet(double met){
 
 double HongKangParser::getMetFromET(double et){
     double met;
-    double referenceET =
-        SpiceManager::ref().ephemerisTimeFromDate("2015-07-14T11:50:00.00");
+    double referenceET = _referenceET;
 
     if (et >= referenceET){
         met = _metRef + (et - referenceET);
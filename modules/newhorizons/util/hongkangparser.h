@@ -68,6 +68,8 @@ private:
 
     std::string _defaultCaptureImage;
     double _metRef = 299180517;
+    // The ephemeris time of the reference date, computed once per call to create
+    double _referenceET;
 
     std::string _name;
     std::string _fileName;
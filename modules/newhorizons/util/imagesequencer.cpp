@@ -29,8 +29,10 @@
 #include <openspace/util/time.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <modules/newhorizons/util/decoder.h>
+#include <ghoul/misc/assert.h>
 
 #include <openspace/util/spicemanager.h>
+#include <algorithm>
 #include <fstream>
 #include <iterator>
 #include <iomanip>
@@ -45,7 +47,10 @@ namespace openspace {
 ImageSequencer* ImageSequencer::_instance = nullptr;
 
 ImageSequencer::ImageSequencer()
-    : _hasData(false)
+    : _instrumentIndexLevel(-1)
+    , _currentTime(0.0)
+    , _previousTime(0.0)
+    , _hasData(false)
 {}
 
 ImageSequencer& ImageSequencer::ref() {
@@ -75,6 +80,7 @@ void ImageSequencer::updateSequencer(double time){
     if (_currentTime != time){
         _previousTime = _currentTime;
         _currentTime = time;
+        updateActiveInstruments();
     }
 }
 
@@ -169,61 +175,186 @@ const Image ImageSequencer::getLatestImageForInstrument(const std::string _instr
 
 std::map<std::string, bool> ImageSequencer::getActiveInstruments(){
     // first set all instruments to off
-    for (auto i : _switchingMap)
-        _switchingMap[i.first] = false;
-    // go over the filetranslation map
-    for (const auto &key : _fileTranslation){
-        // for each spice-instrument
-        for (const auto &instrumentID : key.second->getTranslation()){
-            // check if the spice-instrument is active 
-                if (instrumentActive(instrumentID)){
-                    // go over switching map
-                    for (const auto &instrument : _switchingMap){
-                        // if instrument is present in switching map
-                        if (instrumentID == instrument.first){
-                            // set as active
-                            _switchingMap[instrumentID] = true;
-                        }
-                    }
-                }
-            }
-        }
+    for (auto& i : _switchingMap)
+        i.second = false;
+    // then switch on the ones that are currently active
+    for (const ActiveInstrument& active : _activeInstruments) {
+        auto it = _switchingMap.find(_instrumentNames[active.instrument]);
+        if (it != _switchingMap.end())
+            it->second = true;
+    }
     // return entire map, seen in GUI.
     return _switchingMap;
 }
 
-bool ImageSequencer::instrumentActive(std::string instrumentID) {
+int ImageSequencer::instrumentIndex(const std::string& instrumentID) const {
+    auto it = _instrumentIndices.find(instrumentID);
+    if (it != _instrumentIndices.end())
+        return it->second;
+    else
+        return -1;
+}
+
+const std::string& ImageSequencer::instrumentName(int index) const {
+    ghoul_assert(
+        index >= 0 && static_cast<size_t>(index) < _instrumentNames.size(),
+        "Index out of range"
+    );
+    return _instrumentNames[index];
+}
+
+const std::vector<ImageSequencer::ActiveInstrument>&
+ImageSequencer::activeInstruments() const
+{
+    return _activeInstruments;
+}
+
+bool ImageSequencer::instrumentActive(const std::string& instrumentID) const {
+    return instrumentActiveTime(instrumentID) != -1.f;
+}
+
+float ImageSequencer::instrumentActiveTime(const std::string& instrumentID) const {
+    int index = instrumentIndex(instrumentID);
+    if (index == -1)
+        return -1.f;
+
+    for (const ActiveInstrument& active : _activeInstruments) {
+        if (active.instrument == index)
+            return active.progress;
+    }
+    return -1.f;
+}
+
+void ImageSequencer::buildInstrumentIndex() {
+    _instrumentIndices.clear();
+    _instrumentNames.clear();
+    _instrumentIntervals.clear();
+
+    // Each instrument time refers to a data-file instrument that can translate into
+    // several spice instruments, each of which gets its own interval
     for (const auto& i : _instrumentTimes) {
-        //check if this instrument is in range
-        if (i.second.inRange(_currentTime)) { 
-            //if so, then get the corresponding spiceID
-            std::vector<std::string> spiceIDs = _fileTranslation[i.first]->getTranslation(); 
-            //check which specific subinstrument is firing
-            for (auto s : spiceIDs) {
-                if (s == instrumentID) {
-                    return true;
-                }
+        auto translation = _fileTranslation.find(i.first);
+        if (translation == _fileTranslation.end())
+            continue;
+
+        for (const std::string& spiceID : translation->second->getTranslation()) {
+            auto it = _instrumentIndices.find(spiceID);
+            int instrument;
+            if (it == _instrumentIndices.end()) {
+                instrument = static_cast<int>(_instrumentNames.size());
+                _instrumentIndices[spiceID] = instrument;
+                _instrumentNames.push_back(spiceID);
             }
+            else
+                instrument = it->second;
+
+            _instrumentIntervals.push_back(
+                { i.second._min, i.second._max, i.second._max, instrument }
+            );
         }
     }
-    return false;
+
+    std::stable_sort(
+        _instrumentIntervals.begin(),
+        _instrumentIntervals.end(),
+        [](const InstrumentInterval& a, const InstrumentInterval& b) {
+            return a.start < b.start;
+        }
+    );
+
+    // Compute the maximum end time of every subtree of the implicit interval tree. The
+    // leaves are at the even indices, a node at level k has its lowest k bits set and
+    // its children are at +- 2^(k-1). Nodes that would lie outside of the array are
+    // represented by the maximum end of the last existing subtree
+    std::vector<InstrumentInterval>& a = _instrumentIntervals;
+    const size_t n = a.size();
+    if (n == 0) {
+        _instrumentIndexLevel = -1;
+        return;
+    }
+
+    size_t lastIndex = 0;
+    double last = 0.0;
+    for (size_t i = 0; i < n; i += 2) {
+        lastIndex = i;
+        last = a[i].maxEnd = a[i].end;
+    }
+
+    int k = 1;
+    for (; (size_t(1) << k) <= n; ++k) {
+        const size_t x = size_t(1) << (k - 1);
+        const size_t first = (x << 1) - 1;
+        const size_t step = x << 2;
+        for (size_t i = first; i < n; i += step) {
+            double endLeft = a[i - x].maxEnd;
+            double endRight = (i + x < n) ? a[i + x].maxEnd : last;
+            a[i].maxEnd = std::max(a[i].end, std::max(endLeft, endRight));
+        }
+        lastIndex = ((lastIndex >> k) & 1) ? lastIndex - x : lastIndex + x;
+        if (lastIndex < n && a[lastIndex].maxEnd > last)
+            last = a[lastIndex].maxEnd;
+    }
+    _instrumentIndexLevel = k - 1;
 }
 
-float ImageSequencer::instrumentActiveTime(const std::string& instrumentID) const {
-    for (const auto& i : _instrumentTimes){
-        //check if this instrument is in range
-        if (i.second.inRange(_currentTime)){
-            //if so, then get the corresponding spiceID
-            std::vector<std::string> spiceIDs = _fileTranslation.at(i.first)->getTranslation();
-            //check which specific subinstrument is firing
-            for (auto s : spiceIDs){
-                if (s == instrumentID) {
-                    return static_cast<float>((_currentTime - i.second._min) / (i.second._max - i.second._min));
-                }
+void ImageSequencer::updateActiveInstruments() {
+    _activeInstruments.clear();
+    if (_instrumentIndexLevel < 0)
+        return;
+
+    const std::vector<InstrumentInterval>& a = _instrumentIntervals;
+    const size_t n = a.size();
+    const double t = _currentTime;
+
+    // The intervals are reported in the order of their start times, so the first
+    // interval found for an instrument is the one that would be found by a linear scan
+    auto report = [this, t](const InstrumentInterval& i) {
+        for (const ActiveInstrument& active : _activeInstruments) {
+            if (active.instrument == i.instrument)
+                return;
+        }
+        float progress = (i.end > i.start) ?
+            static_cast<float>((t - i.start) / (i.end - i.start)) :
+            0.f;
+        _activeInstruments.push_back({ i.instrument, progress });
+    };
+
+    // Top-down traversal of the implicit tree using a fixed-size stack; the depth of
+    // the tree is bounded by the number of bits in size_t
+    struct Node {
+        size_t index;
+        int level;
+        bool leftVisited;
+    };
+    Node stack[64];
+    int top = 0;
+    stack[top++] = { (size_t(1) << _instrumentIndexLevel) - 1, _instrumentIndexLevel, false };
+
+    while (top > 0) {
+        Node node = stack[--top];
+        if (node.level <= 3) {
+            // Small subtree; check all of its nodes directly
+            size_t begin = node.index >> node.level << node.level;
+            size_t end = std::min(begin + (size_t(1) << (node.level + 1)) - 1, n);
+            for (size_t i = begin; i < end && a[i].start <= t; ++i) {
+                if (t <= a[i].end)
+                    report(a[i]);
             }
         }
+        else if (!node.leftVisited) {
+            // The left child might be outside of the array but still have children
+            size_t left = node.index - (size_t(1) << (node.level - 1));
+            stack[top++] = { node.index, node.level, true };
+            if (left >= n || a[left].maxEnd >= t)
+                stack[top++] = { left, node.level - 1, false };
+        }
+        else if (node.index < n && a[node.index].start <= t) {
+            if (t <= a[node.index].end)
+                report(a[node.index]);
+            size_t right = node.index + (size_t(1) << (node.level - 1));
+            stack[top++] = { right, node.level - 1, false };
+        }
     }
-    return -1.f;
 }
 
 bool ImageSequencer::getImagePaths(std::vector<Image>& captures, 
@@ -304,6 +435,41 @@ bool ImageSequencer::getImagePaths(std::vector<Image>& captures,
     }
     return false;
 }
+void ImageSequencer::getUpcomingImages(std::vector<Image>& images,
+                                       const std::string& projectee,
+                                       const std::string& instrumentRequest,
+                                       int count) const
+{
+    images.clear();
+    auto subset = _subsetMap.find(projectee);
+    if (subset == _subsetMap.end() || count <= 0)
+        return;
+
+    const std::vector<Image>& sequence = subset->second._subset;
+    auto compareTime = [](const Image& a, double b)->bool{
+        return a.startTime < b;
+    };
+    auto it = std::lower_bound(sequence.begin(), sequence.end(), _currentTime, compareTime);
+
+    auto isRequested = [&instrumentRequest](const Image& i) {
+        return !i.activeInstruments.empty() && i.activeInstruments[0] == instrumentRequest;
+    };
+
+    if (Time::ref().deltaTime() >= 0.0) {
+        for (; it != sequence.end() && images.size() < static_cast<size_t>(count); ++it) {
+            if (isRequested(*it))
+                images.push_back(*it);
+        }
+    }
+    else {
+        while (it != sequence.begin() && images.size() < static_cast<size_t>(count)) {
+            --it;
+            if (isRequested(*it))
+                images.push_back(*it);
+        }
+    }
+}
+
 void ImageSequencer::sortData() {
     auto targetComparer = [](const std::pair<double, std::string> &a,
                              const std::pair<double, std::string> &b)->bool{
@@ -316,9 +482,8 @@ void ImageSequencer::sortData() {
     std::sort(_targetTimes.begin(), _targetTimes.end(), targetComparer);
     std::stable_sort(_captureProgression.begin(), _captureProgression.end());
 
-    for (auto sub : _subsetMap){
-        std::sort(_subsetMap[sub.first]._subset.begin(),
-                  _subsetMap[sub.first]._subset.end(), imageComparer);
+    for (auto& sub : _subsetMap){
+        std::sort(sub.second._subset.begin(), sub.second._subset.end(), imageComparer);
     }
 
     std::sort(
@@ -407,6 +572,9 @@ void ImageSequencer::runSequenceParser(SequenceParser* parser){
                 }
             }
         }
+
+        buildInstrumentIndex();
+        updateActiveInstruments();
         _hasData = true;
     }
     else
@@ -126,10 +126,46 @@ public:
                                         std::string projectee,
                                         std::string instrumentRequest);
 
+    /*
+     * Retrieves up to <code>count</code> images of <code>projectee</code> taken by
+     * <code>instrumentRequest</code> that will be captured next, following the current
+     * direction of time. These are the candidates for prefetching image data.
+     */
+    void getUpcomingImages(std::vector<Image>& images,
+                           const std::string& projectee,
+                           const std::string& instrumentRequest,
+                           int count) const;
+
+    /*
+     * An instrument that is active at the current time together with the fraction of its
+     * current activity interval that has passed.
+     */
+    struct ActiveInstrument {
+        int instrument;
+        float progress;
+    };
+
+    /*
+     * Returns the index under which the spice <code>instrumentID</code> is stored in the
+     * activity index, or -1 if the instrument is not part of any loaded sequence.
+     */
+    int instrumentIndex(const std::string& instrumentID) const;
+
+    /*
+     * Returns the spice id of the instrument stored under <code>index</code>.
+     */
+    const std::string& instrumentName(int index) const;
+
+    /*
+     * Returns all instruments that are active at the current time. The list is
+     * recomputed once whenever the sequencer's time changes.
+     */
+    const std::vector<ActiveInstrument>& activeInstruments() const;
+
     /*
      * returns true if instrumentID is within a capture range. 
      */
-    bool instrumentActive(std::string instrumentID);
+    bool instrumentActive(const std::string& instrumentID) const;
 
     float instrumentActiveTime(const std::string& instrumentID) const;
 
@@ -139,6 +175,17 @@ public:
     const Image getLatestImageForInstrument(const std::string _instrumentID);
 private:
     void sortData();
+
+    /*
+     * Builds the interval index over _instrumentTimes that is used to answer the
+     * activity queries.
+     */
+    void buildInstrumentIndex();
+
+    /*
+     * Updates _activeInstruments for the current time using the interval index.
+     */
+    void updateActiveInstruments();
     
     /*
      * _fileTranslation handles any types of ambiguities between the data and 
@@ -177,6 +224,28 @@ private:
      */
     std::vector<std::pair<std::string, TimeRange>> _instrumentTimes;
 
+    /*
+     * Activity interval of a single spice instrument. The intervals are sorted by their
+     * start time and form an implicit interval tree where each node at an odd index
+     * stores the maximum end time in its subtree in <code>maxEnd</code>.
+     */
+    struct InstrumentInterval {
+        double start;
+        double end;
+        double maxEnd;
+        int instrument;
+    };
+    std::vector<InstrumentInterval> _instrumentIntervals;
+    // The level of the root node of the implicit interval tree
+    int _instrumentIndexLevel;
+
+    // Interned spice instrument ids
+    std::unordered_map<std::string, int> _instrumentIndices;
+    std::vector<std::string> _instrumentNames;
+
+    // The instruments active at the current time
+    std::vector<ActiveInstrument> _activeInstruments;
+
     /*
     * Each consecutive images capture time, for easier traversal. 
     */
@@ -28,10 +28,13 @@
 #include <openspace/util/time.h>
 #include <openspace/util/spicemanager.h>
 #include <modules/newhorizons/util/decoder.h>
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iterator>
 #include <iomanip>
 #include <limits>
+#include <thread>
 
 #include <modules/newhorizons/util/labelparser.h>
 
@@ -100,28 +103,29 @@ LabelParser::LabelParser(std::string name, const std::string& fileName,
     }
 }
 
-std::string LabelParser::decode(std::string line){
-    for (auto key : _fileTranslation){
+std::string LabelParser::decode(const std::string& line) const {
+    for (const auto& key : _fileTranslation){
         std::size_t value = line.find(key.first);
         if (value != std::string::npos){
             std::string toTranslate = line.substr(value);
             
-            //if (_fileTranslation.find(toTranslate) == _fileTranslation.end()) {
-            //    // not found
-            //    _badDecoding = true;
-            //    LERROR("Could not fins '" << toTranslate << "' in translation map." <<
-            //           "\nPlease check label files");
-            //    return "";
-            //}
-            return _fileTranslation[toTranslate]->getTranslation()[0]; //lbls always 1:1 -> single value return
+            auto it = _fileTranslation.find(toTranslate);
+            if (it == _fileTranslation.end() || !it->second) {
+                // not found
+                //_badDecoding = true;
+                //LERROR("Could not fins '" << toTranslate << "' in translation map." <<
+                //       "\nPlease check label files");
+                return "";
+            }
+            return it->second->getTranslation()[0]; //lbls always 1:1 -> single value return
 
         }
     }
     return "";
 }
 
-std::string LabelParser::encode(std::string line) {
-    for (auto key : _fileTranslation) {
+std::string LabelParser::encode(const std::string& line) const {
+    for (const auto& key : _fileTranslation) {
         std::size_t value = line.find(key.first);
         if (value != std::string::npos) {
             return line.substr(value);
@@ -130,6 +134,92 @@ std::string LabelParser::encode(std::string line) {
     return "";
 }
 
+void LabelParser::parseLabelFile(std::string path, LabelFile& result) const {
+    std::ifstream file(path);
+    if (!file.good()) {
+        LERROR("Failed to open label file '" << path << "'");
+        result.success = false;
+        return;
+    }
+
+    size_t position = path.find_last_of(".") + 1;
+    int count = 0;
+
+    std::string target;
+    std::string instrumentID;
+    std::string startTime;
+
+    // open up label files
+    std::string line = "";
+    do {
+        std::getline(file, line);
+
+        std::string read = line.substr(0, line.find_first_of(" "));
+
+        line.erase(std::remove(line.begin(), line.end(), '"'), line.end());
+        line.erase(std::remove(line.begin(), line.end(), ' '), line.end());
+        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+
+        /* Add more  */
+        if (read == "TARGET_NAME"){
+            target = decode(line);
+            count++;
+        }
+        if (read == "INSTRUMENT_HOST_NAME"){
+            count++;
+        }
+        if (read == "INSTRUMENT_ID"){
+            instrumentID = decode(line);
+            result.labelName = encode(line);
+            result.hasLabelName = true;
+            count++;
+        }
+        if (read == "DETECTOR_TYPE"){
+            count++; 
+        }
+
+        if (read == "START_TIME"){
+            startTime = line.substr(line.find("=") + 2);
+            startTime.erase(
+                std::remove(startTime.begin(), startTime.end(), ' '),
+                startTime.end()
+            );
+            count++;
+
+            getline(file, line);
+            read = line.substr(0, line.find_first_of(" "));
+            if (read == "STOP_TIME"){
+                // The stop time is not used as labels describe instantaneous captures
+                count++;
+            }
+            else{
+                LERROR("Label file " + path + " deviates from generic standard!");
+                LINFO("Please make sure input data adheres to format https://pds.jpl.nasa.gov/documents/qs/labels.html");
+            }
+        }
+        if (count == _specsOfInterest.size()){
+            count = 0;
+            std::string ext = "jpg";
+            path.replace(path.begin() + position, path.end(), ext);
+            bool fileExists = FileSys.fileExists(path);
+            if (!fileExists) {
+                ext = "JPG";
+                path.replace(path.begin() + position, path.end(), ext);
+                fileExists = FileSys.fileExists(path);
+            }
+            if (fileExists) {
+                result.entries.push_back({ target, instrumentID, startTime, path });
+            }
+        }
+    } while (!file.eof());
+
+    result.success = true;
+}
+
+void LabelParser::setNumThreads(unsigned int nThreads) {
+    _nThreads = nThreads;
+}
+
 bool LabelParser::create() {
     auto imageComparer = [](const Image &a, const Image &b)->bool{
         return a.startTime < b.startTime;
@@ -149,159 +239,100 @@ bool LabelParser::create() {
     }
     using Recursive = ghoul::filesystem::Directory::Recursive;
     using Sort = ghoul::filesystem::Directory::Sort;
-    std::vector<std::string> sequencePaths = sequenceDir.read(Recursive::Yes, Sort::No);
-    for (auto path : sequencePaths){
-        if (size_t position = path.find_last_of(".") + 1){
-            if (position != std::string::npos){
-                ghoul::filesystem::File currentFile(path);
-                std::string extension = currentFile.fileExtension();
-                if (extension == "lbl" || extension == "LBL"){ // discovered header file         
-                    std::ifstream file(currentFile.path());
-
-                    if (!file.good()){
-                        LERROR("Failed to open label file '" << currentFile.path() << "'");
-                        return false;
-                    }
-                    
-                    int count = 0;
-
-                    // open up label files
-                    std::string line = "";
-                    std::string previousSequence;
-                    TimeRange instrumentRange;
-
-                    do {
-                        std::getline(file, line);
-
-                        std::string read = line.substr(0, line.find_first_of(" "));
-
-                        line.erase(std::remove(line.begin(), line.end(), '"'), line.end());
-                        line.erase(std::remove(line.begin(), line.end(), ' '), line.end());
-                        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
-
-                        _detectorType = "CAMERA"; //default value
-
-                        /* Add more  */
-                        if (read == "TARGET_NAME"){
-                            _target = decode(line);
-                            count++;
-                        }
-                        if (read == "INSTRUMENT_HOST_NAME"){
-                            _instrumentHostID = decode(line);
-                            count++;
-                        }
-                        if (read == "INSTRUMENT_ID"){
-                            _instrumentID = decode(line);
-                            lblName = encode(line);
-                            count++;
-                        }
-                        if (read == "DETECTOR_TYPE"){
-                            _detectorType = decode(line);
-                            count++; 
-                        }
-                    //    if (_badDecoding){
-                    //        LERROR("Please examine file: '" << currentFile.path() << "'");
-                    //        return false;
-                    //    }
-
-                        if (read == "START_TIME"){
-                            std::string start = line.substr(line.find("=") + 2);
-                            start.erase(std::remove(start.begin(), start.end(), ' '), start.end());
-                            _startTime = SpiceManager::ref().ephemerisTimeFromDate(start);
-                            count++;
-
-                            getline(file, line);
-                            read = line.substr(0, line.find_first_of(" "));
-                            if (read == "STOP_TIME"){
-                                std::string stop = line.substr(line.find("=") + 2);
-                                stop.erase(
-                                    std::remove_if(
-                                        stop.begin(),
-                                        stop.end(),
-                                        [](char c) { return c == ' ' || c == '\r'; }
-                                    ),
-                                    stop.end()
-                                );
-                                _stopTime = SpiceManager::ref().ephemerisTimeFromDate(stop);
-                                count++;
-                            }
-                            else{
-                                LERROR("Label file " + currentFile.path() + " deviates from generic standard!");
-                                LINFO("Please make sure input data adheres to format https://pds.jpl.nasa.gov/documents/qs/labels.html");
-                            }
-                        }
-                        if (count == _specsOfInterest.size()){
-                            count = 0;
-                            std::string ext = "jpg";
-                            path.replace(path.begin() + position, path.end(), ext);
-                            bool fileExists = FileSys.fileExists(path);
-                            if (!fileExists) {
-                                ext = "JPG";
-                                path.replace(path.begin() + position, path.end(), ext);
-                                fileExists = FileSys.fileExists(path);
-                            }
-                            if (fileExists) {
-                                Image image;
-                                std::vector<std::string> spiceInstrument;
-                                spiceInstrument.push_back(_instrumentID);
-                                createImage(image, _startTime, _startTime, spiceInstrument, _target, path);
-                                
-                                _subsetMap[image.target]._subset.push_back(image);
-                                _subsetMap[image.target]._range.setRange(_startTime);
-
-                                _captureProgression.push_back(_startTime);
-                                std::stable_sort(_captureProgression.begin(), _captureProgression.end());
-                            }
-    
-                        }
-                    } while (!file.eof());
-                }
+    std::vector<std::string> sequencePaths = sequenceDir.read(Recursive::Yes, Sort::Yes);
+
+    // The cache depends on the contents of the directory, since the existence of the
+    // images is checked, the modification dates of the labels, and the translation
+    std::string information = translationInformation(_fileTranslation);
+    for (const std::string& s : _specsOfInterest)
+        information += s + ";";
+    // The start times are converted with the loaded leap seconds kernel
+    information += kernelInformation();
+
+    std::vector<std::string> labelPaths;
+    for (const std::string& path : sequencePaths) {
+        information += path + ";";
+        if (path.find_last_of(".") != std::string::npos) {
+            ghoul::filesystem::File currentFile(path);
+            std::string extension = currentFile.fileExtension();
+            if (extension == "lbl" || extension == "LBL") { // discovered header file
+                labelPaths.push_back(currentFile.path());
+                information += currentFile.lastModifiedDate() + ";";
             }
         }
     }
+    information = std::to_string(std::hash<std::string>()(information));
+
+    const std::string cacheName = "LabelParser_" + _name;
+    if (loadCachedData(cacheName, information)) {
+        LINFO("Using cached label data for '" << sequenceDir.path() << "'");
+        sendPlaybookInformation(PlaybookIdentifierName);
+        return true;
+    }
+
+    // The label files are independent of each other and are read in parallel; the
+    // results are combined afterwards in the order of the files
+    std::vector<LabelFile> labelFiles(labelPaths.size());
+    std::atomic<size_t> nextFile(0);
+    auto parseFiles = [this, &labelPaths, &labelFiles, &nextFile]() {
+        size_t i;
+        while ((i = nextFile++) < labelPaths.size())
+            parseLabelFile(labelPaths[i], labelFiles[i]);
+    };
+
+    unsigned int nThreads = _nThreads > 0 ?
+        _nThreads : std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < nThreads; ++i)
+        threads.emplace_back(parseFiles);
+    parseFiles();
+    for (std::thread& t : threads)
+        t.join();
+
+    for (const LabelFile& labelFile : labelFiles) {
+        if (!labelFile.success)
+            return false;
+
+        if (labelFile.hasLabelName)
+            lblName = labelFile.labelName;
+
+        for (const LabelEntry& entry : labelFile.entries) {
+            double startTime = SpiceManager::ref().ephemerisTimeFromDate(entry.startTime);
+
+            Image image;
+            std::vector<std::string> spiceInstrument;
+            spiceInstrument.push_back(entry.instrumentID);
+            createImage(image, startTime, startTime, spiceInstrument, entry.target, entry.imagePath);
+
+            _subsetMap[image.target]._subset.push_back(image);
+            _subsetMap[image.target]._range.setRange(startTime);
+
+            _captureProgression.push_back(startTime);
+        }
+    }
+    std::stable_sort(_captureProgression.begin(), _captureProgression.end());
     
     std::vector<Image> tmp;
-    for (auto key : _subsetMap){
-        for (auto image : key.second._subset){
-            tmp.push_back(image);
-        }
+    for (const auto& key : _subsetMap){
+        tmp.insert(tmp.end(), key.second._subset.begin(), key.second._subset.end());
     }
     std::sort(tmp.begin(), tmp.end(), imageComparer);
 
-    for (auto image : tmp){
+    for (const auto& image : tmp){
         if (previousTarget != image.target){
             previousTarget = image.target;
             std::pair<double, std::string> v_target = std::make_pair(image.startTime, image.target);
             _targetTimes.push_back(v_target);
-            std::sort(_targetTimes.begin(), _targetTimes.end(), targetComparer);
         }
     }
+    std::sort(_targetTimes.begin(), _targetTimes.end(), targetComparer);
 
-    for (auto target : _subsetMap){
-        _instrumentTimes.push_back(std::make_pair(lblName, _subsetMap[target.first]._range));
-
-    //    std::string min, max;
-    //    SpiceManager::ref().getDateFromET(target.second._range._min, min);
-    //    SpiceManager::ref().getDateFromET(target.second._range._max, max);
-
-    //    myfile << std::endl;
-    //    for (auto image : target.second._subset){
-    //        std::string time_beg;
-    //        std::string time_end;
-    //        SpiceManager::ref().getDateFromET(image.startTime, time_beg);
-    //        SpiceManager::ref().getDateFromET(image.stopTime, time_end);
-
-    //        myfile << std::fixed
-    //            << " "   << time_beg
-    //            << "-->" << time_end
-    //            << " [ " << image.startTime
-    //            << " ] "   << image.target << std::setw(10);
-    //        for (auto instrument : image.activeInstruments){
-    //            myfile << " " << instrument;
-    //        }
-    //        myfile << std::endl;
-    //    }
+    for (const auto& target : _subsetMap){
+        _instrumentTimes.push_back(std::make_pair(lblName, target.second._range));
     }
+
+    saveCachedData(cacheName, information);
+
     sendPlaybookInformation(PlaybookIdentifierName);
     return true;
 }
@@ -42,10 +42,40 @@ public:
 
     bool create() override;
 
+    /**
+     * Sets the number of threads that read the label files. The default of
+     * <code>0</code> uses one thread per hardware thread.
+     */
+    void setNumThreads(unsigned int nThreads);
+
     // temporary need to figure this out
     std::map<std::string, Decoder*> getTranslation(){ return _fileTranslation; };
 
 private:
+    // The information about a single image that is extracted from a label file. The
+    // start time is kept as a string as the conversion requires SPICE, which is not
+    // thread-safe and is thus done after all label files have been read
+    struct LabelEntry {
+        std::string target;
+        std::string instrumentID;
+        std::string startTime;
+        std::string imagePath;
+    };
+
+    struct LabelFile {
+        std::vector<LabelEntry> entries;
+        // The last encoded instrument id found in the file, if any
+        std::string labelName;
+        bool hasLabelName = false;
+        bool success = false;
+    };
+
+    /**
+     * Reads the label file at <code>path</code> into <code>result</code>. This method
+     * does not modify the parser and is called concurrently for different files.
+     */
+    void parseLabelFile(std::string path, LabelFile& result) const;
+
     void createImage(Image& image,
                         double startTime,
                         double stopTime,
@@ -53,8 +83,8 @@ private:
                         std::string targ,
                         std::string path);
 
-    std::string decode(std::string line);
-    std::string encode(std::string line);
+    std::string decode(const std::string& line) const;
+    std::string encode(const std::string& line) const;
 
     bool augmentWithSpice(Image& image, 
                             std::string spacecraft, 
@@ -67,14 +97,8 @@ private:
     std::map<std::string, Decoder*> _fileTranslation;
     std::vector<std::string> _specsOfInterest;
 
-    std::string _target;
-    std::string _instrumentID;
-    std::string _instrumentHostID;
-    std::string _detectorType;
-    std::string _sequenceID;
-    double _startTime;
-    double _stopTime;
     bool _badDecoding;
+    unsigned int _nThreads = 0;
 };
 }
 #endif //__LABELPARSER_H__
\ No newline at end of file
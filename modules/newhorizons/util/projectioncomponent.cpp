@@ -27,6 +27,7 @@
 #include <modules/newhorizons/util/hongkangparser.h>
 #include <modules/newhorizons/util/imagesequencer.h>
 #include <modules/newhorizons/util/labelparser.h>
+#include <modules/newhorizons/util/projectionimageprefetcher.h>
 
 #include <openspace/scene/scenegraphnode.h>
 
@@ -35,6 +36,8 @@
 #include <ghoul/opengl/textureconversion.h>
 #include <ghoul/systemcapabilities/openglcapabilitiescomponent.h>
 
+#include <algorithm>
+
 namespace {
     const std::string keyPotentialTargets = "PotentialTargets";
 
@@ -59,6 +62,9 @@ namespace {
     const std::string placeholderFile =
         "${OPENSPACE_DATA}/scene/common/textures/placeholder.png";
 
+    const int PrefetchThreads = 2;
+    const size_t PrefetchCacheSize = 256 * 1024 * 1024;
+
     const std::string _loggerCat = "ProjectionComponent";
 }
 
@@ -71,15 +77,20 @@ ProjectionComponent::ProjectionComponent()
     , _performProjection("performProjection", "Perform Projections", true)
     , _clearAllProjections("clearAllProjections", "Clear Projections", false)
     , _projectionFading("projectionFading", "Projection Fading", 1.f, 0.f, 1.f)
+    , _prefetchedImages("prefetchedImages", "Prefetched Images", 32, 0, 256)
     , _projectionTexture(nullptr)
+    , _previousDeltaTime(0.0)
 {
     setName("ProjectionComponent");
 
     addProperty(_performProjection);
     addProperty(_clearAllProjections);
     addProperty(_projectionFading);
+    addProperty(_prefetchedImages);
 }
 
+ProjectionComponent::~ProjectionComponent() {}
+
 bool ProjectionComponent::initialize() {
     bool a = generateProjectionLayerTexture();
     bool b = auxiliaryRendertarget();
@@ -97,11 +108,17 @@ bool ProjectionComponent::initialize() {
         texture->setWrapping(Texture::WrappingMode::ClampToBorder);
     }
     _placeholderTexture = std::move(texture);
+
+    _prefetcher = std::make_unique<ProjectionImagePrefetcher>(
+        PrefetchThreads,
+        PrefetchCacheSize
+    );
     
     return a && b;
 }
 
 bool ProjectionComponent::deinitialize() {
+    _prefetcher = nullptr;
     _projectionTexture = nullptr;
 
     glDeleteFramebuffers(1, &_fboID);
@@ -372,7 +389,22 @@ std::shared_ptr<ghoul::opengl::Texture> ProjectionComponent::loadProjectionTextu
         return _placeholderTexture;
 
 
-    unique_ptr<Texture> texture = TextureReader::ref().loadTexture(absPath(texturePath));
+    const std::string path = absPath(texturePath);
+    unique_ptr<Texture> texture;
+
+    std::unique_ptr<ProjectionImagePrefetcher::ImageData> data =
+        _prefetcher ? _prefetcher->take(path) : nullptr;
+    if (data) {
+        texture = TextureReader::ref().loadTexture(
+            reinterpret_cast<void*>(data->buffer.data()),
+            data->buffer.size(),
+            data->format
+        );
+    }
+    else {
+        texture = TextureReader::ref().loadTexture(path);
+    }
+
     if (texture) {
         if (texture->format() == Texture::Format::Red)
             ghoul::opengl::convertTextureFormat(ghoul::opengl::Texture::Format::RGB, *texture);
@@ -385,6 +417,90 @@ std::shared_ptr<ghoul::opengl::Texture> ProjectionComponent::loadProjectionTextu
     return std::move(texture);
 }
 
+void ProjectionComponent::prefetchProjectionImages(const std::vector<Image>& images) {
+    if (!_prefetcher)
+        return;
+
+    std::vector<std::string> paths;
+    paths.reserve(images.size());
+    for (const Image& img : images)
+        paths.push_back(absPath(img.path));
+
+    _prefetcher->request(paths);
+}
+
+bool ProjectionComponent::isProjectionImageReady(const std::string& texturePath) const {
+    return _prefetcher && _prefetcher->isReady(absPath(texturePath));
+}
+
+int ProjectionComponent::numberOfPrefetchedImages() const {
+    return _prefetchedImages;
+}
+
+void ProjectionComponent::updateImageBacklog(std::vector<Image>& backlog,
+                                             const UpdateData& data)
+{
+    // Images that were captured before a time jump or a reversal of time would be
+    // projected at the wrong time
+    const bool isReversed = (data.delta * _previousDeltaTime) < 0.0;
+    if (data.isTimeJump || isReversed)
+        backlog.clear();
+    _previousDeltaTime = data.delta;
+
+    std::vector<Image> newImages;
+    bool hasNewImages = ImageSequencer::ref().getImagePaths(
+        newImages,
+        projecteeId(),
+        instrumentId()
+    );
+    if (hasNewImages)
+        backlog.insert(backlog.end(), newImages.begin(), newImages.end());
+
+    // Upcoming images are only looked up if the backlog leaves room for them
+    const size_t nPrefetched = static_cast<size_t>(numberOfPrefetchedImages());
+    std::vector<Image> upcoming;
+    if (backlog.size() < nPrefetched) {
+        ImageSequencer::ref().getUpcomingImages(
+            upcoming,
+            projecteeId(),
+            instrumentId(),
+            static_cast<int>(nPrefetched - backlog.size())
+        );
+    }
+    prefetchProjectionImages(imagesToPrefetch(backlog, upcoming, nPrefetched));
+}
+
+std::vector<Image> ProjectionComponent::imagesToPrefetch(
+                                                        const std::vector<Image>& backlog,
+                                                       const std::vector<Image>& upcoming,
+                                                                           size_t nImages)
+{
+    // The first images of the backlog are projected next, followed by the ones that will
+    // be captured next
+    std::vector<Image> result(
+        backlog.begin(),
+        backlog.begin() + std::min(nImages, backlog.size())
+    );
+    const size_t nUpcoming = std::min(nImages - result.size(), upcoming.size());
+    result.insert(result.end(), upcoming.begin(), upcoming.begin() + nUpcoming);
+    return result;
+}
+
+size_t ProjectionComponent::projectReadyImages(std::vector<Image>& backlog,
+                                         const std::function<bool(const Image&)>& isReady,
+                                         const std::function<void(const Image&)>& project)
+{
+    size_t nProjected = 0;
+    for (const Image& img : backlog) {
+        if (nProjected > 0 && !isReady(img))
+            break;
+        project(img);
+        ++nProjected;
+    }
+    backlog.erase(backlog.begin(), backlog.begin() + nProjected);
+    return nProjected;
+}
+
 bool ProjectionComponent::generateProjectionLayerTexture() {
     int maxSize = OpenGLCap.max2DTextureSize() / 2;
 
@@ -25,18 +25,26 @@
 #ifndef __PROJECTIONCOMPONENT_H__
 #define __PROJECTIONCOMPONENT_H__
 
+#include <modules/newhorizons/util/sequenceparser.h>
+
 #include <openspace/properties/propertyowner.h>
 #include <openspace/properties/scalarproperty.h>
 #include <openspace/util/spicemanager.h>
+#include <openspace/util/updatestructures.h>
 
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/opengl/texture.h>
 
+#include <functional>
+
 namespace openspace {
 
+class ProjectionImagePrefetcher;
+
 class ProjectionComponent : public properties::PropertyOwner {
 public:
     ProjectionComponent();
+    ~ProjectionComponent();
 
     bool initialize();
     bool deinitialize();
@@ -56,6 +64,52 @@ public:
         const std::string& texturePath,
         bool isPlaceholder = false
     );
+
+    /**
+     * Requests the images in <code>images</code> to be read in the background so that a
+     * later call to #loadProjectionTexture does not have to access the file system. The
+     * images should be ordered by the time at which they will be projected. Previous
+     * requests that are not part of <code>images</code> are discarded.
+     */
+    void prefetchProjectionImages(const std::vector<Image>& images);
+
+    /**
+     * Returns <code>true</code> if the image at <code>texturePath</code> has been read in
+     * the background and can be loaded without blocking on the file system.
+     */
+    bool isProjectionImageReady(const std::string& texturePath) const;
+
+    /// The number of upcoming images that should be prefetched
+    int numberOfPrefetchedImages() const;
+
+    /**
+     * Appends the images that were captured since the last update to
+     * <code>backlog</code>, which holds the images that still have to be projected, and
+     * prefetches the first of them together with the upcoming images. The backlog is
+     * discarded when the time jumps or changes direction, as its images no longer apply.
+     * Every other image stays in the backlog until it is projected.
+     */
+    void updateImageBacklog(std::vector<Image>& backlog, const UpdateData& data);
+
+    /**
+     * Returns the images that should be prefetched: the first images of
+     * <code>backlog</code>, followed by the <code>upcoming</code> images if there is room
+     * left. At most <code>nImages</code> images are returned, so the prefetcher reads
+     * less far ahead while a backlog builds up.
+     */
+    static std::vector<Image> imagesToPrefetch(const std::vector<Image>& backlog,
+        const std::vector<Image>& upcoming, size_t nImages);
+
+    /**
+     * Calls <code>project</code> for the first images of <code>backlog</code> and removes
+     * them from it. The first image is always projected to guarantee progress, the
+     * following ones only as long as <code>isReady</code> returns <code>true</code> for
+     * them, so that the projection does not block on the file system.
+     * \return The number of images that were projected
+     */
+    static size_t projectReadyImages(std::vector<Image>& backlog,
+        const std::function<bool(const Image&)>& isReady,
+        const std::function<void(const Image&)>& project);
     
     glm::mat4 computeProjectorMatrix(
         const glm::vec3 loc, glm::dvec3 aim, const glm::vec3 up,
@@ -89,11 +143,15 @@ protected:
     properties::BoolProperty _performProjection;
     properties::BoolProperty _clearAllProjections;
     properties::FloatProperty _projectionFading;
+    properties::IntProperty _prefetchedImages;
 
     std::unique_ptr<ghoul::opengl::Texture> _projectionTexture;
 
     std::shared_ptr<ghoul::opengl::Texture> _placeholderTexture;
 
+    std::unique_ptr<ProjectionImagePrefetcher> _prefetcher;
+    double _previousDeltaTime;
+
     std::string _instrumentID;
     std::string _projectorID;
     std::string _projecteeID;
@@ -0,0 +1,175 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/newhorizons/util/projectionimageprefetcher.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+namespace openspace {
+
+ProjectionImagePrefetcher::ProjectionImagePrefetcher(int nThreads,
+                                                     size_t maximumCacheSize)
+    : _stop(false)
+    , _cacheSize(0)
+    , _maximumCacheSize(maximumCacheSize)
+{
+    for (int i = 0; i < nThreads; ++i) {
+        _workers.emplace_back(&ProjectionImagePrefetcher::work, this);
+    }
+}
+
+ProjectionImagePrefetcher::~ProjectionImagePrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+void ProjectionImagePrefetcher::request(const std::vector<std::string>& paths) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Cached images that are no longer requested are stale, most likely because of a
+        // time jump, and would otherwise occupy the cache indefinitely
+        std::unordered_set<std::string> requested(paths.begin(), paths.end());
+        for (auto it = _cacheOrder.begin(); it != _cacheOrder.end();) {
+            if (requested.find(*it) == requested.end()) {
+                auto c = _cache.find(*it);
+                _cacheSize -= c->second.data->buffer.size();
+                _cache.erase(c);
+                it = _cacheOrder.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+
+        _pending.clear();
+        _pendingPaths.clear();
+        for (const std::string& path : paths) {
+            bool isKnown =
+                (_cache.find(path) != _cache.end()) ||
+                (_inFlight.find(path) != _inFlight.end()) ||
+                (_pendingPaths.find(path) != _pendingPaths.end());
+
+            if (!isKnown) {
+                _pending.push_back(path);
+                _pendingPaths.insert(path);
+            }
+        }
+    }
+    _condition.notify_all();
+}
+
+bool ProjectionImagePrefetcher::isReady(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cache.find(path) != _cache.end();
+}
+
+std::unique_ptr<ProjectionImagePrefetcher::ImageData> ProjectionImagePrefetcher::take(
+                                                                  const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _cache.find(path);
+    if (it == _cache.end()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<ImageData> data = std::move(it->second.data);
+    _cacheSize -= data->buffer.size();
+    _cacheOrder.erase(it->second.order);
+    _cache.erase(it);
+    _condition.notify_all();
+    return data;
+}
+
+void ProjectionImagePrefetcher::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending.clear();
+    _pendingPaths.clear();
+    _cache.clear();
+    _cacheOrder.clear();
+    _cacheSize = 0;
+    _condition.notify_all();
+}
+
+void ProjectionImagePrefetcher::work() {
+    while (true) {
+        std::string path;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            // Only start reading a new image if there is room left in the cache; the
+            // cache may exceed its maximum size by at most one image per worker
+            _condition.wait(lock, [this]() {
+                return _stop || (!_pending.empty() && _cacheSize < _maximumCacheSize);
+            });
+            if (_stop) {
+                return;
+            }
+            path = std::move(_pending.front());
+            _pending.pop_front();
+            _pendingPaths.erase(path);
+            _inFlight.insert(path);
+        }
+
+        std::unique_ptr<ImageData> data = std::make_unique<ImageData>();
+        std::ifstream file(path, std::ifstream::binary | std::ifstream::ate);
+        bool success = file.good();
+        if (success) {
+            std::streamsize size = file.tellg();
+            file.seekg(0, std::ifstream::beg);
+            data->buffer.resize(static_cast<size_t>(size));
+            success = static_cast<bool>(file.read(data->buffer.data(), size));
+        }
+
+        std::string::size_type dot = path.find_last_of('.');
+        if (dot != std::string::npos) {
+            data->format = path.substr(dot + 1);
+            std::transform(
+                data->format.begin(),
+                data->format.end(),
+                data->format.begin(),
+                [](char c) { return static_cast<char>(::tolower(c)); }
+            );
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _inFlight.erase(path);
+        // Failed reads are not cached; the consumer will then fall back to reading the
+        // image itself and report the error
+        if (success && _cache.find(path) == _cache.end()) {
+            _cacheSize += data->buffer.size();
+            _cacheOrder.push_back(path);
+            _cache[path] = { std::move(data), std::prev(_cacheOrder.end()) };
+        }
+    }
+}
+
+} // namespace openspace
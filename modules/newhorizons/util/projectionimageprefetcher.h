@@ -0,0 +1,116 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __PROJECTIONIMAGEPREFETCHER_H__
+#define __PROJECTIONIMAGEPREFETCHER_H__
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The ProjectionImagePrefetcher reads the image files of upcoming projections on a set
+ * of worker threads and keeps their contents in a memory cache that is bounded in the
+ * number of bytes. The render thread can then create the projection texture directly from
+ * memory instead of blocking on the file system. The list of images that should be
+ * fetched is replaced on every call to #request, which automatically cancels requests
+ * and drops cached images that are no longer relevant (for example after a time jump).
+ * Workers pause while the cache is full until images are taken out of it.
+ */
+class ProjectionImagePrefetcher {
+public:
+    /// The raw, still encoded, contents of an image file together with its format
+    struct ImageData {
+        std::vector<char> buffer;
+        std::string format;
+    };
+
+    /**
+     * Creates the prefetcher and starts <code>nThreads</code> worker threads.
+     * \param nThreads The number of worker threads that read images
+     * \param maximumCacheSize The maximum number of bytes kept in the cache
+     */
+    ProjectionImagePrefetcher(int nThreads, size_t maximumCacheSize);
+    ~ProjectionImagePrefetcher();
+
+    /**
+     * Replaces the list of pending requests with <code>paths</code>. The paths are read
+     * in the provided order and paths that are already cached or currently being read
+     * are skipped. The paths have to be absolute paths.
+     */
+    void request(const std::vector<std::string>& paths);
+
+    /**
+     * Returns <code>true</code> if the contents of the image at <code>path</code> are
+     * available in the cache.
+     */
+    bool isReady(const std::string& path) const;
+
+    /**
+     * Removes the contents of the image at <code>path</code> from the cache and returns
+     * them. If the image is not available, <code>nullptr</code> is returned.
+     */
+    std::unique_ptr<ImageData> take(const std::string& path);
+
+    /// Removes all pending requests and all cached images
+    void clear();
+
+private:
+    void work();
+
+    std::vector<std::thread> _workers;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stop;
+
+    std::deque<std::string> _pending;
+    // The same paths as _pending, for fast lookups
+    std::unordered_set<std::string> _pendingPaths;
+    std::unordered_set<std::string> _inFlight;
+
+    // Cached images together with their position in the insertion order
+    struct CacheEntry {
+        std::unique_ptr<ImageData> data;
+        std::list<std::string>::iterator order;
+    };
+    std::unordered_map<std::string, CacheEntry> _cache;
+    std::list<std::string> _cacheOrder;
+
+    size_t _cacheSize;
+    size_t _maximumCacheSize;
+};
+
+} // namespace openspace
+
+#endif // __PROJECTIONIMAGEPREFETCHER_H__
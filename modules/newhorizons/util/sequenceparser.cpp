@@ -28,13 +28,53 @@
 #include <openspace/util/spicemanager.h>
 #include <modules/newhorizons/util/decoder.h>
 
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 
+#include <fstream>
+
 namespace {
     const std::string _loggerCat = "SequenceParser";
     const std::string keyTranslation = "DataInputTranslation";
 
     const std::string PlaybookIdentifierName = "Playbook";
+
+    const int8_t CurrentCacheVersion = 1;
+
+    template <typename T>
+    void writeValue(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeValue(std::ofstream& file, const std::string& value) {
+        uint32_t length = static_cast<uint32_t>(value.size());
+        writeValue(file, length);
+        file.write(value.data(), length);
+    }
+
+    template <typename T>
+    void readValue(std::ifstream& file, T& value) {
+        file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+
+    void readValue(std::ifstream& file, std::string& value) {
+        uint32_t length = 0;
+        readValue(file, length);
+        value.resize(length);
+        if (length > 0)
+            file.read(&value[0], length);
+    }
+
+    void writeValue(std::ofstream& file, const openspace::TimeRange& range) {
+        writeValue(file, range._min);
+        writeValue(file, range._max);
+    }
+
+    void readValue(std::ifstream& file, openspace::TimeRange& range) {
+        readValue(file, range._min);
+        readValue(file, range._max);
+    }
 }
 
 namespace openspace {
@@ -168,4 +208,194 @@ void SequenceParser::sendPlaybookInformation(const std::string& name) {
     OsEng.networkEngine().setInitialConnectionMessage(_messageIdentifier, buffer);
 }
 
-}
\ No newline at end of file
+std::string SequenceParser::translationInformation(
+                                         const std::map<std::string, Decoder*>& translation)
+{
+    std::string information;
+    for (const std::pair<const std::string, Decoder*>& t : translation) {
+        if (!t.second)
+            continue;
+        information += t.first + "=" + t.second->getDecoderType() + ":";
+        for (const std::string& spiceID : t.second->getTranslation())
+            information += spiceID + ",";
+        information += ";";
+    }
+    return information;
+}
+
+std::string SequenceParser::kernelInformation() {
+    // A kernel can be replaced by a newer version under the same name
+    std::string information;
+    for (const std::string& kernel : SpiceManager::ref().loadedKernels()) {
+        information += kernel + "@";
+        information += ghoul::filesystem::File(kernel).lastModifiedDate() + ";";
+    }
+    return information;
+}
+
+void SequenceParser::setCacheEnabled(bool isEnabled) {
+    _isCacheEnabled = isEnabled;
+}
+
+bool SequenceParser::loadCachedData(const std::string& cacheName,
+                                    const std::string& information)
+{
+    if (!_isCacheEnabled || !FileSys.cacheManager())
+        return false;
+
+    std::string cachedFile = FileSys.cacheManager()->cachedFilename(
+        cacheName,
+        information,
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+    if (!FileSys.fileExists(cachedFile))
+        return false;
+
+    std::ifstream file(cachedFile, std::ifstream::binary);
+    if (!file.good())
+        return false;
+
+    int8_t version = 0;
+    readValue(file, version);
+    if (version != CurrentCacheVersion) {
+        LINFO("The format of the cached file has changed, deleting old cache");
+        file.close();
+        FileSys.deleteFile(cachedFile);
+        return false;
+    }
+
+    std::map<std::string, ImageSubset> subsetMap;
+    std::vector<std::pair<std::string, TimeRange>> instrumentTimes;
+    std::vector<std::pair<double, std::string>> targetTimes;
+    std::vector<double> captureProgression;
+
+    uint32_t nSubsets = 0;
+    readValue(file, nSubsets);
+    for (uint32_t i = 0; i < nSubsets && file.good(); ++i) {
+        std::string target;
+        readValue(file, target);
+        ImageSubset& subset = subsetMap[target];
+        readValue(file, subset._range);
+
+        uint32_t nImages = 0;
+        readValue(file, nImages);
+        subset._subset.resize(nImages);
+        for (Image& image : subset._subset) {
+            readValue(file, image.startTime);
+            readValue(file, image.stopTime);
+            readValue(file, image.path);
+            uint32_t nInstruments = 0;
+            readValue(file, nInstruments);
+            image.activeInstruments.resize(nInstruments);
+            for (std::string& instrument : image.activeInstruments)
+                readValue(file, instrument);
+            readValue(file, image.target);
+            readValue(file, image.isPlaceholder);
+            readValue(file, image.projected);
+
+            if (!file.good())
+                break;
+        }
+    }
+
+    uint32_t nInstrumentTimes = 0;
+    readValue(file, nInstrumentTimes);
+    instrumentTimes.resize(nInstrumentTimes);
+    for (std::pair<std::string, TimeRange>& p : instrumentTimes) {
+        readValue(file, p.first);
+        readValue(file, p.second);
+    }
+
+    uint32_t nTargetTimes = 0;
+    readValue(file, nTargetTimes);
+    targetTimes.resize(nTargetTimes);
+    for (std::pair<double, std::string>& p : targetTimes) {
+        readValue(file, p.first);
+        readValue(file, p.second);
+    }
+
+    uint32_t nCaptures = 0;
+    readValue(file, nCaptures);
+    captureProgression.resize(nCaptures);
+    if (nCaptures > 0) {
+        file.read(
+            reinterpret_cast<char*>(captureProgression.data()),
+            nCaptures * sizeof(double)
+        );
+    }
+
+    if (!file.good()) {
+        LWARNING("Cache file '" << cachedFile << "' is corrupt, deleting it");
+        file.close();
+        FileSys.deleteFile(cachedFile);
+        return false;
+    }
+
+    _subsetMap = std::move(subsetMap);
+    _instrumentTimes = std::move(instrumentTimes);
+    _targetTimes = std::move(targetTimes);
+    _captureProgression = std::move(captureProgression);
+    return true;
+}
+
+bool SequenceParser::saveCachedData(const std::string& cacheName,
+                                    const std::string& information) const
+{
+    if (!_isCacheEnabled || !FileSys.cacheManager())
+        return false;
+
+    std::string cachedFile = FileSys.cacheManager()->cachedFilename(
+        cacheName,
+        information,
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+
+    std::ofstream file(cachedFile, std::ofstream::binary);
+    if (!file.good()) {
+        LERROR("Error opening file '" << cachedFile << "' for save cache file");
+        return false;
+    }
+
+    writeValue(file, CurrentCacheVersion);
+
+    writeValue(file, static_cast<uint32_t>(_subsetMap.size()));
+    for (const std::pair<const std::string, ImageSubset>& subset : _subsetMap) {
+        writeValue(file, subset.first);
+        writeValue(file, subset.second._range);
+
+        writeValue(file, static_cast<uint32_t>(subset.second._subset.size()));
+        for (const Image& image : subset.second._subset) {
+            writeValue(file, image.startTime);
+            writeValue(file, image.stopTime);
+            writeValue(file, image.path);
+            writeValue(file, static_cast<uint32_t>(image.activeInstruments.size()));
+            for (const std::string& instrument : image.activeInstruments)
+                writeValue(file, instrument);
+            writeValue(file, image.target);
+            writeValue(file, image.isPlaceholder);
+            writeValue(file, image.projected);
+        }
+    }
+
+    writeValue(file, static_cast<uint32_t>(_instrumentTimes.size()));
+    for (const std::pair<std::string, TimeRange>& p : _instrumentTimes) {
+        writeValue(file, p.first);
+        writeValue(file, p.second);
+    }
+
+    writeValue(file, static_cast<uint32_t>(_targetTimes.size()));
+    for (const std::pair<double, std::string>& p : _targetTimes) {
+        writeValue(file, p.first);
+        writeValue(file, p.second);
+    }
+
+    writeValue(file, static_cast<uint32_t>(_captureProgression.size()));
+    file.write(
+        reinterpret_cast<const char*>(_captureProgression.data()),
+        _captureProgression.size() * sizeof(double)
+    );
+
+    return file.good();
+}
+
+} // namespace openspace
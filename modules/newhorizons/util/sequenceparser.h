@@ -75,15 +75,55 @@ public:
     virtual std::map<std::string, Decoder*> getTranslation() = 0;
     virtual std::vector<double> getCaptureProgression() final;
 
+    /**
+     * Enables or disables the persistent cache of the parsed data. If it is disabled,
+     * the input is always parsed and no cache file is written.
+     */
+    void setCacheEnabled(bool isEnabled);
+
 protected:
     void sendPlaybookInformation(const std::string& name);
 
+    /**
+     * Fills the parsed data structures from the persistent cache file that is identified
+     * by <code>cacheName</code> and <code>information</code>. The
+     * <code>information</code> has to change whenever any of the parser's inputs change,
+     * for example by including the modification dates of all parsed files.
+     * \return <code>true</code> if a valid cache file was found and loaded
+     */
+    bool loadCachedData(const std::string& cacheName, const std::string& information);
+
+    /**
+     * Stores the parsed data structures in the persistent cache file that is identified
+     * by <code>cacheName</code> and <code>information</code>.
+     * \see loadCachedData
+     */
+    bool saveCachedData(const std::string& cacheName,
+        const std::string& information) const;
+
+    /**
+     * Returns a string describing the translation in <code>translation</code> that can be
+     * used as part of the cache information passed to #loadCachedData.
+     */
+    static std::string translationInformation(
+        const std::map<std::string, Decoder*>& translation);
+
+    /**
+     * Returns a string describing the currently loaded SPICE kernels that can be used as
+     * part of the cache information passed to #loadCachedData by parsers whose results
+     * depend on SPICE, for example through time conversions or target lookups.
+     */
+    static std::string kernelInformation();
+
     std::map<std::string, ImageSubset> _subsetMap;
     std::vector<std::pair<std::string, TimeRange>> _instrumentTimes;
     std::vector<std::pair<double, std::string>> _targetTimes;
     std::vector<double> _captureProgression;
 
     NetworkEngine::MessageIdentifier _messageIdentifier;
+
+private:
+    bool _isCacheEnabled = true;
 };
 
 } // namespace openspace
@@ -45,6 +45,13 @@ void renderTooltip(Property* prop) {
 }
 
 void executeScript(const std::string& id, const std::string& value) {
+    // Literal values are applied without the Lua interpreter
+    scripting::PropertyAssignment assignment;
+    if (scripting::PropertyAssignment::fromLiteral(id, value, assignment)) {
+        OsEng.scriptEngine().queuePropertyAssignment(std::move(assignment));
+        return;
+    }
+
     std::string script =
         "openspace.setPropertyValueSingle('" + id + "', " + value + ");";
     OsEng.scriptEngine().queueScript(script);
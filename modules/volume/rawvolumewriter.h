@@ -18,6 +18,14 @@ public:
                const std::function<void(float t)>& onProgress = [](float t) {});
     void write(const RawVolume<VoxelType>& volume);
 
+    /**
+     * Writes the volume one z-slice at a time. <code>fn</code> is called in increasing
+     * z order to fill a slice of <code>dimensions().x * dimensions().y</code> voxels,
+     * while the previous slice is written to disk on a separate thread.
+     */
+    void writeSlices(const std::function<void(int z, VoxelType* slice)>& fn,
+                     const std::function<void(float t)>& onProgress = [](float t) {});
+
     size_t coordsToIndex(const glm::ivec3& coords) const;
     glm::ivec3 indexToCoords(size_t linear) const;
 private:
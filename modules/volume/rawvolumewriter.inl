@@ -1,4 +1,5 @@
 #include <fstream>
+#include <future>
 #include <modules/volume/volumeutils.h>
 
 namespace openspace {
@@ -60,6 +61,43 @@ void RawVolumeWriter<VoxelType>::write(const std::function<VoxelType(const glm::
     file.close();
 }
 
+template <typename VoxelType>
+void RawVolumeWriter<VoxelType>::writeSlices(
+                                  const std::function<void(int z, VoxelType* slice)>& fn,
+                                  const std::function<void(float t)>& onProgress)
+{
+    glm::ivec3 dims = dimensions();
+    size_t sliceSize = static_cast<size_t>(dims.x) * static_cast<size_t>(dims.y);
+
+    std::ofstream file(_path, std::ios::binary);
+
+    // Double buffering: one slice is filled while the other one is being written
+    std::vector<VoxelType> buffers[2] = {
+        std::vector<VoxelType>(sliceSize),
+        std::vector<VoxelType>(sliceSize)
+    };
+    std::future<void> pendingWrite;
+
+    for (int z = 0; z < dims.z; z++) {
+        std::vector<VoxelType>& buffer = buffers[z % 2];
+        fn(z, buffer.data());
+
+        if (pendingWrite.valid()) {
+            pendingWrite.get();
+        }
+        pendingWrite = std::async(std::launch::async, [&file, &buffer, sliceSize]() {
+            file.write(reinterpret_cast<const char*>(buffer.data()),
+                       sliceSize * sizeof(VoxelType));
+        });
+        onProgress(static_cast<float>(z + 1) / dims.z);
+    }
+
+    if (pendingWrite.valid()) {
+        pendingWrite.get();
+    }
+    file.close();
+}
+
 template <typename VoxelType>    
 void RawVolumeWriter<VoxelType>::write(const RawVolume<VoxelType>& volume) {
     glm::ivec3 dims = dimensions();
@@ -0,0 +1,128 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __VOLUMERESAMPLER_H__
+#define __VOLUMERESAMPLER_H__
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Resamples a volume to new dimensions one output z-slice at a time, producing the same
+ * result as the VolumeSampler box filter. The filter is separable, so every input slice
+ * is first filtered in x and y and then kept until no later output slice depends on it.
+ * Output slices are combined from the pinned, filtered input slices in z. Requesting the
+ * output slices in increasing order thus reads every input slice exactly once. The
+ * filtering of each slice is split across <code>nThreads</code> threads, which are
+ * started once by the constructor and include the calling thread; input slices are read
+ * from the volume on the calling thread only.
+ */
+template <typename VolumeType>
+class VolumeResampler {
+public:
+    typedef typename VolumeType::VoxelType VoxelType;
+
+    /**
+     * \param volume The volume to resample. It has to outlive the resampler
+     * \param outDimensions The dimensions of the resampled volume
+     * \param nThreads The number of threads to use. If it is 0, the number of hardware
+     * threads is used
+     */
+    VolumeResampler(const VolumeType& volume, const glm::ivec3& outDimensions,
+        unsigned int nThreads = 0);
+
+    /// Stops the worker threads
+    ~VolumeResampler();
+
+    VolumeResampler(const VolumeResampler&) = delete;
+    VolumeResampler& operator=(const VolumeResampler&) = delete;
+
+    glm::ivec3 dimensions() const;
+
+    /**
+     * Writes the output slice <code>z</code> into <code>slice</code>, which has to hold
+     * <code>dimensions().x * dimensions().y</code> voxels.
+     */
+    void sampleSlice(int z, VoxelType* slice);
+
+private:
+    // The taps of a one-dimensional filter for every output coordinate. The indices are
+    // clamped to the input volume and the weights are normalized
+    struct Kernel {
+        int nTaps;
+        std::vector<int> indices;
+        std::vector<float> weights;
+    };
+
+    static Kernel createKernel(int inSize, int outSize);
+
+    const std::vector<VoxelType>& filteredSlice(int inZ);
+    /**
+     * Calls <code>fn</code> for every index in [<code>begin</code>, <code>end</code>).
+     * The indices are split into one contiguous range per thread and the calling thread
+     * processes the last range while the workers process the others.
+     */
+    void parallelFor(int begin, int end, const std::function<void(int)>& fn);
+    void work(unsigned int worker);
+
+    const VolumeType* _volume;
+    glm::ivec3 _inDimensions;
+    glm::ivec3 _outDimensions;
+    unsigned int _nThreads;
+
+    Kernel _kernelX;
+    Kernel _kernelY;
+    Kernel _kernelZ;
+
+    std::vector<VoxelType> _inputSlice;
+    std::vector<VoxelType> _rowFilteredSlice;
+    std::map<int, std::vector<VoxelType>> _filteredSlices;
+
+    // The pass of parallelFor that the workers are currently processing. A new pass is
+    // announced by incrementing _passNumber
+    std::vector<std::thread> _workers;
+    std::mutex _passMutex;
+    std::condition_variable _passStarted;
+    std::condition_variable _passFinished;
+    const std::function<void(int)>* _passFunction;
+    int _passBegin;
+    int _passEnd;
+    unsigned int _passNumber;
+    unsigned int _nBusyWorkers;
+    bool _isStopping;
+};
+
+} // namespace openspace
+
+#include "volumeresampler.inl"
+
+#endif // __VOLUMERESAMPLER_H__
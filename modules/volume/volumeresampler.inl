@@ -0,0 +1,265 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+namespace openspace {
+
+template <typename VolumeType>
+VolumeResampler<VolumeType>::VolumeResampler(const VolumeType& volume,
+                                             const glm::ivec3& outDimensions,
+                                             unsigned int nThreads)
+    : _volume(&volume)
+    , _inDimensions(volume.dimensions())
+    , _outDimensions(outDimensions)
+    , _nThreads(nThreads)
+    , _passFunction(nullptr)
+    , _passBegin(0)
+    , _passEnd(0)
+    , _passNumber(0)
+    , _nBusyWorkers(0)
+    , _isStopping(false)
+{
+    if (_nThreads == 0) {
+        _nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    _kernelX = createKernel(_inDimensions.x, _outDimensions.x);
+    _kernelY = createKernel(_inDimensions.y, _outDimensions.y);
+    _kernelZ = createKernel(_inDimensions.z, _outDimensions.z);
+
+    _inputSlice.resize(static_cast<size_t>(_inDimensions.x) * _inDimensions.y);
+    _rowFilteredSlice.resize(static_cast<size_t>(_outDimensions.x) * _inDimensions.y);
+
+    // The calling thread is one of the threads
+    for (unsigned int i = 0; i + 1 < _nThreads; ++i) {
+        _workers.emplace_back([this, i]() { work(i); });
+    }
+}
+
+template <typename VolumeType>
+VolumeResampler<VolumeType>::~VolumeResampler() {
+    {
+        std::lock_guard<std::mutex> lock(_passMutex);
+        _isStopping = true;
+    }
+    _passStarted.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+template <typename VolumeType>
+glm::ivec3 VolumeResampler<VolumeType>::dimensions() const {
+    return _outDimensions;
+}
+
+template <typename VolumeType>
+typename VolumeResampler<VolumeType>::Kernel
+VolumeResampler<VolumeType>::createKernel(int inSize, int outSize)
+{
+    // Same filter as the VolumeSampler: A box filter of the closest odd size below the
+    // resolution ratio, linearly interpolated at both ends
+    float ratio = static_cast<float>(inSize) / static_cast<float>(outSize);
+    int filterSize = static_cast<int>((ratio - 1.f) * 0.5f) * 2 + 1;
+
+    Kernel kernel;
+    kernel.nTaps = filterSize + 1;
+    kernel.indices.resize(static_cast<size_t>(outSize) * kernel.nTaps);
+    kernel.weights.resize(static_cast<size_t>(outSize) * kernel.nTaps);
+
+    for (int i = 0; i < outSize; ++i) {
+        float position = (static_cast<float>(i) + 0.5f) * ratio - 0.5f;
+        float floored = std::floor(position);
+        float t = position - floored;
+        int minCoord = static_cast<int>(floored) - filterSize / 2;
+
+        for (int k = 0; k < kernel.nTaps; ++k) {
+            float weight = 1.f;
+            if (k == 0) {
+                weight = 1.f - t;
+            } else if (k == filterSize) {
+                weight = t;
+            }
+
+            size_t tap = static_cast<size_t>(i) * kernel.nTaps + k;
+            kernel.indices[tap] = glm::clamp(minCoord + k, 0, inSize - 1);
+            kernel.weights[tap] = weight / static_cast<float>(filterSize);
+        }
+    }
+    return kernel;
+}
+
+template <typename VolumeType>
+void VolumeResampler<VolumeType>::sampleSlice(int z, VoxelType* slice) {
+    const int* indices = &_kernelZ.indices[static_cast<size_t>(z) * _kernelZ.nTaps];
+    const float* weights = &_kernelZ.weights[static_cast<size_t>(z) * _kernelZ.nTaps];
+
+    // The taps are sorted, so every slice before the first tap is no longer needed when
+    // the output slices are requested in order
+    _filteredSlices.erase(_filteredSlices.begin(), _filteredSlices.lower_bound(indices[0]));
+
+    std::vector<const VoxelType*> taps(_kernelZ.nTaps);
+    for (int k = 0; k < _kernelZ.nTaps; ++k) {
+        taps[k] = filteredSlice(indices[k]).data();
+    }
+
+    const int width = _outDimensions.x;
+    parallelFor(0, _outDimensions.y, [&](int y) {
+        size_t rowOffset = static_cast<size_t>(y) * width;
+        VoxelType* row = slice + rowOffset;
+        std::fill(row, row + width, VoxelType(0));
+        for (int k = 0; k < _kernelZ.nTaps; ++k) {
+            const VoxelType* tapRow = taps[k] + rowOffset;
+            for (int x = 0; x < width; ++x) {
+                row[x] += weights[k] * tapRow[x];
+            }
+        }
+    });
+}
+
+template <typename VolumeType>
+const std::vector<typename VolumeType::VoxelType>&
+VolumeResampler<VolumeType>::filteredSlice(int inZ)
+{
+    auto it = _filteredSlices.find(inZ);
+    if (it != _filteredSlices.end()) {
+        return it->second;
+    }
+
+    // Reading is not necessarily thread-safe for the underlying volume
+    const int inWidth = _inDimensions.x;
+    for (int y = 0; y < _inDimensions.y; ++y) {
+        for (int x = 0; x < inWidth; ++x) {
+            _inputSlice[static_cast<size_t>(y) * inWidth + x] =
+                _volume->get(glm::ivec3(x, y, inZ));
+        }
+    }
+
+    const int outWidth = _outDimensions.x;
+
+    // Filter every input row in x
+    parallelFor(0, _inDimensions.y, [&](int y) {
+        const VoxelType* in = &_inputSlice[static_cast<size_t>(y) * inWidth];
+        VoxelType* out = &_rowFilteredSlice[static_cast<size_t>(y) * outWidth];
+        for (int x = 0; x < outWidth; ++x) {
+            size_t tap = static_cast<size_t>(x) * _kernelX.nTaps;
+            VoxelType value(0);
+            for (int k = 0; k < _kernelX.nTaps; ++k) {
+                value += _kernelX.weights[tap + k] * in[_kernelX.indices[tap + k]];
+            }
+            out[x] = value;
+        }
+    });
+
+    // Filter the result in y
+    std::vector<VoxelType>& filtered = _filteredSlices[inZ];
+    filtered.resize(static_cast<size_t>(outWidth) * _outDimensions.y);
+    parallelFor(0, _outDimensions.y, [&](int y) {
+        VoxelType* out = &filtered[static_cast<size_t>(y) * outWidth];
+        std::fill(out, out + outWidth, VoxelType(0));
+
+        size_t tap = static_cast<size_t>(y) * _kernelY.nTaps;
+        for (int k = 0; k < _kernelY.nTaps; ++k) {
+            const float weight = _kernelY.weights[tap + k];
+            const VoxelType* in =
+                &_rowFilteredSlice[static_cast<size_t>(_kernelY.indices[tap + k]) * outWidth];
+            for (int x = 0; x < outWidth; ++x) {
+                out[x] += weight * in[x];
+            }
+        }
+    });
+    return filtered;
+}
+
+template <typename VolumeType>
+void VolumeResampler<VolumeType>::parallelFor(int begin, int end,
+                                              const std::function<void(int)>& fn)
+{
+    const int n = end - begin;
+    if (_workers.empty() || n <= 1) {
+        for (int i = begin; i < end; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_passMutex);
+        _passFunction = &fn;
+        _passBegin = begin;
+        _passEnd = end;
+        _nBusyWorkers = static_cast<unsigned int>(_workers.size());
+        ++_passNumber;
+    }
+    _passStarted.notify_all();
+
+    // Contiguous ranges keep the rows of each thread together in memory
+    const int64_t nRanges = _nThreads;
+    const int first = begin + static_cast<int>(n * (nRanges - 1) / nRanges);
+    for (int i = first; i < end; ++i) {
+        fn(i);
+    }
+
+    std::unique_lock<std::mutex> lock(_passMutex);
+    _passFinished.wait(lock, [this]() { return _nBusyWorkers == 0; });
+}
+
+template <typename VolumeType>
+void VolumeResampler<VolumeType>::work(unsigned int worker) {
+    // One range per worker and the last one for the calling thread
+    const int64_t nRanges = _nThreads;
+    unsigned int lastPass = 0;
+    std::unique_lock<std::mutex> lock(_passMutex);
+    while (true) {
+        _passStarted.wait(lock, [this, lastPass]() {
+            return _isStopping || _passNumber != lastPass;
+        });
+        if (_isStopping) {
+            return;
+        }
+        lastPass = _passNumber;
+
+        const std::function<void(int)>& fn = *_passFunction;
+        const int begin = _passBegin;
+        const int64_t n = _passEnd - _passBegin;
+        lock.unlock();
+
+        const int first = begin + static_cast<int>(n * worker / nRanges);
+        const int last = begin + static_cast<int>(n * (worker + 1) / nRanges);
+        for (int i = first; i < last; ++i) {
+            fn(i);
+        }
+
+        lock.lock();
+        if (--_nBusyWorkers == 0) {
+            _passFinished.notify_one();
+        }
+    }
+}
+
+} // namespace openspace
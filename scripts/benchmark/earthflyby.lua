@@ -0,0 +1,23 @@
+-- A path for the Benchmark application that flies around the Earth in the default scene
+-- while the simulation time speeds up. Frames are counted from the first frame after
+-- the scene has finished loading.
+return {
+    FrameTime = 1 / 60,
+    Frames = 1260,
+    WarmupFrames = 60,
+    Camera = {
+        { Frame = 0,    Anchor = "Earth", Position = {  3.0e7,  0.0,    0.0   } },
+        { Frame = 300,  Anchor = "Earth", Position = {  0.0,    3.0e7,  0.0   } },
+        { Frame = 600,  Anchor = "Earth", Position = { -3.0e7,  0.0,    1.0e7 } },
+        { Frame = 900,  Anchor = "Earth", Position = {  0.0,   -1.0e8,  0.0   } },
+        { Frame = 1260, Anchor = "Sun",   Position = {  0.0,    0.0,    5.0e11 } }
+    },
+    Time = {
+        { Frame = 0,   Time = "2016-07-04T00:00:00", DeltaTime = 1 },
+        { Frame = 600, DeltaTime = 3600 },
+        { Frame = 900, DeltaTime = 86400 }
+    },
+    Scripts = {
+        { Frame = 300, Script = "openspace.setPropertyValue('Constellation Bounds.renderable.enabled', true)" }
+    }
+}
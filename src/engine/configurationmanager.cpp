@@ -62,6 +62,8 @@ const string ConfigurationManager::KeyCapabilitiesVerbosity =
 const string ConfigurationManager::KeyShutdownCountdown = "ShutdownCountdown";
 const string ConfigurationManager::KeyDisableMasterRendering = "DisableRenderingOnMaster";
 const string ConfigurationManager::KeyDownloadRequestURL = "DownloadRequestURL";
+const string ConfigurationManager::KeyExternalControlStatusRate =
+    "ExternalControlStatusRate";
 
 string ConfigurationManager::findConfiguration(const string& filename) {
     using ghoul::filesystem::Directory;
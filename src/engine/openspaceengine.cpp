@@ -38,6 +38,7 @@
 #include <openspace/interaction/mousecontroller.h>
 #include <openspace/network/networkengine.h>
 #include <openspace/properties/propertyowner.h>
+#include <openspace/properties/propertyregistry.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scripting/scriptengine.h>
@@ -167,6 +168,8 @@ OpenSpaceEngine::~OpenSpaceEngine() {
     _gui->deinitializeGL();
 #endif
     _renderEngine->deinitialize();
+    // The sending thread uses the window wrapper
+    _networkEngine->deinitialize();
 
     _globalPropertyNamespace = nullptr;
     _windowWrapper = nullptr;
@@ -416,6 +419,13 @@ bool OpenSpaceEngine::initialize() {
         ConfigurationManager::KeyShutdownCountdown, _shutdownWait
     );
 
+    double statusMessageRate = NetworkEngine::DefaultStatusMessageRate;
+    configurationManager().getValue(
+        ConfigurationManager::KeyExternalControlStatusRate, statusMessageRate
+    );
+    _networkEngine->setStatusMessageRate(statusMessageRate);
+    _networkEngine->initialize();
+
     // Load scenegraph
     Scene* sceneGraph = new Scene;
     _renderEngine->setSceneGraph(sceneGraph);
@@ -577,7 +587,7 @@ void OpenSpaceEngine::runPreInitializationScripts(const std::string& sceneDescri
     OsEng.scriptEngine().initializeLuaState(state);
 
     // First execute the script to get all global variables
-    ghoul::lua::runScriptFile(state, absPath(sceneDescription));
+    scripting::runScriptFile(state, absPath(sceneDescription));
 
     // Get the preinitialize function
     lua_getglobal(state, PreInitializeFunction.c_str());
@@ -607,7 +617,7 @@ void OpenSpaceEngine::runPostInitializationScripts(const std::string& sceneDescr
     OsEng.scriptEngine().initializeLuaState(state);
     
     // First execute the script to get all global variables
-    ghoul::lua::runScriptFile(state, absPath(sceneDescription));
+    scripting::runScriptFile(state, absPath(sceneDescription));
     
     // Get the preinitialize function
     lua_getglobal(state, PostInitializationFunction.c_str());
@@ -823,6 +833,8 @@ void OpenSpaceEngine::postDraw() {
 
     if (_isInShutdownMode)
         _renderEngine->renderShutdownInformation(_shutdownCountdown, _shutdownWait);
+
+    properties::PropertyRegistry::ref().finishFrame();
 }
 
 void OpenSpaceEngine::keyboardCallback(Key key, KeyModifier mod, KeyAction action) {
@@ -987,6 +999,11 @@ RenderEngine& OpenSpaceEngine::renderEngine() {
     return *_renderEngine;
 }
 
+SyncBuffer& OpenSpaceEngine::syncBuffer() {
+    ghoul_assert(_syncBuffer, "SyncBuffer must not be nullptr");
+    return *_syncBuffer;
+}
+
 ScriptEngine& OpenSpaceEngine::scriptEngine() {
     ghoul_assert(_scriptEngine, "ScriptEngine must not be nullptr");
     return *_scriptEngine;
@@ -37,10 +37,22 @@
 
 #include <glm/gtx/quaternion.hpp>
 
+#include <chrono>
 #include <fstream>
 
 namespace {
     const std::string _loggerCat = "InteractionHandler";
+
+    // The smallest distance in meters that the camera keeps to the terrain of a globe
+    const double MinimumAltitudeAboveTerrain = 10.0;
+
+    // The local clock that the arrival and playback of keyframes is measured with. It
+    // is read from the network thread as well, so the application time is not used
+    double keyframeClockTime() {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
 }
 
 #include "interactionhandler_lua.inl"
@@ -626,21 +638,37 @@ InputState::~InputState() {
 }
 
 void InputState::addKeyframe(const network::datamessagestructures::PositionKeyframe &kf) {
-    _keyframeMutex.lock();
-
-    //save a maximum of 10 samples (1 seconds of buffer)
-    if (_keyframes.size() >= 10) {
-        _keyframes.erase(_keyframes.begin());
-    }
-    _keyframes.push_back(kf);
+    KeyframeBuffer::Keyframe keyframe;
+    keyframe.timeStamp = kf._timeStamp;
+    keyframe.position = kf._position.dvec3();
+    // The keyframes contain the rotation of the view, which is the inverse of the
+    // rotation of the camera
+    keyframe.rotation = glm::inverse(glm::dquat(kf._viewRotationQuat));
 
-    _keyframeMutex.unlock();
+    std::lock_guard<std::mutex> lock(_keyframeMutex);
+    _keyframes.addKeyframe(keyframe, keyframeClockTime());
 }
 
 void InputState::clearKeyframes() {
-    _keyframeMutex.lock();
+    std::lock_guard<std::mutex> lock(_keyframeMutex);
     _keyframes.clear();
-    _keyframeMutex.unlock();
+}
+
+void InputState::setKeyframeLatency(double latency) {
+    std::lock_guard<std::mutex> lock(_keyframeMutex);
+    _keyframes.setTargetLatency(latency);
+}
+
+bool InputState::hasKeyframes() {
+    std::lock_guard<std::mutex> lock(_keyframeMutex);
+    return !_keyframes.isEmpty();
+}
+
+KeyframeBuffer::State InputState::sampleKeyframes(glm::dvec3& position,
+                                                  glm::dquat& rotation)
+{
+    std::lock_guard<std::mutex> lock(_keyframeMutex);
+    return _keyframes.sample(keyframeClockTime(), position, rotation);
 }
 
 void InputState::keyboardCallback(Key key, KeyModifier modifier, KeyAction action) {
@@ -746,7 +774,13 @@ KeyframeInteractionMode::~KeyframeInteractionMode() {
 }
 
 void KeyframeInteractionMode::update(double deltaTime) {
-    // TODO : Get keyframes from input state and use them to position and rotate the camera
+    glm::dvec3 position;
+    glm::dquat rotation;
+    KeyframeBuffer::State state = _inputState->sampleKeyframes(position, rotation);
+    if (state != KeyframeBuffer::State::Empty) {
+        _camera->setPositionVec3(position);
+        _camera->setRotation(rotation);
+    }
 }
 
 // OrbitalInteractionMode
@@ -991,6 +1025,23 @@ void GlobeBrowsingInteractionMode::updateCameraStateFromMouseStates() {
             _globalCameraRotation = cameraRollRotation * _globalCameraRotation;
         }
 
+        { // Keep the camera above the terrain
+            const Ellipsoid& ellipsoid = _globe->ellipsoid();
+            glm::dvec3 centerToCamera = newPosition - centerPos;
+            Geodetic2 positionGeodetic = ellipsoid.cartesianToGeodetic2(centerToCamera);
+            HeightQueryResult terrain = _globe->getHeight(positionGeodetic);
+            if (terrain.level >= 0) {
+                glm::dvec3 surfacePosition =
+                    ellipsoid.cartesianSurfacePosition(positionGeodetic);
+                glm::dvec3 surfaceNormal = ellipsoid.geodeticSurfaceNormal(positionGeodetic);
+                double altitude = glm::dot(centerToCamera - surfacePosition, surfaceNormal);
+                double minimumAltitude = terrain.height + MinimumAltitudeAboveTerrain;
+                if (altitude < minimumAltitude) {
+                    newPosition = centerPos + surfacePosition + minimumAltitude * surfaceNormal;
+                }
+            }
+        }
+
         // Update the camera state
         _camera->setRotation(_globalCameraRotation * _localCameraRotation);
         _camera->setPositionVec3(newPosition);
@@ -1010,6 +1061,7 @@ InteractionHandler::InteractionHandler()
     , _coordinateSystem("coordinateSystem", "Coordinate System", "")
     , _rotationalFriction("rotationalFriction", "Rotational Friction", true)
     , _zoomFriction("zoomFriction", "Zoom Friction", true)
+    , _keyframeLatency("keyframeLatency", "Keyframe Latency", 0.1f, 0.f, 2.f)
 {
     setName("Interaction");
 
@@ -1033,6 +1085,8 @@ InteractionHandler::InteractionHandler()
     _inputState = std::shared_ptr<InputState>(new InputState());
     _orbitalInteractionMode = std::shared_ptr<OrbitalInteractionMode>(
         new OrbitalInteractionMode(_inputState, 0.002, 0.02));
+    _keyframeInteractionMode = std::shared_ptr<KeyframeInteractionMode>(
+        new KeyframeInteractionMode(_inputState));
 
 #ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
     _globebrowsingInteractionMode = std::shared_ptr<GlobeBrowsingInteractionMode>(
@@ -1057,6 +1111,11 @@ InteractionHandler::InteractionHandler()
 #endif
     });
     addProperty(_zoomFriction);
+
+    _keyframeLatency.onChange([&]() {
+        _inputState->setKeyframeLatency(_keyframeLatency);
+    });
+    addProperty(_keyframeLatency);
 }
 
 InteractionHandler::~InteractionHandler() {
@@ -1103,7 +1162,14 @@ void InteractionHandler::unlockControls() {
 }
 
 void InteractionHandler::update(double deltaTime) {
-    _currentInteractionMode->update(deltaTime);
+    // While keyframes are received from a parallel host, they control the camera
+    if (_inputState->hasKeyframes()) {
+        _keyframeInteractionMode->setCamera(_currentInteractionMode->camera());
+        _keyframeInteractionMode->update(deltaTime);
+    }
+    else {
+        _currentInteractionMode->update(deltaTime);
+    }
 }
 
 SceneGraphNode* const InteractionHandler::focusNode() const {
@@ -0,0 +1,271 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/interaction/keyframebuffer.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    // The weight of a new delay in the smoothed jitter, as in RFC 3550
+    const double JitterSmoothing = 1.0 / 16.0;
+
+    // The playback may run at most this much faster or slower than the local clock
+    // while it converges to the target latency
+    const double MaximumSlewRate = 0.1;
+
+    // If the playback is further than this from the target (in s), it jumps there
+    const double ResynchronizationThreshold = 1.0;
+
+    // Spherical linear interpolation along the shortest path, which also extrapolates
+    // for t > 1
+    glm::dquat slerp(const glm::dquat& q0, glm::dquat q1, double t) {
+        double cosAngle = glm::dot(q0, q1);
+        if (cosAngle < 0.0) {
+            q1 = -q1;
+            cosAngle = -cosAngle;
+        }
+
+        if (cosAngle > 1.0 - 1e-9) {
+            return glm::normalize(q0 + (q1 - q0) * t);
+        }
+
+        double angle = std::acos(cosAngle);
+        return glm::normalize(
+            (std::sin((1.0 - t) * angle) * q0 + std::sin(t * angle) * q1) /
+            std::sin(angle)
+        );
+    }
+}
+
+namespace openspace {
+namespace interaction {
+
+KeyframeBuffer::KeyframeBuffer(size_t capacity, double targetLatency,
+                               double maximumExtrapolation)
+    : _keyframes(capacity)
+    , _delays(capacity)
+    , _targetLatency(targetLatency)
+    , _maximumExtrapolation(maximumExtrapolation)
+{
+    ghoul_assert(capacity >= 2, "At least two keyframes must be buffered");
+    clear();
+}
+
+void KeyframeBuffer::addKeyframe(const Keyframe& keyframe, double localTime) {
+    // Keyframes that arrive out of order or twice are of no use anymore
+    if (keyframe.timeStamp <= _newestTimeStamp) {
+        return;
+    }
+    _newestTimeStamp = keyframe.timeStamp;
+
+    // The delay is the clock offset plus the network delay of this keyframe
+    double delay = localTime - keyframe.timeStamp;
+    _delays[_nextDelay] = delay;
+    _nextDelay = (_nextDelay + 1) % _delays.size();
+    _nDelays = std::min(_nDelays + 1, _delays.size());
+    updateClockOffset();
+
+    if (_nDelays == 1) {
+        _jitter = 0.0;
+    }
+    else {
+        _jitter += (std::abs(delay - _clockOffset) - _jitter) * JitterSmoothing;
+    }
+
+    if (_size == _keyframes.size()) {
+        popFront();
+    }
+    _keyframes[(_first + _size) % _keyframes.size()] = keyframe;
+    ++_size;
+}
+
+KeyframeBuffer::State KeyframeBuffer::sample(double localTime, glm::dvec3& position,
+                                             glm::dquat& rotation)
+{
+    if (_size == 0) {
+        return State::Empty;
+    }
+
+    updatePlaybackTime(localTime);
+    const double t = _playbackTime;
+
+    // Drop the keyframes that have been played back, but keep the one before the
+    // current interval for the tangent of the spline
+    while (_size >= 3 && at(2).timeStamp <= t) {
+        popFront();
+    }
+
+    // The playback has not reached the first keyframe yet
+    if (t < at(0).timeStamp) {
+        position = at(0).position;
+        rotation = at(0).rotation;
+        return State::Held;
+    }
+
+    // The playback has passed the last keyframe, so the motion between the last two
+    // keyframes is continued for a while. If no keyframe arrives, the host has most
+    // likely stopped, so the camera returns to the last keyframe instead of staying at a
+    // position that the host never had
+    const Keyframe& last = at(_size - 1);
+    const double overshoot = t - last.timeStamp;
+    if (overshoot >= 0.0) {
+        if (_size == 1 || overshoot >= 2.0 * _maximumExtrapolation) {
+            position = last.position;
+            rotation = last.rotation;
+            return State::Held;
+        }
+
+        const Keyframe& previous = at(_size - 2);
+        const double interval = last.timeStamp - previous.timeStamp;
+        const double elapsed = (overshoot <= _maximumExtrapolation) ?
+            overshoot :
+            2.0 * _maximumExtrapolation - overshoot;
+
+        position = last.position +
+            (last.position - previous.position) * (elapsed / interval);
+        rotation = slerp(previous.rotation, last.rotation, 1.0 + elapsed / interval);
+        return State::Extrapolated;
+    }
+
+    // After the keyframes have been dropped, the interval starts at the first or the
+    // second keyframe
+    const size_t i = (_size >= 2 && at(1).timeStamp <= t) ? 1 : 0;
+    const Keyframe& k1 = at(i);
+    const Keyframe& k2 = at(i + 1);
+    const double h = k2.timeStamp - k1.timeStamp;
+    const double s = (t - k1.timeStamp) / h;
+
+    // Velocities at the ends of the interval from the neighbouring keyframes
+    glm::dvec3 v1 = (k2.position - k1.position) / h;
+    if (i > 0) {
+        const Keyframe& k0 = at(i - 1);
+        v1 = (k2.position - k0.position) / (k2.timeStamp - k0.timeStamp);
+    }
+    glm::dvec3 v2 = (k2.position - k1.position) / h;
+    if (i + 2 < _size) {
+        const Keyframe& k3 = at(i + 2);
+        v2 = (k3.position - k1.position) / (k3.timeStamp - k1.timeStamp);
+    }
+
+    // Cubic Hermite spline
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+    position =
+        (2.0 * s3 - 3.0 * s2 + 1.0) * k1.position +
+        (s3 - 2.0 * s2 + s) * h * v1 +
+        (-2.0 * s3 + 3.0 * s2) * k2.position +
+        (s3 - s2) * h * v2;
+    rotation = slerp(k1.rotation, k2.rotation, s);
+
+    return State::Interpolated;
+}
+
+void KeyframeBuffer::clear() {
+    _first = 0;
+    _size = 0;
+    _nextDelay = 0;
+    _nDelays = 0;
+    _clockOffset = 0.0;
+    _jitter = 0.0;
+    _newestTimeStamp = -std::numeric_limits<double>::max();
+    _isPlaying = false;
+    _playbackTime = 0.0;
+    _lastLocalTime = 0.0;
+}
+
+bool KeyframeBuffer::isEmpty() const {
+    return _size == 0;
+}
+
+size_t KeyframeBuffer::size() const {
+    return _size;
+}
+
+void KeyframeBuffer::setTargetLatency(double targetLatency) {
+    _targetLatency = targetLatency;
+}
+
+double KeyframeBuffer::targetLatency() const {
+    return _targetLatency;
+}
+
+double KeyframeBuffer::clockOffset() const {
+    return _clockOffset;
+}
+
+double KeyframeBuffer::jitter() const {
+    return _jitter;
+}
+
+double KeyframeBuffer::playbackTime() const {
+    return _playbackTime;
+}
+
+const KeyframeBuffer::Keyframe& KeyframeBuffer::at(size_t i) const {
+    ghoul_assert(i < _size, "Index out of range");
+    return _keyframes[(_first + i) % _keyframes.size()];
+}
+
+void KeyframeBuffer::popFront() {
+    _first = (_first + 1) % _keyframes.size();
+    --_size;
+}
+
+void KeyframeBuffer::updatePlaybackTime(double localTime) {
+    const double target = localTime - _clockOffset - _targetLatency;
+
+    if (!_isPlaying) {
+        _playbackTime = target;
+        _isPlaying = true;
+    }
+    else {
+        // The playback follows the local clock and converges to the target slowly, so
+        // that changes in the clock offset do not make the camera jump
+        const double elapsed = std::max(localTime - _lastLocalTime, 0.0);
+        const double predicted = _playbackTime + elapsed;
+        const double error = target - predicted;
+
+        if (std::abs(error) > ResynchronizationThreshold) {
+            _playbackTime = target;
+        }
+        else {
+            const double correction = MaximumSlewRate * elapsed;
+            _playbackTime = predicted + glm::clamp(error, -correction, correction);
+        }
+    }
+    _lastLocalTime = localTime;
+}
+
+void KeyframeBuffer::updateClockOffset() {
+    // The keyframe with the smallest delay is the best estimate of the clock offset, as
+    // the network delay can only make keyframes later
+    _clockOffset = *std::min_element(_delays.begin(), _delays.begin() + _nDelays);
+}
+
+} // namespace interaction
+} // namespace openspace
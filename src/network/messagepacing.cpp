@@ -0,0 +1,95 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/network/messagepacing.h>
+
+namespace openspace {
+namespace network {
+
+MessageRateLimiter::MessageRateLimiter(double messagesPerSecond)
+    : _hasAllowedMessage(false)
+{
+    setRate(messagesPerSecond);
+}
+
+void MessageRateLimiter::setRate(double messagesPerSecond) {
+    if (messagesPerSecond > 0.0) {
+        _interval = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / messagesPerSecond)
+        );
+    }
+    else
+        _interval = Clock::duration::zero();
+}
+
+bool MessageRateLimiter::allow(Clock::time_point now) {
+    if (_hasAllowedMessage && now - _lastMessageTime < _interval)
+        return false;
+    _lastMessageTime = now;
+    _hasAllowedMessage = true;
+    return true;
+}
+
+PacedMessageSequence::PacedMessageSequence(Clock::duration interval,
+                                           Clock::duration finalDelay)
+    : _interval(interval)
+    , _finalDelay(finalDelay)
+    , _nextMessage(0)
+{}
+
+void PacedMessageSequence::start(std::vector<std::vector<char>> messages,
+                                 Clock::time_point now)
+{
+    _messages = std::move(messages);
+    _nextMessage = 0;
+    _nextMessageTime = now;
+}
+
+void PacedMessageSequence::clear() {
+    _messages.clear();
+    _nextMessage = 0;
+}
+
+bool PacedMessageSequence::isActive() const {
+    return _nextMessage < _messages.size();
+}
+
+PacedMessageSequence::Clock::time_point PacedMessageSequence::nextMessageTime() const {
+    return _nextMessageTime;
+}
+
+const std::vector<char>* PacedMessageSequence::next(Clock::time_point now) {
+    if (!isActive() || now < _nextMessageTime)
+        return nullptr;
+
+    const std::vector<char>* message = &_messages[_nextMessage];
+    ++_nextMessage;
+    _nextMessageTime = now + _interval;
+    if (_nextMessage + 1 == _messages.size())
+        _nextMessageTime += _finalDelay;
+    return message;
+}
+
+} // namespace network
+} // namespace openspace
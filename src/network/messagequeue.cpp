@@ -0,0 +1,114 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/network/messagequeue.h>
+
+#include <ghoul/misc/assert.h>
+
+namespace {
+    // Marks that the exchanged buffer holds a message that was not consumed yet
+    const int FreshFlag = 4;
+    const int IndexMask = 3;
+}
+
+namespace openspace {
+namespace network {
+
+MessageQueue::MessageQueue(size_t capacity)
+    : _slots(capacity)
+    , _head(0)
+    , _tail(0)
+{
+    ghoul_assert(capacity > 0, "Capacity must be positive");
+}
+
+std::vector<char>* MessageQueue::beginPush() {
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head.load(std::memory_order_acquire) == _slots.size())
+        return nullptr;
+
+    std::vector<char>* buffer = &_slots[tail % _slots.size()];
+    buffer->clear();
+    return buffer;
+}
+
+void MessageQueue::endPush() {
+    _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+const std::vector<char>* MessageQueue::front() {
+    const size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire))
+        return nullptr;
+    return &_slots[head % _slots.size()];
+}
+
+void MessageQueue::pop() {
+    ghoul_assert(!isEmpty(), "Queue must not be empty");
+    _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bool MessageQueue::isEmpty() const {
+    return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+}
+
+size_t MessageQueue::capacity() const {
+    return _slots.size();
+}
+
+LatestMessageBuffer::LatestMessageBuffer()
+    : _writeIndex(0)
+    , _readIndex(1)
+    , _exchangeIndex(2)
+{}
+
+std::vector<char>& LatestMessageBuffer::writeBuffer() {
+    return _buffers[_writeIndex];
+}
+
+void LatestMessageBuffer::publish() {
+    // Replaces a message that the consumer has not taken yet
+    _writeIndex = _exchangeIndex.exchange(
+        _writeIndex | FreshFlag,
+        std::memory_order_acq_rel
+    ) & IndexMask;
+}
+
+bool LatestMessageBuffer::hasMessage() const {
+    return (_exchangeIndex.load(std::memory_order_acquire) & FreshFlag) != 0;
+}
+
+const std::vector<char>* LatestMessageBuffer::consume() {
+    if (!hasMessage())
+        return nullptr;
+
+    _readIndex = _exchangeIndex.exchange(
+        _readIndex,
+        std::memory_order_acq_rel
+    ) & IndexMask;
+    return &_buffers[_readIndex];
+}
+
+} // namespace network
+} // namespace openspace
@@ -0,0 +1,587 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/network/messagetransport.h>
+
+#include <ghoul/logging/logmanager.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+
+#ifdef WIN32
+#ifndef _ERRNO
+#define _ERRNO WSAGetLastError()
+#endif
+#else //Use BSD sockets
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <errno.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+#ifndef SOCKET_ERROR
+#define SOCKET_ERROR (-1)
+#endif
+
+#ifndef INVALID_SOCKET
+#define INVALID_SOCKET (_SOCKET)(~0)
+#endif
+
+#ifndef _ERRNO
+#define _ERRNO errno
+#endif
+#endif
+
+namespace {
+    const std::string _loggerCat = "MessageTransport";
+
+    // The most buffers that are sent with one gathering write
+    const size_t MaximumBuffersPerWrite = 64;
+
+    // The receive buffer grows when less than this many bytes are free
+    const size_t MinimumReceiveSpace = 4096;
+
+    // Buffers beyond this number are freed instead of returned to the pool
+    const size_t MaximumPooledBuffers = 64;
+
+#ifndef __linux__
+    // If the wake-up socket can not be created, the I/O thread checks for queued
+    // messages and for being closed at this interval (in ms) instead
+    const int PollInterval = 2;
+#endif
+
+#ifdef MSG_NOSIGNAL
+    // A broken connection is reported as an error rather than by SIGPIPE
+    const int SendFlags = MSG_NOSIGNAL;
+#else
+    const int SendFlags = 0;
+#endif
+
+    bool initializeNetworkApi() {
+#ifdef WIN32
+        WSADATA wsaData;
+        int error = WSAStartup(MAKEWORD(2, 2), &wsaData);
+        return error == 0 &&
+            LOBYTE(wsaData.wVersion) == 2 &&
+            HIBYTE(wsaData.wVersion) == 2;
+#else
+        //No init needed on unix
+        return true;
+#endif
+    }
+
+    void closeSocket(_SOCKET socket) {
+#ifdef WIN32
+        shutdown(socket, SD_BOTH);
+        closesocket(socket);
+#else
+        shutdown(socket, SHUT_RDWR);
+        close(socket);
+#endif
+    }
+
+    bool setNonBlocking(_SOCKET socket) {
+#ifdef WIN32
+        u_long mode = 1;
+        return ioctlsocket(socket, FIONBIO, &mode) == 0;
+#else
+        int flags = fcntl(socket, F_GETFL, 0);
+        return flags != -1 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) != -1;
+#endif
+    }
+
+    bool wouldBlock() {
+#ifdef WIN32
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+    }
+
+    bool wasInterrupted() {
+#ifdef WIN32
+        return WSAGetLastError() == WSAEINTR;
+#else
+        return errno == EINTR;
+#endif
+    }
+
+#ifndef __linux__
+    // Returns a UDP socket on the loopback interface that is connected to itself, so
+    // that sending a datagram to it makes it readable
+    _SOCKET createWakeUpSocket() {
+        if (!initializeNetworkApi())
+            return INVALID_SOCKET;
+
+        _SOCKET wakeUpSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (wakeUpSocket == INVALID_SOCKET)
+            return INVALID_SOCKET;
+
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+
+        const bool isOk =
+            bind(wakeUpSocket, (sockaddr*)&address, sizeof(address)) == 0 &&
+            getsockname(wakeUpSocket, (sockaddr*)&address, &length) == 0 &&
+            ::connect(wakeUpSocket, (sockaddr*)&address, sizeof(address)) == 0 &&
+            setNonBlocking(wakeUpSocket);
+        if (!isOk) {
+            closeSocket(wakeUpSocket);
+            return INVALID_SOCKET;
+        }
+        return wakeUpSocket;
+    }
+#endif
+}
+
+namespace openspace {
+namespace network {
+
+const size_t MessageTransport::InvalidMessage = static_cast<size_t>(-1);
+
+MessageTransport::MessageTransport(MessageSizeFunction messageSize,
+                                   MessageCallback onMessage,
+                                   ConnectionCallback onConnection)
+    : _messageSize(std::move(messageSize))
+    , _onMessage(std::move(onMessage))
+    , _onConnection(std::move(onConnection))
+    , _isRunning(false)
+    , _isConnected(false)
+    , _isStopping(false)
+    , _socket(INVALID_SOCKET)
+    , _wakeUpDescriptor(-1)
+    , _sendOffset(0)
+    , _receivedBytes(0)
+{
+#ifdef __linux__
+    _wakeUpDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+    _wakeUpSocket = createWakeUpSocket();
+    _hasPendingWakeUp = false;
+    if (_wakeUpSocket == INVALID_SOCKET)
+        LWARNING("Failed to create the wake-up socket, polling the connection instead");
+#endif
+}
+
+MessageTransport::~MessageTransport() {
+    disconnect();
+#ifdef __linux__
+    if (_wakeUpDescriptor != -1)
+        ::close(_wakeUpDescriptor);
+#else
+    if (_wakeUpSocket != INVALID_SOCKET)
+        closeSocket(_wakeUpSocket);
+#endif
+}
+
+void MessageTransport::connect(const std::string& address, const std::string& port) {
+    if (_isRunning)
+        return;
+
+    // The previous I/O thread has finished on its own
+    if (_ioThread.joinable())
+        _ioThread.join();
+
+    {
+        std::lock_guard<std::mutex> lock(_sendMutex);
+        _sendQueue.clear();
+    }
+
+    _isStopping = false;
+    _isRunning = true;
+    _ioThread = std::thread(&MessageTransport::run, this, address, port);
+}
+
+void MessageTransport::close() {
+    _isStopping = true;
+    wakeUp();
+}
+
+void MessageTransport::disconnect() {
+    close();
+    if (_ioThread.joinable() && _ioThread.get_id() != std::this_thread::get_id())
+        _ioThread.join();
+}
+
+bool MessageTransport::isRunning() const {
+    return _isRunning;
+}
+
+bool MessageTransport::isConnected() const {
+    return _isConnected;
+}
+
+std::vector<char> MessageTransport::acquireBuffer() {
+    std::lock_guard<std::mutex> lock(_poolMutex);
+    if (_bufferPool.empty())
+        return std::vector<char>();
+
+    std::vector<char> buffer = std::move(_bufferPool.back());
+    _bufferPool.pop_back();
+    buffer.clear();
+    return buffer;
+}
+
+void MessageTransport::send(std::vector<char> message) {
+    if (message.empty()) {
+        releaseBuffer(std::move(message));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_sendMutex);
+        _sendQueue.push_back(std::move(message));
+    }
+    wakeUp();
+}
+
+MessageTransport::Statistics MessageTransport::statistics() const {
+    std::lock_guard<std::mutex> lock(_statisticsMutex);
+    return _statistics;
+}
+
+void MessageTransport::run(std::string address, std::string port) {
+    auto finish = [this]() {
+        if (_socket != INVALID_SOCKET) {
+            closeSocket(_socket);
+            _socket = INVALID_SOCKET;
+        }
+        for (std::vector<char>& buffer : _sending)
+            releaseBuffer(std::move(buffer));
+        _sending.clear();
+        _sendOffset = 0;
+
+        _isConnected = false;
+        _onConnection(false);
+        _isRunning = false;
+    };
+
+    if (!initializeNetworkApi()) {
+        LERROR("Failed to initialize network API");
+        finish();
+        return;
+    }
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+
+    addrinfo* info = nullptr;
+    if (getaddrinfo(address.c_str(), port.c_str(), &hints, &info) != 0) {
+        LERROR("Failed to resolve address '" << address << "' and port '" << port << "'");
+        finish();
+        return;
+    }
+
+    bool isConnected = false;
+    _socket = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (_socket != INVALID_SOCKET) {
+        int flag = 1;
+        setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, (char*)&flag, sizeof(int));
+        setsockopt(_socket, SOL_SOCKET, SO_KEEPALIVE, (char*)&flag, sizeof(int));
+#ifdef SO_NOSIGPIPE
+        setsockopt(_socket, SOL_SOCKET, SO_NOSIGPIPE, (char*)&flag, sizeof(int));
+#endif
+
+        while (!_isStopping) {
+            LINFO("Attempting to connect to server " << address << " on port " << port);
+            int result = ::connect(_socket, info->ai_addr, (int)info->ai_addrlen);
+            if (result != SOCKET_ERROR) {
+                isConnected = true;
+                break;
+            }
+#ifdef WIN32
+            //on windows: try to connect once per second
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+#else
+            break;
+#endif
+        }
+    }
+    freeaddrinfo(info);
+
+    if (!isConnected || !setNonBlocking(_socket)) {
+        LERROR("Failed to establish a connection with server " << address <<
+            " on port " << port << ", terminating connection.");
+        finish();
+        return;
+    }
+
+    LINFO("Connection established with server at ip: " << address);
+    _receivedBytes = 0;
+    _isConnected = true;
+    _onConnection(true);
+
+#ifdef __linux__
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = _socket;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, _socket, &event);
+    event.data.fd = _wakeUpDescriptor;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, _wakeUpDescriptor, &event);
+    bool isWaitingForWrite = false;
+#endif
+
+    bool isOk = true;
+    while (isOk && !_isStopping) {
+        // Only if a previous write was incomplete is it necessary to wait for the socket
+        // to accept more data; new messages wake the thread up on their own
+        const bool hasUnsentData = !_sending.empty();
+        bool isReadable = false;
+
+#ifdef __linux__
+        if (hasUnsentData != isWaitingForWrite) {
+            event.events = EPOLLIN | (hasUnsentData ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+            event.data.fd = _socket;
+            epoll_ctl(epoll, EPOLL_CTL_MOD, _socket, &event);
+            isWaitingForWrite = hasUnsentData;
+        }
+
+        epoll_event events[2];
+        int nEvents = epoll_wait(epoll, events, 2, -1);
+        if (nEvents < 0 && errno != EINTR) {
+            LERROR("Error " << _ERRNO << " while waiting for the connection, disconnecting.");
+            break;
+        }
+        for (int i = 0; i < nEvents; ++i) {
+            if (events[i].data.fd == _wakeUpDescriptor) {
+                uint64_t value;
+                ssize_t result = read(_wakeUpDescriptor, &value, sizeof(value));
+                (void)result;
+            }
+            else if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                isReadable = true;
+            }
+        }
+#else
+        const bool canWakeUp = _wakeUpSocket != INVALID_SOCKET;
+        pollfd descriptors[2];
+        descriptors[0].fd = _socket;
+        descriptors[0].events = POLLIN | (hasUnsentData ? POLLOUT : 0);
+        descriptors[0].revents = 0;
+        descriptors[1].fd = _wakeUpSocket;
+        descriptors[1].events = POLLIN;
+        descriptors[1].revents = 0;
+        const int nDescriptors = canWakeUp ? 2 : 1;
+        const int timeout = canWakeUp ? -1 : PollInterval;
+#ifdef WIN32
+        int nEvents = WSAPoll(descriptors, nDescriptors, timeout);
+#else
+        int nEvents = poll(descriptors, nDescriptors, timeout);
+#endif
+        if (nEvents < 0 && !wasInterrupted()) {
+            LERROR("Error " << _ERRNO << " while waiting for the connection, disconnecting.");
+            break;
+        }
+        if (nEvents > 0 && canWakeUp && (descriptors[1].revents & POLLIN)) {
+            char value[64];
+            while (recv(_wakeUpSocket, value, sizeof(value), 0) > 0) {}
+            // Messages queued after this are either flushed below or send a new datagram
+            _hasPendingWakeUp = false;
+        }
+        isReadable = nEvents > 0 &&
+            (descriptors[0].revents & (POLLIN | POLLHUP | POLLERR));
+#endif
+
+        if (isReadable)
+            isOk = receive();
+        if (isOk)
+            isOk = flush();
+    }
+
+#ifdef __linux__
+    ::close(epoll);
+#endif
+    finish();
+}
+
+bool MessageTransport::receive() {
+    while (true) {
+        if (_receiveBuffer.size() - _receivedBytes < MinimumReceiveSpace) {
+            _receiveBuffer.resize(
+                std::max(2 * _receiveBuffer.size(), _receivedBytes + MinimumReceiveSpace)
+            );
+        }
+
+        int result = recv(
+            _socket,
+            _receiveBuffer.data() + _receivedBytes,
+            static_cast<int>(_receiveBuffer.size() - _receivedBytes),
+            0
+        );
+        if (result == 0) {
+            LERROR("Connection closed by the server, disconnecting...");
+            return false;
+        }
+        if (result < 0) {
+            if (wouldBlock())
+                return true;
+            if (wasInterrupted())
+                continue;
+            LERROR("Error " << _ERRNO << " detected in connection, disconnecting!");
+            return false;
+        }
+        _receivedBytes += result;
+
+        // Handle all complete messages where they are in the buffer
+        char* data = _receiveBuffer.data();
+        size_t offset = 0;
+        size_t nMessages = 0;
+        while (offset < _receivedBytes) {
+            const size_t available = _receivedBytes - offset;
+            const size_t size = _messageSize(data + offset, available);
+            if (size == InvalidMessage) {
+                LERROR("Received an invalid message, disconnecting!");
+                return false;
+            }
+            if (size == 0 || size > available)
+                break;
+
+            _onMessage(data + offset, size);
+            offset += size;
+            ++nMessages;
+        }
+
+        // Move the start of an incomplete message to the front
+        if (offset > 0) {
+            memmove(data, data + offset, _receivedBytes - offset);
+            _receivedBytes -= offset;
+        }
+
+        std::lock_guard<std::mutex> lock(_statisticsMutex);
+        _statistics.bytesReceived += result;
+        _statistics.messagesReceived += nMessages;
+    }
+}
+
+bool MessageTransport::flush() {
+    {
+        std::lock_guard<std::mutex> lock(_sendMutex);
+        std::move(_sendQueue.begin(), _sendQueue.end(), std::back_inserter(_sending));
+        _sendQueue.clear();
+    }
+
+    while (!_sending.empty()) {
+        // All queued messages, up to a limit, are sent with one call
+        const size_t nBuffers = std::min(_sending.size(), MaximumBuffersPerWrite);
+#ifdef WIN32
+        WSABUF buffers[MaximumBuffersPerWrite];
+        for (size_t i = 0; i < nBuffers; ++i) {
+            const size_t offset = (i == 0) ? _sendOffset : 0;
+            buffers[i].buf = _sending[i].data() + offset;
+            buffers[i].len = static_cast<ULONG>(_sending[i].size() - offset);
+        }
+        DWORD sent = 0;
+        int result = WSASend(
+            _socket, buffers, static_cast<DWORD>(nBuffers), &sent, 0, nullptr, nullptr
+        );
+        long long written = (result == SOCKET_ERROR) ? -1 : static_cast<long long>(sent);
+#else
+        iovec buffers[MaximumBuffersPerWrite];
+        for (size_t i = 0; i < nBuffers; ++i) {
+            const size_t offset = (i == 0) ? _sendOffset : 0;
+            buffers[i].iov_base = _sending[i].data() + offset;
+            buffers[i].iov_len = _sending[i].size() - offset;
+        }
+        msghdr message = {};
+        message.msg_iov = buffers;
+        message.msg_iovlen = nBuffers;
+        long long written = sendmsg(_socket, &message, SendFlags);
+#endif
+
+        if (written < 0) {
+            // The rest is sent once the socket accepts more data
+            if (wouldBlock())
+                return true;
+            if (wasInterrupted())
+                continue;
+            LERROR("Failed to send message.\nError: " << _ERRNO <<
+                " detected in connection, disconnecting.");
+            return false;
+        }
+
+        // Return the buffers of the messages that were sent completely to the pool
+        size_t remaining = static_cast<size_t>(written);
+        size_t nMessages = 0;
+        while (remaining > 0) {
+            const size_t left = _sending.front().size() - _sendOffset;
+            if (remaining < left) {
+                _sendOffset += remaining;
+                break;
+            }
+            remaining -= left;
+            _sendOffset = 0;
+            releaseBuffer(std::move(_sending.front()));
+            _sending.pop_front();
+            ++nMessages;
+        }
+
+        std::lock_guard<std::mutex> lock(_statisticsMutex);
+        _statistics.bytesSent += static_cast<size_t>(written);
+        _statistics.messagesSent += nMessages;
+        ++_statistics.writeCalls;
+    }
+    return true;
+}
+
+void MessageTransport::wakeUp() {
+#ifdef __linux__
+    uint64_t value = 1;
+    ssize_t result = write(_wakeUpDescriptor, &value, sizeof(value));
+    (void)result;
+#else
+    // One datagram is enough to wake the I/O thread up for all queued messages
+    if (_wakeUpSocket != INVALID_SOCKET && !_hasPendingWakeUp.exchange(true)) {
+        char value = 1;
+        ::send(_wakeUpSocket, &value, 1, 0);
+    }
+#endif
+}
+
+void MessageTransport::releaseBuffer(std::vector<char> buffer) {
+    std::lock_guard<std::mutex> lock(_poolMutex);
+    if (_bufferPool.size() < MaximumPooledBuffers)
+        _bufferPool.push_back(std::move(buffer));
+}
+
+} // namespace network
+} // namespace openspace
@@ -27,10 +27,10 @@
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/engine/wrapper/windowwrapper.h>
 
-#include <array>
-#include <chrono>
-#include <thread>
+#include <algorithm>
+#include <cstring>
 
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/ghoul_gl.h>
 
 namespace {
@@ -42,23 +42,76 @@ namespace {
 
     const char MessageTypeLuaScript = '0';
     const char MessageTypeExternalControlConnected = '1';
+
+    // The number of messages that can wait to be sent before new ones are dropped
+    const size_t OutboundQueueCapacity = 256;
+
+    // The pause after each of the initial connection messages, and the additional pause
+    // before the message that marks the end of them
+    const std::chrono::milliseconds InitialMessageInterval(250);
+    const std::chrono::milliseconds InitialMessageFinishedDelay(1000);
+
+    // Protocol:
+    // 2 bytes: type of message as uint16_t
+    // Rest of payload depending on the message type
+    void encodeMessage(uint16_t identifier, const std::vector<char>& body,
+                       std::vector<char>& buffer)
+    {
+        buffer.resize(sizeof(uint16_t) + body.size());
+        std::memcpy(buffer.data(), &identifier, sizeof(uint16_t));
+        if (!body.empty())
+            std::memcpy(buffer.data() + sizeof(uint16_t), body.data(), body.size());
+    }
 }
 
 namespace openspace {
 
+const double NetworkEngine::DefaultStatusMessageRate = 20.0;
+
 NetworkEngine::NetworkEngine() 
     : _lastAssignedIdentifier(MessageIdentifier(-1)) // -1 is okay as we assign one identifier in this ctor
     , _shouldPublishStatusMessage(true)
+    , _statusRateLimiter(DefaultStatusMessageRate)
+    , _outboundQueue(OutboundQueueCapacity)
+    , _nDroppedMessages(0)
+    , _isDropping(false)
+    , _isRunning(false)
+    , _isInitialInformationRequested(false)
+    , _initialMessages(InitialMessageInterval, InitialMessageFinishedDelay)
 {
     static_assert(
         sizeof(MessageIdentifier) == 2,
         "MessageIdentifier has to be 2 bytes or dependent applications will break"
     );
+    static_assert(
+        sizeof(MessageIdentifier) + sizeof(double) + StatusTimeStringSize +
+            sizeof(double) == StatusMessageSize,
+        "StatusMessageSize does not match the layout of the status message"
+    );
     _statusMessageIdentifier = identifier(StatusMessageIdentifierName);
     _identifierMappingIdentifier = identifier(MappingIdentifierIdentifierName);
     _initialMessageFinishedIdentifier = identifier(InitialMessageFinishedIdentifierName);
 }
 
+NetworkEngine::~NetworkEngine() {
+    deinitialize();
+}
+
+void NetworkEngine::initialize() {
+    if (_isRunning)
+        return;
+    _isRunning = true;
+    _sendThread = std::thread([this]() { run(); });
+}
+
+void NetworkEngine::deinitialize() {
+    if (!_isRunning)
+        return;
+    _isRunning = false;
+    wakeUpSendThread();
+    _sendThread.join();
+}
+
 bool NetworkEngine::handleMessage(const std::string& message) {
     // The first byte determines the type of message
     const char type = message[0];
@@ -72,8 +125,7 @@ bool NetworkEngine::handleMessage(const std::string& message) {
     }
     case MessageTypeExternalControlConnected:
     {
-        publishIdentifierMappingMessage();
-        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+        // The identifier mapping is the first of the initial messages
         sendInitialInformation();
         return true;
     }
@@ -87,37 +139,39 @@ bool NetworkEngine::handleMessage(const std::string& message) {
 void NetworkEngine::publishStatusMessage() {
     if (!_shouldPublishStatusMessage || !OsEng.windowWrapper().isExternalControlConnected())
         return;
-    // Protocol:
-    // 8 bytes: time as a ET double
-    // 24 bytes: time as a UTC string
-    // 8 bytes: delta time as double
-    // Total: 40
 
-    uint16_t messageSize = 0;
-    
+    // Status messages are only useful to clients at a limited rate
+    if (!_statusRateLimiter.allow(Clock::now()))
+        return;
+
     double time = Time::ref().currentTime();
     std::string timeString = Time::ref().currentTimeUTC();
     double delta = Time::ref().deltaTime();
 
-    messageSize += sizeof(time);
-    messageSize += static_cast<uint16_t>(timeString.length());
-    messageSize += sizeof(delta);
-
-    ghoul_assert(messageSize == 40, "Message size is not correct");
-
-    unsigned int currentLocation = 0;
-    std::vector<char> buffer(messageSize);
-    
-    std::memmove(buffer.data() + currentLocation, &time, sizeof(time));
-    currentLocation += sizeof(time);
-    std::memmove(buffer.data() + currentLocation, timeString.c_str(), timeString.length());
-    currentLocation += static_cast<unsigned int>(timeString.length());
-    std::memmove(buffer.data() + currentLocation, &delta, sizeof(delta));
+    std::vector<char>& message = _statusMessages.writeBuffer();
+    message.resize(StatusMessageSize);
+    char* buffer = message.data();
+    std::memcpy(buffer, &_statusMessageIdentifier, sizeof(MessageIdentifier));
+    buffer += sizeof(MessageIdentifier);
+    std::memcpy(buffer, &time, sizeof(time));
+    buffer += sizeof(time);
+    // The time string has a fixed size in the message, so it is cut or padded with \0
+    const size_t timeStringSize = std::min(
+        timeString.length(),
+        size_t(StatusTimeStringSize)
+    );
+    std::memcpy(buffer, timeString.c_str(), timeStringSize);
+    std::memset(buffer + timeStringSize, 0, StatusTimeStringSize - timeStringSize);
+    buffer += StatusTimeStringSize;
+    std::memcpy(buffer, &delta, sizeof(delta));
 
-    publishMessage(_statusMessageIdentifier, std::move(buffer));
+    _statusMessages.publish();
+    wakeUpSendThread();
 }
 
-void NetworkEngine::publishIdentifierMappingMessage() {
+std::vector<char> NetworkEngine::identifierMappingMessage() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
     size_t bufferSize = sizeof(uint16_t);
     for (const std::pair<std::string, MessageIdentifier>& i : _identifiers) {
         bufferSize += sizeof(MessageIdentifier);
@@ -139,11 +193,17 @@ void NetworkEngine::publishIdentifierMappingMessage() {
         currentWritingPosition += i.first.size();
     }
 
-    publishMessage(_identifierMappingIdentifier, std::move(buffer));
+    return buffer;
+}
+
+void NetworkEngine::publishIdentifierMappingMessage() {
+    publishMessage(_identifierMappingIdentifier, identifierMappingMessage());
 }
 
 
 NetworkEngine::MessageIdentifier NetworkEngine::identifier(std::string name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
     auto i = _identifiers.find(name);
     if (i != _identifiers.end())
         return i->second;
@@ -162,64 +222,133 @@ void NetworkEngine::publishMessage(MessageIdentifier identifier, std::vector<cha
 }
 
 void NetworkEngine::sendMessages() {
-    if (!OsEng.windowWrapper().isExternalControlConnected())
+    if (!OsEng.windowWrapper().isExternalControlConnected()) {
+        _messagesToSend.clear();
         return;
+    }
 
-    for (Message& m : _messagesToSend) {
-        // Protocol:
-        // 2 bytes: type of message as uint16_t
-        // Rest of payload depending on the message type
-
-        union {
-            MessageIdentifier value;
-            std::array<char, 2> data;
-        } identifier;
-        identifier.value = m.identifer;
+    if (_messagesToSend.empty())
+        return;
 
-        // Prepending the message identifier to the front
-        m.body.insert(m.body.begin(), identifier.data.begin(), identifier.data.end());
-        OsEng.windowWrapper().sendMessageToExternalControl(m.body);
+    for (const Message& m : _messagesToSend) {
+        std::vector<char>* buffer = _outboundQueue.beginPush();
+        if (!buffer) {
+            // The external control does not keep up, so new messages are dropped rather
+            // than letting the queue grow
+            ++_nDroppedMessages;
+            if (!_isDropping) {
+                LWARNING("Outbound queue to external control is full, dropping messages");
+                _isDropping = true;
+            }
+            continue;
+        }
+        _isDropping = false;
+
+        encodeMessage(m.identifer, m.body, *buffer);
+        _outboundQueue.endPush();
     }
 
     _messagesToSend.clear();
+    wakeUpSendThread();
 }
 
-void NetworkEngine::sendInitialInformation() {
-    static const int SleepTime = 250;
-    _shouldPublishStatusMessage = false;
-    for (const Message& m : _initialConnectionMessages) {
-        union {
-            MessageIdentifier value;
-            std::array<char, 2> data;
-        } identifier;
-        identifier.value = m.identifer;
-
-        std::vector<char> payload = m.body;
-        payload.insert(payload.begin(), identifier.data.begin(), identifier.data.end());
-        OsEng.windowWrapper().sendMessageToExternalControl(payload);
-        LINFO("Sent initial message: (s=" << m.body.size() << ") [i=" << identifier.value << "]");
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(SleepTime));
-    }
+void NetworkEngine::setStatusMessageRate(double messagesPerSecond) {
+    // A rate that is not positive publishes a status message every frame
+    _statusRateLimiter.setRate(messagesPerSecond);
+}
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(4 * SleepTime));
+size_t NetworkEngine::numberOfDroppedMessages() const {
+    return _nDroppedMessages;
+}
 
-    // Send finished message
-    union {
-        MessageIdentifier value;
-        std::array<char, 2> data;
-    } identifier;
-    identifier.value = _initialMessageFinishedIdentifier;
+void NetworkEngine::sendInitialInformation() {
+    _shouldPublishStatusMessage = false;
+    _isInitialInformationRequested = true;
+    wakeUpSendThread();
+}
 
-    std::vector<char> d;
-    d.insert(d.begin(), identifier.data.begin(), identifier.data.end());
+void NetworkEngine::wakeUpSendThread() {
+    // Taking the lock orders the notification after the sending thread has checked
+    // whether it has work, so the notification cannot be lost while it waits
+    { std::lock_guard<std::mutex> lock(_wakeUpMutex); }
+    _wakeUp.notify_one();
+}
 
-    OsEng.windowWrapper().sendMessageToExternalControl(d);
-    _shouldPublishStatusMessage = true;
+void NetworkEngine::run() {
+    std::vector<char> buffer;
+    while (_isRunning) {
+        {
+            std::unique_lock<std::mutex> lock(_wakeUpMutex);
+            auto hasWork = [this]() {
+                return !_isRunning || _isInitialInformationRequested ||
+                    !_outboundQueue.isEmpty() || _statusMessages.hasMessage();
+            };
+            // Everything else that is sent wakes the thread up, so it only needs a
+            // timeout while it waits for the next initial message
+            if (_initialMessages.isActive())
+                _wakeUp.wait_until(lock, _initialMessages.nextMessageTime(), hasWork);
+            else
+                _wakeUp.wait(lock, hasWork);
+        }
+
+        if (_isInitialInformationRequested.exchange(false)) {
+            // The identifier mapping is followed by the initial messages, with pauses
+            // in between so that the clients can process them, and a final message
+            std::vector<std::vector<char>> messages;
+            encodeMessage(
+                _identifierMappingIdentifier,
+                identifierMappingMessage(),
+                buffer
+            );
+            messages.push_back(buffer);
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                for (const Message& m : _initialConnectionMessages) {
+                    encodeMessage(m.identifer, m.body, buffer);
+                    messages.push_back(buffer);
+                }
+            }
+            encodeMessage(_initialMessageFinishedIdentifier, {}, buffer);
+            messages.push_back(buffer);
+            _initialMessages.start(std::move(messages), Clock::now());
+        }
+
+        const bool isConnected = OsEng.windowWrapper().isExternalControlConnected();
+
+        // Messages for a client that is gone are discarded
+        while (const std::vector<char>* message = _outboundQueue.front()) {
+            if (isConnected)
+                OsEng.windowWrapper().sendMessageToExternalControl(*message);
+            _outboundQueue.pop();
+        }
+
+        // Only the latest status message is sent; older ones were replaced in the buffer
+        const std::vector<char>* status = _statusMessages.consume();
+
+        if (!isConnected) {
+            _initialMessages.clear();
+            _shouldPublishStatusMessage = true;
+            continue;
+        }
+
+        if (const std::vector<char>* message = _initialMessages.next(Clock::now())) {
+            OsEng.windowWrapper().sendMessageToExternalControl(*message);
+            MessageIdentifier identifier;
+            std::memcpy(&identifier, message->data(), sizeof(MessageIdentifier));
+            const size_t size = message->size() - sizeof(MessageIdentifier);
+            LINFO("Sent initial message: (s=" << size << ") [i=" << identifier << "]");
+            if (!_initialMessages.isActive())
+                _shouldPublishStatusMessage = true;
+        }
+
+        if (status && !_initialMessages.isActive())
+            OsEng.windowWrapper().sendMessageToExternalControl(*status);
+    }
 }
 
 void NetworkEngine::setInitialConnectionMessage(MessageIdentifier identifier, std::vector<char> message) {
     // Add check if a MessageIdentifier already exists ---abock
+    std::lock_guard<std::mutex> lock(_mutex);
     _initialConnectionMessages.push_back({std::move(identifier), std::move(message)});
 }
 
@@ -22,49 +22,64 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
-#ifdef WIN32
-#ifndef _ERRNO
-#define _ERRNO WSAGetLastError()
-#endif
-#else //Use BSD sockets
-#include <unistd.h>
-#include <sys/types.h>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <netinet/tcp.h>
-#include <arpa/inet.h>
-#include <netdb.h>
-#include <errno.h>
-#ifndef SOCKET_ERROR
-#define SOCKET_ERROR (-1)
-#endif
-
-#ifndef INVALID_SOCKET
-#define INVALID_SOCKET (_SOCKET)(~0)
-#endif
-
-#ifndef NO_ERROR
-#define NO_ERROR 0L
-#endif
-
-#ifndef _ERRNO
-#define _ERRNO errno
-#endif
-#endif
-
 //openspace includes
 #include <openspace/network/parallelconnection.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/interaction/interactionhandler.h>
+#include <openspace/scripting/scriptengine.h>
+#include <openspace/util/camera.h>
 #include <openspace/util/time.h>
 #include <openspace/openspace.h>
 #include <ghoul/logging/logmanager.h>
 
+#include <cstring>
+#include <limits>
+
 //lua functions
 #include "parallelconnection_lua.inl"
 
 namespace {
     const std::string _loggerCat = "ParallelConnection";
+
+    // While the camera moves, position keyframes are sent at most this often (in s)
+    const double MinimumKeyframeInterval = 1.0 / 30.0;
+
+    // While the camera is still, a keyframe is sent this often (in s), so that clients
+    // keep having keyframes to interpolate between
+    const double MaximumKeyframeInterval = 1.0;
+
+    // A position keyframe is written with its absolute position at least this often
+    // (in s), so that clients that join can decode the relative positions
+    const double PositionReferenceInterval = 1.0;
+
+    // The largest payload of the batched property messages, which leaves room for the
+    // headers within the 16 bit size of a Data message
+    const size_t MaximumPropertyMessageSize = 60000;
+
+    // The interval in seconds over which the data rates are averaged
+    const double DataStatisticsInterval = 1.0;
+
+    const char* DataTypeNames[] = {
+        "Position", "Time", "Script", "PropertyMapping", "PropertyDiff"
+    };
+    static_assert(
+        sizeof(DataTypeNames) / sizeof(DataTypeNames[0]) ==
+            openspace::network::datamessagestructures::NumberOfDataTypes,
+        "Every type of data message needs a name"
+    );
+
+    template <typename T>
+    T readValue(const char* data) {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void appendValue(std::vector<char>& buffer, const T& value) {
+        const char* data = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), data, data + sizeof(T));
+    }
 }
 
 namespace openspace {
@@ -76,329 +91,145 @@ ParallelConnection::ParallelConnection()
     , _port("20501")
     , _address("127.0.0.1")
     , _name("Local Connection")
-    , _clientSocket(INVALID_SOCKET)
-    , _connectionThread(nullptr)
-    , _broadcastThread(nullptr)
-    , _sendThread(nullptr)
-    , _listenThread(nullptr)
-    , _handlerThread(nullptr)
-    , _isRunning(true)
     , _isHost(false)
-    , _isConnected(false)
-    , _tryConnect(false)
-    , _performDisconnect(false)
-    , _latestTimeKeyframeValid(false)
     , _initializationTimejumpRequired(false)
-{
-    //create handler thread
-    _handlerThread = new (std::nothrow) std::thread(&ParallelConnection::threadManagement, this);
-}
+    , _hasSentPositionKeyframe(false)
+    , _isCameraMoving(false)
+    , _shouldResetPositionKeyframes(false)
+    , _latestTimeKeyframeValid(false)
+    , _sentPositionReferenceTime(0.0)
+    , _hasReportedProtocolMismatch(false)
+    , _dataStatistics(network::datamessagestructures::NumberOfDataTypes)
+    , _previousDataStatistics(network::datamessagestructures::NumberOfDataTypes)
+    , _previousDataStatisticsTime(0.0)
+    , _transport(
+        [this](const char* data, size_t size) { return messageSize(data, size); },
+        [this](const char* message, size_t size) { handleMessage(message, size); },
+        [this](bool isConnected) { handleConnectionChange(isConnected); }
+    )
+{}
         
 ParallelConnection::~ParallelConnection(){
-            
-    //signal that a disconnect should occur
-    signalDisconnect();
-            
-    //signal that execution has stopped
-    _isRunning.store(false);
-            
-    //join handler
-    _handlerThread->join();
-            
-    //and delete handler
-    delete _handlerThread;
-}
-        
-void ParallelConnection::threadManagement(){
-    // The _disconnectCondition.wait(unqlock) stalls
-    // How about moving this out of the thread and into the destructor? ---abock
-    
-    //while we're still running
-    while(_isRunning.load()){
-        {
-            //lock disconnect mutex mutex
-            //not really needed since no data is modified but conditions need a mutex
-            std::unique_lock<std::mutex> unqlock(_disconnectMutex);
-            //wait for a signal to disconnect
-            _disconnectCondition.wait(unqlock);
-                
-            //perform actual disconnect
-            disconnect();
-                    
-        }
-    }
+    //close the connection and wait for the I/O thread
+    _transport.disconnect();
 }
         
 void ParallelConnection::signalDisconnect(){
-    //signal handler thread to disconnect
-    _disconnectCondition.notify_all();
-}
-        
-void ParallelConnection::closeSocket(){
-            
-    /*
-        Windows shutdown options
-        * SD_RECIEVE
-        * SD_SEND
-        * SD_BOTH
-             
-        Linux & Mac shutdown options
-        * SHUT_RD (Disables further receive operations)
-        * SHUT_WR (Disables further send operations)
-        * SHUT_RDWR (Disables further send and receive operations)
-        */
-            
-#ifdef WIN32
-    shutdown(_clientSocket, SD_BOTH);
-    closesocket(_clientSocket);
-#else
-    shutdown(_clientSocket, SHUT_RDWR);
-    close(_clientSocket);
-#endif
-            
-    _clientSocket = INVALID_SOCKET;
-}
-        
-void ParallelConnection::disconnect(){
-    //we're disconnecting
-            
-    if (_clientSocket != INVALID_SOCKET){
-                
-        //must be run before trying to join communication threads, else the threads are stuck trying to receive data
-        closeSocket();
-                
-        //tell connection thread to stop trying to connect
-        _tryConnect.store(false);
-                
-        //tell send thread to stop sending and listen thread to stop listenin
-        _isConnected.store(false);
-                
-        //tell broadcast thread to stop broadcasting (we're no longer host)
-        _isHost.store(false);
-                
-        //signal send thread to stop waiting and finish current run
-        _sendCondition.notify_all();
-                
-        //join connection thread and delete it
-        if(_connectionThread != nullptr){
-            _connectionThread->join();
-            delete _connectionThread;
-            _connectionThread = nullptr;
-        }
-                
-        //join send thread and delete it
-        if (_sendThread != nullptr){
-            _sendThread->join();
-            delete _sendThread;
-            _sendThread = nullptr;
-        }
-                
-        //join listen thread and delete it
-        if( _listenThread != nullptr){
-            _listenThread->join();
-            delete _listenThread;
-            _listenThread = nullptr;
-        }
-                
-        //join broadcast thread and delete it
-        if(_broadcastThread != nullptr){
-            _broadcastThread->join();
-            delete _broadcastThread;
-            _broadcastThread = nullptr;
-        }
-                
-        // disconnect and cleanup completed
-        _performDisconnect.store(false);
-    }
+    //the I/O thread closes the connection
+    _transport.close();
 }
         
 void ParallelConnection::clientConnect(){
-
     //we're already connected (or already trying to connect), do nothing (dummy check)
-    if(_isConnected.load() || _tryConnect.load()){
-        return;
-    }
-            
-    if (!initNetworkAPI()){
-        LERROR("Failed to initialize network API for Parallel Connection");
+    if (_transport.isRunning()){
         return;
     }
-            
-    struct addrinfo *addresult = NULL, *ptr = NULL, hints;
-    #ifdef __WIN32__ //WinSock
-        ZeroMemory(&hints, sizeof(hints));
-    #else
-        memset(&hints, 0, sizeof(hints));
-    #endif
-    hints.ai_family = AF_INET;
-    hints.ai_socktype = SOCK_STREAM;
-    hints.ai_protocol = IPPROTO_TCP;
-    hints.ai_flags = AI_PASSIVE;
-
-    // Resolve the local address and port to be used by the server
-    int result = getaddrinfo(_address.c_str(), _port.c_str(), &hints, &addresult);
-    if (result != 0)
-    {
-        LERROR("Failed to parse hints for Parallel Connection");
-        return;
-    }
-            
-    //we're not connected
-    _isConnected.store(false);
-            
-    //we want to try and establish a connection
-    _tryConnect.store(true);
-            
-    //start connection thread
-    _connectionThread = new (std::nothrow) std::thread(&ParallelConnection::establishConnection, this, addresult);
-            
-}
-
-void ParallelConnection::establishConnection(addrinfo *info){
 
-    _clientSocket = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
-            
-    if (_clientSocket == INVALID_SOCKET){
-        freeaddrinfo(info);
-        LERROR("Failed to create client socket, disconnecting.");
+    _transport.connect(_address, _port);
+}
 
-        //signal a disconnect
-        signalDisconnect();
+void ParallelConnection::handleConnectionChange(bool isConnected){
+    if (isConnected){
+        //send authentication
+        sendAuthentication();
     }
-            
-    int flag = 1;
-    int result;
-            
-    //set no delay
-    result = setsockopt(_clientSocket,      /* socket affected */
-                        IPPROTO_TCP,        /* set option at TCP level */
-                        TCP_NODELAY,        /* name of option */
-                        (char *)&flag,      /* the cast is historical cruft */
-                        sizeof(int));       /* length of option value */
-            
-    //set send timeout
-    int timeout = 0;
-    result = setsockopt(
-                        _clientSocket,
-                        SOL_SOCKET,
-                        SO_SNDTIMEO,
-                        (char *)&timeout,
-                        sizeof(timeout));
-            
-    //set receive timeout
-    result = setsockopt(
-                        _clientSocket,
-                        SOL_SOCKET,
-                        SO_RCVTIMEO,
-                        (char *)&timeout,
-                        sizeof(timeout));
-
-    result = setsockopt(_clientSocket, SOL_SOCKET, SO_REUSEADDR, (char*)&flag, sizeof(int));
-    if (result == SOCKET_ERROR)
-        LERROR("Failed to set socket option 'reuse address'. Error code: " << _ERRNO);
-            
-    result = setsockopt(_clientSocket, SOL_SOCKET, SO_KEEPALIVE, (char*)&flag, sizeof(int));
-    if (result == SOCKET_ERROR)
-        LERROR("Failed to set socket option 'keep alive'. Error code: " << _ERRNO);
-
-
-    //while the connection thread is still running
-    while (_tryConnect.load()){
-                
-        LINFO("Attempting to connect to server "<< _address << " on port " << _port);
-                
-        //try to connect
-        result = connect(_clientSocket, info->ai_addr, (int)info->ai_addrlen);
-                
-        //if the connection was successfull
-        if (result != SOCKET_ERROR)
-        {
-                    
-            LINFO("Connection established with server at ip: "<< _address);
-                    
-            //we're connected
-            _isConnected.store(true);
-                    
-            //start sending messages
-            _sendThread = new (std::nothrow) std::thread(&ParallelConnection::sendFunc, this);
-                    
-            //start listening for communication
-            _listenThread = new (std::nothrow) std::thread(&ParallelConnection::listenCommunication, this);
-                    
-            //we no longer need to try to establish connection
-            _tryConnect.store(false);
-                    
-            //send authentication
-            sendAuthentication();
-        }
-                
-#ifdef __WIN32__
-        //on windows: try to connect once per second
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-#else
-        if(!_isConnected.load()){
-            //on unix disconnect and display error message if we're not connected
-            LERROR("Failed to establish a connection with server "<< _address << " on port " << _port<<", terminating connection.");
-                    
-            //signal disconnect
-            signalDisconnect();
-                    
-            //stop loop
-            break;
-        }
-#endif
+    else{
+        //we're no longer host
+        _isHost.store(false);
+        _shouldResetPositionKeyframes.store(true);
+
+        //give the control of the camera back to the user
+        OsEng.interactionHandler().clearKeyframes();
     }
-            
-    //cleanup
-    freeaddrinfo(info);
 }
 
 void ParallelConnection::sendAuthentication(){
     //length of this nodes name
     uint16_t namelen = static_cast<uint16_t>(_name.length());
-            
-    //total size of the buffer, header + size of passcodde + namelength + size of namelength
-    int size = headerSize() + sizeof(uint32_t) + sizeof(namelen) + static_cast<int>(namelen);
 
-    //create and reserve buffer
-    std::vector<char> buffer;
-    buffer.reserve(size);
+    std::vector<char> buffer = _transport.acquireBuffer();
 
     //write header to buffer
     writeHeader(buffer, MessageTypes::Authentication);
 
     //write passcode to buffer
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&_passCode), reinterpret_cast<char*>(&_passCode) + sizeof(uint32_t));
+    appendValue(buffer, _passCode);
 
     //write the length of the nodes name to buffer
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&namelen), reinterpret_cast<char*>(&namelen) + sizeof(uint16_t));
+    appendValue(buffer, namelen);
 
     //write this nodes name to buffer
     buffer.insert(buffer.end(), _name.begin(), _name.end());
             
     //send buffer
-    queueMessage(buffer);
+    queueMessage(std::move(buffer));
 }
 
-void ParallelConnection::delegateDecoding(uint32_t type){
+size_t ParallelConnection::messageSize(const char* data, size_t size){
+    //the header is needed to know the type of message
+    if (size < static_cast<size_t>(headerSize())){
+        return 0;
+    }
+
+    //make sure that header matches this version of OpenSpace
+    if (!(data[0] == 'O' &&                     //Open
+          data[1] == 'S' &&                     //Space
+          data[2] == OPENSPACE_VERSION_MAJOR && // major version
+          data[3] == OPENSPACE_VERSION_MINOR))  // minor version
+    {
+        LERROR("Error: Client OpenSpace version " << OPENSPACE_VERSION_MAJOR << ", " << OPENSPACE_VERSION_MINOR << " does not match server version " << static_cast<int>(data[2]) << ", " << static_cast<int>(data[3]));
+        return MessageTransport::InvalidMessage;
+    }
+
+    const size_t header = headerSize();
+    const uint32_t type = readValue<uint32_t>(data + 4);
+    switch (type){
+    case MessageTypes::Initialization:{
+        //id, size of the scripts and number of scripts, followed by the scripts
+        const size_t prefix = header + 2 * sizeof(uint32_t) + sizeof(uint16_t);
+        if (size < prefix){
+            return 0;
+        }
+        return prefix + readValue<uint32_t>(data + header + sizeof(uint32_t));
+    }
+    case MessageTypes::Data:{
+        //type and size of the data, followed by the data
+        const size_t prefix = header + 2 * sizeof(uint16_t);
+        if (size < prefix){
+            return 0;
+        }
+        return prefix + readValue<uint16_t>(data + header + sizeof(uint16_t));
+    }
+    case MessageTypes::HostInfo:
+        //host flag
+        return header + 1;
+    case MessageTypes::InitializationRequest:
+        //requester id
+        return header + sizeof(uint32_t);
+    default:
+        //the size of an unknown message type can not be known
+        LERROR("Unknown message type " << type << " received in parallel connection.");
+        return MessageTransport::InvalidMessage;
+    }
+}
+
+void ParallelConnection::handleMessage(const char* message, size_t size){
+    const uint32_t type = readValue<uint32_t>(message + 4);
+    const char* data = message + headerSize();
+    size -= headerSize();
+
     switch (type){
-    case MessageTypes::Authentication:
-        //not used
-        break;
     case MessageTypes::Initialization:
-        initializationMessageReceived();
+        initializationMessageReceived(data, size);
         break;
     case MessageTypes::Data:
-        dataMessageReceived();
-        break;
-    case MessageTypes::Script:
-            //not used
+        dataMessageReceived(data, size);
         break;
     case MessageTypes::HostInfo:
-        hostInfoMessageReceived();
+        hostInfoMessageReceived(data, size);
         break;
     case MessageTypes::InitializationRequest:
-        initializationRequestMessageReceived();
+        initializationRequestMessageReceived(data, size);
         break;
     default:
         //unknown message type
@@ -406,136 +237,82 @@ void ParallelConnection::delegateDecoding(uint32_t type){
     }
 }
 
-void ParallelConnection::initializationMessageReceived(){
-            
-    int result;
-            
-    uint32_t id, datasize;
-    uint16_t numscripts;
-            
-    std::vector<char> buffer;
-    buffer.resize(sizeof(id));
-
-    //read id
-    result = receiveData(_clientSocket, buffer, sizeof(id), 0);
-    if (result < 0){
-        //error
-    }
-    id = *(reinterpret_cast<uint32_t*>(buffer.data()));
+void ParallelConnection::initializationMessageReceived(const char* data, size_t size){
+    //skip the id and the size of the scripts
+    size_t offset = 2 * sizeof(uint32_t);
 
-    //read datalength
-    result = receiveData(_clientSocket, buffer, sizeof(datasize), 0);
-    if (result < 0){
-        //error
-    }
-    datasize = *(reinterpret_cast<uint32_t*>(buffer.data()));
-            
-    buffer.clear();
-    buffer.resize(sizeof(uint16_t));
     //read number of scripts
-    result = receiveData(_clientSocket, buffer, sizeof(numscripts), 0);
-    if(result < 0){
-        //error
-    }        
-    numscripts = *(reinterpret_cast<uint16_t*>(buffer.data()));
-            
-    //length of current script
-    uint16_t scriptlen;
-            
-    buffer.clear();
-    buffer.resize(sizeof(scriptlen));
-            
-    //holder for current script
-    std::string script;
-            
+    uint16_t numscripts = readValue<uint16_t>(data + offset);
+    offset += sizeof(uint16_t);
+
     for(int n = 0; n < numscripts; ++n){
         //read length of script
-        result = receiveData(_clientSocket, buffer, sizeof(numscripts), 0);
-        if(result < 0){
-            //error
+        if (offset + sizeof(uint16_t) > size){
+            LERROR("Initialization message is truncated.");
+            break;
         }
-        scriptlen = *(reinterpret_cast<uint16_t*>(buffer.data()));
-                
-        //resize buffer
-        buffer.clear();
-        buffer.resize(scriptlen);
-                
-        //read script
-        result = receiveData(_clientSocket, buffer, scriptlen, 0);
-
-        //assign current script
-        script.clear();
-        script.assign(buffer.begin(), buffer.end());
-                
+        uint16_t scriptlen = readValue<uint16_t>(data + offset);
+        offset += sizeof(uint16_t);
+
+        if (offset + scriptlen > size){
+            LERROR("Initialization message is truncated.");
+            break;
+        }
+
         //queue received script
-        OsEng.scriptEngine().queueScript(script);
+        OsEng.scriptEngine().queueScript(std::string(data + offset, scriptlen));
+        offset += scriptlen;
     }
             
     //we've gone through all scripts, initialization is done
-    buffer.clear();
+    std::vector<char> buffer = _transport.acquireBuffer();
     writeHeader(buffer, MessageTypes::InitializationCompleted);
             
     //let the server know
-    queueMessage(buffer);
+    queueMessage(std::move(buffer));
             
     //we also need to force a time jump just to ensure that the server and client are synced
     _initializationTimejumpRequired.store(true);
-            
 }
 
-void ParallelConnection::dataMessageReceived(){
-    int result;
-    uint16_t msglen;
-    uint16_t type;
-
-    //create a buffer to hold the size of streamdata message
-    std::vector<char> buffer;
-    buffer.resize(sizeof(type));
-            
-    //read type of data message
-    result = receiveData(_clientSocket, buffer, sizeof(type), 0);
+void ParallelConnection::dataMessageReceived(const char* data, size_t size){
+    //the type of data message received
+    uint16_t type = readValue<uint16_t>(data);
 
-    if (result <= 0){
-        //error
-        LERROR("Failed to read type of data message received.");
+    //the streamdata follows the type, size and protocol version
+    const size_t prefix = 2 * sizeof(uint16_t) + sizeof(uint8_t);
+    if (size < prefix){
+        LERROR("Data message is truncated.");
         return;
     }
-            
-    //the type of data message received
-    type =(*(reinterpret_cast<uint16_t*>(buffer.data())));
-            
-    //read size of streamdata message
-    result = receiveData(_clientSocket, buffer, sizeof(msglen), 0);
-            
-    if (result <= 0){
-        //error
-        LERROR("Failed to read size of data message received.");
+
+    //messages from hosts that encode data differently can not be read
+    const uint8_t version = static_cast<uint8_t>(data[2 * sizeof(uint16_t)]);
+    if (version != network::datamessagestructures::ProtocolVersion){
+        if (!_hasReportedProtocolMismatch){
+            LERROR("Ignoring data messages of protocol version " << static_cast<int>(version) << ", expected version " << static_cast<int>(network::datamessagestructures::ProtocolVersion));
+            _hasReportedProtocolMismatch = true;
+        }
         return;
     }
-            
-    //the size in bytes of the streamdata message
-    msglen = (*(reinterpret_cast<uint16_t*>(buffer.data())));
 
-    //resize the buffer to be able to read the streamdata
-    buffer.clear();
-    buffer.resize(msglen);
+    const char* streamdata = data + prefix;
+    size_t msglen = size - prefix;
 
-    //read the data into buffer
-    result = receiveData(_clientSocket, buffer, msglen, 0);
-            
-    if (result <= 0){
-        //error
-        LERROR("Failed to read data message.");
-        return;
+    if (type < network::datamessagestructures::NumberOfDataTypes){
+        countDataMessage(static_cast<network::datamessagestructures::type>(type), size + headerSize(), false);
     }
             
     //which type of data message was received?
     switch(type){
         case network::datamessagestructures::PositionData:{
             //position data message
-            //create and read a position keyframe from the data buffer
+            //create and read a position keyframe from the data
             network::datamessagestructures::PositionKeyframe kf;
-            kf.deserialize(buffer);
+            if (!kf.deserialize(streamdata, msglen, _receivedPositionReference)){
+                //relative keyframes are dropped until the first absolute one arrives
+                break;
+            }
                     
             //add the keyframe to the interaction handler
             OsEng.interactionHandler().addKeyframe(kf);
@@ -543,9 +320,12 @@ void ParallelConnection::dataMessageReceived(){
         }
         case network::datamessagestructures::TimeData:{
             //time data message
-            //create and read a time keyframe from the data buffer
+            //create and read a time keyframe from the data
             network::datamessagestructures::TimeKeyframe tf;
-            tf.deserialize(buffer);
+            if (!tf.deserialize(streamdata, msglen)){
+                LERROR("Malformed time keyframe received in parallel connection.");
+                break;
+            }
                     
             //lock mutex and assign latest time keyframe parameters
             _timeKeyframeMutex.lock();
@@ -580,14 +360,56 @@ void ParallelConnection::dataMessageReceived(){
         }
         case network::datamessagestructures::ScriptData:{
             //script data message
-            //create and read a script message from data buffer
+            //create and read a script message from the data
             network::datamessagestructures::ScriptMessage sm;
-            sm.deserialize(buffer);
+            if (!sm.deserialize(streamdata, msglen)){
+                LERROR("Malformed script message received in parallel connection.");
+                break;
+            }
                     
             //Que script to be executed by script engine
             OsEng.scriptEngine().queueScript(sm._script);
             break;
         }
+        case network::datamessagestructures::PropertyMappingData:{
+            //identifiers for the properties in following property diffs
+            network::datamessagestructures::PropertyMapping mapping;
+            if (!mapping.deserialize(streamdata, msglen)){
+                LERROR("Malformed property mapping received in parallel connection.");
+                break;
+            }
+
+            for (const auto& entry : mapping._entries){
+                _propertyNames[entry.first] = entry.second;
+            }
+            break;
+        }
+        case network::datamessagestructures::PropertyDiffData:{
+            //a batch of property changes
+            network::datamessagestructures::PropertyDiff diff;
+            if (!diff.deserialize(streamdata, msglen)){
+                LERROR("Malformed property diff received in parallel connection.");
+                break;
+            }
+
+            for (const auto& change : diff._entries){
+                auto it = _propertyNames.find(change.first);
+                if (it == _propertyNames.end()){
+                    LERROR("Change of unknown property " << change.first << " received in parallel connection.");
+                    continue;
+                }
+
+                //values that are plain literals are applied without the interpreter
+                scripting::PropertyAssignment assignment;
+                if (scripting::PropertyAssignment::fromLiteral(it->second, change.second, assignment)){
+                    OsEng.scriptEngine().queuePropertyAssignment(std::move(assignment));
+                }
+                else{
+                    OsEng.scriptEngine().queueScript(scriptFromPropertyAndValue(it->second, change.second));
+                }
+            }
+            break;
+        }
         default:{
             LERROR("Unidentified data message with identifier " << type << " received in parallel connection.");
             break;
@@ -596,251 +418,224 @@ void ParallelConnection::dataMessageReceived(){
 }
 
 void ParallelConnection::queueMessage(std::vector<char> message){
-    {
-        std::unique_lock<std::mutex> unqlock(_sendBufferMutex);
-        _sendBuffer.push_back(message);
-        _sendCondition.notify_all();
-    }
+    _transport.send(std::move(message));
 }
-        
-void ParallelConnection::sendFunc(){
-    int result;
-    //while we're connected
-    while(_isConnected.load()){
-        {
-            //wait for signal then lock mutex and send first queued message
-            std::unique_lock<std::mutex> unqlock(_sendBufferMutex);
-            _sendCondition.wait_for(unqlock, std::chrono::milliseconds(500));
-                    
-            if(!_sendBuffer.empty()){
-                while(!_sendBuffer.empty()){
-                    result = send(_clientSocket, _sendBuffer.front().data(), _sendBuffer.front().size(), 0);
-                    _sendBuffer.erase(_sendBuffer.begin());
-                            
-                    //make sure everything went well
-                    if (result == SOCKET_ERROR){
-                        //failed to send message
-                        LERROR("Failed to send message.\nError: " << _ERRNO << " detected in connection, disconnecting.");
-                                
-                        //signal that a disconnect should be performed
-                        signalDisconnect();
-                    }
-                }
-            }
+
+void ParallelConnection::queueDataMessage(datamessagestructures::type type,
+                                          const std::function<void(std::vector<char>&)>& serialize)
+{
+    std::vector<char> buffer = _transport.acquireBuffer();
+
+    //write header
+    writeHeader(buffer, MessageTypes::Data);
+
+    //type of message
+    appendValue(buffer, static_cast<uint16_t>(type));
+
+    //size of message, which is filled in once the message is serialized
+    const size_t sizeOffset = buffer.size();
+    appendValue(buffer, static_cast<uint16_t>(0));
+
+    //version of the encoding, followed by the actual message
+    appendValue(buffer, datamessagestructures::ProtocolVersion);
+    serialize(buffer);
+
+    uint16_t msglen = static_cast<uint16_t>(buffer.size() - sizeOffset - sizeof(uint16_t));
+    memcpy(buffer.data() + sizeOffset, &msglen, sizeof(msglen));
+
+    countDataMessage(type, buffer.size(), true);
+
+    //send message
+    queueMessage(std::move(buffer));
+}
+
+template <typename T>
+void ParallelConnection::queueDataMessage(datamessagestructures::type type, T& message){
+    queueDataMessage(type, [&message](std::vector<char>& buffer){ message.serialize(buffer); });
+}
+
+template <typename T>
+void ParallelConnection::queuePropertyMessages(datamessagestructures::type type,
+                                               const std::vector<std::pair<uint16_t, std::string>>& entries)
+{
+    T message;
+    size_t messageSize = sizeof(uint16_t);
+    for (const auto& entry : entries){
+        const size_t entrySize = 2 * sizeof(uint16_t) + entry.second.length();
+        if (!message._entries.empty() && messageSize + entrySize > MaximumPropertyMessageSize){
+            queueDataMessage(type, message);
+            message._entries.clear();
+            messageSize = sizeof(uint16_t);
         }
-                
+        message._entries.push_back(entry);
+        messageSize += entrySize;
+    }
+
+    if (!message._entries.empty()){
+        queueDataMessage(type, message);
+    }
+}
+
+void ParallelConnection::sendPropertyChanges(){
+    std::lock_guard<std::mutex> lock(_currentStateMutex);
+
+    //the names of new properties have to arrive before their changes
+    if (!_unsentPropertyMappings.empty()){
+        queuePropertyMessages<network::datamessagestructures::PropertyMapping>(
+            network::datamessagestructures::PropertyMappingData, _unsentPropertyMappings);
+        _unsentPropertyMappings.clear();
+    }
+
+    if (!_propertyChanges.empty()){
+        std::vector<std::pair<uint16_t, std::string>> changes(_propertyChanges.begin(), _propertyChanges.end());
+        queuePropertyMessages<network::datamessagestructures::PropertyDiff>(
+            network::datamessagestructures::PropertyDiffData, changes);
+        _propertyChanges.clear();
+    }
+}
+
+void ParallelConnection::countDataMessage(datamessagestructures::type type, size_t size, bool isSent){
+    std::lock_guard<std::mutex> lock(_dataStatisticsMutex);
+    DataStatistics& statistics = _dataStatistics[type];
+    if (isSent){
+        statistics.messagesSent++;
+        statistics.bytesSent += size;
+    }
+    else{
+        statistics.messagesReceived++;
+        statistics.bytesReceived += size;
+    }
+}
+
+void ParallelConnection::updateDataStatistics(){
+    const double now = OsEng.runTime();
+    const double elapsed = now - _previousDataStatisticsTime;
+    if (elapsed < DataStatisticsInterval){
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_dataStatisticsMutex);
+    for (size_t i = 0; i < _dataStatistics.size(); ++i){
+        DataStatistics& statistics = _dataStatistics[i];
+        const DataStatistics& previous = _previousDataStatistics[i];
+        statistics.bytesSentPerSecond = (statistics.bytesSent - previous.bytesSent) / elapsed;
+        statistics.bytesReceivedPerSecond = (statistics.bytesReceived - previous.bytesReceived) / elapsed;
+    }
+    _previousDataStatistics = _dataStatistics;
+    _previousDataStatisticsTime = now;
+}
+
+std::vector<ParallelConnection::DataStatistics> ParallelConnection::dataStatistics(){
+    std::lock_guard<std::mutex> lock(_dataStatisticsMutex);
+    return _dataStatistics;
+}
+
+void ParallelConnection::printDataStatistics(){
+    std::vector<DataStatistics> statistics = dataStatistics();
+    for (size_t i = 0; i < statistics.size(); ++i){
+        const DataStatistics& s = statistics[i];
+        LINFO(DataTypeNames[i] << ": sent " << s.messagesSent << " messages (" << s.bytesSent << " bytes, " << s.bytesSentPerSecond << " bytes/s), received " << s.messagesReceived << " messages (" << s.bytesReceived << " bytes, " << s.bytesReceivedPerSecond << " bytes/s)");
     }
 }
         
-void ParallelConnection::hostInfoMessageReceived(){
-    //create buffer
-    std::vector<char> hostflag;
-    //resize to hold a flag saying if we're host or not
-    hostflag.resize(1);
-            
-    //read data into buffer
-    int result = receiveData(_clientSocket, hostflag, 1, 0);
-
-    //enough data was read
-    if (result > 0){
-                
-        //we've been assigned as host
-        if (hostflag.at(0) == 1){
-                    
-            //we're already host, do nothing (dummy check)
-            if (_isHost.load()){
-                return;
+void ParallelConnection::hostInfoMessageReceived(const char* data, size_t size){
+    //we've been assigned as host
+    if (data[0] == 1){
+        //we're already host, do nothing (dummy check)
+        if (!_isHost.load()){
+            //we're the host, keyframes are sent from preSynchronization
+            _shouldResetPositionKeyframes.store(true);
+
+            //the clients may have the property identifiers of the previous host, so
+            //ours are sent again as they are used
+            {
+                std::lock_guard<std::mutex> lock(_currentStateMutex);
+                _propertyIds.clear();
+                _unsentPropertyMappings.clear();
+                _propertyChanges.clear();
             }
-            else{
-                        
-                //we're the host
-                _isHost.store(true);
 
-                //start broadcasting
-                _broadcastThread = new (std::nothrow) std::thread(&ParallelConnection::broadcast, this);
-            }
+            _isHost.store(true);
+
+            //the camera is no longer controlled by keyframes from the previous host
+            OsEng.interactionHandler().clearKeyframes();
         }
-        else{   //we've been assigned as client
-                    
-            //we were broadcasting but should stop now
-            if (_isHost.load()){
-
-                //stop broadcast loop
-                _isHost.store(false);
-                        
-                //and delete broadcasting thread
-                if (_broadcastThread != nullptr){
-                    _broadcastThread->join();
-                    delete _broadcastThread;
-                    _broadcastThread = nullptr;
-                }                       
-            }
-            else{
-                //we were not broadcasting so nothing to do
-            }
+    }
+    else{   //we've been assigned as client
+        //stop broadcasting if we were
+        _isHost.store(false);
                     
-            //clear buffered any keyframes
-            OsEng.interactionHandler().clearKeyframes();
+        //clear buffered any keyframes
+        OsEng.interactionHandler().clearKeyframes();
                     
-            //request init package from the host
-            int size = headerSize();
-            std::vector<char> buffer;
-            buffer.reserve(size);
+        //request init package from the host
+        std::vector<char> buffer = _transport.acquireBuffer();
                     
-            //write header
-            writeHeader(buffer, MessageTypes::InitializationRequest);
+        //write header
+        writeHeader(buffer, MessageTypes::InitializationRequest);
 
-            //send message
-            queueMessage(buffer);
-        }
-    }
-    else{
-        LERROR("Error " << _ERRNO << " detected in connection, disconnecting.");
-        signalDisconnect();
+        //send message
+        queueMessage(std::move(buffer));
     }
 }
 
-void ParallelConnection::initializationRequestMessageReceived(){
-            
-    //get current state as scripts
-    std::vector<std::string> scripts;
-    std::map<std::string, std::string>::iterator state_it;
-    {
-        //mutex protect
-        std::lock_guard<std::mutex> lock(_currentStateMutex);
-                
-        for(state_it = _currentState.begin();
-            state_it != _currentState.end();
-            ++state_it){
-            scripts.push_back(scriptFromPropertyAndValue(state_it->first, state_it->second));
-        }
-    }
-            
+void ParallelConnection::initializationRequestMessageReceived(const char* data, size_t size){
     //get requester ID
-    std::vector<char> buffer;
-    buffer.resize(sizeof(uint32_t));
-    receiveData(_clientSocket, buffer, sizeof(uint32_t), 0);
-    uint32_t requesterID = *reinterpret_cast<uint32_t*>(buffer.data());
-            
-    //total number of scripts sent
-    uint16_t numscripts = 0;
-            
-    //temporary buffers
-    std::vector<char> scriptbuffer;
-    std::vector<char> tmpbuffer;
-            
-    //serialize and encode all scripts into scriptbuffer
-    std::vector<std::string>::iterator script_it;
-    network::datamessagestructures::ScriptMessage sm;
-    for(script_it = scripts.begin();
-        script_it != scripts.end();
-        ++script_it){
-        sm._script = *script_it;
-        sm._scriptlen = script_it->length();
-
-        //serialize current script
-        tmpbuffer.clear();
-        sm.serialize(tmpbuffer);
-                
-        //and insert into full buffer
-        scriptbuffer.insert(scriptbuffer.end(), tmpbuffer.begin(), tmpbuffer.end());
-                
-        //increment number of scripts
-        numscripts++;
-    }
-            
+    uint32_t requesterID = readValue<uint32_t>(data);
+
+    std::vector<char> buffer = _transport.acquireBuffer();
+
     //write header
-    buffer.clear();
     writeHeader(buffer, MessageTypes::Initialization);
             
     //write client ID to receive init message
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&requesterID), reinterpret_cast<char*>(&requesterID) + sizeof(uint32_t));
-            
-    //write total size of data chunk
-    uint32_t totlen = static_cast<uint32_t>(scriptbuffer.size());
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&totlen), reinterpret_cast<char*>(&totlen) + sizeof(uint32_t));
-            
-    //write number of scripts
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&numscripts), reinterpret_cast<char*>(&numscripts) + sizeof(uint16_t));
+    appendValue(buffer, requesterID);
             
-    //write all scripts
-    buffer.insert(buffer.end(), scriptbuffer.begin(), scriptbuffer.end());
-            
-    //queue message
-    queueMessage(buffer);
-}
+    //write total size of data chunk, which is filled in once the scripts are written
+    const size_t sizeOffset = buffer.size();
+    appendValue(buffer, static_cast<uint32_t>(0));
 
-void ParallelConnection::listenCommunication(){
-            
-    //create basic buffer for receiving first part of messages
-    std::vector<char> buffer;
-    //size of the header
-    buffer.resize(headerSize());
-            
-    int result;
-            
-    //while we're still connected
-    while (_isConnected.load()){
-        //receive the first parts of a message
-        result = receiveData(_clientSocket, buffer, headerSize(), 0);
-
-        //if enough data was received
-        if (result > 0){
-                
-            //make sure that header matches this version of OpenSpace
-            if (buffer[0] == 'O' &&                     //Open
-                buffer[1] == 'S' &&                     //Space
-                buffer[2] == OPENSPACE_VERSION_MAJOR && // major version
-                buffer[3] == OPENSPACE_VERSION_MINOR    // minor version
-                )
-            {
-                //parse type
-                uint32_t type = (*(reinterpret_cast<uint32_t*>(&buffer[4])));
+    //write number of scripts, also filled in later
+    const size_t countOffset = buffer.size();
+    appendValue(buffer, static_cast<uint16_t>(0));
 
-                //and delegate decoding depending on type
-                delegateDecoding(type);
-            }
-            else{
-                LERROR("Error: Client OpenSpace version " << OPENSPACE_VERSION_MAJOR << ", " << OPENSPACE_VERSION_MINOR << " does not match server version " << buffer[2] <<", " << buffer[3] << std::endl << "Message not decoded.");
-            }
-        }
-        else{
-            if (result == 0){
-                //connection rejected
-                LERROR("Parallel connection rejected, disconnecting...");
-            }
-            else{
-                LERROR("Error " << _ERRNO << " detected in connection, disconnecting!");
-            }
-
-            //signal that a disconnect should be performed
-            signalDisconnect();
-            break;
-        }
-    }
-
-}
+    //serialize the current state as scripts directly into the buffer
+    uint16_t numscripts = 0;
+    {
+        //mutex protect
+        std::lock_guard<std::mutex> lock(_currentStateMutex);
 
-int ParallelConnection::receiveData(_SOCKET & socket, std::vector<char> &buffer, int length, int flags){
-    int result = 0;
-    int received = 0;
-    while (result < length){
-        received = recv(socket, buffer.data() + result, length - result, flags);
+        network::datamessagestructures::ScriptMessage sm;
+        for (const auto& state : _currentState){
+            sm._script = scriptFromPropertyAndValue(state.first, state.second);
+            sm._scriptlen = static_cast<uint16_t>(sm._script.length());
+            sm.serialize(buffer);
 
-        if (received > 0){
-            result += received;
-            received = 0;
+            //increment number of scripts
+            numscripts++;
         }
-        else{
-            //error receiving
-            result = received;
-            break;
+
+        //the new client also needs the identifiers of the properties that are used in
+        //the following property diffs
+        if (_isHost.load() && !_propertyIds.empty()){
+            std::vector<std::pair<uint16_t, std::string>> mappings;
+            mappings.reserve(_propertyIds.size());
+            for (const auto& propertyId : _propertyIds){
+                mappings.emplace_back(propertyId.second, propertyId.first);
+            }
+            queuePropertyMessages<network::datamessagestructures::PropertyMapping>(
+                network::datamessagestructures::PropertyMappingData, mappings);
         }
     }
 
-    return result;
+    uint32_t totlen = static_cast<uint32_t>(buffer.size() - countOffset - sizeof(uint16_t));
+    memcpy(buffer.data() + sizeOffset, &totlen, sizeof(totlen));
+    memcpy(buffer.data() + countOffset, &numscripts, sizeof(numscripts));
+            
+    //queue message
+    queueMessage(std::move(buffer));
 }
-        
+
 void ParallelConnection::setPort(const std::string  &port){
     _port = port;
 }
@@ -858,8 +653,7 @@ bool ParallelConnection::isHost(){
 }
         
 void ParallelConnection::requestHostship(const std::string &password){
-    std::vector<char> buffer;
-    buffer.reserve(headerSize());
+    std::vector<char> buffer = _transport.acquireBuffer();
           
     uint32_t passcode = hash(password);
             
@@ -867,42 +661,16 @@ void ParallelConnection::requestHostship(const std::string &password){
     writeHeader(buffer, MessageTypes::HostshipRequest);
             
     //write passcode
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&passcode), reinterpret_cast<char*>(&passcode) + sizeof(uint32_t));
+    appendValue(buffer, passcode);
             
     //send message
-    queueMessage(buffer);
+    queueMessage(std::move(buffer));
 }
 
 void ParallelConnection::setPassword(const std::string& pwd){
     _passCode = hash(pwd);
 }
 
-bool ParallelConnection::initNetworkAPI(){
-    #if defined(__WIN32__)
-        WSADATA wsaData;
-        WORD version;
-        int error;
-
-        version = MAKEWORD(2, 2);
-
-        error = WSAStartup(version, &wsaData);
-
-        if (error != 0 ||
-            LOBYTE(wsaData.wVersion) != 2 ||
-            HIBYTE(wsaData.wVersion) != 2)
-        {
-            /* incorrect WinSock version */
-            LERROR("Failed to init winsock API.");
-            //WSACleanup();
-            return false;
-        }
-    #else
-                //No init needed on unix
-    #endif
-
-    return true;
-}
-
 void ParallelConnection::preSynchronization(){
             
     //if we're the host
@@ -913,35 +681,12 @@ void ParallelConnection::preSynchronization(){
         tf._paused = Time::ref().paused();
         tf._requiresTimeJump = Time::ref().timeJumped();
         tf._time = Time::ref().currentTime();
-                
-        //create a buffer and serialize message
-        std::vector<char> tbuffer;
-        tf.serialize(tbuffer);
-                
-        //get the size of the keyframebuffer
-        uint16_t msglen = static_cast<uint16_t>(tbuffer.size());
-                
-        //the type of data message
-        uint16_t type = static_cast<uint16_t>(network::datamessagestructures::TimeData);
-                
-        //create the full buffer
-        std::vector<char> buffer;
-        buffer.reserve(headerSize() + sizeof(type) + sizeof(msglen) + msglen);
-                
-        //write header
-        writeHeader(buffer, MessageTypes::Data);
-                
-        //type of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&type), reinterpret_cast<char*>(&type) + sizeof(type));
-                
-        //size of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&msglen), reinterpret_cast<char*>(&msglen) + sizeof(msglen));
-                
-        //actual message
-        buffer.insert(buffer.end(), tbuffer.begin(), tbuffer.end());
-                
-        //send message
-        queueMessage(buffer);
+
+        queueDataMessage(network::datamessagestructures::TimeData, tf);
+
+        sendPositionKeyframe();
+
+        sendPropertyChanges();
     }
     else{
         //if we're not the host and we have a valid keyframe (one that hasnt been used before)
@@ -967,59 +712,94 @@ void ParallelConnection::preSynchronization(){
                     
         }
     }
+
+    updateDataStatistics();
+}
+
+void ParallelConnection::sendPositionKeyframe(){
+    //create a keyframe with current position and orientation of camera
+    network::datamessagestructures::PositionKeyframe kf;
+    kf._position = OsEng.interactionHandler().camera()->position();
+    kf._viewRotationQuat = glm::quat_cast(glm::mat4(OsEng.interactionHandler().camera()->viewRotationMatrix()));
+
+    //timestamp as current runtime of OpenSpace instance
+    kf._timeStamp = OsEng.runTime();
+
+    //start over with an absolute keyframe after the host or connection has changed
+    if (_shouldResetPositionKeyframes.exchange(false)){
+        _hasSentPositionKeyframe = false;
+        _isCameraMoving = false;
+        _sentPositionReference._isValid = false;
+    }
+
+    if (_hasSentPositionKeyframe){
+        const double elapsed = kf._timeStamp - _lastPositionKeyframe._timeStamp;
+        if (elapsed < MinimumKeyframeInterval){
+            return;
+        }
+
+        //only skip the keyframe if the pose is exactly the same as in the last one. any
+        //threshold would have to depend on the distance to what the user looks at, and
+        //slow motion close to a surface would otherwise become choppy
+        const bool isMoving =
+            kf._position.dvec3() != _lastPositionKeyframe._position.dvec3() ||
+            kf._viewRotationQuat != _lastPositionKeyframe._viewRotationQuat;
+
+        //the pose is sent once more when the camera stops, so that clients see it stand
+        //still instead of extrapolating its last motion
+        const bool hasStopped = _isCameraMoving && !isMoving;
+        _isCameraMoving = isMoving;
+
+        if (!isMoving && !hasStopped && elapsed < MaximumKeyframeInterval){
+            return;
+        }
+    }
+
+    //regularly write the absolute position, which following keyframes are relative to
+    if (kf._timeStamp - _sentPositionReferenceTime >= PositionReferenceInterval){
+        _sentPositionReference._isValid = false;
+    }
+    if (!_sentPositionReference._isValid){
+        _sentPositionReferenceTime = kf._timeStamp;
+    }
+
+    queueDataMessage(
+        network::datamessagestructures::PositionData,
+        [this, &kf](std::vector<char>& buffer){ kf.serialize(buffer, _sentPositionReference); }
+    );
+    _lastPositionKeyframe = kf;
+    _hasSentPositionKeyframe = true;
 }
         
 void ParallelConnection::scriptMessage(const std::string propIdentifier, const std::string propValue){
-            
+    //mutex protect
+    std::lock_guard<std::mutex> lock(_currentStateMutex);
+
     //save script as current state
-    {
-        //mutex protect
-        std::lock_guard<std::mutex> lock(_currentStateMutex);
-        _currentState[propIdentifier] = propValue;
-    }
-            
-    //if we're connected and we're the host, also send the script
-    if(_isConnected.load() && _isHost.load()){
-        //construct script
-        std::string script = scriptFromPropertyAndValue(propIdentifier, propValue);
-                
-        //create a script message
-        network::datamessagestructures::ScriptMessage sm;
-        sm._script = script;
-        sm._scriptlen = static_cast<uint16_t>(script.length());
-                
-        //create a buffer for the script
-        std::vector<char> sbuffer;
-                
-        //fill the script buffer
-        sm.serialize(sbuffer);
-                
-        //get the size of the keyframebuffer
-        uint16_t msglen = static_cast<uint16_t>(sbuffer.size());
-                
-        //the type of message
-        uint16_t type = static_cast<uint16_t>(network::datamessagestructures::ScriptData);
-                
-        //create the full buffer
-        std::vector<char> buffer;
-        buffer.reserve(headerSize() + sizeof(type) + sizeof(msglen) + msglen);
-                
-        //write header
-        writeHeader(buffer, MessageTypes::Data);
-                
-        //type of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&type), reinterpret_cast<char*>(&type) + sizeof(type));
-                
-        //size of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&msglen), reinterpret_cast<char*>(&msglen) + sizeof(msglen));
-                
-        //actual message
-        buffer.insert(buffer.end(), sbuffer.begin(), sbuffer.end());
-                
-        //send message
-        queueMessage(buffer);
-    }
+    _currentState[propIdentifier] = propValue;
+            
+    //if we're connected and we're the host, also send the change with the next batch
+    if(_transport.isConnected() && _isHost.load()){
+        auto it = _propertyIds.find(propIdentifier);
+        if (it == _propertyIds.end()){
+            if (_propertyIds.size() > std::numeric_limits<uint16_t>::max()){
+                //out of identifiers, send the full script instead
+                network::datamessagestructures::ScriptMessage sm;
+                sm._script = scriptFromPropertyAndValue(propIdentifier, propValue);
+                sm._scriptlen = static_cast<uint16_t>(sm._script.length());
+                queueDataMessage(network::datamessagestructures::ScriptData, sm);
+                return;
+            }
+
+            //assign the next identifier, whose mapping is sent before the change
+            uint16_t id = static_cast<uint16_t>(_propertyIds.size());
+            it = _propertyIds.emplace(propIdentifier, id).first;
+            _unsentPropertyMappings.emplace_back(id, propIdentifier);
+        }
 
+        //only the last change of a property within a frame is sent
+        _propertyChanges[it->second] = propValue;
+    }
 }
         
 std::string ParallelConnection::scriptFromPropertyAndValue(const std::string property, const std::string value){
@@ -1028,61 +808,7 @@ std::string ParallelConnection::scriptFromPropertyAndValue(const std::string pro
     return script;
 }
         
-void ParallelConnection::broadcast(){
-            
-    //while we're still connected and we're the host
-    while (_isConnected.load() && _isHost.load()){
-
-        //create a keyframe with current position and orientation of camera
-        network::datamessagestructures::PositionKeyframe kf;
-        kf._position = OsEng.interactionHandler().camera()->position();
-        kf._viewRotationQuat = glm::quat_cast(glm::mat4(OsEng.interactionHandler().camera()->viewRotationMatrix()));
-                
-        //timestamp as current runtime of OpenSpace instance
-        kf._timeStamp = OsEng.runTime();
-                
-        //create a buffer for the keyframe
-        std::vector<char> kfBuffer;
-                
-        //fill the keyframe buffer
-        kf.serialize(kfBuffer);
-                
-        //get the size of the keyframebuffer
-        uint16_t msglen = static_cast<uint16_t>(kfBuffer.size());
-                
-        //the type of message
-        uint16_t type = static_cast<uint16_t>(network::datamessagestructures::PositionData);
-                
-        //create the full buffer
-        std::vector<char> buffer;
-        buffer.reserve(headerSize() + sizeof(type) + sizeof(msglen) + msglen);
-                
-        //write header
-        writeHeader(buffer, MessageTypes::Data);
-                
-        //type of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&type), reinterpret_cast<char*>(&type) + sizeof(type));
-
-        //size of message
-        buffer.insert(buffer.end(), reinterpret_cast<char*>(&msglen), reinterpret_cast<char*>(&msglen) + sizeof(msglen));
-
-        //actual message
-        buffer.insert(buffer.end(), kfBuffer.begin(), kfBuffer.end());
-
-        //send message
-        queueMessage(buffer);
-
-        //100 ms sleep - send keyframes 10 times per second
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
-}
-        
 void ParallelConnection::writeHeader(std::vector<char> &buffer, uint32_t messageType){
-    //make sure the buffer is large enough to hold at least the header
-    if(buffer.size() < headerSize()){
-        buffer.reserve(headerSize());
-    }
-            
     //get the current running version of openspace
     uint8_t versionMajor = static_cast<uint8_t>(OPENSPACE_VERSION_MAJOR);
     uint8_t versionMinor = static_cast<uint8_t>(OPENSPACE_VERSION_MINOR);
@@ -1092,7 +818,7 @@ void ParallelConnection::writeHeader(std::vector<char> &buffer, uint32_t message
     buffer.insert(buffer.end(), 'S');
     buffer.insert(buffer.end(), versionMajor);
     buffer.insert(buffer.end(), versionMinor);
-    buffer.insert(buffer.end(), reinterpret_cast<char*>(&messageType), reinterpret_cast<char*>(&messageType) + sizeof(messageType));
+    appendValue(buffer, messageType);
 }
         
 int ParallelConnection::headerSize(){
@@ -1146,6 +872,13 @@ scripting::LuaLibrary ParallelConnection::luaLibrary() {
                 "string",
                 "Request to be the host for this session"
             },
+            {
+                "printDataStatistics",
+                &luascriptfunctions::printDataStatistics,
+                "",
+                "Logs the number of messages and bytes that have been sent and "
+                "received for each type of data message, and the current data rates"
+            },
         }
     };
 }
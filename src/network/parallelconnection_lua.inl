@@ -184,6 +184,17 @@ int requestHostship(lua_State* L) {
     return 0;
 }
 
+int printDataStatistics(lua_State* L) {
+    
+    int nArguments = lua_gettop(L);
+    if (nArguments != 0)
+        return luaL_error(L, "Expected %i arguments, got %i", 0, nArguments);
+    if(OsEng.isMaster()){
+        OsEng.parallelConnection().printDataStatistics();
+    }
+    return 0;
+}
+
 } // namespace luascriptfunctions
 
 } // namespace openspace
@@ -25,9 +25,12 @@
 #include <openspace/properties/property.h>
 
 #include <openspace/properties/propertyowner.h>
+#include <openspace/properties/propertyregistry.h>
 
 #include <ghoul/lua/ghoul_lua.h>
 
+#include <algorithm>
+
 namespace openspace {
 namespace properties {
 
@@ -54,7 +57,11 @@ const std::string Property::MetaDataKey = "MetaData";
 Property::Property(std::string identifier, std::string guiName)
     : _owner(nullptr)
     , _identifier(std::move(identifier))
+    , _nextOnChangeHandle(0)
 {
+    // Creates the registry before the first Property so that it outlives all of them
+    PropertyRegistry::ref();
+
     if (_identifier.empty())
         LWARNING("Property identifier is empty");
     if (guiName.empty())
@@ -64,7 +71,9 @@ Property::Property(std::string identifier, std::string guiName)
     _metaData.setValue(_metaDataKeyGuiName, std::move(guiName));
 }
 
-Property::~Property() {}
+Property::~Property() {
+    PropertyRegistry::ref().removeProperty(this);
+}
 
 const std::string& Property::identifier() const {
     return _identifier;
@@ -162,6 +171,24 @@ void Property::onChange(std::function<void()> callback) {
     _onChangeCallback = std::move(callback);
 }
 
+Property::OnChangeHandle Property::addOnChangeListener(std::function<void()> callback) {
+    OnChangeHandle handle = _nextOnChangeHandle++;
+    _onChangeListeners.emplace_back(handle, std::move(callback));
+    return handle;
+}
+
+void Property::removeOnChangeListener(OnChangeHandle handle) {
+    auto it = std::find_if(
+        _onChangeListeners.begin(),
+        _onChangeListeners.end(),
+        [handle](const std::pair<OnChangeHandle, std::function<void()>>& listener) {
+            return listener.first == handle;
+        }
+    );
+    if (it != _onChangeListeners.end())
+        _onChangeListeners.erase(it);
+}
+
 PropertyOwner* Property::owner() const
 {
     return _owner;
@@ -175,6 +202,13 @@ void Property::setPropertyOwner(PropertyOwner* owner)
 void Property::notifyListener() {
     if (_onChangeCallback)
         _onChangeCallback();
+    // Listeners may add or remove listeners, which would invalidate the iteration
+    const std::vector<std::pair<OnChangeHandle, std::function<void()>>> listeners =
+        _onChangeListeners;
+    for (const std::pair<OnChangeHandle, std::function<void()>>& listener : listeners) {
+        listener.second();
+    }
+    PropertyRegistry::ref().markChanged(this);
 }
 
 std::string Property::generateBaseDescription() const {
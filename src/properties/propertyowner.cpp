@@ -24,6 +24,8 @@
 
 #include <openspace/properties/propertyowner.h>
 
+#include <openspace/properties/propertyregistry.h>
+
 #include <ghoul/logging/logmanager.h>
 
 #include <algorithm>
@@ -53,6 +55,7 @@ PropertyOwner::PropertyOwner()
 }
 
 PropertyOwner::~PropertyOwner() {
+    PropertyRegistry::ref().invalidateUris();
     _properties.clear();
     _subOwners.clear();
 }
@@ -186,6 +189,7 @@ void PropertyOwner::addProperty(Property* prop)
             // now have found the correct position to add it in
             _properties.insert(it, prop);
             prop->setPropertyOwner(this);
+            PropertyRegistry::ref().invalidateUris();
         }
     }
 }
@@ -228,6 +232,7 @@ void PropertyOwner::addPropertySubOwner(openspace::properties::PropertyOwner* ow
             // Otherwise we have found the correct position to add it in
             _subOwners.insert(it, owner);
             owner->setPropertyOwner(this);
+            PropertyRegistry::ref().invalidateUris();
         }
     }
     
@@ -251,6 +256,7 @@ void PropertyOwner::removeProperty(Property* prop) {
     if (it != _properties.end() && (*it)->identifier() == prop->identifier()) {
         (*it)->setPropertyOwner(nullptr);
         _properties.erase(it);
+        PropertyRegistry::ref().invalidateUris();
     } else
         LERROR("Property with identifier '" << prop->identifier()
                                             << "' not found for removal.");
@@ -273,6 +279,7 @@ void PropertyOwner::removePropertySubOwner(openspace::properties::PropertyOwner*
     // If we found the propertyowner, we can delete it
     if (it != _subOwners.end() && (*it)->name() == owner->name()) {
         _subOwners.erase(it);
+        PropertyRegistry::ref().invalidateUris();
     } else
         LERROR("PropertyOwner with name '" << owner->name()
                << "' not found for removal.");
@@ -284,6 +291,8 @@ void PropertyOwner::removePropertySubOwner(openspace::properties::PropertyOwner&
 
 void PropertyOwner::setName(std::string name) {
     _name = std::move(name);
+    // The URIs of all Property%s below this owner have changed
+    PropertyRegistry::ref().invalidateUris();
 }
 
 const std::string& PropertyOwner::name() const {
@@ -0,0 +1,136 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/properties/propertyregistry.h>
+
+#include <algorithm>
+
+namespace openspace {
+namespace properties {
+
+PropertyRegistry& PropertyRegistry::ref() {
+    // Every Property accesses the registry in its constructor, so the registry is
+    // created before and destroyed after any Property with static storage duration
+    static PropertyRegistry registry;
+    return registry;
+}
+
+PropertyRegistry::PropertyRegistry()
+    : _isUriCacheValid(true)
+    , _generation(0)
+    , _nCacheHits(0)
+    , _nCacheMisses(0)
+{}
+
+Property* PropertyRegistry::property(const std::string& uri) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_isUriCacheValid) {
+        _uris.clear();
+        _isUriCacheValid = true;
+    }
+
+    auto it = _uris.find(uri);
+    if (it == _uris.end()) {
+        ++_nCacheMisses;
+        return nullptr;
+    }
+    ++_nCacheHits;
+    return it->second;
+}
+
+size_t PropertyRegistry::generation() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _generation;
+}
+
+void PropertyRegistry::cacheProperty(const std::string& uri, Property* property,
+                                     size_t generation)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    // The Property might have been removed or destroyed while it was looked up
+    if (generation != _generation)
+        return;
+
+    if (!_isUriCacheValid) {
+        _uris.clear();
+        _isUriCacheValid = true;
+    }
+    _uris[uri] = property;
+}
+
+void PropertyRegistry::invalidateUris() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    // The cache is only cleared on the next access, as hierarchies change many times in
+    // a row while a scene is loaded
+    _isUriCacheValid = false;
+    ++_generation;
+}
+
+void PropertyRegistry::markChanged(Property* property) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_isChanging.insert(property).second)
+        _changingProperties.push_back(property);
+}
+
+void PropertyRegistry::removeProperty(Property* property) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _isUriCacheValid = false;
+    ++_generation;
+
+    if (_isChanging.erase(property) > 0) {
+        _changingProperties.erase(
+            std::remove(_changingProperties.begin(), _changingProperties.end(), property),
+            _changingProperties.end()
+        );
+    }
+    _changedProperties.erase(
+        std::remove(_changedProperties.begin(), _changedProperties.end(), property),
+        _changedProperties.end()
+    );
+}
+
+std::vector<Property*> PropertyRegistry::changedProperties() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _changedProperties;
+}
+
+void PropertyRegistry::finishFrame() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _isChanging.clear();
+    _changedProperties.swap(_changingProperties);
+    _changingProperties.clear();
+}
+
+size_t PropertyRegistry::numberOfCacheHits() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _nCacheHits;
+}
+
+size_t PropertyRegistry::numberOfCacheMisses() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _nCacheMisses;
+}
+
+} // namespace properties
+} // namespace openspace
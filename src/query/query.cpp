@@ -26,6 +26,7 @@
 
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/interaction/interactionhandler.h>
+#include <openspace/properties/propertyregistry.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/rendering/renderable.h>
 #include <openspace/scene/scene.h>
@@ -40,6 +41,8 @@ namespace openspace {
 
 namespace {
     const std::string _loggerCat = "Query";
+
+    properties::Property* findProperty(const std::string& uri);
 }
 
 Scene* sceneGraph() {
@@ -57,6 +60,20 @@ Renderable* renderable(const std::string& name) {
 }
 
 properties::Property* property(const std::string& uri) {
+    properties::PropertyRegistry& registry = properties::PropertyRegistry::ref();
+    const size_t generation = registry.generation();
+    properties::Property* prop = registry.property(uri);
+    if (!prop) {
+        prop = findProperty(uri);
+        if (prop)
+            registry.cacheProperty(uri, prop, generation);
+    }
+    return prop;
+}
+
+namespace {
+
+properties::Property* findProperty(const std::string& uri) {
     properties::Property* globalProp = OsEng.globalPropertyOwner().property(uri);
     if (globalProp) {
         return globalProp;
@@ -96,6 +113,8 @@ properties::Property* property(const std::string& uri) {
     }
 }
 
+} // namespace
+
 std::vector<properties::Property*> allProperties() {
     std::vector<properties::Property*> properties;
 
@@ -184,6 +184,10 @@ void Renderable::setBody(std::string& body) {
     _hasBody = true;
 }
 
+bool Renderable::initializeData() {
+    return true;
+}
+
 bool Renderable::isReady() const {
     return true;
 }
@@ -42,6 +42,7 @@
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/interaction/interactionhandler.h>
 #include <openspace/scene/scene.h>
+#include <openspace/scene/sceneinitializer.h>
 #include <openspace/util/camera.h>
 #include <openspace/util/time.h>
 #include <openspace/util/screenlog.h>
@@ -60,6 +61,7 @@
 #include <ghoul/glm.h>
 #include <openspace/engine/wrapper/windowwrapper.h>
 #include <openspace/rendering/screenspacerenderable.h>
+#include <openspace/properties/propertyregistry.h>
 
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/io/texture/texturewriter.h>
@@ -389,6 +391,10 @@ void RenderEngine::render(const glm::mat4& projectionMatrix, const glm::mat4& vi
 
     if (!(OsEng.isMaster() && _disableMasterRendering) && !OsEng.windowWrapper().isGuiWindow()) {
         _renderer->render(_globalBlackOutFactor, _performanceManager != nullptr);
+
+        if (_sceneGraph && _sceneGraph->isLoading()) {
+            renderLoadingInformation();
+        }
     }
 
     // Print some useful information on the master viewport
@@ -429,6 +435,36 @@ void RenderEngine::renderShutdownInformation(float timer, float fullTime) {
     );
 }
 
+void RenderEngine::renderLoadingInformation() {
+    if (!_fontDate)
+        return;
+
+    const SceneInitializer* initializer = _sceneGraph->initializer();
+    const int nInitialized = static_cast<int>(initializer->numberOfInitializedNodes());
+    const int nNodes = static_cast<int>(initializer->numberOfNodes());
+
+    auto size = ghoul::fontrendering::FontRenderer::defaultRenderer().boundingBox(
+        *_fontDate,
+        "Loading scene: %i/%i",
+        nInitialized,
+        nNodes
+    );
+
+    glm::ivec4 viewport = OsEng.windowWrapper().viewportPixelCoordinates();
+    glm::vec2 penPosition = glm::vec2(
+        (viewport.x + viewport.y - size.boundingBox.x) / 2.f,
+        (viewport.z + viewport.w - size.boundingBox.y) / 2.f
+    );
+
+    RenderFontCr(
+        *_fontDate,
+        penPosition,
+        "Loading scene: %i/%i",
+        nInitialized,
+        nNodes
+    );
+}
+
 void RenderEngine::postDraw() {
     if (Time::ref().timeJumped()) {
         Time::ref().setTimeJumped(false);
@@ -472,20 +508,20 @@ void RenderEngine::serialize(SyncBuffer* syncBuffer) {
     }
 
 
-    syncBuffer->encode(_onScreenInformation._node);
-    syncBuffer->encode(_onScreenInformation._position.x);
-    syncBuffer->encode(_onScreenInformation._position.y);
-    syncBuffer->encode(_onScreenInformation._size);
+    syncBuffer->encodeDelta(_onScreenInformation._node);
+    syncBuffer->encodeDelta(_onScreenInformation._position.x);
+    syncBuffer->encodeDelta(_onScreenInformation._position.y);
+    syncBuffer->encodeDelta(_onScreenInformation._size);
 }
 
 void RenderEngine::deserialize(SyncBuffer* syncBuffer) {
     if (_mainCamera){
         _mainCamera->deserialize(syncBuffer);
     }
-    syncBuffer->decode(_onScreenInformation._node);
-    syncBuffer->decode(_onScreenInformation._position.x);
-    syncBuffer->decode(_onScreenInformation._position.y);
-    syncBuffer->decode(_onScreenInformation._size);
+    syncBuffer->decodeDelta(_onScreenInformation._node);
+    syncBuffer->decodeDelta(_onScreenInformation._position.x);
+    syncBuffer->decodeDelta(_onScreenInformation._position.y);
+    syncBuffer->decodeDelta(_onScreenInformation._size);
 
 }
 
@@ -1168,6 +1204,8 @@ void RenderEngine::unregisterScreenSpaceRenderable(std::shared_ptr<ScreenSpaceRe
     if (it != _screenSpaceRenderables.end()) {
         s->deinitialize();
         _screenSpaceRenderables.erase(it);
+        // Its Property%s can no longer be reached, even if it is kept alive elsewhere
+        properties::PropertyRegistry::ref().invalidateUris();
     }
 }
 
@@ -1245,6 +1283,15 @@ void RenderEngine::renderInformation() {
             OsEng.windowWrapper().averageDeltaTime()
             );
 
+        const SyncBuffer::Statistics& syncStatistics = OsEng.syncBuffer().statistics();
+        RenderFontCr(*_fontInfo,
+            penPosition,
+            "Sync: %i bytes/frame, encode %.3f ms, decode %.3f ms",
+            static_cast<int>(syncStatistics.bytesPerFrame),
+            std::chrono::duration<double, std::milli>(syncStatistics.encodeTime).count(),
+            std::chrono::duration<double, std::milli>(syncStatistics.decodeTime).count()
+            );
+
 #ifdef OPENSPACE_MODULE_NEWHORIZONS_ENABLED
         bool hasNewHorizons = scene()->sceneGraphNode("NewHorizons");
 
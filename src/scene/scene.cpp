@@ -30,6 +30,8 @@
 #include <openspace/query/query.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/scene/scenegraphnode.h>
+#include <openspace/scene/sceneinitializer.h>
+#include <openspace/scripting/scriptcache.h>
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/scripting/script_helper.h>
 #include <openspace/util/time.h>
@@ -67,6 +69,10 @@ namespace {
     const std::string KeyFocusObject = "Focus";
     const std::string KeyPositionObject = "Position";
     const std::string KeyViewOffset = "Offset";
+
+    // The time that the initialization of nodes on the rendering thread may take each
+    // frame while a scene is loading
+    const std::chrono::milliseconds UploadTimePerFrame(15);
 }
 
 namespace openspace {
@@ -93,7 +99,25 @@ void Scene::update(const UpdateData& data) {
         try {
             loadSceneInternal(_sceneGraphToLoad);
             _sceneGraphToLoad = "";
-            
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERROR(e.what());
+            _sceneGraphToLoad = "";
+            return;
+        }
+    }
+
+    if (_initializer) {
+        // The nodes are initialized over several frames; until all of them are done,
+        // none of them are updated
+        if (!_initializer->update(UploadTimePerFrame))
+            return;
+
+        _initializer->logTimingReport();
+        _initializer = nullptr;
+        try {
+            finishLoadingScene();
+
             // After loading the scene, the keyboard bindings have been set
             
             std::string type;
@@ -112,7 +136,6 @@ void Scene::update(const UpdateData& data) {
         }
         catch (const ghoul::RuntimeError& e) {
             LERROR(e.what());
-            _sceneGraphToLoad = "";
             return;
         }
     }
@@ -128,18 +151,27 @@ void Scene::update(const UpdateData& data) {
 }
 
 void Scene::evaluate(Camera* camera) {
+    if (isLoading())
+        return;
+
     for (SceneGraphNode* node : _graph.nodes())
         node->evaluate(camera);
     //_root->evaluate(camera);
 }
 
 void Scene::render(const RenderData& data, RendererTasks& tasks) {
+    if (isLoading())
+        return;
+
     for (SceneGraphNode* node : _graph.nodes()) {
         node->render(data, tasks);
     }
 }
 
 void Scene::postRender(const RenderData& data) {
+    if (isLoading())
+        return;
+
     for (SceneGraphNode* node : _graph.nodes()) {
         node->postRender(data);
     }
@@ -149,7 +181,19 @@ void Scene::scheduleLoadSceneFile(const std::string& sceneDescriptionFilePath) {
     _sceneGraphToLoad = sceneDescriptionFilePath;
 }
 
+bool Scene::isLoading() const {
+    return _initializer != nullptr;
+}
+
+const SceneInitializer* Scene::initializer() const {
+    return _initializer.get();
+}
+
 void Scene::clearSceneGraph() {
+    // A scene that is still being initialized is abandoned; this waits for the nodes
+    // that are currently loading on the worker threads
+    _initializer = nullptr;
+
     // deallocate the scene graph. Recursive deallocation will occur
     _graph.clear();
     //if (_root) {
@@ -176,7 +220,7 @@ bool Scene::loadSceneInternal(const std::string& sceneDescriptionFilePath) {
     
     OsEng.scriptEngine().initializeLuaState(state);
 
-    ghoul::lua::loadDictionaryFromFile(
+    scripting::loadDictionaryFromFile(
         sceneDescriptionFilePath,
         dictionary,
         state
@@ -212,20 +256,20 @@ bool Scene::loadSceneInternal(const std::string& sceneDescriptionFilePath) {
         }
     }
 
-    // Initialize all nodes
-    for (SceneGraphNode* node : _graph.nodes()) {
-        try {
-            bool success = node->initialize();
-            if (success)
-                LDEBUG(node->name() << " initialized successfully!");
-            else
-                LWARNING(node->name() << " not initialized.");
-        }
-        catch (const ghoul::RuntimeError& e) {
-            LERRORC(_loggerCat + "(" + e.component + ")", e.what());
-        }
-    }
+    // Until the scene is loaded, the camera is focused on the root node
+    OsEng.interactionHandler().setFocusNode(_graph.rootNode());
+
+    _cameraDictionary = cameraDictionary;
+    _loadingSceneFile = sceneDescriptionFilePath;
 
+    // The nodes are initialized concurrently and finished in Scene::update
+    _initializer = std::make_unique<SceneInitializer>(_graph);
+
+    return true;
+}
+
+void Scene::finishLoadingScene() {
+    const ghoul::Dictionary& cameraDictionary = _cameraDictionary;
 
     // update the position of all nodes
     // TODO need to check this; unnecessary? (ab)
@@ -358,11 +402,9 @@ bool Scene::loadSceneInternal(const std::string& sceneDescriptionFilePath) {
     }
 
 
-    OsEng.runPostInitializationScripts(sceneDescriptionFilePath);
+    OsEng.runPostInitializationScripts(_loadingSceneFile);
 
     OsEng.enableBarrier();
-
-    return true;
 }
 
 //void Scene::loadModules(
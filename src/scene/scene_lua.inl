@@ -246,6 +246,7 @@ int addSceneGraphNode(lua_State* L) {
         return 0;
     }
     node->setParent(parentNode);
+    node->initializeData();
     node->initialize();
     OsEng.renderEngine().scene()->sceneGraph().addSceneGraphNode(node);
 
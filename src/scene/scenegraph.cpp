@@ -28,12 +28,14 @@
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/rendering/renderengine.h>
 #include <openspace/interaction/interactionhandler.h>
+#include <openspace/scripting/scriptcache.h>
 
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/lua_helper.h>
 #include <ghoul/misc/onscopeexit.h>
 
+#include <chrono>
 #include <stack>
 #include <unordered_map>
 
@@ -91,6 +93,7 @@ bool SceneGraph::loadFromFile(const std::string& sceneDescription) {
         return false;
     }
     LINFO("Loading SceneGraph from file '" << absSceneFile << "'");
+    auto parseStart = std::chrono::steady_clock::now();
 
     
     lua_State* state = ghoul::lua::createNewLuaState();
@@ -105,7 +108,7 @@ bool SceneGraph::loadFromFile(const std::string& sceneDescription) {
     // Load dictionary
     ghoul::Dictionary sceneDictionary;
     try {
-        ghoul::lua::loadDictionaryFromFile(
+        scripting::loadDictionaryFromFile(
             absSceneFile,
             sceneDictionary,
             state
@@ -151,7 +154,7 @@ bool SceneGraph::loadFromFile(const std::string& sceneDescription) {
     // file again to load any variables defined inside into the state that is passed to
     // the modules. This allows us to specify global variables that can then be used
     // inside the modules to toggle settings
-    ghoul::lua::runScriptFile(state, absSceneFile);
+    scripting::runScriptFile(state, absSceneFile);
     
     // Get the common directory
     bool commonFolderSpecified = sceneDictionary.hasKey(KeyCommonFolder);
@@ -230,7 +233,7 @@ bool SceneGraph::loadFromFile(const std::string& sceneDescription) {
             // We have a module file, so it is a direct include
             try {
                 ghoul::Dictionary moduleDictionary;
-                ghoul::lua::loadDictionaryFromFile(moduleFile, moduleDictionary, state);
+                scripting::loadDictionaryFromFile(moduleFile, moduleDictionary, state);
                 moduleDictionaries.push_back({
                     moduleDictionary,
                     moduleFile,
@@ -268,7 +271,7 @@ bool SceneGraph::loadFromFile(const std::string& sceneDescription) {
                 // We have a module file, so it is a direct include
                 try {
                     ghoul::Dictionary moduleDictionary;
-                    ghoul::lua::loadDictionaryFromFile(moduleFile, moduleDictionary, state);
+                    scripting::loadDictionaryFromFile(moduleFile, moduleDictionary, state);
                     moduleDictionaries.push_back({
                         moduleDictionary,
                         moduleFile,
@@ -350,6 +353,11 @@ bool SceneGraph::loadFromFile(const std::string& sceneDescription) {
 //    ghoul::lua::destroyLuaState(state);
     FileSys.setCurrentDirectory(oldDirectory);
 
+    // Compiled scene and module files are cached, see scripting::loadFile
+    std::chrono::duration<double, std::milli> parseTime =
+        std::chrono::steady_clock::now() - parseStart;
+    LINFO("Read scene description and modules in " << parseTime.count() << " ms");
+
     for (SceneGraphNodeInternal* node : _nodes) {
         if (node->node == _rootNode)
             continue;
@@ -546,6 +554,24 @@ const std::vector<SceneGraphNode*>& SceneGraph::nodes() const {
     return _topologicalSortedNodes;
 }
 
+std::vector<SceneGraphNode*> SceneGraph::dependencies(SceneGraphNode* node) const {
+    auto it = std::find_if(
+        _nodes.begin(),
+        _nodes.end(),
+        [node](SceneGraphNodeInternal* i) {
+            return i->node == node;
+        }
+    );
+    if (it == _nodes.end())
+        return {};
+
+    std::vector<SceneGraphNode*> result;
+    result.reserve((*it)->outgoingEdges.size());
+    for (SceneGraphNodeInternal* n : (*it)->outgoingEdges)
+        result.push_back(n->node);
+    return result;
+}
+
 SceneGraphNode* SceneGraph::rootNode() const {
     return _rootNode;
 }
@@ -133,6 +133,13 @@ SceneGraphNode::~SceneGraphNode() {
     deinitialize();
 }
 
+bool SceneGraphNode::initializeData() {
+    if (_renderable)
+        return _renderable->initializeData();
+
+    return true;
+}
+
 bool SceneGraphNode::initialize() {
     if (_renderable)
         _renderable->initialize();
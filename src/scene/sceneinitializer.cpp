@@ -0,0 +1,241 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/scene/sceneinitializer.h>
+
+#include <openspace/scene/scenegraph.h>
+#include <openspace/scene/scenegraphnode.h>
+
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+    const std::string _loggerCat = "SceneInitializer";
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    double milliseconds(std::chrono::microseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    }
+}
+
+namespace openspace {
+
+SceneInitializer::SceneInitializer(const SceneGraph& graph, unsigned int nThreads)
+    : SceneInitializer(
+        graph.nodes(),
+        [&graph](SceneGraphNode* node) { return graph.dependencies(node); },
+        nThreads
+    )
+{}
+
+SceneInitializer::SceneInitializer(const std::vector<SceneGraphNode*>& nodes,
+                                   const DependencyFunction& dependencies,
+                                   unsigned int nThreads)
+    : _isStopping(false)
+    , _nextNode(0)
+    , _startTime(Clock::now())
+    , _totalTime(0)
+{
+    std::unordered_map<SceneGraphNode*, size_t> indices;
+    _nodes.reserve(nodes.size());
+    for (SceneGraphNode* node : nodes) {
+        indices[node] = _nodes.size();
+        _nodes.push_back({
+            node,
+            {},
+            0,
+            false,
+            { node->name(), std::chrono::microseconds(0), std::chrono::microseconds(0) }
+        });
+    }
+
+    for (size_t i = 0; i < _nodes.size(); ++i) {
+        for (SceneGraphNode* dependency : dependencies(_nodes[i].node)) {
+            auto it = indices.find(dependency);
+            if (it != indices.end()) {
+                _nodes[it->second].dependents.push_back(i);
+                ++_nodes[i].nUnfinishedDependencies;
+            }
+        }
+        if (_nodes[i].nUnfinishedDependencies == 0)
+            _readyNodes.push_back(i);
+    }
+
+    if (nThreads == 0)
+        nThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    LDEBUG("Initializing " << _nodes.size() << " nodes on " << nThreads << " threads");
+
+    for (unsigned int i = 0; i < nThreads; ++i)
+        _workers.emplace_back([this]() { work(); });
+}
+
+SceneInitializer::~SceneInitializer() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _nodeIsReady.notify_all();
+    for (std::thread& worker : _workers)
+        worker.join();
+}
+
+bool SceneInitializer::update(std::chrono::microseconds budget) {
+    const Clock::time_point start = Clock::now();
+    while (_nextNode < _nodes.size()) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_nodes[_nextNode].dataFinished)
+                break;
+        }
+
+        initializeNode(_nextNode);
+        ++_nextNode;
+
+        if (isFinished())
+            _totalTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now() - _startTime
+            );
+
+        if (Clock::now() - start > budget)
+            break;
+    }
+    return isFinished();
+}
+
+bool SceneInitializer::isFinished() const {
+    return _nextNode == _nodes.size();
+}
+
+size_t SceneInitializer::numberOfNodes() const {
+    return _nodes.size();
+}
+
+size_t SceneInitializer::numberOfInitializedNodes() const {
+    return _nextNode;
+}
+
+std::vector<SceneInitializer::NodeTiming> SceneInitializer::timings() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<NodeTiming> result;
+    result.reserve(_nodes.size());
+    for (const NodeState& node : _nodes)
+        result.push_back(node.timing);
+    return result;
+}
+
+void SceneInitializer::logTimingReport() const {
+    std::vector<NodeTiming> nodeTimings = timings();
+    std::sort(
+        nodeTimings.begin(),
+        nodeTimings.end(),
+        [](const NodeTiming& lhs, const NodeTiming& rhs) {
+            return lhs.dataTime + lhs.uploadTime > rhs.dataTime + rhs.uploadTime;
+        }
+    );
+
+    std::chrono::microseconds sequentialTime(0);
+    for (const NodeTiming& t : nodeTimings) {
+        sequentialTime += t.dataTime + t.uploadTime;
+        LINFO(t.name << ": " << milliseconds(t.dataTime) << " ms loading, "
+            << milliseconds(t.uploadTime) << " ms uploading");
+    }
+
+    const double speedup = _totalTime.count() > 0 ?
+        static_cast<double>(sequentialTime.count()) / _totalTime.count() : 1.0;
+    LINFO("Initialized " << _nodes.size() << " nodes in " << milliseconds(_totalTime)
+        << " ms (" << milliseconds(sequentialTime) << " ms sequentially, speedup "
+        << speedup << ")");
+}
+
+void SceneInitializer::work() {
+    while (true) {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _nodeIsReady.wait(lock, [this]() {
+                return _isStopping || !_readyNodes.empty();
+            });
+            if (_isStopping)
+                return;
+
+            index = _readyNodes.front();
+            _readyNodes.pop_front();
+        }
+
+        initializeNodeData(index);
+    }
+}
+
+void SceneInitializer::initializeNodeData(size_t index) {
+    NodeState& state = _nodes[index];
+
+    const Clock::time_point start = Clock::now();
+    try {
+        if (!state.node->initializeData())
+            LWARNING(state.node->name() << " could not load its data.");
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(_loggerCat + "(" + e.component + ")", e.what());
+    }
+    const std::chrono::microseconds time =
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        state.timing.dataTime = time;
+        state.dataFinished = true;
+        for (size_t dependent : state.dependents) {
+            if (--_nodes[dependent].nUnfinishedDependencies == 0)
+                _readyNodes.push_back(dependent);
+        }
+    }
+    _nodeIsReady.notify_all();
+}
+
+void SceneInitializer::initializeNode(size_t index) {
+    NodeState& state = _nodes[index];
+
+    const Clock::time_point start = Clock::now();
+    try {
+        bool success = state.node->initialize();
+        if (success)
+            LDEBUG(state.node->name() << " initialized successfully!");
+        else
+            LWARNING(state.node->name() << " not initialized.");
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(_loggerCat + "(" + e.component + ")", e.what());
+    }
+    const std::chrono::microseconds time =
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    state.timing.uploadTime = time;
+}
+
+} // namespace openspace
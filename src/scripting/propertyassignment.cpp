@@ -0,0 +1,437 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/scripting/propertyassignment.h>
+
+#include <openspace/util/syncbuffer.h>
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    const std::string SetPropertyValueSingle = "openspace.setPropertyValueSingle";
+    const std::string SetPropertyValue = "openspace.setPropertyValue";
+
+    // setPropertyValue treats its URI as a regular expression with wildcards, so it is
+    // only a single assignment if none of these characters are used
+    const char* PatternCharacters = "*?+()[]{}|^$\\";
+
+    bool isIdentifierCharacter(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    // Reads the subset of Lua literals that a PropertyAssignment can hold. Anything else,
+    // including comments, long strings and expressions, is rejected so that the script is
+    // run by the interpreter instead
+    class LiteralParser {
+    public:
+        explicit LiteralParser(const std::string& text)
+            : _text(text)
+            , _position(0)
+        {}
+
+        void skipWhitespace() {
+            while (_position < _text.size() &&
+                   std::isspace(static_cast<unsigned char>(_text[_position])))
+            {
+                ++_position;
+            }
+        }
+
+        bool atEnd() {
+            skipWhitespace();
+            return _position == _text.size();
+        }
+
+        bool consume(char c) {
+            skipWhitespace();
+            if (_position < _text.size() && _text[_position] == c) {
+                ++_position;
+                return true;
+            }
+            return false;
+        }
+
+        bool consumeName(const std::string& name) {
+            skipWhitespace();
+            if (_text.compare(_position, name.size(), name) != 0)
+                return false;
+            size_t end = _position + name.size();
+            if (end < _text.size() && isIdentifierCharacter(_text[end]))
+                return false;
+            _position = end;
+            return true;
+        }
+
+        bool parseString(std::string& value) {
+            skipWhitespace();
+            if (_position >= _text.size())
+                return false;
+            const char quote = _text[_position];
+            if (quote != '"' && quote != '\'')
+                return false;
+
+            value.clear();
+            for (size_t i = _position + 1; i < _text.size(); ++i) {
+                char c = _text[i];
+                if (c == quote) {
+                    _position = i + 1;
+                    return true;
+                }
+                if (c == '\n' || c == '\r')
+                    return false;
+                if (c == '\\') {
+                    if (++i == _text.size())
+                        return false;
+                    switch (_text[i]) {
+                        case '\\': value += '\\'; break;
+                        case '"':  value += '"';  break;
+                        case '\'': value += '\''; break;
+                        case 'n':  value += '\n'; break;
+                        case 't':  value += '\t'; break;
+                        default:   return false;
+                    }
+                }
+                else
+                    value += c;
+            }
+            return false;
+        }
+
+        bool parseNumber(double& value) {
+            skipWhitespace();
+            size_t start = _position;
+            if (start < _text.size() && _text[start] == '-')
+                ++start;
+            // strtod also accepts names such as 'inf' which are variables in Lua
+            const bool startsWithDigit = start < _text.size() &&
+                (std::isdigit(static_cast<unsigned char>(_text[start])) ||
+                (_text[start] == '.' && start + 1 < _text.size() &&
+                 std::isdigit(static_cast<unsigned char>(_text[start + 1]))));
+            if (!startsWithDigit)
+                return false;
+
+            const char* begin = _text.c_str() + _position;
+            char* end = nullptr;
+            value = std::strtod(begin, &end);
+            size_t next = _position + (end - begin);
+            if (end == begin ||
+                (next < _text.size() && (isIdentifierCharacter(_text[next]) ||
+                                         _text[next] == '.')))
+            {
+                return false;
+            }
+            _position = next;
+            return true;
+        }
+
+        bool parseValue(openspace::scripting::PropertyAssignment& assignment,
+                        std::string uri)
+        {
+            using openspace::scripting::PropertyAssignment;
+
+            if (consumeName("true")) {
+                assignment = PropertyAssignment(std::move(uri), true);
+                return true;
+            }
+            if (consumeName("false")) {
+                assignment = PropertyAssignment(std::move(uri), false);
+                return true;
+            }
+
+            std::string string;
+            if (parseString(string)) {
+                assignment = PropertyAssignment(std::move(uri), std::move(string));
+                return true;
+            }
+
+            double number;
+            if (parseNumber(number)) {
+                assignment = PropertyAssignment(std::move(uri), number);
+                return true;
+            }
+
+            if (consume('{')) {
+                std::vector<double> numbers;
+                while (!consume('}')) {
+                    if (!parseNumber(number))
+                        return false;
+                    numbers.push_back(number);
+                    if (!consume(',') && !consume(';')) {
+                        if (!consume('}'))
+                            return false;
+                        break;
+                    }
+                }
+                assignment = PropertyAssignment(std::move(uri), std::move(numbers));
+                return true;
+            }
+
+            return false;
+        }
+
+    private:
+        const std::string& _text;
+        size_t _position;
+    };
+
+    std::string quotedString(const std::string& value) {
+        std::string result = "\"";
+        for (char c : value) {
+            switch (c) {
+                case '\\': result += "\\\\"; break;
+                case '"':  result += "\\\""; break;
+                case '\n': result += "\\n";  break;
+                case '\t': result += "\\t";  break;
+                default:   result += c;
+            }
+        }
+        return result + "\"";
+    }
+
+    std::string numberLiteral(double value) {
+        if (std::isnan(value))
+            return "(0/0)";
+        if (std::isinf(value))
+            return value > 0 ? "(1/0)" : "(-1/0)";
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+        return buffer;
+    }
+}
+
+namespace openspace {
+namespace scripting {
+
+PropertyAssignment::PropertyAssignment()
+    : _type(Type::Boolean)
+    , _boolean(false)
+{}
+
+PropertyAssignment::PropertyAssignment(std::string uri, bool value)
+    : _uri(std::move(uri))
+    , _type(Type::Boolean)
+    , _boolean(value)
+{}
+
+PropertyAssignment::PropertyAssignment(std::string uri, int value)
+    : PropertyAssignment(std::move(uri), static_cast<double>(value))
+{}
+
+PropertyAssignment::PropertyAssignment(std::string uri, double value)
+    : _uri(std::move(uri))
+    , _type(Type::Number)
+    , _boolean(false)
+    , _numbers(1, value)
+{}
+
+PropertyAssignment::PropertyAssignment(std::string uri, std::string value)
+    : _uri(std::move(uri))
+    , _type(Type::String)
+    , _boolean(false)
+    , _string(std::move(value))
+{}
+
+PropertyAssignment::PropertyAssignment(std::string uri, const char* value)
+    : PropertyAssignment(std::move(uri), std::string(value))
+{}
+
+PropertyAssignment::PropertyAssignment(std::string uri, std::vector<double> values)
+    : _uri(std::move(uri))
+    , _type(Type::NumberTable)
+    , _boolean(false)
+    , _numbers(std::move(values))
+{}
+
+bool PropertyAssignment::fromScript(const std::string& script,
+                                    PropertyAssignment& assignment)
+{
+    LiteralParser parser(script);
+
+    // setPropertyValue is a prefix of setPropertyValueSingle
+    bool isSingle = parser.consumeName(SetPropertyValueSingle);
+    if (!isSingle && !parser.consumeName(SetPropertyValue))
+        return false;
+
+    std::string uri;
+    if (!parser.consume('(') || !parser.parseString(uri) || !parser.consume(','))
+        return false;
+
+    if (!isSingle && uri.find_first_of(PatternCharacters) != std::string::npos)
+        return false;
+
+    if (!parser.parseValue(assignment, std::move(uri)) || !parser.consume(')'))
+        return false;
+
+    parser.consume(';');
+    return parser.atEnd();
+}
+
+bool PropertyAssignment::fromLiteral(std::string uri, const std::string& literal,
+                                     PropertyAssignment& assignment)
+{
+    LiteralParser parser(literal);
+    return parser.parseValue(assignment, std::move(uri)) && parser.atEnd();
+}
+
+const std::string& PropertyAssignment::uri() const {
+    return _uri;
+}
+
+PropertyAssignment::Type PropertyAssignment::type() const {
+    return _type;
+}
+
+int PropertyAssignment::luaType() const {
+    switch (_type) {
+        case Type::Boolean:
+            return LUA_TBOOLEAN;
+        case Type::Number:
+            return LUA_TNUMBER;
+        case Type::String:
+            return LUA_TSTRING;
+        case Type::NumberTable:
+            return LUA_TTABLE;
+        default:
+            return LUA_TNIL;
+    }
+}
+
+void PropertyAssignment::pushValue(lua_State* state) const {
+    switch (_type) {
+        case Type::Boolean:
+            lua_pushboolean(state, _boolean ? 1 : 0);
+            break;
+        case Type::Number:
+            lua_pushnumber(state, static_cast<lua_Number>(_numbers[0]));
+            break;
+        case Type::String:
+            lua_pushlstring(state, _string.data(), _string.size());
+            break;
+        case Type::NumberTable:
+            lua_createtable(state, static_cast<int>(_numbers.size()), 0);
+            for (size_t i = 0; i < _numbers.size(); ++i) {
+                lua_pushnumber(state, static_cast<lua_Number>(_numbers[i]));
+                lua_rawseti(state, -2, static_cast<int>(i + 1));
+            }
+            break;
+    }
+}
+
+std::string PropertyAssignment::literal() const {
+    switch (_type) {
+        case Type::Boolean:
+            return _boolean ? "true" : "false";
+        case Type::Number:
+            return numberLiteral(_numbers[0]);
+        case Type::String:
+            return quotedString(_string);
+        case Type::NumberTable: {
+            std::string result = "{";
+            for (double v : _numbers)
+                result += numberLiteral(v) + ",";
+            if (!_numbers.empty())
+                result.pop_back();
+            return result + "}";
+        }
+        default:
+            return "nil";
+    }
+}
+
+std::string PropertyAssignment::script() const {
+    return SetPropertyValueSingle + "(" + quotedString(_uri) + ", " + literal() + ")";
+}
+
+size_t PropertyAssignment::serializedSize() const {
+    size_t size = sizeof(int32_t) + _uri.size() + sizeof(uint8_t);
+    switch (_type) {
+        case Type::Boolean:
+            return size + sizeof(uint8_t);
+        case Type::Number:
+            return size + sizeof(double);
+        case Type::String:
+            return size + sizeof(int32_t) + _string.size();
+        case Type::NumberTable:
+            return size + sizeof(int32_t) + _numbers.size() * sizeof(double);
+        default:
+            return size;
+    }
+}
+
+void PropertyAssignment::serialize(SyncBuffer& buffer) const {
+    buffer.encode(_uri);
+    buffer.encode(static_cast<uint8_t>(_type));
+    switch (_type) {
+        case Type::Boolean:
+            buffer.encode(static_cast<uint8_t>(_boolean ? 1 : 0));
+            break;
+        case Type::Number:
+            buffer.encode(_numbers[0]);
+            break;
+        case Type::String:
+            buffer.encode(_string);
+            break;
+        case Type::NumberTable:
+            buffer.encode(static_cast<int32_t>(_numbers.size()));
+            for (double v : _numbers)
+                buffer.encode(v);
+            break;
+    }
+}
+
+bool PropertyAssignment::deserialize(SyncBuffer& buffer) {
+    buffer.decode(_uri);
+    const uint8_t type = buffer.decode<uint8_t>();
+    if (type > static_cast<uint8_t>(Type::NumberTable))
+        return false;
+
+    _type = static_cast<Type>(type);
+    _numbers.clear();
+    _string.clear();
+    switch (_type) {
+        case Type::Boolean:
+            _boolean = buffer.decode<uint8_t>() != 0;
+            break;
+        case Type::Number:
+            _numbers.push_back(buffer.decode<double>());
+            break;
+        case Type::String:
+            buffer.decode(_string);
+            break;
+        case Type::NumberTable: {
+            int32_t nNumbers = buffer.decode<int32_t>();
+            _numbers.resize(nNumbers);
+            for (int32_t i = 0; i < nNumbers; ++i)
+                _numbers[i] = buffer.decode<double>();
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace scripting
+} // namespace openspace
@@ -0,0 +1,262 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/scripting/scriptcache.h>
+
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/file.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/dictionary.h>
+
+#include <fstream>
+#include <functional>
+#include <iterator>
+
+namespace {
+    const std::string _loggerCat = "ScriptCache";
+
+    // Compiles the script and pushes the chunk onto the stack
+    void compileScript(lua_State* state, const std::string& script) {
+        // Same chunk name as luaL_loadstring so that error messages are unchanged
+        int status = luaL_loadbuffer(state, script.data(), script.size(), script.c_str());
+        if (status != 0) {
+            std::string error = lua_tostring(state, -1);
+            lua_pop(state, 1);
+            throw ghoul::lua::LuaLoadingException(error);
+        }
+    }
+
+    int writeChunk(lua_State*, const void* data, size_t size, void* buffer) {
+        std::string* bytecode = reinterpret_cast<std::string*>(buffer);
+        bytecode->append(reinterpret_cast<const char*>(data), size);
+        return 0;
+    }
+
+    // Dumps the chunk on top of the stack, including debug information so that errors
+    // raised from cached chunks still carry file names and line numbers
+    std::string dumpChunk(lua_State* state) {
+        std::string bytecode;
+#if LUA_VERSION_NUM >= 503
+        lua_dump(state, writeChunk, &bytecode, 0);
+#else
+        lua_dump(state, writeChunk, &bytecode);
+#endif
+        return bytecode;
+    }
+}
+
+namespace openspace {
+namespace scripting {
+
+ScriptCache::ScriptCache(size_t capacity)
+    : _state(nullptr)
+    , _capacity(capacity)
+    , _isEnabled(true)
+    , _nHits(0)
+    , _nMisses(0)
+{
+    ghoul_assert(_capacity > 0, "Capacity must be positive");
+}
+
+void ScriptCache::loadScript(lua_State* state, const std::string& script) {
+    ghoul_assert(state, "State must not be nullptr");
+    ghoul_assert(!_state || _state == state, "All scripts must use the same Lua state");
+
+    if (!_isEnabled) {
+        compileScript(state, script);
+        return;
+    }
+
+    auto it = _chunkIndex.find(script);
+    if (it != _chunkIndex.end()) {
+        ++_nHits;
+        _chunks.splice(_chunks.begin(), _chunks, it->second);
+        lua_rawgeti(state, LUA_REGISTRYINDEX, it->second->second);
+        return;
+    }
+
+    ++_nMisses;
+    compileScript(state, script);
+
+    // Keep a reference to the chunk in the registry and leave the chunk on the stack
+    lua_pushvalue(state, -1);
+    int reference = luaL_ref(state, LUA_REGISTRYINDEX);
+    _state = state;
+    _chunks.emplace_front(script, reference);
+    _chunkIndex[script] = _chunks.begin();
+
+    if (_chunks.size() > _capacity) {
+        const std::pair<std::string, int>& leastRecent = _chunks.back();
+        luaL_unref(_state, LUA_REGISTRYINDEX, leastRecent.second);
+        _chunkIndex.erase(leastRecent.first);
+        _chunks.pop_back();
+    }
+}
+
+void ScriptCache::clear() {
+    for (const std::pair<std::string, int>& chunk : _chunks)
+        luaL_unref(_state, LUA_REGISTRYINDEX, chunk.second);
+    _chunks.clear();
+    _chunkIndex.clear();
+    _state = nullptr;
+}
+
+void ScriptCache::setEnabled(bool enabled) {
+    if (!enabled)
+        clear();
+    _isEnabled = enabled;
+}
+
+bool ScriptCache::isEnabled() const {
+    return _isEnabled;
+}
+
+size_t ScriptCache::numberOfHits() const {
+    return _nHits;
+}
+
+size_t ScriptCache::numberOfMisses() const {
+    return _nMisses;
+}
+
+void loadFile(lua_State* state, const std::string& filename,
+              ghoul::filesystem::CacheManager::Persistent persistent)
+{
+    ghoul_assert(state, "State must not be nullptr");
+
+    const std::string file = absPath(filename);
+    if (!FileSys.fileExists(file))
+        throw ghoul::lua::LuaLoadingException("File did not exist", file);
+
+    // There is one entry per file, which is overwritten when the file is modified.
+    // Binary chunks are only valid for the Lua version that created them, so the
+    // version is stored in the entry together with the modification date
+    std::string cachedFile;
+    std::string header;
+    if (FileSys.cacheManager()) {
+        ghoul::filesystem::File f(file, ghoul::filesystem::File::RawPath::Yes);
+        header = f.lastModifiedDate() + ";" + LUA_RELEASE;
+
+        cachedFile = FileSys.cacheManager()->cachedFilename(
+            f.filename(),
+            std::to_string(std::hash<std::string>()(file)),
+            persistent
+        );
+    }
+
+    const std::string chunkName = "@" + file;
+    if (!cachedFile.empty() && FileSys.fileExists(cachedFile)) {
+        std::ifstream stream(cachedFile, std::ifstream::binary);
+        std::string cachedHeader;
+        std::getline(stream, cachedHeader);
+        std::string bytecode(
+            (std::istreambuf_iterator<char>(stream)),
+            std::istreambuf_iterator<char>()
+        );
+        stream.close();
+
+        // An outdated entry is overwritten below
+        if (cachedHeader == header) {
+            int status = luaL_loadbuffer(
+                state,
+                bytecode.data(),
+                bytecode.size(),
+                chunkName.c_str()
+            );
+            if (status == 0)
+                return;
+
+            LWARNING("Discarding cached bytecode for '" << file << "': " <<
+                lua_tostring(state, -1));
+            lua_pop(state, 1);
+        }
+        FileSys.deleteFile(cachedFile);
+    }
+
+    int status = luaL_loadfile(state, file.c_str());
+    if (status != 0) {
+        std::string error = lua_tostring(state, -1);
+        lua_pop(state, 1);
+        throw ghoul::lua::LuaLoadingException(error, file);
+    }
+
+    if (!cachedFile.empty()) {
+        std::string bytecode = dumpChunk(state);
+        std::ofstream stream(cachedFile, std::ofstream::binary);
+        if (stream.good()) {
+            stream << header << '\n';
+            stream.write(bytecode.data(), bytecode.size());
+        }
+        else {
+            LWARNING("Could not write cached bytecode to '" << cachedFile << "'");
+        }
+    }
+}
+
+void runScriptFile(lua_State* state, const std::string& filename) {
+    loadFile(state, filename);
+    if (lua_pcall(state, 0, 0, 0) != 0) {
+        std::string error = lua_tostring(state, -1);
+        lua_pop(state, 1);
+        throw ghoul::lua::LuaExecutionException(error, absPath(filename));
+    }
+}
+
+void loadDictionaryFromFile(const std::string& filename, ghoul::Dictionary& dictionary,
+                            lua_State* state,
+                            ghoul::filesystem::CacheManager::Persistent persistent)
+{
+    ghoul_assert(state, "State must not be nullptr");
+
+    const int top = lua_gettop(state);
+    loadFile(state, filename, persistent);
+    if (lua_pcall(state, 0, 1, 0) != 0) {
+        std::string error = lua_tostring(state, -1);
+        lua_settop(state, top);
+        throw ghoul::lua::LuaExecutionException(error, absPath(filename));
+    }
+
+    if (!lua_istable(state, -1)) {
+        lua_settop(state, top);
+        throw ghoul::lua::LuaFormatException(
+            "Script did not return a table",
+            absPath(filename)
+        );
+    }
+
+    try {
+        ghoul::lua::luaDictionaryFromState(state, dictionary);
+    }
+    catch (...) {
+        lua_settop(state, top);
+        throw;
+    }
+    lua_settop(state, top);
+}
+
+} // namespace scripting
+} // namespace openspace
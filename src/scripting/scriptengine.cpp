@@ -31,6 +31,8 @@
 #include <openspace/engine/configurationmanager.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/network/parallelconnection.h>
+#include <openspace/properties/property.h>
+#include <openspace/query/query.h>
 #include <openspace/util/syncbuffer.h>
 
 #include <fstream>
@@ -52,6 +54,20 @@ namespace {
     
     const int _setTableOffset = -3; // -1 (top) -1 (first argument) -1 (second argument)
 
+    // The maximum number of bytes of scripts that are synchronized in one frame. The
+    // SyncBuffer is shared with the time and the camera, so not all of it can be used
+    const size_t MaximumSyncedScriptBytes = 2048;
+
+    // Returns the URI of the property if the script only assigns a literal value to a
+    // single property, otherwise an empty string. The check is conservative; scripts
+    // that read values, use wildcards, or do anything else are never coalesced
+    std::string assignedPropertyUri(const std::string& script) {
+        PropertyAssignment assignment;
+        if (PropertyAssignment::fromScript(script, assignment))
+            return assignment.uri();
+        else
+            return "";
+    }
 }
 
 void ScriptEngine::initialize() {
@@ -67,6 +83,7 @@ void ScriptEngine::initialize() {
 
 void ScriptEngine::deinitialize() {
     if (_state) {
+        _scriptCache.clear();
         lua_close(_state);
         _state = nullptr;
     }
@@ -140,20 +157,27 @@ bool ScriptEngine::runScript(const std::string& script) {
         return false;
     }
 
+    // Simple property assignments do not need the interpreter
+    PropertyAssignment assignment;
+    if (PropertyAssignment::fromScript(script, assignment))
+        return runPropertyAssignment(assignment);
+
     if (_logScripts) {
         // Write command to log before it's executed
         writeLog(script);
     }
 
     try {
-        ghoul::lua::runScript(_state, script);
+        _scriptCache.loadScript(_state, script);
     }
     catch (const ghoul::lua::LuaLoadingException& e) {
         LERRORC(e.component, e.message);
         return false;
     }
-    catch (const ghoul::lua::LuaExecutionException& e) {
-        LERRORC(e.component, e.message);
+
+    if (lua_pcall(_state, 0, 0, 0) != 0) {
+        LERROR("Error executing script: " << lua_tostring(_state, -1));
+        lua_pop(_state, 1);
         return false;
     }
     
@@ -169,6 +193,38 @@ bool ScriptEngine::runScript(const std::string& script) {
     return true;
 }
     
+bool ScriptEngine::runPropertyAssignment(const PropertyAssignment& assignment) {
+    if (_logScripts)
+        writeLog(assignment.script());
+
+    properties::Property* prop = property(assignment.uri());
+    if (!prop) {
+        LERROR("Property with URI '" << assignment.uri() << "' was not found");
+        return false;
+    }
+
+    if (assignment.luaType() != prop->typeLua()) {
+        LERROR("Property '" << assignment.uri() <<
+            "' does not accept input of type '" <<
+            ghoul::lua::luaTypeToString(assignment.luaType()) << "'. Requested type: '" <<
+            ghoul::lua::luaTypeToString(prop->typeLua()) << "'");
+        return false;
+    }
+
+    // Properties read their values from the stack, which is cheap compared to running
+    // the setPropertyValueSingle script
+    assignment.pushValue(_state);
+    prop->setLuaValue(_state);
+    lua_pop(_state, 1);
+
+    //ensure properties are synced over parallel connection
+    std::string value;
+    prop->getStringValue(value);
+    OsEng.parallelConnection().scriptMessage(prop->fullyQualifiedIdentifier(), value);
+
+    return true;
+}
+
 bool ScriptEngine::runScriptFile(const std::string& filename) {
     if (filename.empty()) {
         LWARNING("Filename was empty");
@@ -180,7 +236,7 @@ bool ScriptEngine::runScriptFile(const std::string& filename) {
     }
     
     try {
-        ghoul::lua::runScriptFile(_state, filename);
+        scripting::runScriptFile(_state, filename);
     }
     catch (const ghoul::lua::LuaLoadingException& e) {
         LERRORC(e.component, e.message);
@@ -415,6 +471,20 @@ void ScriptEngine::addBaseLibrary() {
                 "string, string",
                 "Registers a new path token provided by the"
                 " first argument to the path provided in the second argument"
+            },
+            {
+                "setScriptCacheEnabled",
+                &luascriptfunctions::setScriptCacheEnabled,
+                "bool",
+                "Enables or disables the cache of compiled scripts, for example to "
+                "measure how much time is spent compiling scripts"
+            },
+            {
+                "printScriptCacheStatistics",
+                &luascriptfunctions::printScriptCacheStatistics,
+                "",
+                "Logs how many of the scripts were run from the cache of compiled "
+                "scripts"
             }
         }
     };
@@ -471,6 +541,10 @@ bool ScriptEngine::registerLuaLibrary(lua_State* state, const LuaLibrary& librar
     return true;
 }
 
+ScriptCache& ScriptEngine::scriptCache() {
+    return _scriptCache;
+}
+
 std::vector<std::string> ScriptEngine::allLuaFunctions() const {
     std::vector<std::string> result;
 
@@ -626,53 +700,130 @@ bool ScriptEngine::writeLog(const std::string& script) {
 
 
 void ScriptEngine::serialize(SyncBuffer* syncBuffer){
-    syncBuffer->encode(_currentSyncedScript);
-    _currentSyncedScript.clear();
+    syncBuffer->encode(static_cast<int32_t>(_currentSyncedScripts.size()));
+    for (const QueuedCommand& command : _currentSyncedScripts) {
+        syncBuffer->encode(static_cast<uint8_t>(command.type));
+        if (command.type == QueuedCommand::Type::Assignment)
+            command.assignment.serialize(*syncBuffer);
+        else
+            syncBuffer->encode(command.script);
+    }
+    _currentSyncedScripts.clear();
 }
 
 void ScriptEngine::deserialize(SyncBuffer* syncBuffer){
-    syncBuffer->decode(_currentSyncedScript);
+    int32_t nScripts = 0;
+    syncBuffer->decode(nScripts);
+
+    if (nScripts > 0) {
+        std::lock_guard<std::mutex> guard(_mutex);
+        for (int32_t i = 0; i < nScripts; ++i) {
+            QueuedCommand command;
+            command.type = static_cast<QueuedCommand::Type>(
+                syncBuffer->decode<uint8_t>()
+            );
+            bool isValid = true;
+            switch (command.type) {
+                case QueuedCommand::Type::Script: {
+                    SyncBuffer::StringView script = syncBuffer->decodeView();
+                    command.script.assign(script.data, script.size);
+                    break;
+                }
+                case QueuedCommand::Type::Assignment:
+                    isValid = command.assignment.deserialize(*syncBuffer);
+                    break;
+                default:
+                    isValid = false;
+            }
 
-    if (!_currentSyncedScript.empty()){
-        _mutex.lock();
-        _receivedScripts.push_back(_currentSyncedScript);
-        _mutex.unlock();
+            // The remaining commands can not be found in the buffer
+            if (!isValid) {
+                LERROR("Received a command of unknown type, discarding " <<
+                    nScripts - i << " commands");
+                break;
+            }
+            _receivedScripts.push_back(std::move(command));
+        }
     }
 }
 
 void ScriptEngine::postSynchronizationPreDraw() {
-    std::vector<std::string> scripts;
+    std::vector<QueuedCommand> commands;
 
     _mutex.lock();
-    scripts.assign(_receivedScripts.begin(), _receivedScripts.end());
-    _receivedScripts.clear();
+    commands.swap(_receivedScripts);
     _mutex.unlock();
     
-    while (!scripts.empty()) {
+    for (const QueuedCommand& command : commands) {
         try {
-            runScript(scripts.back());
+            if (command.type == QueuedCommand::Type::Assignment)
+                runPropertyAssignment(command.assignment);
+            else
+                runScript(command.script);
         }
         catch (const ghoul::RuntimeError& e) {
             LERRORC(e.component, e.message);
         }
-        scripts.pop_back();
     }
-    
 }
 
 void ScriptEngine::preSynchronization() {
-    
-    _mutex.lock();
-    
-    if (!_queuedScripts.empty()){
-        _currentSyncedScript = _queuedScripts.back();
-        _queuedScripts.pop_back();
-        
-        //Not really a received script but the master also needs to run the script...
-        _receivedScripts.push_back(_currentSyncedScript);
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    if (_queuedScripts.empty())
+        return;
+
+    // At least one script is always sent so that an oversized script cannot block the
+    // queue
+    size_t nBytes = 0;
+    while (!_queuedScripts.empty()) {
+        const QueuedCommand& command = _queuedScripts.front();
+        size_t size = sizeof(uint8_t) +
+            (command.type == QueuedCommand::Type::Assignment ?
+            command.assignment.serializedSize() :
+            command.script.size() + sizeof(int32_t));
+        if (!_currentSyncedScripts.empty() && nBytes + size > MaximumSyncedScriptBytes)
+            break;
+
+        nBytes += size;
+        _currentSyncedScripts.push_back(std::move(_queuedScripts.front()));
+        _queuedScripts.pop_front();
+    }
+
+    // Of consecutive assignments of literal values to a property, only the last one has
+    // an effect, so the earlier ones are dropped. Any other script might read the
+    // property, so assignments are never dropped across it
+    if (_currentSyncedScripts.size() > 1) {
+        std::set<std::string> assignedProperties;
+        std::vector<bool> isOverwritten(_currentSyncedScripts.size(), false);
+        for (size_t i = _currentSyncedScripts.size(); i-- > 0;) {
+            const QueuedCommand& command = _currentSyncedScripts[i];
+            std::string uri = command.type == QueuedCommand::Type::Assignment ?
+                command.assignment.uri() :
+                assignedPropertyUri(command.script);
+            if (uri.empty())
+                assignedProperties.clear();
+            else
+                isOverwritten[i] = !assignedProperties.insert(uri).second;
+        }
+
+        size_t nKept = 0;
+        for (size_t i = 0; i < _currentSyncedScripts.size(); ++i) {
+            if (!isOverwritten[i]) {
+                if (nKept != i)
+                    _currentSyncedScripts[nKept] = std::move(_currentSyncedScripts[i]);
+                ++nKept;
+            }
+        }
+        _currentSyncedScripts.resize(nKept);
     }
-    
-    _mutex.unlock();
+
+    //Not really a received script but the master also needs to run the script...
+    _receivedScripts.insert(
+        _receivedScripts.end(),
+        _currentSyncedScripts.begin(),
+        _currentSyncedScripts.end()
+    );
 }
 
 void ScriptEngine::queueScript(const std::string &script){
@@ -681,10 +832,19 @@ void ScriptEngine::queueScript(const std::string &script){
     
     _mutex.lock();
 
-    _queuedScripts.insert(_queuedScripts.begin(), script);
+    _queuedScripts.push_back(
+        { QueuedCommand::Type::Script, script, PropertyAssignment() }
+    );
 
     _mutex.unlock();
 }
 
+void ScriptEngine::queuePropertyAssignment(PropertyAssignment assignment) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _queuedScripts.push_back(
+        { QueuedCommand::Type::Assignment, std::string(), std::move(assignment) }
+    );
+}
+
 } // namespace scripting
 } // namespace openspace
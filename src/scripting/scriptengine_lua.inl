@@ -152,6 +152,42 @@ namespace luascriptfunctions {
         return 0;
     }
 
+    /**
+     * \ingroup LuaScripts
+     * setScriptCacheEnabled(bool):
+     * Enables or disables the cache of compiled scripts that are run by the ScriptEngine
+     */
+    int setScriptCacheEnabled(lua_State* L) {
+        int nArguments = lua_gettop(L);
+        if (nArguments != 1)
+            return luaL_error(L, "Expected %i arguments, got %i", 1, nArguments);
+
+        bool enabled = lua_toboolean(L, -1) != 0;
+        OsEng.scriptEngine().scriptCache().setEnabled(enabled);
+        return 0;
+    }
+
+    /**
+     * \ingroup LuaScripts
+     * printScriptCacheStatistics():
+     * Logs how many scripts were run from the cache of compiled scripts
+     */
+    int printScriptCacheStatistics(lua_State* L) {
+        const std::string _loggerCat = "ScriptCache";
+
+        int nArguments = lua_gettop(L);
+        if (nArguments != 0)
+            return luaL_error(L, "Expected %i arguments, got %i", 0, nArguments);
+
+        const scripting::ScriptCache& cache = OsEng.scriptEngine().scriptCache();
+        LINFO(
+            "Enabled: " << (cache.isEnabled() ? "yes" : "no") <<
+            ", Hits: " << cache.numberOfHits() <<
+            ", Misses: " << cache.numberOfMisses()
+        );
+        return 0;
+    }
+
 } // namespace luascriptfunctions
 
 } // namespace openspace
@@ -169,7 +169,8 @@ namespace openspace {
 
         _rotation.serialize(syncBuffer);
         _position.serialize(syncBuffer);
-        _scaling.serialize(syncBuffer);
+        // The scaling rarely changes
+        syncBuffer->encodeDelta(_scaling.shared);
     }
 
     void Camera::deserialize(SyncBuffer* syncBuffer) {
@@ -177,7 +178,7 @@ namespace openspace {
 
         _rotation.deserialize(syncBuffer);
         _position.deserialize(syncBuffer);
-        _scaling.deserialize(syncBuffer);
+        syncBuffer->decodeDelta(_scaling.shared);
     }
 
     void Camera::postSynchronizationPreDraw() {
@@ -289,6 +289,14 @@ void SpiceManager::unloadKernel(std::string filePath) {
     }
 }
 
+std::vector<string> SpiceManager::loadedKernels() const {
+    std::vector<string> paths;
+    paths.reserve(_loadedKernels.size());
+    for (const KernelInformation& info : _loadedKernels)
+        paths.push_back(info.path);
+    return paths;
+}
+
 bool SpiceManager::hasSpkCoverage(const string& target, double et) const {
     ghoul_assert(!target.empty(), "Empty target");
     
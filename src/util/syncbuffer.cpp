@@ -22,19 +22,37 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+
 #include <openspace/util/syncbuffer.h>
 
+#include <ghoul/misc/assert.h>
+
 #include <sgct.h>
 
+namespace {
+    // Every frame starts with its number as uint32_t and whether it is a keyframe
+    const size_t FrameHeaderSize = sizeof(uint32_t) + sizeof(uint8_t);
+
+    // The number of frames after which all delta-encoded values are sent in full
+    const uint32_t KeyframeInterval = 60;
+}
+
 namespace openspace {
 
 SyncBuffer::SyncBuffer(size_t n)
     : _n(n)
-    , _encodeOffset(0)
-    , _decodeOffset(0)
+    , _decodeOffset(FrameHeaderSize)
     , _synchronizationBuffer(new sgct::SharedVector<char>())
+    , _deltaIndex(0)
+    , _nUnchangedValues(0)
+    , _frameNumber(0)
+    , _isKeyframe(true)
+    , _isKeyframeRequested(false)
+    , _receivedFrameNumber(0)
+    , _hasReceivedFrame(false)
 {
-    _dataStream.resize(_n);
+    _dataStream.reserve(_n);
+    _dataStream.resize(FrameHeaderSize);
 }
 
 SyncBuffer::~SyncBuffer() {
@@ -44,17 +62,122 @@ SyncBuffer::~SyncBuffer() {
 }
 
 void SyncBuffer::write() {
+    // Only the bytes that were encoded this frame are sent
+    finishFrame();
     _synchronizationBuffer->setVal(_dataStream);
     sgct::SharedData::instance()->writeVector(_synchronizationBuffer.get());
-    _encodeOffset = 0;
-    _decodeOffset = 0;
+    startFrame();
 }
 
 void SyncBuffer::read() {
     sgct::SharedData::instance()->readVector(_synchronizationBuffer.get());
-    _dataStream = std::move(_synchronizationBuffer->getVal());
-    _encodeOffset = 0;
+    readFrame(std::move(_synchronizationBuffer->getVal()));
+}
+
+std::vector<char> SyncBuffer::writeFrame() {
+    finishFrame();
+    std::vector<char> frame = _dataStream;
+    startFrame();
+    return frame;
+}
+
+void SyncBuffer::readFrame(std::vector<char> frame) {
+    _decodeStart = Clock::now();
+    _dataStream = std::move(frame);
+    _deltaIndex = 0;
+
+    _statistics.bytesPerFrame = _dataStream.size();
+    _statistics.unchangedValues = 0;
+    _statistics.missingValues = 0;
+
+    if (_dataStream.size() < FrameHeaderSize) {
+        // Nothing was sent yet, so nothing can be decoded either
+        _decodeOffset = _dataStream.size();
+        _hasReceivedFrame = false;
+        for (std::vector<char>& value : _deltaValues)
+            value.clear();
+        return;
+    }
+
     _decodeOffset = 0;
+    const uint32_t frameNumber = decode<uint32_t>();
+    const bool isKeyframe = decode<uint8_t>() != 0;
+
+    // Delta-encoded values refer to the previous frame, so after a missed frame their
+    // previous values are forgotten until the next keyframe sends them in full
+    if (!isKeyframe && _hasReceivedFrame && frameNumber != _receivedFrameNumber + 1) {
+        for (std::vector<char>& value : _deltaValues)
+            value.clear();
+    }
+    _receivedFrameNumber = frameNumber;
+    _hasReceivedFrame = true;
+}
+
+void SyncBuffer::requestKeyframe() {
+    // A frame that already contains encoded values can only become a keyframe next time
+    if (_dataStream.size() == FrameHeaderSize)
+        _isKeyframe = true;
+    else
+        _isKeyframeRequested = true;
+}
+
+const SyncBuffer::Statistics& SyncBuffer::statistics() const {
+    return _statistics;
+}
+
+void SyncBuffer::finishFrame() {
+    const uint8_t isKeyframe = _isKeyframe ? 1 : 0;
+    memcpy(_dataStream.data(), &_frameNumber, sizeof(uint32_t));
+    memcpy(_dataStream.data() + sizeof(uint32_t), &isKeyframe, sizeof(uint8_t));
+
+    _statistics.bytesPerFrame = _dataStream.size();
+    _statistics.unchangedValues = _nUnchangedValues;
+    _statistics.encodeTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        Clock::now() - _encodeStart
+    );
+}
+
+void SyncBuffer::startFrame() {
+    // Keeps the capacity, so that encoding does not allocate
+    _dataStream.resize(FrameHeaderSize);
+    _decodeOffset = FrameHeaderSize;
+    _deltaIndex = 0;
+    _nUnchangedValues = 0;
+
+    ++_frameNumber;
+    _isKeyframe = _isKeyframeRequested || (_frameNumber % KeyframeInterval == 0);
+    _isKeyframeRequested = false;
+}
+
+char* SyncBuffer::reserve(size_t size) {
+    const size_t offset = _dataStream.size();
+    ghoul_assert(offset + size <= _n, "SyncBuffer is full");
+
+    if (offset == FrameHeaderSize)
+        _encodeStart = Clock::now();
+
+    _dataStream.resize(offset + size);
+    return _dataStream.data() + offset;
+}
+
+const char* SyncBuffer::consume(size_t size) {
+    ghoul_assert(_decodeOffset + size <= _dataStream.size(), "Read past the end of the frame");
+
+    const char* data = _dataStream.data() + _decodeOffset;
+    _decodeOffset += size;
+
+    if (_decodeOffset == _dataStream.size()) {
+        _statistics.decodeTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - _decodeStart
+        );
+    }
+    return data;
+}
+
+std::vector<char>& SyncBuffer::deltaValue() {
+    if (_deltaIndex == _deltaValues.size())
+        _deltaValues.emplace_back();
+    return _deltaValues[_deltaIndex++];
 }
 
 } // namespace openspace
@@ -183,9 +183,10 @@ std::string Time::ISO8601() const {
 void Time::serialize(SyncBuffer* syncBuffer) {
     _syncMutex.lock();
 
-    syncBuffer->encode(_sharedTime);
-    syncBuffer->encode(_sharedDt);
-    syncBuffer->encode(_sharedTimeJumped);
+    // The time does not change while it is paused
+    syncBuffer->encodeDelta(_sharedTime);
+    syncBuffer->encodeDelta(_sharedDt);
+    syncBuffer->encodeDelta(_sharedTimeJumped);
 
     _syncMutex.unlock();
 }
@@ -193,9 +194,9 @@ void Time::serialize(SyncBuffer* syncBuffer) {
 void Time::deserialize(SyncBuffer* syncBuffer) {
     _syncMutex.lock();
 
-    syncBuffer->decode(_sharedTime);
-    syncBuffer->decode(_sharedDt);
-    syncBuffer->decode(_sharedTimeJumped);
+    syncBuffer->decodeDelta(_sharedTime);
+    syncBuffer->decodeDelta(_sharedDt);
+    syncBuffer->decodeDelta(_sharedTimeJumped);
 
     if (_sharedTimeJumped)
         _jockeHasToFixThisLater = true;
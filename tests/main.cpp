@@ -32,8 +32,25 @@
 
 // test files
 #include <test_common.inl>
+
 #include <test_spicemanager.inl>
+#include <test_powerscalecoordinates.inl>
+
 #include <test_scenegraphloader.inl>
+#include <test_sceneinitializer.inl>
+
+#include <test_luaconversions.inl>
+#include <test_scriptcache.inl>
+
+#include <test_propertyassignment.inl>
+#include <test_propertyregistry.inl>
+
+#include <test_syncbuffer.inl>
+#include <test_keyframebuffer.inl>
+#include <test_messagestructures.inl>
+#include <test_messagetransport.inl>
+#include <test_messagequeue.inl>
+#include <test_messagepacing.inl>
 
 #ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
 //#include <test_chunknode.inl>
@@ -49,10 +66,26 @@
 
 #include <test_concurrentqueue.inl>
 #include <test_concurrentjobmanager.inl>
+
+#include <test_chunkculling.inl>
+#include <test_chunklevelevaluator.inl>
+#include <test_chunktree.inl>
+#include <test_chunkdrawbatch.inl>
+
+#include <test_tiledataset.inl>
+#include <test_heighttilecache.inl>
+#include <test_tileuploadscheduler.inl>
 #endif
 
-#include <test_luaconversions.inl>
-#include <test_powerscalecoordinates.inl>
+#ifdef OPENSPACE_MODULE_NEWHORIZONS_ENABLED
+#include <test_imagesequencer.inl>
+#include <test_projectioncomponent.inl>
+#include <test_sequenceparser.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_VOLUME_ENABLED
+#include <test_volumeresampler.inl>
+#endif
 
 #ifdef OPENSPACE_MODULE_ISWA_ENABLED
 #include <test_screenspaceimage.inl>
@@ -0,0 +1,172 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/scene/scenegraphnode.h>
+#include <openspace/util/camera.h>
+#include <modules/globebrowsing/chunk/chunk.h>
+#include <modules/globebrowsing/chunk/culling.h>
+#include <modules/globebrowsing/geometry/ellipsoid.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+using namespace openspace;
+
+class ChunkCullingTest : public testing::Test {
+protected:
+    struct ChunkBounds {
+        GeodeticPatch patch;
+        std::array<glm::dvec4, 8> corners;
+        Scalar maxHeight;
+    };
+
+    // All chunks of one level with height bounds that vary over the globe
+    std::vector<ChunkBounds> createChunks(const Ellipsoid& ellipsoid, int level) {
+        std::vector<ChunkBounds> chunks;
+        int nX = 1 << level;
+        int nY = 1 << (level - 1);
+        for (int y = 0; y < nY; ++y) {
+            for (int x = 0; x < nX; ++x) {
+                GeodeticPatch patch(ChunkIndex(x, y, level));
+                Chunk::BoundingHeights heights;
+                heights.min = -1000.f * ((x + y) % 3);
+                heights.max = 2000.f * ((x * y) % 5);
+                heights.available = true;
+                chunks.push_back({
+                    patch,
+                    Chunk::computeBoundingPolyhedronCorners(ellipsoid, patch, heights),
+                    heights.max
+                });
+            }
+        }
+        return chunks;
+    }
+
+    // Scripted camera path: a descending orbit around the globe that looks at its center
+    // for the first half and along the orbit for the second half
+    void placeCamera(Camera& camera, int frame, int nFrames, Scalar radius) {
+        double t = static_cast<double>(frame) / nFrames;
+        double angle = 2.0 * M_PI * t;
+        double altitude = radius * (3.0 - 2.9 * t);
+
+        glm::dvec3 position = (radius + altitude) *
+            glm::normalize(glm::dvec3(cos(angle), sin(angle), 0.4 * sin(3.0 * angle)));
+        glm::dvec3 target = t < 0.5 ?
+            glm::dvec3(0.0) :
+            position + glm::dvec3(-sin(angle), cos(angle), 0.0);
+
+        glm::dmat4 lookAtMat = glm::lookAt(position, target, glm::dvec3(0.0, 0.0, 1.0));
+        camera.setPositionVec3(position);
+        camera.setRotation(glm::normalize(glm::quat_cast(glm::inverse(lookAtMat))));
+        camera.preSynchronization();
+        camera.postSynchronizationPreDraw();
+    }
+
+    const AABB3 ViewFrustum = AABB3(vec3(-1, -1, 0), vec3(1, 1, 1e35));
+};
+
+TEST_F(ChunkCullingTest, ScriptedCameraBenchmark) {
+    const Ellipsoid ellipsoid(6378137.0, 6378137.0, 6356752.3);
+    const std::vector<ChunkBounds> chunks = createChunks(ellipsoid, 6);
+    const int nFrames = 200;
+
+    Camera camera;
+    camera.sgctInternal.setViewMatrix(glm::mat4(1.f));
+    camera.sgctInternal.setProjectionMatrix(
+        glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 1e10f));
+
+    Vec3 globePosition(0.0);
+    Scalar minimumRadius = ellipsoid.minimumRadius();
+
+    HorizonCuller horizonCuller;
+    FrustumCuller frustumCuller(ViewFrustum);
+    BatchedChunkCuller batchedCuller(ViewFrustum);
+
+    std::chrono::duration<double, std::micro> perChunkTime(0);
+    std::chrono::duration<double, std::micro> batchedTime(0);
+    int nCulled = 0;
+    int nMismatches = 0;
+
+    for (int frame = 0; frame < nFrames; ++frame) {
+        placeCamera(camera, frame, nFrames, ellipsoid.maximumRadius());
+
+        Vec3 cameraPosition = camera.positionVec3();
+        dmat4 modelTransform = translate(dmat4(1), globePosition);
+        dmat4 modelViewProjectionTransform = dmat4(camera.projectionMatrix())
+            * dmat4(camera.combinedViewMatrix()) * modelTransform;
+
+        std::vector<Vec3> surfacePositions(chunks.size());
+        Geodetic2 cameraOnGlobe = ellipsoid.cartesianToGeodetic2(cameraPosition - globePosition);
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            surfacePositions[i] = ellipsoid.cartesianSurfacePosition(
+                chunks[i].patch.closestPoint(cameraOnGlobe));
+        }
+
+        // Reference: the chunk by chunk cullers
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<bool> expected(chunks.size());
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            expected[i] = horizonCuller.isCullable(cameraPosition, globePosition,
+                    surfacePositions[i], chunks[i].maxHeight, minimumRadius) ||
+                frustumCuller.isCullable(chunks[i].corners, modelViewProjectionTransform);
+        }
+        perChunkTime += std::chrono::high_resolution_clock::now() - start;
+
+        start = std::chrono::high_resolution_clock::now();
+        batchedCuller.clear();
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            batchedCuller.add(chunks[i].corners, surfacePositions[i], chunks[i].maxHeight);
+        }
+        batchedCuller.cull(modelViewProjectionTransform, cameraPosition, globePosition,
+            minimumRadius, true, true);
+        batchedTime += std::chrono::high_resolution_clock::now() - start;
+
+        ASSERT_EQ(chunks.size(), batchedCuller.size());
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            if (batchedCuller.isCullable(i) != expected[i]) {
+                ++nMismatches;
+            }
+            nCulled += expected[i] ? 1 : 0;
+        }
+    }
+
+    EXPECT_EQ(0, nMismatches) << "Batched culling must agree with the chunk cullers";
+    EXPECT_GT(nCulled, 0) << "The camera path should cull some chunks";
+    EXPECT_LT(nCulled, nFrames * static_cast<int>(chunks.size())) <<
+        "The camera path should not cull all chunks";
+
+    RecordProperty("ChunksPerFrame", static_cast<int>(chunks.size()));
+    RecordProperty("PerChunkMicrosecondsPerFrame",
+        static_cast<int>(perChunkTime.count() / nFrames));
+    RecordProperty("BatchedMicrosecondsPerFrame",
+        static_cast<int>(batchedTime.count() / nFrames));
+}
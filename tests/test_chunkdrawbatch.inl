@@ -0,0 +1,160 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/chunk/chunkdrawbatch.h>
+#include <modules/globebrowsing/chunk/chunkindex.h>
+#include <modules/globebrowsing/geometry/ellipsoid.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <vector>
+
+using namespace openspace;
+
+class ChunkDrawBatchTest : public testing::Test {
+protected:
+    // n x n chunks of one level around the point (lat, lon) = (0, 0)
+    std::vector<ChunkIndex> createChunks(int level, int n) {
+        std::vector<ChunkIndex> chunks;
+        int centerX = 1 << (level - 1);
+        int centerY = 1 << (level - 2);
+        for (int y = centerY - n / 2; y < centerY + n / 2; ++y) {
+            for (int x = centerX - n / 2; x < centerX + n / 2; ++x) {
+                chunks.push_back(ChunkIndex(x, y, level));
+            }
+        }
+        return chunks;
+    }
+
+    // How the chunk renderer computed the corners of a locally rendered chunk for
+    // every chunk before the draw data was batched
+    std::array<vec3, 4> referenceCorners(const ChunkIndex& chunkIndex,
+        const Ellipsoid& ellipsoid, const dmat4& modelViewTransform)
+    {
+        GeodeticPatch patch(chunkIndex);
+        std::array<vec3, 4> corners;
+        const Quad quads[4] = {
+            Quad::SOUTH_WEST, Quad::SOUTH_EAST, Quad::NORTH_WEST, Quad::NORTH_EAST
+        };
+        for (int i = 0; i < 4; ++i) {
+            Vec3 cornerModelSpace = ellipsoid.cartesianSurfacePosition(patch.getCorner(quads[i]));
+            corners[i] = vec3(Vec3(modelViewTransform * dvec4(cornerModelSpace, 1)));
+        }
+        return corners;
+    }
+};
+
+TEST_F(ChunkDrawBatchTest, ChunksAreGroupedByVariant) {
+    const Ellipsoid ellipsoid(6378137.0, 6378137.0, 6356752.3);
+    ChunkDrawBatch batch;
+    batch.clear(dmat4(1.0), 2);
+
+    std::vector<ChunkIndex> chunks = {
+        ChunkIndex(5, 3, 4), ChunkIndex(600, 200, 10), ChunkIndex(6, 3, 4)
+    };
+    ghoul::opengl::Texture* textures[2] = {
+        reinterpret_cast<ghoul::opengl::Texture*>(0x10),
+        reinterpret_cast<ghoul::opengl::Texture*>(0x20)
+    };
+    for (const ChunkIndex& chunkIndex : chunks) {
+        batch.addChunk(GeodeticPatch(chunkIndex), chunkIndex.level, ellipsoid);
+        for (int t = 0; t < 2; ++t) {
+            batch.addTile(textures[t], vec2(chunkIndex.x, t), vec2(1.f));
+        }
+    }
+
+    ASSERT_EQ(3u, batch.size());
+    const auto& global = batch.chunksOfVariant(ChunkDrawBatch::Variant::Global);
+    const auto& local = batch.chunksOfVariant(ChunkDrawBatch::Variant::Local);
+    ASSERT_EQ(2u, global.size());
+    ASSERT_EQ(1u, local.size());
+    EXPECT_EQ(0u, global[0]);
+    EXPECT_EQ(2u, global[1]);
+    EXPECT_EQ(1u, local[0]);
+
+    // The tiles stay with their chunk
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        for (size_t t = 0; t < 2; ++t) {
+            EXPECT_EQ(textures[t], batch.tile(i, t).texture);
+            EXPECT_EQ(vec2(chunks[i].x, t), batch.tile(i, t).uvOffset);
+        }
+    }
+
+    batch.clear(dmat4(1.0), 0);
+    EXPECT_EQ(0u, batch.size());
+    EXPECT_TRUE(batch.chunksOfVariant(ChunkDrawBatch::Variant::Global).empty());
+}
+
+TEST_F(ChunkDrawBatchTest, PackingBenchmark) {
+    const Ellipsoid ellipsoid(6378137.0, 6378137.0, 6356752.3);
+    const int nFrames = 100;
+    const size_t tilesPerChunk = 6;
+
+    std::vector<ChunkIndex> chunks = createChunks(6, 16);
+    std::vector<ChunkIndex> localChunks = createChunks(12, 20);
+    chunks.insert(chunks.end(), localChunks.begin(), localChunks.end());
+
+    ChunkDrawBatch batch;
+    std::chrono::duration<double, std::micro> packingTime(0);
+    int nMismatches = 0;
+
+    for (int frame = 0; frame < nFrames; ++frame) {
+        dvec3 cameraPosition = dvec3(ellipsoid.maximumRadius() * (1.5 - 0.004 * frame), 0, 0);
+        dmat4 viewTransform = glm::lookAt(cameraPosition, dvec3(0.0), dvec3(0, 0, 1));
+
+        auto start = std::chrono::high_resolution_clock::now();
+        batch.clear(viewTransform, tilesPerChunk);
+        for (const ChunkIndex& chunkIndex : chunks) {
+            batch.addChunk(GeodeticPatch(chunkIndex), chunkIndex.level, ellipsoid);
+            for (size_t t = 0; t < tilesPerChunk; ++t) {
+                batch.addTile(nullptr, vec2(0.f), vec2(1.f));
+            }
+        }
+        packingTime += std::chrono::high_resolution_clock::now() - start;
+
+        ASSERT_EQ(chunks.size(), batch.size());
+        for (size_t i : batch.chunksOfVariant(ChunkDrawBatch::Variant::Local)) {
+            std::array<vec3, 4> expected =
+                referenceCorners(chunks[i], ellipsoid, viewTransform);
+            for (int c = 0; c < 4; ++c) {
+                if (glm::distance(expected[c], batch.chunk(i).corners[c]) > 1e-3f) {
+                    ++nMismatches;
+                }
+            }
+        }
+    }
+
+    EXPECT_EQ(0, nMismatches) << "Packed corners must match the per chunk computation";
+    EXPECT_EQ(localChunks.size(),
+        batch.chunksOfVariant(ChunkDrawBatch::Variant::Local).size());
+
+    RecordProperty("ChunksPerFrame", static_cast<int>(chunks.size()));
+    RecordProperty("PackingMicrosecondsPerFrame",
+        static_cast<int>(packingTime.count() / nFrames));
+}
@@ -0,0 +1,262 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/chunk/chunkindex.h>
+#include <modules/globebrowsing/chunk/chunklevelevaluator.h>
+#include <modules/globebrowsing/geometry/ellipsoid.h>
+#include <modules/globebrowsing/geometry/geodetic2.h>
+#include <modules/globebrowsing/tile/tiledataset.h>
+
+#include "gdal_priv.h"
+#include "cpl_conv.h"
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+using namespace openspace;
+
+// Compares the chunks and tile reads of the chunk level evaluators along a camera path
+// over a globe that is flat in the western hemisphere and rough in the eastern
+class ChunkLevelEvaluatorTest : public testing::Test {
+protected:
+    struct ChunkData {
+        float minHeight;
+        float maxHeight;
+        float geometricError;
+    };
+
+    struct Result {
+        // Sum of the rendered chunks over all camera positions
+        size_t numChunks = 0;
+        size_t numFlatChunks = 0;
+        // Distinct rendered chunks, each of which needs its tiles to be read once
+        size_t numTileReads = 0;
+    };
+
+    typedef std::function<int(const ChunkIndex&, const Vec3&)> LevelFunction;
+
+    ChunkLevelEvaluatorTest()
+        : _ellipsoid(Radius, Radius, Radius)
+    { }
+
+    void SetUp() override {
+        GDALAllRegister();
+        _filename = std::string(CPLGenerateTempFilename("chunklevelevaluatortest")) + ".tif";
+
+        GDALDriver* driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+        ASSERT_NE(driver, nullptr) << "GTiff driver is not available";
+        char** options = nullptr;
+        options = CSLSetNameValue(options, "TILED", "YES");
+        GDALDataset* dataset = driver->Create(
+            _filename.c_str(), Width, Height, 1, GDT_Byte, options
+        );
+        CSLDestroy(options);
+        ASSERT_NE(dataset, nullptr) << "Failed to create " << _filename;
+
+        double geoTransform[6] = { -180.0, 360.0 / Width, 0.0, 90.0, 0.0, -180.0 / Height };
+        dataset->SetGeoTransform(geoTransform);
+
+        // Heights in meters; sea level in the west and rough terrain in the east
+        std::vector<GByte> data(Width * Height, 0);
+        for (int y = 0; y < Height; ++y) {
+            for (int x = Width / 2; x < Width; ++x) {
+                data[y * Width + x] = static_cast<GByte>((x ^ y) + (x * y >> 7));
+            }
+        }
+        CPLErr err = dataset->GetRasterBand(1)->RasterIO(GF_Write, 0, 0, Width, Height,
+            data.data(), Width, Height, GDT_Byte, 0, 0);
+        ASSERT_EQ(CE_None, err);
+
+        int overviews[] = { 2, 4, 8, 16, 32 };
+        err = dataset->BuildOverviews("AVERAGE", 5, overviews, 0, nullptr, nullptr,
+            nullptr);
+        ASSERT_EQ(CE_None, err);
+        GDALClose(dataset);
+
+        // The preprocessed data of every tile, as it is stored when the tile is loaded
+        TileDataset tileDataset(_filename, MinimumPixelSize, true);
+        _maximumLevel = tileDataset.getMaximumLevel();
+        for (int level = 1; level <= _maximumLevel; ++level) {
+            for (int y = 0; y < (1 << (level - 1)); ++y) {
+                for (int x = 0; x < (1 << level); ++x) {
+                    ChunkIndex chunkIndex(x, y, level);
+                    std::shared_ptr<TileIOResult> tile =
+                        tileDataset.readTileData(chunkIndex);
+                    ASSERT_NE(nullptr, tile->preprocessData);
+                    _chunkData[chunkIndex.hashKey()] = {
+                        tile->preprocessData->minValues[0],
+                        tile->preprocessData->maxValues[0],
+                        tile->preprocessData->geometricErrors[0]
+                    };
+                    delete[] static_cast<char*>(tile->imageData);
+                }
+            }
+        }
+    }
+
+    void TearDown() override {
+        std::remove(_filename.c_str());
+    }
+
+    // A descent from orbit to the boundary between the hemispheres, followed by a
+    // low flight from the flat to the rough hemisphere
+    std::vector<Vec3> cameraPath() const {
+        std::vector<Vec3> path;
+        for (int i = 0; i < 10; ++i) {
+            Scalar altitude = 1e7 * std::pow(0.5, i);
+            path.push_back(_ellipsoid.cartesianPosition({ { 0.3, 0.0 }, altitude }));
+        }
+        for (int i = 0; i <= 10; ++i) {
+            Scalar longitude = -0.5 + 0.1 * i;
+            path.push_back(_ellipsoid.cartesianPosition({ { 0.3, longitude }, 2e4 }));
+        }
+        return path;
+    }
+
+    // Splits chunks as long as they want to be split, like the chunk tree does for a
+    // camera that stands still
+    void selectChunks(const ChunkIndex& chunkIndex, const Vec3& cameraPosition,
+        const LevelFunction& desiredLevel, std::vector<ChunkIndex>& chunks) const
+    {
+        if (chunkIndex.level < _maximumLevel &&
+            desiredLevel(chunkIndex, cameraPosition) > chunkIndex.level)
+        {
+            for (int q = 0; q < 4; ++q) {
+                selectChunks(chunkIndex.child(static_cast<Quad>(q)), cameraPosition,
+                    desiredLevel, chunks);
+            }
+        }
+        else {
+            chunks.push_back(chunkIndex);
+        }
+    }
+
+    Result runCameraPath(const LevelFunction& desiredLevel) const {
+        Result result;
+        std::set<HashKey> readTiles;
+        for (const Vec3& cameraPosition : cameraPath()) {
+            std::vector<ChunkIndex> chunks;
+            selectChunks(ChunkIndex(0, 0, 1), cameraPosition, desiredLevel, chunks);
+            selectChunks(ChunkIndex(1, 0, 1), cameraPosition, desiredLevel, chunks);
+            for (const ChunkIndex& chunkIndex : chunks) {
+                readTiles.insert(chunkIndex.hashKey());
+                if (GeodeticPatch(chunkIndex).center().lon < 0.0) {
+                    result.numFlatChunks++;
+                }
+            }
+            result.numChunks += chunks.size();
+        }
+        result.numTileReads = readTiles.size();
+        return result;
+    }
+
+    int levelByDistance(const ChunkIndex& chunkIndex, const Vec3& cameraPosition) const {
+        return EvaluateChunkLevelByDistance::desiredLevel(_ellipsoid, chunkIndex,
+            boundingHeights(chunkIndex), cameraPosition, LodScaleFactor);
+    }
+
+    int levelByProjectedArea(const ChunkIndex& chunkIndex, const Vec3& cameraPosition) const {
+        return EvaluateChunkLevelByProjectedArea::desiredLevel(_ellipsoid, chunkIndex,
+            boundingHeights(chunkIndex), cameraPosition, LodScaleFactor);
+    }
+
+    int levelByScreenSpaceError(const ChunkIndex& chunkIndex,
+        const Vec3& cameraPosition) const
+    {
+        return EvaluateChunkLevelByScreenSpaceError::desiredLevel(_ellipsoid, chunkIndex,
+            boundingHeights(chunkIndex), _chunkData.at(chunkIndex.hashKey()).geometricError,
+            cameraPosition, SegmentsPerPatch, ProjectionScale, Threshold);
+    }
+
+    // The bounding heights a chunk gets from its preprocessed height tile
+    Chunk::BoundingHeights boundingHeights(const ChunkIndex& chunkIndex) const {
+        const ChunkData& chunk = _chunkData.at(chunkIndex.hashKey());
+        return { chunk.minHeight, chunk.maxHeight, true };
+    }
+
+    static const int Width = 4096;
+    static const int Height = 2048;
+    static const int MinimumPixelSize = 64;
+    static const int SegmentsPerPatch = 64;
+    static constexpr double Radius = 6.371e6;
+    static constexpr double LodScaleFactor = 5.0;
+    static constexpr double Threshold = 2.0;
+    // A 1080 pixel high viewport with a vertical field of view of 60 degrees
+    static constexpr double ProjectionScale = 540.0 / 0.57735026918962573;
+
+    Ellipsoid _ellipsoid;
+    std::string _filename;
+    int _maximumLevel;
+    std::unordered_map<HashKey, ChunkData> _chunkData;
+};
+
+TEST_F(ChunkLevelEvaluatorTest, ScreenSpaceErrorHasHysteresis) {
+    // Split above the threshold, merge when the parent would be below it
+    EXPECT_EQ(6, EvaluateChunkLevelByScreenSpaceError::desiredLevel(5, 2.5, 2.0));
+    EXPECT_EQ(5, EvaluateChunkLevelByScreenSpaceError::desiredLevel(5, 1.5, 2.0));
+    EXPECT_EQ(4, EvaluateChunkLevelByScreenSpaceError::desiredLevel(5, 0.5, 2.0));
+
+    // Halving the segment angle quarters the curvature error
+    Scalar error = EvaluateChunkLevelByScreenSpaceError::curvatureError(Radius, 0.1, 64);
+    Scalar childError =
+        EvaluateChunkLevelByScreenSpaceError::curvatureError(Radius, 0.05, 64);
+    EXPECT_NEAR(0.25, childError / error, 1e-3);
+}
+
+TEST_F(ChunkLevelEvaluatorTest, FlatRegionsAreRefinedLessByScreenSpaceError) {
+    ASSERT_GE(_maximumLevel, 5);
+
+    Result byDistance = runCameraPath([this](const ChunkIndex& c, const Vec3& p) {
+        return levelByDistance(c, p);
+    });
+    Result byProjectedArea = runCameraPath([this](const ChunkIndex& c, const Vec3& p) {
+        return levelByProjectedArea(c, p);
+    });
+    Result byScreenSpaceError = runCameraPath([this](const ChunkIndex& c, const Vec3& p) {
+        return levelByScreenSpaceError(c, p);
+    });
+
+    EXPECT_LT(byScreenSpaceError.numTileReads, byDistance.numTileReads);
+    EXPECT_LT(byScreenSpaceError.numFlatChunks, byDistance.numFlatChunks);
+    EXPECT_LT(byScreenSpaceError.numFlatChunks,
+        byScreenSpaceError.numChunks - byScreenSpaceError.numFlatChunks)
+        << "The flat hemisphere should need fewer chunks than the rough one";
+
+    RecordProperty("DistanceChunks", static_cast<int>(byDistance.numChunks));
+    RecordProperty("DistanceTileReads", static_cast<int>(byDistance.numTileReads));
+    RecordProperty("ProjectedAreaChunks", static_cast<int>(byProjectedArea.numChunks));
+    RecordProperty("ProjectedAreaTileReads",
+        static_cast<int>(byProjectedArea.numTileReads));
+    RecordProperty("ScreenSpaceErrorChunks",
+        static_cast<int>(byScreenSpaceError.numChunks));
+    RecordProperty("ScreenSpaceErrorTileReads",
+        static_cast<int>(byScreenSpaceError.numTileReads));
+}
@@ -0,0 +1,160 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/chunk/chunkindex.h>
+#include <modules/globebrowsing/chunk/chunktree.h>
+#include <modules/globebrowsing/chunk/mortonkeymap.h>
+
+#include <random>
+#include <unordered_map>
+
+class ChunkTreeTest : public testing::Test {};
+
+using namespace openspace;
+
+TEST_F(ChunkTreeTest, MortonKeyRoundTrip) {
+    for (int level = 1; level < 23; ++level) {
+        for (int x : { 0, 1, (1 << level) - 1 }) {
+            for (int y : { 0, (1 << (level - 1)) - 1 }) {
+                ChunkIndex chunkIndex(x, y, level);
+                MortonKey key = chunkIndex.mortonKey();
+                ASSERT_EQ(chunkIndex, ChunkIndex::fromMortonKey(key));
+                if (level > 1) {
+                    ASSERT_EQ(chunkIndex.parent(), ChunkIndex::fromMortonKey(key >> 2));
+                }
+                for (int q = 0; q < 4; ++q) {
+                    ASSERT_EQ((key << 2) | q, chunkIndex.child(static_cast<Quad>(q)).mortonKey());
+                }
+            }
+        }
+    }
+}
+
+TEST_F(ChunkTreeTest, SplitAndMergeUpdateLeaves) {
+    ChunkTree tree(nullptr);
+    int nodeCount = ChunkNode::chunkNodeCount;
+    ASSERT_EQ(2, tree.numLeaves());
+
+    tree.split(tree.findNode(ChunkIndex(1, 0, 1)));
+    tree.split(tree.findNode(ChunkIndex(3, 1, 2)));
+    ASSERT_EQ(8, tree.numLeaves());
+    ASSERT_EQ(10, tree.numNodes());
+    ASSERT_EQ(nodeCount + 8, ChunkNode::chunkNodeCount);
+
+    int node = tree.findNode(ChunkIndex(7, 3, 3));
+    ASSERT_NE(-1, node);
+    ASSERT_EQ(ChunkIndex(3, 1, 2), tree.getNode(tree.getParent(node)).getChunk().index());
+
+    tree.merge(tree.findNode(ChunkIndex(1, 0, 1)));
+    ASSERT_EQ(2, tree.numLeaves());
+    ASSERT_EQ(2, tree.numNodes());
+    ASSERT_EQ(-1, tree.findNode(ChunkIndex(7, 3, 3)));
+    ASSERT_EQ(nodeCount, ChunkNode::chunkNodeCount);
+
+    // The freed blocks are reused
+    tree.split(tree.findNode(ChunkIndex(0, 0, 1)));
+    ASSERT_EQ(5, tree.numLeaves());
+}
+
+TEST_F(ChunkTreeTest, DestroyedNodesAreNotCounted) {
+    int nodeCount = ChunkNode::chunkNodeCount;
+    {
+        ChunkTree tree(nullptr);
+        tree.split(tree.findNode(ChunkIndex(0, 0, 1)));
+        tree.split(tree.findNode(ChunkIndex(1, 1, 2)));
+        tree.merge(tree.findNode(ChunkIndex(1, 1, 2)));
+        ASSERT_EQ(nodeCount + 6, ChunkNode::chunkNodeCount);
+    }
+    ASSERT_EQ(nodeCount, ChunkNode::chunkNodeCount);
+}
+
+TEST_F(ChunkTreeTest, NeighborsWrapAndWalkUp) {
+    ChunkTree tree(nullptr);
+    tree.split(tree.findNode(ChunkIndex(0, 0, 1)));
+    tree.split(tree.findNode(ChunkIndex(1, 0, 1)));
+    tree.split(tree.findNode(ChunkIndex(3, 1, 2)));
+
+    // Wraps around the date line to the coarser node of the western hemisphere
+    int node = tree.findNode(ChunkIndex(7, 2, 3));
+    int east = tree.getNeighbor(node, EAST);
+    ASSERT_EQ(ChunkIndex(0, 1, 2), tree.getNode(east).getChunk().index());
+
+    // There are no neighbours across the poles
+    ASSERT_EQ(-1, tree.getNeighbor(tree.findNode(ChunkIndex(0, 0, 2)), NORTH));
+
+    int west = tree.getNeighbor(node, WEST);
+    ASSERT_EQ(ChunkIndex(6, 2, 3), tree.getNode(west).getChunk().index());
+}
+
+TEST_F(ChunkTreeTest, MortonKeyMapMatchesUnorderedMap) {
+    // Starts small so that the map grows and probe sequences wrap around the table
+    MortonKeyMap map;
+    std::unordered_map<MortonKey, int> reference;
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<int> level(1, 8);
+
+    for (int i = 0; i < 20000; ++i) {
+        int l = level(random);
+        ChunkIndex chunkIndex(random() % (1 << l), random() % (1 << (l - 1)), l);
+        MortonKey key = chunkIndex.mortonKey();
+        if (random() % 3 == 0) {
+            ASSERT_EQ(reference.erase(key) == 1, map.erase(key));
+        }
+        else {
+            map.insert(key, i);
+            reference[key] = i;
+        }
+        ASSERT_EQ(reference.size(), map.size());
+    }
+
+    for (int l = 1; l <= 8; ++l) {
+        for (int x = 0; x < (1 << l); ++x) {
+            for (int y = 0; y < (1 << (l - 1)); ++y) {
+                MortonKey key = ChunkIndex(x, y, l).mortonKey();
+                auto it = reference.find(key);
+                ASSERT_EQ(it != reference.end() ? it->second : -1, map.find(key));
+            }
+        }
+    }
+}
+
+TEST_F(ChunkTreeTest, MortonKeyMapDoesNotGrowWithinCapacity) {
+    MortonKeyMap map(100);
+    size_t capacity = map.capacity();
+    ASSERT_LE(100u, capacity);
+
+    for (int round = 0; round < 10; ++round) {
+        for (int x = 0; x < 100; ++x) {
+            map.insert(ChunkIndex(x, 0, 7).mortonKey(), x);
+        }
+        for (int x = 0; x < 100; ++x) {
+            ASSERT_TRUE(map.erase(ChunkIndex(x, 0, 7).mortonKey()));
+        }
+        ASSERT_EQ(0u, map.size());
+        ASSERT_EQ(capacity, map.capacity());
+    }
+}
@@ -0,0 +1,238 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/tile/heighttilecache.h>
+#include <modules/globebrowsing/tile/tiledataset.h>
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace openspace;
+
+class HeightTileCacheTest : public TileDatasetTest {
+protected:
+    std::shared_ptr<HeightTile> createHeightTile(const ChunkIndex& chunkIndex,
+        const std::function<float(int x, int y)>& height, int size = 64)
+    {
+        std::shared_ptr<HeightTile> heightTile(new HeightTile);
+        heightTile->chunkIndex = chunkIndex;
+        heightTile->dimensions = glm::uvec2(size, size);
+        heightTile->heights.resize(size * size);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                heightTile->heights[y * size + x] = height(x, y);
+            }
+        }
+        return heightTile;
+    }
+
+    // The position of the center of a sample of a tile
+    Geodetic2 samplePosition(const ChunkIndex& chunkIndex, glm::uvec2 dimensions,
+        double x, double y)
+    {
+        GeodeticPatch patch(chunkIndex);
+        Geodetic2 northWest = patch.getCorner(Quad::NORTH_WEST);
+        return Geodetic2(
+            northWest.lat - (y + 0.5) / dimensions.y * patch.size().lat,
+            northWest.lon + (x + 0.5) / dimensions.x * patch.size().lon);
+    }
+};
+
+TEST_F(HeightTileCacheTest, HeightsMatchTileData) {
+    TileDataset tileDataset(_filename, MinimumPixelSize, true);
+    ChunkIndex chunkIndex(3, 1, 3);
+    std::shared_ptr<TileIOResult> result = tileDataset.readTileData(chunkIndex);
+    ASSERT_EQ(CE_None, result->error);
+    ASSERT_TRUE(result->heightTile != nullptr);
+
+    const HeightTile& heightTile = *result->heightTile;
+    glm::uvec2 dimensions = heightTile.dimensions;
+    ASSERT_EQ(glm::uvec2(result->dimensions), dimensions);
+
+    // The byte data has no scale or offset, so the heights are the raw values. The
+    // image data is flipped to start at the southern edge
+    const GByte* imageData = static_cast<const GByte*>(result->imageData);
+    HeightTileCache heightTileCache;
+    heightTileCache.put(result->heightTile);
+    for (unsigned int y = 0; y < dimensions.y; y += 7) {
+        for (unsigned int x = 0; x < dimensions.x; x += 5) {
+            float expected = imageData[(dimensions.y - 1 - y) * dimensions.x + x];
+            ASSERT_EQ(expected, heightTile.heights[y * dimensions.x + x]);
+
+            HeightQueryResult query = heightTileCache.getHeight(
+                samplePosition(chunkIndex, dimensions, x, y));
+            EXPECT_EQ(3, query.level);
+            EXPECT_NEAR(expected, query.height, 1e-3f);
+        }
+    }
+
+    // Only height maps, which are preprocessed, keep a copy of the heights
+    TileDataset colorDataset(_filename, MinimumPixelSize, false);
+    std::shared_ptr<TileIOResult> colorResult = colorDataset.readTileData(chunkIndex);
+    EXPECT_TRUE(colorResult->heightTile == nullptr);
+
+    delete[] static_cast<char*>(result->imageData);
+    delete[] static_cast<char*>(colorResult->imageData);
+}
+
+TEST_F(HeightTileCacheTest, MostDetailedTileAnswers) {
+    HeightTileCache heightTileCache;
+    Geodetic2 position = samplePosition(ChunkIndex(5, 2, 3), glm::uvec2(1, 1), 0, 0);
+    Geodetic2 otherPosition = samplePosition(ChunkIndex(1, 2, 3), glm::uvec2(1, 1), 0, 0);
+
+    EXPECT_EQ(-1, heightTileCache.getHeight(position).level);
+
+    ChunkIndex coarse = ChunkIndex(5, 2, 3).parent().parent();
+    heightTileCache.put(createHeightTile(coarse, [](int, int) { return 100.0f; }));
+    heightTileCache.put(createHeightTile(ChunkIndex(5, 2, 3), [](int, int) { return 300.0f; }));
+
+    HeightQueryResult query = heightTileCache.getHeight(position);
+    EXPECT_EQ(3, query.level);
+    EXPECT_FLOAT_EQ(300.0f, query.height);
+
+    query = heightTileCache.getHeight(
+        samplePosition(ChunkIndex(4, 2, 3), glm::uvec2(1, 1), 0, 0));
+    EXPECT_EQ(1, query.level);
+    EXPECT_FLOAT_EQ(100.0f, query.height);
+
+    // No tile covers the western hemisphere
+    EXPECT_EQ(-1, heightTileCache.getHeight(otherPosition).level);
+}
+
+TEST_F(HeightTileCacheTest, InterpolatesBilinearly) {
+    HeightTileCache heightTileCache;
+    ChunkIndex chunkIndex(10, 6, 4);
+    std::shared_ptr<HeightTile> heightTile = createHeightTile(chunkIndex,
+        [](int x, int y) { return 2.0f * x - 3.0f * y + 7.0f; });
+    heightTileCache.put(heightTile);
+
+    // Bilinear interpolation reproduces a linear function between the samples
+    std::mt19937 random(5);
+    std::uniform_real_distribution<double> sample(0.0, 63.0);
+    std::vector<Geodetic2> positions;
+    std::vector<float> expected;
+    for (int i = 0; i < 1000; ++i) {
+        double x = sample(random);
+        double y = sample(random);
+        positions.push_back(samplePosition(chunkIndex, heightTile->dimensions, x, y));
+        expected.push_back(static_cast<float>(2.0 * x - 3.0 * y + 7.0));
+    }
+
+    std::vector<HeightQueryResult> results;
+    heightTileCache.getHeights(positions, results);
+    ASSERT_EQ(positions.size(), results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(4, results[i].level);
+        EXPECT_NEAR(expected[i], results[i].height, 1e-3f);
+    }
+}
+
+TEST_F(HeightTileCacheTest, LeastRecentlyUsedTilesAreEvicted) {
+    const int TileSize = 64;
+    const size_t TileBytes = TileSize * TileSize * sizeof(float);
+    HeightTileCache heightTileCache(4 * TileBytes);
+    for (int x = 0; x < 8; ++x) {
+        heightTileCache.put(createHeightTile(ChunkIndex(x, 1, 3),
+            [](int, int) { return 0.0f; }, TileSize));
+    }
+    EXPECT_EQ(4u, heightTileCache.numTiles());
+    EXPECT_EQ(4 * TileBytes, heightTileCache.numBytes());
+    EXPECT_EQ(-1, heightTileCache.getHeight(
+        samplePosition(ChunkIndex(0, 1, 3), glm::uvec2(1, 1), 0, 0)).level);
+    EXPECT_EQ(3, heightTileCache.getHeight(
+        samplePosition(ChunkIndex(7, 1, 3), glm::uvec2(1, 1), 0, 0)).level);
+}
+
+TEST_F(HeightTileCacheTest, ConcurrentQueryThroughput) {
+    const int nThreads = 4;
+    const int nBatches = 200;
+    const int BatchSize = 1024;
+    const int MaxLevel = 6;
+
+    HeightTileCache heightTileCache(256 * 1024 * 1024);
+    for (const ChunkIndex& chunkIndex : chunkIndices(MaxLevel - 1)) {
+        heightTileCache.put(createHeightTile(chunkIndex,
+            [&chunkIndex](int, int) { return static_cast<float>(chunkIndex.level); }));
+    }
+
+    std::atomic<int> nUnanswered(0);
+    std::atomic<bool> done(false);
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            std::mt19937 random(t);
+            std::uniform_real_distribution<double> lat(-M_PI / 2, M_PI / 2);
+            std::uniform_real_distribution<double> lon(-M_PI, M_PI);
+            std::vector<Geodetic2> positions(BatchSize);
+            std::vector<HeightQueryResult> results;
+            for (int b = 0; b < nBatches; ++b) {
+                for (Geodetic2& position : positions) {
+                    position = Geodetic2(lat(random), lon(random));
+                }
+                heightTileCache.getHeights(positions, results);
+                for (const HeightQueryResult& result : results) {
+                    if (result.level < 1) {
+                        ++nUnanswered;
+                    }
+                }
+            }
+        }));
+    }
+
+    // Tiles keep arriving from the render thread while the queries run
+    std::thread writer([&]() {
+        int level = MaxLevel;
+        for (int y = 0; y < (1 << (level - 1)) && !done; ++y) {
+            for (int x = 0; x < (1 << level); ++x) {
+                heightTileCache.put(createHeightTile(ChunkIndex(x, y, level),
+                    [](int, int) { return 1.0f; }, 16));
+            }
+        }
+    });
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::high_resolution_clock::now() - start;
+    done = true;
+    writer.join();
+
+    EXPECT_EQ(0, nUnanswered) << "All positions are covered by the coarser levels";
+
+    double nQueries = static_cast<double>(nThreads) * nBatches * BatchSize;
+    RecordProperty("Threads", nThreads);
+    RecordProperty("Queries", static_cast<int>(nQueries));
+    RecordProperty("QueriesPerSecond", static_cast<int>(nQueries / elapsed.count()));
+}
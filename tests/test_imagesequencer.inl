@@ -0,0 +1,135 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/newhorizons/util/decoder.h>
+#include <modules/newhorizons/util/imagesequencer.h>
+#include <modules/newhorizons/util/sequenceparser.h>
+
+class ImageSequencerTest : public testing::Test {};
+
+using namespace openspace;
+
+namespace {
+
+class TestDecoder : public Decoder {
+public:
+    TestDecoder(std::vector<std::string> spiceIDs)
+        : _spiceIDs(std::move(spiceIDs))
+    {}
+
+    std::string getDecoderType() override { return "CAMERA"; }
+    std::vector<std::string> getTranslation() override { return _spiceIDs; }
+
+private:
+    std::vector<std::string> _spiceIDs;
+};
+
+class TestParser : public SequenceParser {
+public:
+    TestParser() {
+        _translation["CAM"] = new TestDecoder({ "SC_CAM" });
+        _translation["SCAN"] = new TestDecoder({ "SC_SCAN_A", "SC_SCAN_B" });
+
+        addInstrumentTime("CAM", 10.0, 20.0);
+        addInstrumentTime("CAM", 30.0, 40.0);
+        addInstrumentTime("SCAN", 15.0, 35.0);
+
+        Image image;
+        image.startTime = 10.0;
+        image.activeInstruments = { "SC_CAM" };
+        _subsetMap["TARGET"]._subset.push_back(image);
+        _subsetMap["TARGET"]._range.setRange(10.0);
+        _targetTimes.push_back({ 10.0, "TARGET" });
+        _captureProgression.push_back(10.0);
+    }
+
+    bool create() override { return true; }
+    std::map<std::string, Decoder*> getTranslation() override { return _translation; }
+
+private:
+    void addInstrumentTime(std::string instrument, double start, double end) {
+        TimeRange range;
+        range._min = start;
+        range._max = end;
+        _instrumentTimes.push_back({ std::move(instrument), range });
+    }
+
+    std::map<std::string, Decoder*> _translation;
+};
+
+} // namespace
+
+TEST_F(ImageSequencerTest, InstrumentActivity) {
+    ImageSequencer sequencer;
+    TestParser parser;
+    sequencer.runSequenceParser(&parser);
+    ASSERT_TRUE(sequencer.isReady());
+
+    sequencer.updateSequencer(5.0);
+    EXPECT_FALSE(sequencer.instrumentActive("SC_CAM"));
+    EXPECT_TRUE(sequencer.activeInstruments().empty());
+
+    sequencer.updateSequencer(12.5);
+    EXPECT_TRUE(sequencer.instrumentActive("SC_CAM"));
+    EXPECT_FALSE(sequencer.instrumentActive("SC_SCAN_A"));
+    EXPECT_FLOAT_EQ(0.25f, sequencer.instrumentActiveTime("SC_CAM"));
+
+    sequencer.updateSequencer(17.5);
+    EXPECT_TRUE(sequencer.instrumentActive("SC_CAM"));
+    EXPECT_TRUE(sequencer.instrumentActive("SC_SCAN_A"));
+    EXPECT_TRUE(sequencer.instrumentActive("SC_SCAN_B"));
+    EXPECT_EQ(3, sequencer.activeInstruments().size());
+    EXPECT_FLOAT_EQ(0.125f, sequencer.instrumentActiveTime("SC_SCAN_B"));
+
+    sequencer.updateSequencer(25.0);
+    EXPECT_FALSE(sequencer.instrumentActive("SC_CAM"));
+    EXPECT_TRUE(sequencer.instrumentActive("SC_SCAN_A"));
+
+    sequencer.updateSequencer(40.0);
+    EXPECT_TRUE(sequencer.instrumentActive("SC_CAM"));
+    EXPECT_FLOAT_EQ(1.f, sequencer.instrumentActiveTime("SC_CAM"));
+    EXPECT_FALSE(sequencer.instrumentActive("SC_SCAN_B"));
+
+    EXPECT_FALSE(sequencer.instrumentActive("UNKNOWN"));
+    EXPECT_EQ(-1, sequencer.instrumentIndex("UNKNOWN"));
+    EXPECT_EQ(-1.f, sequencer.instrumentActiveTime("UNKNOWN"));
+}
+
+TEST_F(ImageSequencerTest, ActiveInstrumentMap) {
+    ImageSequencer sequencer;
+    TestParser parser;
+    sequencer.runSequenceParser(&parser);
+
+    sequencer.updateSequencer(25.0);
+    std::map<std::string, bool> active = sequencer.getActiveInstruments();
+    EXPECT_FALSE(active["SC_CAM"]);
+    EXPECT_TRUE(active["SC_SCAN_A"]);
+    EXPECT_TRUE(active["SC_SCAN_B"]);
+
+    int index = sequencer.instrumentIndex("SC_SCAN_A");
+    ASSERT_NE(-1, index);
+    EXPECT_EQ("SC_SCAN_A", sequencer.instrumentName(index));
+}
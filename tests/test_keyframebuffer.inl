@@ -0,0 +1,343 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/interaction/keyframebuffer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using openspace::interaction::KeyframeBuffer;
+
+class KeyframeBufferTest : public testing::Test {
+protected:
+    // The host moves along x with constant speed and rotates around z with a
+    // constant angular velocity
+    static const double Speed;
+    static const double AngularVelocity;
+
+    // The host's clock is this far behind the local clock
+    static const double ClockOffset;
+
+    static KeyframeBuffer::Keyframe keyframeAt(double hostTime) {
+        KeyframeBuffer::Keyframe keyframe;
+        keyframe.timeStamp = hostTime;
+        keyframe.position = glm::dvec3(Speed * hostTime, 1.0, 2.0);
+        keyframe.rotation = glm::angleAxis(
+            AngularVelocity * hostTime,
+            glm::dvec3(0.0, 0.0, 1.0)
+        );
+        return keyframe;
+    }
+
+    static double angleBetween(const glm::dquat& q0, const glm::dquat& q1) {
+        return 2.0 * std::acos(std::min(std::abs(glm::dot(q0, q1)), 1.0));
+    }
+
+    /**
+     * Plays a stream of keyframes that are sent every <code>sendInterval</code> and
+     * arrive with a delay between <code>minimumDelay</code> and
+     * <code>minimumDelay + jitter</code>. The buffer is sampled at 60 Hz and the
+     * largest error after the first second is returned. Keyframes that are sent
+     * between <code>gapStart</code> and <code>gapEnd</code> are lost.
+     */
+    struct PlaybackResult {
+        double maximumPositionError = 0.0;
+        double maximumRotationError = 0.0;
+        bool isMonotonic = true;
+        int nInterpolated = 0;
+        int nExtrapolated = 0;
+        int nHeld = 0;
+        double lastLocalTime = 0.0;
+    };
+
+    PlaybackResult play(KeyframeBuffer& buffer, double duration, double sendInterval,
+        double minimumDelay, double jitter, double gapStart = -1.0, double gapEnd = -1.0)
+    {
+        std::mt19937 generator(1337);
+        std::uniform_real_distribution<double> delayDistribution(0.0, jitter);
+
+        struct Arrival {
+            double localTime;
+            KeyframeBuffer::Keyframe keyframe;
+        };
+        std::vector<Arrival> arrivals;
+        for (double t = 0.0; t < duration; t += sendInterval) {
+            if (t >= gapStart && t < gapEnd) {
+                continue;
+            }
+            double delay = minimumDelay + delayDistribution(generator);
+            arrivals.push_back({ t + ClockOffset + delay, keyframeAt(t) });
+        }
+        std::sort(arrivals.begin(), arrivals.end(),
+            [](const Arrival& a, const Arrival& b) { return a.localTime < b.localTime; }
+        );
+
+        PlaybackResult result;
+        size_t nextArrival = 0;
+        double lastPlaybackTime = -std::numeric_limits<double>::max();
+        const double frameTime = 1.0 / 60.0;
+        for (double localTime = ClockOffset; localTime < ClockOffset + duration;
+             localTime += frameTime)
+        {
+            while (nextArrival < arrivals.size() &&
+                   arrivals[nextArrival].localTime <= localTime)
+            {
+                buffer.addKeyframe(
+                    arrivals[nextArrival].keyframe,
+                    arrivals[nextArrival].localTime
+                );
+                ++nextArrival;
+            }
+
+            glm::dvec3 position;
+            glm::dquat rotation;
+            KeyframeBuffer::State state = buffer.sample(localTime, position, rotation);
+            if (state == KeyframeBuffer::State::Empty) {
+                continue;
+            }
+
+            result.lastLocalTime = localTime;
+            double playbackTime = buffer.playbackTime();
+            result.isMonotonic &= playbackTime >= lastPlaybackTime;
+            lastPlaybackTime = playbackTime;
+
+            if (localTime < ClockOffset + 1.0) {
+                continue;
+            }
+
+            switch (state) {
+                case KeyframeBuffer::State::Interpolated:
+                    ++result.nInterpolated;
+                    break;
+                case KeyframeBuffer::State::Extrapolated:
+                    ++result.nExtrapolated;
+                    break;
+                default:
+                    ++result.nHeld;
+                    break;
+            }
+
+            if (state != KeyframeBuffer::State::Held) {
+                KeyframeBuffer::Keyframe expected = keyframeAt(playbackTime);
+                result.maximumPositionError = std::max(
+                    result.maximumPositionError,
+                    glm::length(position - expected.position)
+                );
+                result.maximumRotationError = std::max(
+                    result.maximumRotationError,
+                    angleBetween(rotation, expected.rotation)
+                );
+            }
+        }
+        return result;
+    }
+};
+
+const double KeyframeBufferTest::Speed = 1000.0;
+const double KeyframeBufferTest::AngularVelocity = 0.5;
+const double KeyframeBufferTest::ClockOffset = 5000.0;
+
+TEST_F(KeyframeBufferTest, EmptyBuffer) {
+    KeyframeBuffer buffer;
+    glm::dvec3 position;
+    glm::dquat rotation;
+    EXPECT_EQ(KeyframeBuffer::State::Empty, buffer.sample(0.0, position, rotation));
+    EXPECT_TRUE(buffer.isEmpty());
+}
+
+TEST_F(KeyframeBufferTest, SingleKeyframeIsHeld) {
+    KeyframeBuffer buffer;
+    buffer.addKeyframe(keyframeAt(1.0), ClockOffset + 1.0);
+
+    glm::dvec3 position;
+    glm::dquat rotation;
+    EXPECT_EQ(
+        KeyframeBuffer::State::Held,
+        buffer.sample(ClockOffset + 3.0, position, rotation)
+    );
+    EXPECT_DOUBLE_EQ(Speed * 1.0, position.x);
+}
+
+TEST_F(KeyframeBufferTest, OldAndDuplicateKeyframesAreDropped) {
+    KeyframeBuffer buffer;
+    buffer.addKeyframe(keyframeAt(1.0), 1.0);
+    buffer.addKeyframe(keyframeAt(2.0), 2.0);
+    buffer.addKeyframe(keyframeAt(2.0), 2.1);
+    buffer.addKeyframe(keyframeAt(1.5), 2.2);
+    EXPECT_EQ(2, buffer.size());
+}
+
+TEST_F(KeyframeBufferTest, CapacityIsLimited) {
+    KeyframeBuffer buffer(8);
+    for (int i = 0; i < 20; ++i) {
+        buffer.addKeyframe(keyframeAt(i), i);
+    }
+    EXPECT_EQ(8, buffer.size());
+}
+
+TEST_F(KeyframeBufferTest, ClockOffsetAndJitterAreEstimated) {
+    const double minimumDelay = 0.03;
+    const double jitter = 0.05;
+
+    KeyframeBuffer buffer(64, 0.1);
+    play(buffer, 5.0, 1.0 / 30.0, minimumDelay, jitter);
+
+    // The estimate is the smallest delay that was seen, which is close to the minimum
+    EXPECT_GE(buffer.clockOffset(), ClockOffset + minimumDelay);
+    EXPECT_LT(buffer.clockOffset(), ClockOffset + minimumDelay + 0.1 * jitter);
+
+    EXPECT_GT(buffer.jitter(), 0.0);
+    EXPECT_LT(buffer.jitter(), jitter);
+}
+
+TEST_F(KeyframeBufferTest, PlaybackFollowsTargetLatency) {
+    const double minimumDelay = 0.03;
+    const double targetLatency = 0.12;
+
+    KeyframeBuffer buffer(64, targetLatency);
+    PlaybackResult result = play(buffer, 5.0, 1.0 / 30.0, minimumDelay, 0.05);
+
+    // The playback lags behind the host by the smallest delay and the target latency
+    double hostTime = result.lastLocalTime - ClockOffset;
+    EXPECT_NEAR(hostTime - minimumDelay - targetLatency, buffer.playbackTime(), 0.005);
+}
+
+TEST_F(KeyframeBufferTest, JitteryStreamIsPlayedSmoothly) {
+    // The target latency covers the jitter, so all frames are interpolated
+    KeyframeBuffer buffer(64, 0.1);
+    PlaybackResult result = play(buffer, 10.0, 1.0 / 30.0, 0.02, 0.08);
+
+    EXPECT_TRUE(result.isMonotonic);
+    EXPECT_GT(result.nInterpolated, 0);
+    EXPECT_EQ(0, result.nExtrapolated);
+    EXPECT_EQ(0, result.nHeld);
+
+    // The motion is linear, so the spline reproduces it exactly
+    EXPECT_LT(result.maximumPositionError, 1e-6 * Speed);
+    EXPECT_LT(result.maximumRotationError, 1e-6);
+}
+
+TEST_F(KeyframeBufferTest, GapsAreExtrapolated) {
+    // Keyframes for 0.3 s are lost, which is longer than the target latency
+    KeyframeBuffer buffer(64, 0.1, 0.5);
+    PlaybackResult result = play(buffer, 6.0, 1.0 / 30.0, 0.02, 0.0, 3.0, 3.3);
+
+    EXPECT_TRUE(result.isMonotonic);
+    EXPECT_GT(result.nExtrapolated, 0);
+    EXPECT_EQ(0, result.nHeld);
+
+    // The motion is linear, so the extrapolation is exact as well
+    EXPECT_LT(result.maximumPositionError, 1e-6 * Speed);
+    EXPECT_LT(result.maximumRotationError, 1e-6);
+}
+
+TEST_F(KeyframeBufferTest, LongGapsAreHeld) {
+    KeyframeBuffer buffer(64, 0.1, 0.2);
+    PlaybackResult result = play(buffer, 6.0, 1.0 / 30.0, 0.02, 0.0, 3.0, 4.0);
+
+    EXPECT_GT(result.nExtrapolated, 0);
+    EXPECT_GT(result.nHeld, 0);
+}
+
+TEST_F(KeyframeBufferTest, StoppedCameraReturnsToLastKeyframe) {
+    // The host moves for two seconds, stops, and sends nothing but the keyframe that
+    // keeps the connection alive one second later
+    const double stopTime = 2.0;
+    const double sendInterval = 1.0 / 30.0;
+    const double delay = 0.02;
+
+    for (bool hasFinalKeyframe : { false, true }) {
+        KeyframeBuffer buffer(64, 0.1, 0.2);
+
+        std::vector<KeyframeBuffer::Keyframe> keyframes;
+        for (double t = 0.0; t <= stopTime; t += sendInterval) {
+            keyframes.push_back(keyframeAt(t));
+        }
+        KeyframeBuffer::Keyframe stop = keyframes.back();
+        if (hasFinalKeyframe) {
+            // The host repeats the pose as soon as it notices that the camera stopped
+            stop.timeStamp += sendInterval;
+            keyframes.push_back(stop);
+        }
+        stop.timeStamp += 1.0;
+        keyframes.push_back(stop);
+
+        double maximumOvershoot = 0.0;
+        glm::dvec3 position;
+        glm::dquat rotation;
+        glm::dvec3 idlePosition;
+        size_t next = 0;
+        for (double t = ClockOffset; t < ClockOffset + stopTime + 2.0; t += 1.0 / 60.0) {
+            while (next < keyframes.size() &&
+                   keyframes[next].timeStamp + ClockOffset + delay <= t)
+            {
+                const double arrival = keyframes[next].timeStamp + ClockOffset + delay;
+                buffer.addKeyframe(keyframes[next], arrival);
+                ++next;
+            }
+            KeyframeBuffer::State state = buffer.sample(t, position, rotation);
+            maximumOvershoot = std::max(
+                maximumOvershoot,
+                position.x - stop.position.x
+            );
+
+            // Sample shortly before the keep-alive keyframe is played back
+            if (buffer.playbackTime() < stop.timeStamp - 0.1) {
+                idlePosition = position;
+                if (buffer.playbackTime() > stop.timeStamp - 0.5) {
+                    EXPECT_EQ(KeyframeBuffer::State::Held, state);
+                }
+            }
+        }
+
+        // While idle, the camera is exactly where the host stopped, so the keep-alive
+        // keyframe does not make it jump back
+        EXPECT_EQ(stop.position, idlePosition);
+        EXPECT_EQ(stop.position, position);
+        if (hasFinalKeyframe) {
+            // Only the spline overshoots a little around the stop
+            EXPECT_LT(maximumOvershoot, Speed * sendInterval);
+        }
+        else {
+            EXPECT_GT(maximumOvershoot, 0.0);
+            EXPECT_LE(maximumOvershoot, 0.2 * Speed + 1e-6 * Speed);
+        }
+    }
+}
+
+TEST_F(KeyframeBufferTest, SamplingIsDeterministic) {
+    KeyframeBuffer buffer0(64, 0.1);
+    KeyframeBuffer buffer1(64, 0.1);
+    PlaybackResult result0 = play(buffer0, 4.0, 1.0 / 20.0, 0.02, 0.1);
+    PlaybackResult result1 = play(buffer1, 4.0, 1.0 / 20.0, 0.02, 0.1);
+
+    EXPECT_EQ(result0.maximumPositionError, result1.maximumPositionError);
+    EXPECT_EQ(result0.nInterpolated, result1.nInterpolated);
+    EXPECT_EQ(buffer0.playbackTime(), buffer1.playbackTime());
+}
@@ -52,6 +52,40 @@ TEST_F(LRUCacheTest, CleaningCache) {
 	ASSERT_TRUE(lru.exist(12)) << "Element should remain in cache";
 }
 
+TEST_F(LRUCacheTest, EvictedValues) {
+	LRUCache<int, double> lru(2);
+	std::vector<double> evicted;
+	lru.put(1, 1.2, evicted);
+	lru.put(2, 2.3, evicted);
+	ASSERT_TRUE(evicted.empty()) << "Nothing should be evicted while the cache fits";
+
+	lru.get(1);
+	lru.put(3, 3.4, evicted);
+	ASSERT_EQ(1, evicted.size());
+	ASSERT_EQ(2.3, evicted[0]) << "The least recently used value should be evicted";
+
+	lru.put(1, 4.5, evicted);
+	ASSERT_EQ(2, evicted.size());
+	ASSERT_EQ(1.2, evicted[1]) << "A replaced value should be evicted";
+}
+
+TEST_F(LRUCacheTest, CostBounded) {
+	LRUCache<int, int> lru(100);
+	std::vector<int> evicted;
+	lru.put(1, 1, evicted, 60);
+	lru.put(2, 2, evicted, 30);
+	ASSERT_EQ(90, lru.totalCost());
+
+	lru.put(3, 3, evicted, 20);
+	ASSERT_FALSE(lru.exist(1)) << "Element should have been cleaned out of cache";
+	ASSERT_TRUE(lru.exist(2)) << "Element should remain in cache";
+	ASSERT_EQ(50, lru.totalCost());
+
+	lru.put(4, 4, evicted, 500);
+	ASSERT_EQ(1, lru.size()) << "An item larger than the cache should be kept alone";
+	ASSERT_TRUE(lru.exist(4));
+}
+
 
 
 
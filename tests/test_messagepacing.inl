@@ -0,0 +1,160 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/network/messagepacing.h>
+
+#include <chrono>
+
+using openspace::network::MessageRateLimiter;
+using openspace::network::PacedMessageSequence;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::vector<char>> numberedMessages(int n) {
+        std::vector<std::vector<char>> messages;
+        for (int i = 0; i < n; ++i)
+            messages.push_back(std::vector<char>(1, static_cast<char>(i)));
+        return messages;
+    }
+}
+
+class MessagePacingTest : public testing::Test {};
+
+TEST_F(MessagePacingTest, RateLimiterAllowsFirstMessage) {
+    MessageRateLimiter limiter(10.0);
+    EXPECT_TRUE(limiter.allow(Clock::time_point()));
+}
+
+TEST_F(MessagePacingTest, RateLimiterSpacesMessages) {
+    MessageRateLimiter limiter(10.0);
+    const Clock::time_point start = Clock::now();
+    ASSERT_TRUE(limiter.allow(start));
+
+    EXPECT_FALSE(limiter.allow(start));
+    EXPECT_FALSE(limiter.allow(start + std::chrono::milliseconds(99)));
+    EXPECT_TRUE(limiter.allow(start + std::chrono::milliseconds(100)));
+
+    // The interval is counted from the last allowed message
+    EXPECT_FALSE(limiter.allow(start + std::chrono::milliseconds(150)));
+    EXPECT_TRUE(limiter.allow(start + std::chrono::milliseconds(250)));
+}
+
+TEST_F(MessagePacingTest, RateLimiterCountsMessagesPerSecond) {
+    MessageRateLimiter limiter(20.0);
+    const Clock::time_point start = Clock::now();
+
+    // Calls every millisecond for one second, as a fast render loop would
+    int nAllowed = 0;
+    for (int i = 0; i < 1000; ++i) {
+        if (limiter.allow(start + std::chrono::milliseconds(i)))
+            ++nAllowed;
+    }
+    EXPECT_EQ(20, nAllowed);
+}
+
+TEST_F(MessagePacingTest, RateLimiterWithoutRateAllowsEveryMessage) {
+    MessageRateLimiter limiter(0.0);
+    const Clock::time_point start = Clock::now();
+    for (int i = 0; i < 10; ++i)
+        EXPECT_TRUE(limiter.allow(start));
+
+    limiter.setRate(1.0);
+    EXPECT_FALSE(limiter.allow(start));
+    limiter.setRate(-1.0);
+    EXPECT_TRUE(limiter.allow(start));
+}
+
+TEST_F(MessagePacingTest, SequenceStartsInactive) {
+    PacedMessageSequence sequence(
+        std::chrono::milliseconds(250),
+        std::chrono::milliseconds(1000)
+    );
+    EXPECT_FALSE(sequence.isActive());
+    EXPECT_EQ(nullptr, sequence.next(Clock::now()));
+}
+
+TEST_F(MessagePacingTest, SequencePacesMessages) {
+    const std::chrono::milliseconds interval(250);
+    const std::chrono::milliseconds finalDelay(1000);
+    PacedMessageSequence sequence(interval, finalDelay);
+
+    const Clock::time_point start = Clock::now();
+    sequence.start(numberedMessages(4), start);
+    ASSERT_TRUE(sequence.isActive());
+    EXPECT_EQ(start, sequence.nextMessageTime());
+
+    Clock::time_point now = start;
+    for (char i = 0; i < 4; ++i) {
+        const std::vector<char>* message = sequence.next(now);
+        ASSERT_NE(nullptr, message);
+        ASSERT_EQ(1, message->size());
+        EXPECT_EQ(i, (*message)[0]);
+
+        if (i < 3) {
+            // The message before the last one is followed by the additional pause
+            const Clock::duration pause = (i == 2) ? interval + finalDelay : interval;
+            EXPECT_EQ(now + pause, sequence.nextMessageTime());
+            EXPECT_EQ(nullptr, sequence.next(now + pause - Clock::duration(1)));
+            now += pause;
+        }
+    }
+    EXPECT_FALSE(sequence.isActive());
+    EXPECT_EQ(nullptr, sequence.next(now + finalDelay));
+}
+
+TEST_F(MessagePacingTest, SequencePausesAfterLateMessages) {
+    const std::chrono::milliseconds interval(250);
+    PacedMessageSequence sequence(interval, std::chrono::milliseconds(1000));
+
+    const Clock::time_point start = Clock::now();
+    sequence.start(numberedMessages(3), start);
+
+    // A message that is sent late does not shorten the pause to the next one
+    const Clock::time_point late = start + std::chrono::milliseconds(400);
+    ASSERT_NE(nullptr, sequence.next(late));
+    EXPECT_EQ(late + interval, sequence.nextMessageTime());
+}
+
+TEST_F(MessagePacingTest, SequenceCanBeClearedAndRestarted) {
+    PacedMessageSequence sequence(
+        std::chrono::milliseconds(250),
+        std::chrono::milliseconds(1000)
+    );
+    const Clock::time_point start = Clock::now();
+    sequence.start(numberedMessages(3), start);
+    ASSERT_NE(nullptr, sequence.next(start));
+
+    sequence.clear();
+    EXPECT_FALSE(sequence.isActive());
+    EXPECT_EQ(nullptr, sequence.next(start + std::chrono::seconds(10)));
+
+    // A new sequence starts from its first message
+    sequence.start(numberedMessages(2), start);
+    const std::vector<char>* message = sequence.next(start);
+    ASSERT_NE(nullptr, message);
+    EXPECT_EQ(0, (*message)[0]);
+}
@@ -0,0 +1,203 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/network/messagequeue.h>
+
+#include <cstring>
+#include <thread>
+
+using openspace::network::LatestMessageBuffer;
+using openspace::network::MessageQueue;
+
+class MessageQueueTest : public testing::Test {};
+
+TEST_F(MessageQueueTest, EmptyQueue) {
+    MessageQueue queue(4);
+    EXPECT_TRUE(queue.isEmpty());
+    EXPECT_EQ(nullptr, queue.front());
+    EXPECT_EQ(4, queue.capacity());
+}
+
+TEST_F(MessageQueueTest, FullQueueRejectsMessages) {
+    MessageQueue queue(2);
+    for (int i = 0; i < 2; ++i) {
+        std::vector<char>* buffer = queue.beginPush();
+        ASSERT_NE(nullptr, buffer);
+        buffer->push_back(static_cast<char>(i));
+        queue.endPush();
+    }
+    EXPECT_EQ(nullptr, queue.beginPush());
+
+    // Removing a message frees its slot again
+    queue.pop();
+    std::vector<char>* buffer = queue.beginPush();
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_TRUE(buffer->empty());
+    buffer->push_back(2);
+    queue.endPush();
+
+    for (char i = 1; i < 3; ++i) {
+        const std::vector<char>* message = queue.front();
+        ASSERT_NE(nullptr, message);
+        ASSERT_EQ(1, message->size());
+        EXPECT_EQ(i, (*message)[0]);
+        queue.pop();
+    }
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST_F(MessageQueueTest, BuffersAreReused) {
+    MessageQueue queue(1);
+    std::vector<char>* buffer = queue.beginPush();
+    buffer->resize(1024);
+    queue.endPush();
+    queue.pop();
+
+    // The slot keeps its memory, so steady traffic does not allocate
+    buffer = queue.beginPush();
+    EXPECT_TRUE(buffer->empty());
+    EXPECT_GE(buffer->capacity(), 1024);
+}
+
+TEST_F(MessageQueueTest, MessagesArriveInOrderAcrossThreads) {
+    const int nMessages = 100000;
+    MessageQueue queue(16);
+
+    std::thread producer([&queue, nMessages]() {
+        for (int i = 0; i < nMessages; ++i) {
+            std::vector<char>* buffer = nullptr;
+            while (!(buffer = queue.beginPush())) {
+                std::this_thread::yield();
+            }
+            buffer->resize(sizeof(int));
+            std::memcpy(buffer->data(), &i, sizeof(int));
+            queue.endPush();
+        }
+    });
+
+    int expected = 0;
+    bool isOrdered = true;
+    while (expected < nMessages) {
+        const std::vector<char>* message = queue.front();
+        if (!message) {
+            std::this_thread::yield();
+            continue;
+        }
+        int value;
+        std::memcpy(&value, message->data(), sizeof(int));
+        isOrdered &= (value == expected);
+        queue.pop();
+        ++expected;
+    }
+    producer.join();
+
+    EXPECT_TRUE(isOrdered);
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST_F(MessageQueueTest, LatestMessageBufferStartsEmpty) {
+    LatestMessageBuffer buffer;
+    EXPECT_FALSE(buffer.hasMessage());
+    EXPECT_EQ(nullptr, buffer.consume());
+}
+
+TEST_F(MessageQueueTest, LatestMessageBufferKeepsLatestMessage) {
+    LatestMessageBuffer buffer;
+    for (char i = 0; i < 3; ++i) {
+        std::vector<char>& message = buffer.writeBuffer();
+        message.assign(1, i);
+        buffer.publish();
+    }
+    EXPECT_TRUE(buffer.hasMessage());
+
+    // Earlier messages that were not consumed are replaced
+    const std::vector<char>* message = buffer.consume();
+    ASSERT_NE(nullptr, message);
+    ASSERT_EQ(1, message->size());
+    EXPECT_EQ(2, (*message)[0]);
+
+    EXPECT_FALSE(buffer.hasMessage());
+    EXPECT_EQ(nullptr, buffer.consume());
+}
+
+TEST_F(MessageQueueTest, LatestMessageBufferKeepsConsumedMessage) {
+    LatestMessageBuffer buffer;
+    buffer.writeBuffer().assign(1, 1);
+    buffer.publish();
+    const std::vector<char>* message = buffer.consume();
+    ASSERT_NE(nullptr, message);
+
+    // Publishing more messages does not touch the one the consumer holds
+    for (char i = 2; i < 5; ++i) {
+        buffer.writeBuffer().assign(1, i);
+        buffer.publish();
+    }
+    ASSERT_EQ(1, message->size());
+    EXPECT_EQ(1, (*message)[0]);
+
+    message = buffer.consume();
+    ASSERT_NE(nullptr, message);
+    EXPECT_EQ(4, (*message)[0]);
+}
+
+TEST_F(MessageQueueTest, LatestMessageBufferExchangesAcrossThreads) {
+    const int nMessages = 100000;
+    LatestMessageBuffer buffer;
+
+    // Every message carries its number twice, so a torn message would be noticed
+    std::thread producer([&buffer, nMessages]() {
+        for (int i = 1; i <= nMessages; ++i) {
+            std::vector<char>& message = buffer.writeBuffer();
+            message.resize(2 * sizeof(int));
+            std::memcpy(message.data(), &i, sizeof(int));
+            std::memcpy(message.data() + sizeof(int), &i, sizeof(int));
+            buffer.publish();
+        }
+    });
+
+    int last = 0;
+    bool isConsistent = true;
+    bool isIncreasing = true;
+    while (last < nMessages) {
+        const std::vector<char>* message = buffer.consume();
+        if (!message) {
+            std::this_thread::yield();
+            continue;
+        }
+        int first;
+        int second;
+        std::memcpy(&first, message->data(), sizeof(int));
+        std::memcpy(&second, message->data() + sizeof(int), sizeof(int));
+        isConsistent &= (first == second);
+        isIncreasing &= (first > last);
+        last = first;
+    }
+    producer.join();
+
+    EXPECT_TRUE(isConsistent);
+    EXPECT_TRUE(isIncreasing);
+    EXPECT_FALSE(buffer.hasMessage());
+}
@@ -0,0 +1,215 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/network/messagestructures.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace openspace::network::datamessagestructures;
+
+class MessageStructuresTest : public testing::Test {
+protected:
+    static glm::quat randomRotation(std::mt19937& generator) {
+        std::normal_distribution<float> distribution;
+        return glm::normalize(glm::quat(
+            distribution(generator),
+            distribution(generator),
+            distribution(generator),
+            distribution(generator)
+        ));
+    }
+
+    // Approximately the angle of the rotation between two close quaternions. The dot
+    // product is too insensitive to small differences for this
+    static double angleBetween(const glm::quat& q0, const glm::quat& q1) {
+        double difference = 0.0;
+        double sum = 0.0;
+        const float c0[4] = { q0.w, q0.x, q0.y, q0.z };
+        const float c1[4] = { q1.w, q1.x, q1.y, q1.z };
+        for (int i = 0; i < 4; ++i) {
+            difference += (c0[i] - c1[i]) * (c0[i] - c1[i]);
+            sum += (c0[i] + c1[i]) * (c0[i] + c1[i]);
+        }
+        return 2.0 * std::sqrt(std::min(difference, sum));
+    }
+};
+
+TEST_F(MessageStructuresTest, ValuesAreLittleEndian) {
+    std::vector<char> buffer;
+    writeValue(buffer, static_cast<uint32_t>(0x04030201));
+    writeValue(buffer, static_cast<int16_t>(-2));
+    ASSERT_EQ(6, buffer.size());
+    const char expected[6] = { 1, 2, 3, 4, -2, -1 };
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        EXPECT_EQ(expected[i], buffer[i]);
+    }
+
+    size_t offset = 0;
+    uint32_t first = 0;
+    int16_t second = 0;
+    ASSERT_TRUE(readValue(buffer.data(), buffer.size(), offset, first));
+    ASSERT_TRUE(readValue(buffer.data(), buffer.size(), offset, second));
+    EXPECT_EQ(0x04030201, first);
+    EXPECT_EQ(-2, second);
+    EXPECT_FALSE(readValue(buffer.data(), buffer.size(), offset, second));
+}
+
+TEST_F(MessageStructuresTest, QuaternionsAreQuantized) {
+    std::mt19937 generator(42);
+    for (int i = 0; i < 10000; ++i) {
+        glm::quat rotation = randomRotation(generator);
+
+        std::vector<char> buffer;
+        writeQuaternion(buffer, 0, rotation);
+        ASSERT_EQ(7u, buffer.size());
+
+        size_t offset = 0;
+        uint8_t flags;
+        glm::quat decoded;
+        ASSERT_TRUE(readQuaternion(buffer.data(), buffer.size(), offset, flags, decoded));
+        EXPECT_EQ(buffer.size(), offset);
+        EXPECT_EQ(0, flags);
+        EXPECT_LT(angleBetween(rotation, decoded), 1e-4);
+    }
+}
+
+TEST_F(MessageStructuresTest, PositionKeyframesAreRelativeToReference) {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> step(-1000.0, 1000.0);
+
+    PositionReference sentReference;
+    PositionReference receivedReference;
+
+    // A camera far away from the origin that moves in small steps
+    glm::dvec3 position(1.5e11, -3.2e10, 7.7e9);
+    for (int i = 0; i < 100; ++i) {
+        position += glm::dvec3(step(generator), step(generator), step(generator));
+
+        PositionKeyframe keyframe;
+        keyframe._position = openspace::psc::CreatePowerScaledCoordinate(
+            position.x, position.y, position.z
+        );
+        keyframe._viewRotationQuat = randomRotation(generator);
+        keyframe._timeStamp = i / 30.0;
+
+        std::vector<char> buffer;
+        keyframe.serialize(buffer, sentReference);
+
+        // Only the first keyframe has no reference
+        EXPECT_EQ(i == 0 ? 39u : 27u, buffer.size());
+
+        PositionKeyframe decoded;
+        ASSERT_TRUE(decoded.deserialize(buffer.data(), buffer.size(), receivedReference));
+        EXPECT_EQ(keyframe._timeStamp, decoded._timeStamp);
+        EXPECT_LT(
+            glm::length(decoded._position.dvec3() - keyframe._position.dvec3()),
+            0.01
+        );
+        EXPECT_LT(
+            angleBetween(decoded._viewRotationQuat, keyframe._viewRotationQuat),
+            1e-4
+        );
+    }
+}
+
+TEST_F(MessageStructuresTest, RelativeKeyframesNeedReference) {
+    PositionReference sentReference;
+    PositionKeyframe keyframe;
+    keyframe._position = openspace::psc::CreatePowerScaledCoordinate(1.0, 2.0, 3.0);
+    keyframe._viewRotationQuat = glm::quat(1.f, 0.f, 0.f, 0.f);
+    keyframe._timeStamp = 0.0;
+
+    std::vector<char> absolute;
+    keyframe.serialize(absolute, sentReference);
+    std::vector<char> relative;
+    keyframe.serialize(relative, sentReference);
+
+    // A client that joins after the absolute keyframe can not read the relative one
+    PositionReference receivedReference;
+    PositionKeyframe decoded;
+    EXPECT_FALSE(decoded.deserialize(relative.data(), relative.size(), receivedReference));
+    EXPECT_TRUE(decoded.deserialize(absolute.data(), absolute.size(), receivedReference));
+    EXPECT_TRUE(decoded.deserialize(relative.data(), relative.size(), receivedReference));
+
+    // Truncated keyframes are rejected
+    EXPECT_FALSE(decoded.deserialize(relative.data(), relative.size() - 1, receivedReference));
+}
+
+TEST_F(MessageStructuresTest, TimeKeyframeRoundTrip) {
+    TimeKeyframe keyframe;
+    keyframe._time = 5.2e8;
+    keyframe._dt = -3600.0;
+    keyframe._paused = true;
+    keyframe._requiresTimeJump = false;
+
+    std::vector<char> buffer;
+    keyframe.serialize(buffer);
+    EXPECT_EQ(17u, buffer.size());
+
+    TimeKeyframe decoded;
+    ASSERT_TRUE(decoded.deserialize(buffer.data(), buffer.size()));
+    EXPECT_EQ(keyframe._time, decoded._time);
+    EXPECT_EQ(keyframe._dt, decoded._dt);
+    EXPECT_TRUE(decoded._paused);
+    EXPECT_FALSE(decoded._requiresTimeJump);
+}
+
+TEST_F(MessageStructuresTest, PropertyDiffIsSmallerThanScripts) {
+    PropertyMapping mapping;
+    PropertyDiff diff;
+    size_t scriptBytes = 0;
+    for (uint16_t i = 0; i < 50; ++i) {
+        std::string property = "Earth.RenderableGlobe.Layers.ColorLayer" +
+            std::to_string(i) + ".Opacity";
+        std::string value = std::to_string(i / 50.0);
+        mapping._entries.emplace_back(i, property);
+        diff._entries.emplace_back(i, value);
+
+        // The size of a ScriptMessage of the same change
+        std::string script = "openspace.setPropertyValue(\"" + property + "\"," + value + ");";
+        scriptBytes += sizeof(uint16_t) + script.length();
+    }
+
+    std::vector<char> mappingBuffer;
+    mapping.serialize(mappingBuffer);
+    std::vector<char> diffBuffer;
+    diff.serialize(diffBuffer);
+
+    // Once the properties are mapped, the changes take a fraction of the scripts
+    EXPECT_LT(diffBuffer.size() * 4, scriptBytes);
+
+    PropertyMapping decodedMapping;
+    ASSERT_TRUE(decodedMapping.deserialize(mappingBuffer.data(), mappingBuffer.size()));
+    EXPECT_EQ(mapping._entries, decodedMapping._entries);
+
+    PropertyDiff decodedDiff;
+    ASSERT_TRUE(decodedDiff.deserialize(diffBuffer.data(), diffBuffer.size()));
+    EXPECT_EQ(diff._entries, decodedDiff._entries);
+
+    EXPECT_FALSE(decodedDiff.deserialize(diffBuffer.data(), diffBuffer.size() - 1));
+}
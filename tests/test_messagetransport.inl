@@ -0,0 +1,259 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef WIN32
+
+#include "gtest/gtest.h"
+
+#include <openspace/network/messagetransport.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace openspace::network;
+
+/**
+ * A local stand-in for the parallel server, which echoes everything that it receives
+ * back to the single client that connects to it
+ */
+class EchoServer {
+public:
+    EchoServer()
+        : _listenSocket(socket(AF_INET, SOCK_STREAM, 0))
+        , _port(0)
+    {
+        int reuse = 1;
+        setsockopt(_listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        bind(_listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        listen(_listenSocket, 1);
+
+        socklen_t length = sizeof(address);
+        getsockname(_listenSocket, reinterpret_cast<sockaddr*>(&address), &length);
+        _port = ntohs(address.sin_port);
+
+        _thread = std::thread([this]() {
+            int client = accept(_listenSocket, nullptr, nullptr);
+            if (client < 0) {
+                return;
+            }
+            int noDelay = 1;
+            setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+            std::vector<char> buffer(64 * 1024);
+            while (true) {
+                ssize_t received = recv(client, buffer.data(), buffer.size(), 0);
+                if (received <= 0) {
+                    break;
+                }
+                ssize_t sent = 0;
+                while (sent < received) {
+                    ssize_t result = ::send(client, buffer.data() + sent, received - sent, 0);
+                    if (result <= 0) {
+                        break;
+                    }
+                    sent += result;
+                }
+            }
+            close(client);
+        });
+    }
+
+    ~EchoServer() {
+        shutdown(_listenSocket, SHUT_RDWR);
+        close(_listenSocket);
+        _thread.join();
+    }
+
+    std::string port() const {
+        return std::to_string(_port);
+    }
+
+private:
+    int _listenSocket;
+    int _port;
+    std::thread _thread;
+};
+
+class MessageTransportTest : public testing::Test {
+protected:
+    MessageTransportTest()
+        : transport(
+            [](const char* data, size_t size) -> size_t {
+                // Messages are prefixed with their total length
+                if (size < sizeof(uint32_t)) {
+                    return 0;
+                }
+                uint32_t length;
+                memcpy(&length, data, sizeof(length));
+                return length;
+            },
+            [this](const char* message, size_t size) {
+                std::lock_guard<std::mutex> lock(mutex);
+                uint32_t sequence;
+                memcpy(&sequence, message + sizeof(uint32_t), sizeof(sequence));
+                receivedSequences.push_back(sequence);
+                receivedBytes += size;
+                received.notify_all();
+            },
+            [this](bool isConnected) {
+                std::lock_guard<std::mutex> lock(mutex);
+                connectionChanges.push_back(isConnected);
+                received.notify_all();
+            }
+        )
+    {}
+
+    void connect() {
+        transport.connect("127.0.0.1", server.port());
+        std::unique_lock<std::mutex> lock(mutex);
+        received.wait_for(lock, std::chrono::seconds(5), [this]() {
+            return !connectionChanges.empty();
+        });
+        ASSERT_EQ(1u, connectionChanges.size());
+        ASSERT_TRUE(connectionChanges[0]);
+    }
+
+    void send(uint32_t sequence, size_t size) {
+        std::vector<char> message = transport.acquireBuffer();
+        message.resize(size);
+        uint32_t length = static_cast<uint32_t>(size);
+        memcpy(message.data(), &length, sizeof(length));
+        memcpy(message.data() + sizeof(length), &sequence, sizeof(sequence));
+        transport.send(std::move(message));
+    }
+
+    bool waitForMessages(size_t nMessages) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return received.wait_for(lock, std::chrono::seconds(10), [&]() {
+            return receivedSequences.size() >= nMessages;
+        });
+    }
+
+    EchoServer server;
+
+    std::mutex mutex;
+    std::condition_variable received;
+    std::vector<uint32_t> receivedSequences;
+    size_t receivedBytes = 0;
+    std::vector<bool> connectionChanges;
+
+    MessageTransport transport;
+};
+
+TEST_F(MessageTransportTest, MessagesArriveCompleteAndInOrder) {
+    connect();
+
+    // Sizes that split messages and headers across reads
+    const size_t nMessages = 2000;
+    size_t totalBytes = 0;
+    for (uint32_t i = 0; i < nMessages; ++i) {
+        size_t size = 8 + (i * 37) % 3000;
+        send(i, size);
+        totalBytes += size;
+    }
+
+    ASSERT_TRUE(waitForMessages(nMessages));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(nMessages, receivedSequences.size());
+    for (uint32_t i = 0; i < nMessages; ++i) {
+        EXPECT_EQ(i, receivedSequences[i]);
+    }
+    EXPECT_EQ(totalBytes, receivedBytes);
+
+    MessageTransport::Statistics statistics = transport.statistics();
+    EXPECT_EQ(nMessages, statistics.messagesSent);
+    EXPECT_EQ(totalBytes, statistics.bytesSent);
+    EXPECT_LE(statistics.writeCalls, statistics.messagesSent);
+}
+
+TEST_F(MessageTransportTest, RoundTripLatency) {
+    connect();
+
+    const size_t nRoundTrips = 1000;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < nRoundTrips; ++i) {
+        send(i, 64);
+        ASSERT_TRUE(waitForMessages(i + 1));
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::high_resolution_clock::now() - start;
+
+    RecordProperty(
+        "RoundTripMicroseconds",
+        static_cast<int>(elapsed.count() / nRoundTrips)
+    );
+}
+
+TEST_F(MessageTransportTest, Throughput) {
+    connect();
+
+    // About the size of a position keyframe message
+    const size_t nMessages = 200000;
+    const size_t messageSize = 64;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < nMessages; ++i) {
+        send(i, messageSize);
+    }
+    ASSERT_TRUE(waitForMessages(nMessages));
+    std::chrono::duration<double> elapsed =
+        std::chrono::high_resolution_clock::now() - start;
+
+    MessageTransport::Statistics statistics = transport.statistics();
+    RecordProperty("MessagesPerSecond", static_cast<int>(nMessages / elapsed.count()));
+    RecordProperty(
+        "MessagesPerWrite",
+        static_cast<int>(statistics.messagesSent / std::max<size_t>(statistics.writeCalls, 1))
+    );
+}
+
+TEST_F(MessageTransportTest, DisconnectIsReported) {
+    connect();
+    transport.disconnect();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(2u, connectionChanges.size());
+    EXPECT_FALSE(connectionChanges[1]);
+    EXPECT_FALSE(transport.isRunning());
+    EXPECT_FALSE(transport.isConnected());
+}
+
+#endif // WIN32
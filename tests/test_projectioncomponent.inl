@@ -0,0 +1,147 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/newhorizons/util/projectioncomponent.h>
+
+#include <set>
+
+class ProjectionComponentTest : public testing::Test {};
+
+using openspace::Image;
+using openspace::ProjectionComponent;
+
+namespace {
+    Image imageAt(int i) {
+        Image image;
+        image.startTime = static_cast<double>(i);
+        image.path = "image" + std::to_string(i) + ".png";
+        return image;
+    }
+}
+
+TEST_F(ProjectionComponentTest, PrefetchStartsWithBacklog) {
+    std::vector<Image> backlog = { imageAt(0), imageAt(1) };
+    std::vector<Image> upcoming = { imageAt(2), imageAt(3), imageAt(4) };
+
+    std::vector<Image> prefetch = ProjectionComponent::imagesToPrefetch(
+        backlog,
+        upcoming,
+        4
+    );
+    ASSERT_EQ(4, prefetch.size());
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(imageAt(i).path, prefetch[i].path);
+}
+
+TEST_F(ProjectionComponentTest, PrefetchIsLimitedByLongBacklog) {
+    std::vector<Image> backlog;
+    for (int i = 0; i < 100; ++i)
+        backlog.push_back(imageAt(i));
+    std::vector<Image> upcoming = { imageAt(100) };
+
+    // The prefetcher reads no further ahead than the number of images, however long the
+    // backlog is
+    std::vector<Image> prefetch = ProjectionComponent::imagesToPrefetch(
+        backlog,
+        upcoming,
+        8
+    );
+    ASSERT_EQ(8, prefetch.size());
+    EXPECT_EQ(imageAt(0).path, prefetch.front().path);
+    EXPECT_EQ(imageAt(7).path, prefetch.back().path);
+}
+
+TEST_F(ProjectionComponentTest, ProjectionWaitsForPrefetchedImages) {
+    std::vector<Image> backlog = { imageAt(0), imageAt(1), imageAt(2) };
+
+    // The first image is projected even if it was not prefetched, the following ones
+    // only once they are ready
+    std::vector<std::string> projected;
+    size_t nProjected = ProjectionComponent::projectReadyImages(
+        backlog,
+        [](const Image&) { return false; },
+        [&projected](const Image& img) { projected.push_back(img.path); }
+    );
+    EXPECT_EQ(1, nProjected);
+    ASSERT_EQ(1, projected.size());
+    EXPECT_EQ(imageAt(0).path, projected[0]);
+    ASSERT_EQ(2, backlog.size());
+    EXPECT_EQ(imageAt(1).path, backlog.front().path);
+}
+
+TEST_F(ProjectionComponentTest, LongSequenceIsProjectedCompletely) {
+    const int nImages = 10000;
+    const int nCapturedPerFrame = 40;
+    const size_t nPrefetched = 32;
+    // The prefetcher reads fewer images per frame than are captured
+    const size_t nReadPerFrame = 10;
+
+    std::vector<Image> backlog;
+    std::set<std::string> ready;
+    std::vector<int> projected;
+    size_t maximumPrefetch = 0;
+
+    int nextImage = 0;
+    int nFrames = 0;
+    while (nextImage < nImages || !backlog.empty()) {
+        for (int i = 0; i < nCapturedPerFrame && nextImage < nImages; ++i)
+            backlog.push_back(imageAt(nextImage++));
+
+        std::vector<Image> upcoming;
+        for (int i = nextImage; i < std::min(nextImage + 8, nImages); ++i)
+            upcoming.push_back(imageAt(i));
+        std::vector<Image> prefetch = ProjectionComponent::imagesToPrefetch(
+            backlog,
+            upcoming,
+            nPrefetched
+        );
+        maximumPrefetch = std::max(maximumPrefetch, prefetch.size());
+        size_t nRead = 0;
+        for (const Image& img : prefetch) {
+            if (nRead == nReadPerFrame)
+                break;
+            if (ready.insert(img.path).second)
+                ++nRead;
+        }
+
+        ProjectionComponent::projectReadyImages(
+            backlog,
+            [&ready](const Image& img) { return ready.count(img.path) > 0; },
+            [&projected, &ready](const Image& img) {
+                projected.push_back(static_cast<int>(img.startTime));
+                ready.erase(img.path);
+            }
+        );
+        ++nFrames;
+        ASSERT_LT(nFrames, 10 * nImages) << "The backlog does not shrink";
+    }
+
+    // Every image is projected exactly once and in the order it was captured
+    ASSERT_EQ(nImages, projected.size());
+    for (int i = 0; i < nImages; ++i)
+        EXPECT_EQ(i, projected[i]);
+    EXPECT_LE(maximumPrefetch, nPrefetched);
+}
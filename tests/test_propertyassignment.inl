@@ -0,0 +1,263 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/properties/scalarproperty.h>
+#include <openspace/properties/vectorproperty.h>
+#include <openspace/scripting/propertyassignment.h>
+#include <openspace/util/syncbuffer.h>
+
+#include <ghoul/lua/lua_helper.h>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using openspace::scripting::PropertyAssignment;
+
+class PropertyAssignmentTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _state = ghoul::lua::createNewLuaState();
+    }
+
+    void TearDown() override {
+        ghoul::lua::destroyLuaState(_state);
+    }
+
+    void apply(const PropertyAssignment& assignment, openspace::properties::Property& p) {
+        ASSERT_EQ(p.typeLua(), assignment.luaType());
+        assignment.pushValue(_state);
+        p.setLuaValue(_state);
+        lua_pop(_state, 1);
+    }
+
+    lua_State* _state;
+};
+
+TEST_F(PropertyAssignmentTest, FromScript) {
+    PropertyAssignment a;
+    ASSERT_TRUE(PropertyAssignment::fromScript(
+        "openspace.setPropertyValueSingle(\"Earth.renderable.enabled\", true)", a
+    ));
+    EXPECT_EQ("Earth.renderable.enabled", a.uri());
+    EXPECT_EQ(PropertyAssignment::Type::Boolean, a.type());
+
+    ASSERT_TRUE(PropertyAssignment::fromScript(
+        "  openspace.setPropertyValue('A.b', -1.5e3 ) ; ", a
+    ));
+    EXPECT_EQ(PropertyAssignment::Type::Number, a.type());
+    EXPECT_EQ("-1500", a.literal());
+
+    ASSERT_TRUE(PropertyAssignment::fromScript(
+        "openspace.setPropertyValue('A.b', {1, 2.5, -3,})", a
+    ));
+    EXPECT_EQ(PropertyAssignment::Type::NumberTable, a.type());
+    EXPECT_EQ("{1,2.5,-3}", a.literal());
+
+    ASSERT_TRUE(PropertyAssignment::fromScript(
+        "openspace.setPropertyValueSingle('A.b', 'x\\'y')", a
+    ));
+    EXPECT_EQ(PropertyAssignment::Type::String, a.type());
+    EXPECT_EQ("\"x'y\"", a.literal());
+}
+
+TEST_F(PropertyAssignmentTest, ScriptsThatNeedTheInterpreter) {
+    PropertyAssignment a;
+    // Wildcards can match more than one property
+    EXPECT_FALSE(PropertyAssignment::fromScript("openspace.setPropertyValue('A.*', 1)", a));
+    // Expressions, variables and multiple statements
+    EXPECT_FALSE(PropertyAssignment::fromScript(
+        "openspace.setPropertyValueSingle('A.b', 1 + 2)", a
+    ));
+    EXPECT_FALSE(PropertyAssignment::fromScript(
+        "openspace.setPropertyValueSingle('A.b', inf)", a
+    ));
+    EXPECT_FALSE(PropertyAssignment::fromScript(
+        "openspace.setPropertyValueSingle('A.b', 1..2)", a
+    ));
+    EXPECT_FALSE(PropertyAssignment::fromScript(
+        "openspace.setPropertyValueSingle('A.b', {1, x})", a
+    ));
+    EXPECT_FALSE(PropertyAssignment::fromScript(
+        "openspace.setPropertyValueSingle('A.b', 1); print(2)", a
+    ));
+    EXPECT_FALSE(PropertyAssignment::fromScript(
+        "openspace.setPropertyValueSingle('A.b', 1) -- comment", a
+    ));
+    EXPECT_FALSE(PropertyAssignment::fromScript(
+        "openspace.setPropertyValueSingleX('A.b', 1)", a
+    ));
+}
+
+TEST_F(PropertyAssignmentTest, ScriptRoundTrip) {
+    std::vector<PropertyAssignment> assignments = {
+        PropertyAssignment("A.b", true),
+        PropertyAssignment("A.b", 0.1),
+        PropertyAssignment("A\"b", "q\nr"),
+        PropertyAssignment("A.b", std::vector<double>{ 1.0, -2.0, 1e-20 })
+    };
+    for (const PropertyAssignment& a : assignments) {
+        PropertyAssignment b;
+        ASSERT_TRUE(PropertyAssignment::fromScript(a.script(), b)) << a.script();
+        EXPECT_EQ(a.uri(), b.uri());
+        EXPECT_EQ(a.literal(), b.literal());
+    }
+}
+
+TEST_F(PropertyAssignmentTest, Serialization) {
+    std::vector<PropertyAssignment> assignments = {
+        PropertyAssignment("a", false),
+        PropertyAssignment("b", 2.5),
+        PropertyAssignment("c", "string"),
+        PropertyAssignment("d", std::vector<double>{ 1.0, 2.0, 3.0 })
+    };
+
+    openspace::SyncBuffer buffer(1024);
+    for (const PropertyAssignment& a : assignments)
+        a.serialize(buffer);
+    // The encoded bytes are decoded from the same buffer without synchronizing them
+    for (const PropertyAssignment& a : assignments) {
+        PropertyAssignment b;
+        ASSERT_TRUE(b.deserialize(buffer));
+        EXPECT_EQ(a.script(), b.script());
+    }
+
+    // An unknown type is rejected
+    buffer.encode(std::string("e"));
+    buffer.encode(static_cast<uint8_t>(4));
+    PropertyAssignment c;
+    EXPECT_FALSE(c.deserialize(buffer));
+}
+
+TEST_F(PropertyAssignmentTest, ApplyToProperties) {
+    openspace::properties::BoolProperty b("b", "B", false);
+    openspace::properties::FloatProperty f("f", "F", 0.f, -10.f, 10.f);
+    openspace::properties::Vec3Property v("v", "V", glm::vec3(0.f));
+
+    PropertyAssignment a;
+    ASSERT_TRUE(PropertyAssignment::fromLiteral("b", "true", a));
+    apply(a, b);
+    EXPECT_TRUE(b.value());
+
+    ASSERT_TRUE(PropertyAssignment::fromLiteral("f", "2.5", a));
+    apply(a, f);
+    EXPECT_EQ(2.5f, f.value());
+
+    ASSERT_TRUE(PropertyAssignment::fromLiteral("v", "{1, 2, 3}", a));
+    apply(a, v);
+    EXPECT_EQ(glm::vec3(1.f, 2.f, 3.f), v.value());
+
+    EXPECT_EQ(0, lua_gettop(_state));
+}
+
+namespace {
+    std::map<std::string, openspace::properties::Property*>* benchmarkProperties;
+
+    // Does the same work as the setPropertyValueSingle binding without the scene lookup
+    int benchmarkSetValue(lua_State* L) {
+        std::string uri = luaL_checkstring(L, -2);
+        auto it = benchmarkProperties->find(uri);
+        if (it != benchmarkProperties->end() && lua_type(L, -1) == it->second->typeLua())
+            it->second->setLuaValue(L);
+        return 0;
+    }
+}
+
+TEST_F(PropertyAssignmentTest, Benchmark) {
+    // One frame of 10000 property assignments to 100 properties
+    const int nProperties = 100;
+    const int nAssignments = 10000;
+
+    std::vector<std::unique_ptr<openspace::properties::FloatProperty>> properties;
+    std::map<std::string, openspace::properties::Property*> propertyMap;
+    for (int i = 0; i < nProperties; ++i) {
+        std::string id = "p" + std::to_string(i);
+        properties.emplace_back(
+            new openspace::properties::FloatProperty(id, id, 0.f, -1e6f, 1e6f)
+        );
+        propertyMap["Node." + id] = properties.back().get();
+    }
+    benchmarkProperties = &propertyMap;
+
+    std::vector<std::string> scripts;
+    for (int i = 0; i < nAssignments; ++i) {
+        scripts.push_back(
+            "openspace.setPropertyValueSingle(\"Node.p" + std::to_string(i % nProperties) +
+            "\", " + std::to_string(i) + ")"
+        );
+    }
+
+    lua_newtable(_state);
+    lua_pushcfunction(_state, benchmarkSetValue);
+    lua_setfield(_state, -2, "setPropertyValueSingle");
+    lua_setglobal(_state, "openspace");
+
+    using Clock = std::chrono::high_resolution_clock;
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    // Lua interpreter
+    auto start = Clock::now();
+    for (const std::string& script : scripts) {
+        ASSERT_EQ(0, luaL_loadstring(_state, script.c_str()));
+        ASSERT_EQ(0, lua_pcall(_state, 0, 0, 0));
+    }
+    Milliseconds interpreterTime = Clock::now() - start;
+    EXPECT_EQ(static_cast<float>(nAssignments - 1), properties.back()->value());
+
+    // Scripts that are recognized as assignments
+    start = Clock::now();
+    for (const std::string& script : scripts) {
+        PropertyAssignment assignment;
+        ASSERT_TRUE(PropertyAssignment::fromScript(script, assignment));
+        apply(assignment, *propertyMap[assignment.uri()]);
+    }
+    Milliseconds parsedTime = Clock::now() - start;
+
+    // Assignments that are created by the producer
+    std::vector<PropertyAssignment> assignments;
+    for (int i = 0; i < nAssignments; ++i) {
+        assignments.emplace_back(
+            "Node.p" + std::to_string(i % nProperties),
+            static_cast<double>(i)
+        );
+    }
+    start = Clock::now();
+    for (const PropertyAssignment& assignment : assignments)
+        apply(assignment, *propertyMap[assignment.uri()]);
+    Milliseconds structuredTime = Clock::now() - start;
+    EXPECT_EQ(static_cast<float>(nAssignments - 1), properties.back()->value());
+
+    RecordProperty("Assignments", nAssignments);
+    RecordProperty("InterpreterMicroseconds",
+        static_cast<int>(1000.0 * interpreterTime.count()));
+    RecordProperty("ParsedMicroseconds", static_cast<int>(1000.0 * parsedTime.count()));
+    RecordProperty("StructuredMicroseconds",
+        static_cast<int>(1000.0 * structuredTime.count()));
+
+    benchmarkProperties = nullptr;
+}
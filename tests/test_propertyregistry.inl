@@ -0,0 +1,183 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/properties/propertyowner.h>
+#include <openspace/properties/propertyregistry.h>
+#include <openspace/properties/scalarproperty.h>
+
+#include <algorithm>
+#include <vector>
+
+using openspace::properties::FloatProperty;
+using openspace::properties::Property;
+using openspace::properties::PropertyOwner;
+using openspace::properties::PropertyRegistry;
+
+class PropertyRegistryTest : public testing::Test {
+protected:
+    void SetUp() override {
+        // Discard the changes of previous tests
+        PropertyRegistry::ref().finishFrame();
+        PropertyRegistry::ref().finishFrame();
+    }
+
+    static bool contains(const std::vector<Property*>& properties, Property* p) {
+        return std::find(properties.begin(), properties.end(), p) != properties.end();
+    }
+};
+
+TEST_F(PropertyRegistryTest, MultipleListeners) {
+    FloatProperty p("p", "P", 0.f);
+
+    int nCallback = 0;
+    int nFirst = 0;
+    int nSecond = 0;
+    p.onChange([&nCallback]() { ++nCallback; });
+    Property::OnChangeHandle first = p.addOnChangeListener([&nFirst]() { ++nFirst; });
+    p.addOnChangeListener([&nSecond]() { ++nSecond; });
+
+    p = 1.f;
+    EXPECT_EQ(1, nCallback);
+    EXPECT_EQ(1, nFirst);
+    EXPECT_EQ(1, nSecond);
+
+    p.removeOnChangeListener(first);
+    p = 2.f;
+    EXPECT_EQ(2, nCallback);
+    EXPECT_EQ(1, nFirst);
+    EXPECT_EQ(2, nSecond);
+
+    // Unknown handles are ignored
+    p.removeOnChangeListener(first);
+    p = 3.f;
+    EXPECT_EQ(3, nSecond);
+}
+
+TEST_F(PropertyRegistryTest, ListenersCanRemoveListeners) {
+    FloatProperty p("p", "P", 0.f);
+
+    int nFirst = 0;
+    int nSecond = 0;
+    Property::OnChangeHandle first = 0;
+    first = p.addOnChangeListener([&]() {
+        ++nFirst;
+        p.removeOnChangeListener(first);
+        p.addOnChangeListener([&nSecond]() { ++nSecond; });
+    });
+
+    p = 1.f;
+    EXPECT_EQ(1, nFirst);
+    EXPECT_EQ(0, nSecond) << "Listeners added during a notification are not notified";
+
+    p = 2.f;
+    EXPECT_EQ(1, nFirst);
+    EXPECT_EQ(1, nSecond);
+}
+
+TEST_F(PropertyRegistryTest, ChangedPropertiesPerFrame) {
+    FloatProperty a("a", "A", 0.f);
+    FloatProperty b("b", "B", 0.f);
+
+    a = 1.f;
+    a = 2.f;
+    // Changes only become visible at the end of the frame
+    EXPECT_TRUE(PropertyRegistry::ref().changedProperties().empty());
+
+    PropertyRegistry::ref().finishFrame();
+    std::vector<Property*> changed = PropertyRegistry::ref().changedProperties();
+    ASSERT_EQ(1, changed.size());
+    EXPECT_EQ(&a, changed[0]);
+
+    b = 1.f;
+    PropertyRegistry::ref().finishFrame();
+    changed = PropertyRegistry::ref().changedProperties();
+    EXPECT_FALSE(contains(changed, &a));
+    EXPECT_TRUE(contains(changed, &b));
+
+    PropertyRegistry::ref().finishFrame();
+    EXPECT_TRUE(PropertyRegistry::ref().changedProperties().empty());
+}
+
+TEST_F(PropertyRegistryTest, DestroyedPropertiesAreRemoved) {
+    {
+        FloatProperty a("a", "A", 0.f);
+        a = 1.f;
+    }
+    PropertyRegistry::ref().finishFrame();
+    EXPECT_TRUE(PropertyRegistry::ref().changedProperties().empty());
+
+    {
+        FloatProperty a("a", "A", 0.f);
+        a = 1.f;
+        PropertyRegistry::ref().finishFrame();
+        EXPECT_EQ(1, PropertyRegistry::ref().changedProperties().size());
+    }
+    EXPECT_TRUE(PropertyRegistry::ref().changedProperties().empty());
+}
+
+TEST_F(PropertyRegistryTest, UriCache) {
+    PropertyRegistry& registry = PropertyRegistry::ref();
+
+    PropertyOwner owner;
+    owner.setName("Owner");
+    FloatProperty a("a", "A", 0.f);
+    owner.addProperty(a);
+
+    EXPECT_EQ(nullptr, registry.property("Owner.a"));
+    registry.cacheProperty("Owner.a", &a, registry.generation());
+    EXPECT_EQ(&a, registry.property("Owner.a"));
+
+    // Renaming the owner changes the URI of the Property
+    owner.setName("Renamed");
+    EXPECT_EQ(nullptr, registry.property("Owner.a"));
+    registry.cacheProperty("Renamed.a", &a, registry.generation());
+    EXPECT_EQ(&a, registry.property("Renamed.a"));
+
+    owner.removeProperty(a);
+    EXPECT_EQ(nullptr, registry.property("Renamed.a"));
+
+    {
+        FloatProperty b("b", "B", 0.f);
+        registry.cacheProperty("Renamed.b", &b, registry.generation());
+        EXPECT_EQ(&b, registry.property("Renamed.b"));
+    }
+    EXPECT_EQ(nullptr, registry.property("Renamed.b"));
+}
+
+TEST_F(PropertyRegistryTest, StaleLookupsAreNotCached) {
+    PropertyRegistry& registry = PropertyRegistry::ref();
+
+    PropertyOwner owner;
+    owner.setName("Owner");
+    FloatProperty a("a", "A", 0.f);
+    owner.addProperty(a);
+
+    // The Property is removed while it is looked up
+    size_t generation = registry.generation();
+    owner.removeProperty(a);
+    registry.cacheProperty("Owner.a", &a, generation);
+    EXPECT_EQ(nullptr, registry.property("Owner.a"));
+}
@@ -0,0 +1,226 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <openspace/rendering/renderable.h>
+#include <openspace/scene/sceneinitializer.h>
+#include <openspace/scene/scenegraphnode.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace openspace;
+
+namespace {
+
+// Records the order in which the two phases of the nodes start and finish
+class InitializationLog {
+public:
+    void add(const std::string& event) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _events.push_back(event);
+    }
+
+    // Returns the position of the event in the log or -1 if it did not happen
+    int position(const std::string& event) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = std::find(_events.begin(), _events.end(), event);
+        return it == _events.end() ? -1 : static_cast<int>(it - _events.begin());
+    }
+
+    std::vector<std::string> events(const std::string& prefix) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<std::string> result;
+        for (const std::string& event : _events) {
+            if (event.compare(0, prefix.size(), prefix) == 0)
+                result.push_back(event.substr(prefix.size()));
+        }
+        return result;
+    }
+
+private:
+    mutable std::mutex _mutex;
+    std::vector<std::string> _events;
+};
+
+class LoggingRenderable : public Renderable {
+public:
+    LoggingRenderable(std::string name, InitializationLog& log,
+                      std::chrono::milliseconds dataTime,
+                      std::chrono::milliseconds uploadTime)
+        : _nodeName(std::move(name))
+        , _log(log)
+        , _dataTime(dataTime)
+        , _uploadTime(uploadTime)
+    {}
+
+    bool initializeData() override {
+        _log.add("data start " + _nodeName);
+        std::this_thread::sleep_for(_dataTime);
+        _log.add("data finish " + _nodeName);
+        return true;
+    }
+
+    bool initialize() override {
+        _log.add("upload " + _nodeName);
+        std::this_thread::sleep_for(_uploadTime);
+        return true;
+    }
+
+    bool deinitialize() override { return true; }
+    bool isReady() const override { return true; }
+
+private:
+    std::string _nodeName;
+    InitializationLog& _log;
+    std::chrono::milliseconds _dataTime;
+    std::chrono::milliseconds _uploadTime;
+};
+
+} // namespace
+
+class SceneInitializerTest : public testing::Test {
+protected:
+    SceneGraphNode* addNode(const std::string& name,
+                            std::vector<std::string> dependencies,
+                            std::chrono::milliseconds dataTime,
+                            std::chrono::milliseconds uploadTime)
+    {
+        std::unique_ptr<SceneGraphNode> node(new SceneGraphNode);
+        node->setName(name);
+        node->setRenderable(new LoggingRenderable(name, _log, dataTime, uploadTime));
+        for (const std::string& dependency : dependencies)
+            _dependencies[node.get()].push_back(_nodesByName.at(dependency));
+
+        _nodesByName[name] = node.get();
+        _order.push_back(node.get());
+        _nodes.push_back(std::move(node));
+        return _nodes.back().get();
+    }
+
+    SceneInitializer::DependencyFunction dependencyFunction() const {
+        return [this](SceneGraphNode* node) {
+            auto it = _dependencies.find(node);
+            return it == _dependencies.end() ?
+                std::vector<SceneGraphNode*>() : it->second;
+        };
+    }
+
+    InitializationLog _log;
+    std::vector<std::unique_ptr<SceneGraphNode>> _nodes;
+    std::vector<SceneGraphNode*> _order;
+    std::map<std::string, SceneGraphNode*> _nodesByName;
+    std::map<SceneGraphNode*, std::vector<SceneGraphNode*>> _dependencies;
+};
+
+TEST_F(SceneInitializerTest, DependenciesAreInitializedFirst) {
+    using std::chrono::milliseconds;
+
+    // Root -> Sun -> (Earth -> Moon, Mars); Mars also depends on the Moon
+    addNode("Root", {}, milliseconds(1), milliseconds(0));
+    addNode("Sun", { "Root" }, milliseconds(5), milliseconds(0));
+    addNode("Earth", { "Sun" }, milliseconds(1), milliseconds(0));
+    addNode("Moon", { "Earth" }, milliseconds(10), milliseconds(0));
+    addNode("Mars", { "Sun", "Moon" }, milliseconds(1), milliseconds(0));
+    // Independent of everything but the root, so it can load while the others wait
+    addNode("Stars", { "Root" }, milliseconds(20), milliseconds(0));
+
+    SceneInitializer initializer(_order, dependencyFunction(), 4);
+    for (int i = 0; i < 1000 && !initializer.update(std::chrono::microseconds(0)); ++i)
+        std::this_thread::sleep_for(milliseconds(1));
+    ASSERT_TRUE(initializer.isFinished());
+    EXPECT_EQ(_order.size(), initializer.numberOfInitializedNodes());
+
+    for (const auto& node : _dependencies) {
+        const std::string name = node.first->name();
+        for (SceneGraphNode* dependency : node.second) {
+            EXPECT_LT(
+                _log.position("data finish " + dependency->name()),
+                _log.position("data start " + name)
+            ) << name << " was loaded before " << dependency->name();
+        }
+    }
+
+    // Uploads happen in the given order and after the data of each node has been loaded
+    std::vector<std::string> uploads = _log.events("upload ");
+    std::vector<std::string> expected;
+    for (SceneGraphNode* node : _order)
+        expected.push_back(node->name());
+    EXPECT_EQ(expected, uploads);
+    for (const std::string& name : uploads) {
+        EXPECT_LT(_log.position("data finish " + name), _log.position("upload " + name));
+    }
+}
+
+TEST_F(SceneInitializerTest, UploadsStayWithinBudget) {
+    using std::chrono::milliseconds;
+
+    addNode("Root", {}, milliseconds(0), milliseconds(2));
+    for (int i = 0; i < 10; ++i)
+        addNode("Node" + std::to_string(i), { "Root" }, milliseconds(0), milliseconds(2));
+
+    SceneInitializer initializer(_order, dependencyFunction(), 2);
+
+    // Once a node exceeds the budget of 3 ms, the rest waits for the next frame
+    size_t nFrames = 0;
+    size_t nInitialized = 0;
+    while (!initializer.isFinished() && nFrames < 1000) {
+        initializer.update(std::chrono::microseconds(3000));
+        size_t nUploaded = initializer.numberOfInitializedNodes() - nInitialized;
+        EXPECT_LE(nUploaded, 2) << "Frame " << nFrames << " exceeded its budget";
+        nInitialized = initializer.numberOfInitializedNodes();
+        ++nFrames;
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    ASSERT_TRUE(initializer.isFinished());
+    EXPECT_GE(nFrames, _order.size() / 2);
+}
+
+TEST_F(SceneInitializerTest, ZeroBudgetUploadsOneNodePerFrame) {
+    using std::chrono::milliseconds;
+
+    addNode("Root", {}, milliseconds(0), milliseconds(1));
+    for (int i = 0; i < 5; ++i)
+        addNode("Node" + std::to_string(i), { "Root" }, milliseconds(0), milliseconds(1));
+
+    SceneInitializer initializer(_order, dependencyFunction(), 2);
+
+    size_t nFrames = 0;
+    size_t nInitialized = 0;
+    while (!initializer.isFinished() && nFrames < 1000) {
+        initializer.update(std::chrono::microseconds(0));
+        EXPECT_LE(initializer.numberOfInitializedNodes() - nInitialized, 1);
+        nInitialized = initializer.numberOfInitializedNodes();
+        ++nFrames;
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    ASSERT_TRUE(initializer.isFinished());
+    EXPECT_GE(nFrames, _order.size());
+}
@@ -0,0 +1,209 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/scripting/scriptcache.h>
+
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/dictionary.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using openspace::scripting::ScriptCache;
+
+class ScriptCacheTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _state = ghoul::lua::createNewLuaState();
+    }
+
+    void TearDown() override {
+        _cache.clear();
+        ghoul::lua::destroyLuaState(_state);
+    }
+
+    void run(const std::string& script) {
+        _cache.loadScript(_state, script);
+        ASSERT_EQ(0, lua_pcall(_state, 0, 0, 0)) << lua_tostring(_state, -1);
+    }
+
+    double global(const std::string& name) {
+        lua_getglobal(_state, name.c_str());
+        double value = lua_tonumber(_state, -1);
+        lua_pop(_state, 1);
+        return value;
+    }
+
+    // Runs all scripts the number of times and returns the number of scripts per second
+    double scriptsPerSecond(const std::vector<std::string>& scripts, int nRepetitions) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < nRepetitions; ++i) {
+            for (const std::string& script : scripts)
+                run(script);
+        }
+        std::chrono::duration<double> time =
+            std::chrono::high_resolution_clock::now() - start;
+        return (nRepetitions * scripts.size()) / time.count();
+    }
+
+    lua_State* _state;
+    ScriptCache _cache;
+};
+
+TEST_F(ScriptCacheTest, CachedScriptsAreRunAgain) {
+    run("counter = (counter or 0) + 1");
+    run("counter = (counter or 0) + 1");
+    EXPECT_EQ(2.0, global("counter"));
+    EXPECT_EQ(1, _cache.numberOfMisses());
+    EXPECT_EQ(1, _cache.numberOfHits());
+
+    // Cached chunks see the current globals
+    run("value = counter * 10");
+    run("counter = 5");
+    run("value = counter * 10");
+    EXPECT_EQ(50.0, global("value"));
+
+    // The stack is left as it was
+    EXPECT_EQ(0, lua_gettop(_state));
+}
+
+TEST_F(ScriptCacheTest, LeastRecentlyUsedIsEvicted) {
+    ScriptCache cache(2);
+    cache.loadScript(_state, "a = 1");
+    cache.loadScript(_state, "b = 1");
+    cache.loadScript(_state, "a = 1");
+    cache.loadScript(_state, "c = 1");
+    lua_settop(_state, 0);
+    EXPECT_EQ(3, cache.numberOfMisses());
+    EXPECT_EQ(1, cache.numberOfHits());
+
+    cache.loadScript(_state, "a = 1");
+    EXPECT_EQ(2, cache.numberOfHits());
+    cache.loadScript(_state, "b = 1");
+    EXPECT_EQ(4, cache.numberOfMisses());
+    lua_settop(_state, 0);
+    cache.clear();
+}
+
+TEST_F(ScriptCacheTest, CompilationErrors) {
+    EXPECT_THROW(
+        _cache.loadScript(_state, "this is not lua"),
+        ghoul::lua::LuaLoadingException
+    );
+    EXPECT_EQ(0, lua_gettop(_state));
+
+    // Failed scripts are not cached
+    EXPECT_THROW(
+        _cache.loadScript(_state, "this is not lua"),
+        ghoul::lua::LuaLoadingException
+    );
+    EXPECT_EQ(0, _cache.numberOfHits());
+}
+
+TEST_F(ScriptCacheTest, Disabled) {
+    _cache.setEnabled(false);
+    run("counter = (counter or 0) + 1");
+    run("counter = (counter or 0) + 1");
+    EXPECT_EQ(2.0, global("counter"));
+    EXPECT_EQ(0, _cache.numberOfHits());
+    EXPECT_EQ(0, _cache.numberOfMisses());
+}
+
+TEST_F(ScriptCacheTest, ScriptThroughput) {
+    // Scripts of the size of typical property assignments in show scripts
+    std::vector<std::string> scripts;
+    for (int i = 0; i < 50; ++i) {
+        scripts.push_back(
+            "local t = { Name = 'Node" + std::to_string(i) + "', Value = " +
+            std::to_string(i) + " } value = t.Value * 2"
+        );
+    }
+    const int nRepetitions = 100;
+
+    _cache.setEnabled(false);
+    double uncached = scriptsPerSecond(scripts, nRepetitions);
+    _cache.setEnabled(true);
+    double cached = scriptsPerSecond(scripts, nRepetitions);
+
+    RecordProperty("UncachedScriptsPerSecond", static_cast<int>(uncached));
+    RecordProperty("CachedScriptsPerSecond", static_cast<int>(cached));
+    EXPECT_EQ(scripts.size() * (nRepetitions - 1), _cache.numberOfHits());
+}
+
+TEST_F(ScriptCacheTest, FileBytecodeCache) {
+    if (!FileSys.cacheManager())
+        return;
+
+    // Neither the module file nor its bytecode outlive the test
+    const ghoul::filesystem::CacheManager::Persistent Persistent =
+        ghoul::filesystem::CacheManager::Persistent::No;
+
+    // A module file with a few nodes
+    std::string file = FileSys.cacheManager()->cachedFilename(
+        "scriptcachetest.mod",
+        "",
+        Persistent
+    );
+    {
+        std::ofstream stream(file);
+        stream << "return {\n";
+        for (int i = 0; i < 100; ++i) {
+            stream << "  { Name = 'Node" << i << "', Parent = 'Root', " <<
+                "Renderable = { Type = 'RenderablePlanet', Radius = { " << i <<
+                ", 6 } } },\n";
+        }
+        stream << "}\n";
+    }
+
+    using Clock = std::chrono::high_resolution_clock;
+    ghoul::Dictionary fromSource;
+    auto start = Clock::now();
+    openspace::scripting::loadDictionaryFromFile(file, fromSource, _state, Persistent);
+    std::chrono::duration<double, std::milli> sourceTime = Clock::now() - start;
+
+    ghoul::Dictionary fromBytecode;
+    start = Clock::now();
+    openspace::scripting::loadDictionaryFromFile(file, fromBytecode, _state, Persistent);
+    std::chrono::duration<double, std::milli> bytecodeTime = Clock::now() - start;
+
+    RecordProperty("SourceMicroseconds", static_cast<int>(1000.0 * sourceTime.count()));
+    RecordProperty("BytecodeMicroseconds",
+        static_cast<int>(1000.0 * bytecodeTime.count()));
+
+    ASSERT_EQ(100, fromSource.size());
+    ASSERT_EQ(100, fromBytecode.size());
+    EXPECT_EQ(
+        fromSource.value<std::string>("100.Name"),
+        fromBytecode.value<std::string>("100.Name")
+    );
+    EXPECT_EQ(0, lua_gettop(_state));
+
+    FileSys.deleteFile(file);
+}
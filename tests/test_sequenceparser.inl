@@ -0,0 +1,281 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/newhorizons/util/labelparser.h>
+#include <modules/newhorizons/util/sequenceparser.h>
+
+#include <openspace/util/spicemanager.h>
+
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/dictionary.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace openspace;
+
+namespace {
+
+class CachingParser : public SequenceParser {
+public:
+    bool create() override { return true; }
+    std::map<std::string, Decoder*> getTranslation() override { return {}; }
+
+    void fill() {
+        Image image;
+        image.startTime = 10.0;
+        image.stopTime = 12.0;
+        image.path = "image.jpg";
+        image.activeInstruments = { "SC_CAM", "SC_SCAN" };
+        image.target = "TARGET";
+        image.isPlaceholder = true;
+        _subsetMap["TARGET"]._subset.push_back(image);
+        _subsetMap["TARGET"]._range.setRange(10.0);
+
+        TimeRange range;
+        range._min = 10.0;
+        range._max = 12.0;
+        _instrumentTimes.push_back({ "CAM", range });
+        _targetTimes.push_back({ 10.0, "TARGET" });
+        _captureProgression = { 10.0, 11.0 };
+    }
+
+    bool load(const std::string& information) {
+        return loadCachedData(CacheName, information);
+    }
+
+    bool save(const std::string& information) const {
+        return saveCachedData(CacheName, information);
+    }
+
+    static std::string kernels() {
+        return kernelInformation();
+    }
+
+private:
+    const std::string CacheName = "SequenceParserTest";
+};
+
+void expectEqualData(SequenceParser& expected, SequenceParser& actual) {
+    std::map<std::string, ImageSubset> expectedSubsets = expected.getSubsetMap();
+    std::map<std::string, ImageSubset> actualSubsets = actual.getSubsetMap();
+    ASSERT_EQ(expectedSubsets.size(), actualSubsets.size());
+    for (const auto& subset : expectedSubsets) {
+        auto it = actualSubsets.find(subset.first);
+        ASSERT_NE(actualSubsets.end(), it) << subset.first;
+        EXPECT_EQ(subset.second._range._min, it->second._range._min);
+        EXPECT_EQ(subset.second._range._max, it->second._range._max);
+
+        const std::vector<Image>& expectedImages = subset.second._subset;
+        const std::vector<Image>& actualImages = it->second._subset;
+        ASSERT_EQ(expectedImages.size(), actualImages.size());
+        for (size_t i = 0; i < expectedImages.size(); ++i) {
+            EXPECT_EQ(expectedImages[i].startTime, actualImages[i].startTime);
+            EXPECT_EQ(expectedImages[i].stopTime, actualImages[i].stopTime);
+            EXPECT_EQ(expectedImages[i].path, actualImages[i].path);
+            EXPECT_EQ(
+                expectedImages[i].activeInstruments,
+                actualImages[i].activeInstruments
+            );
+            EXPECT_EQ(expectedImages[i].target, actualImages[i].target);
+            EXPECT_EQ(expectedImages[i].isPlaceholder, actualImages[i].isPlaceholder);
+            EXPECT_EQ(expectedImages[i].projected, actualImages[i].projected);
+        }
+    }
+
+    std::vector<std::pair<std::string, TimeRange>> expectedInstruments =
+        expected.getIstrumentTimes();
+    std::vector<std::pair<std::string, TimeRange>> actualInstruments =
+        actual.getIstrumentTimes();
+    ASSERT_EQ(expectedInstruments.size(), actualInstruments.size());
+    for (size_t i = 0; i < expectedInstruments.size(); ++i) {
+        EXPECT_EQ(expectedInstruments[i].first, actualInstruments[i].first);
+        EXPECT_EQ(expectedInstruments[i].second._min, actualInstruments[i].second._min);
+        EXPECT_EQ(expectedInstruments[i].second._max, actualInstruments[i].second._max);
+    }
+
+    EXPECT_EQ(expected.getTargetTimes(), actual.getTargetTimes());
+    EXPECT_EQ(expected.getCaptureProgression(), actual.getCaptureProgression());
+}
+
+} // namespace
+
+class SequenceParserTest : public testing::Test {
+protected:
+    void SetUp() override {
+        SpiceManager::initialize();
+        SpiceManager::ref().loadKernel("${TESTDIR}/SpiceTest/spicekernels/naif0008.tls");
+    }
+
+    void TearDown() override {
+        SpiceManager::deinitialize();
+    }
+
+    // Writes label files with an image each into a directory of the cache and returns
+    // the directory
+    std::string createLabelDirectory(const std::string& name, int nLabels) {
+        std::string file = FileSys.cacheManager()->cachedFilename(
+            name,
+            "",
+            ghoul::filesystem::CacheManager::Persistent::No
+        );
+        std::string directory = ghoul::filesystem::File(file).directoryName();
+
+        for (int i = 0; i < nLabels; ++i) {
+            std::ostringstream name;
+            name << directory << "/image_" << std::setw(4) << std::setfill('0') << i;
+
+            std::ofstream label(name.str() + ".lbl");
+            label << "TARGET_NAME = \"" << (i % 3 == 0 ? "MOON" : "PLANET") << "\"\n";
+            label << "INSTRUMENT_HOST_NAME = \"SPACECRAFT\"\n";
+            label << "INSTRUMENT_ID = \"CAM\"\n";
+            label << "DETECTOR_TYPE = \"CCD\"\n";
+            // Out of order, so that the merged results have to be sorted
+            label << "START_TIME = 2015-07-14T10:" << std::setfill('0') <<
+                std::setw(2) << (i * 7) % 60 << ":" << std::setw(2) << i % 60 << ".000\n";
+            label << "STOP_TIME = 2015-07-14T11:00:00.000\n";
+
+            std::ofstream image(name.str() + ".jpg");
+            image << "jpg";
+        }
+        return directory;
+    }
+
+    ghoul::Dictionary labelTranslation() {
+        using ghoul::Dictionary;
+        Dictionary camera({
+            { "DetectorType", std::string("Camera") },
+            { "Spice", Dictionary({ { "1", std::string("SC_CAM") } }) }
+        });
+        Dictionary read;
+        std::vector<std::string> keys = {
+            "TARGET_NAME", "INSTRUMENT_HOST_NAME", "INSTRUMENT_ID", "DETECTOR_TYPE",
+            "START_TIME", "STOP_TIME"
+        };
+        for (size_t i = 0; i < keys.size(); ++i) {
+            read.setValue(std::to_string(i + 1), keys[i]);
+        }
+        Dictionary convert({
+            { "PLANET", Dictionary({ { "1", std::string("PLANET") } }) },
+            { "MOON", Dictionary({ { "1", std::string("MOON") } }) }
+        });
+
+        return Dictionary({
+            { "Instrument", Dictionary({ { "CAM", camera } }) },
+            { "Target", Dictionary({ { "Read", read }, { "Convert", convert } }) }
+        });
+    }
+};
+
+TEST_F(SequenceParserTest, CachedDataRoundTrip) {
+    if (!FileSys.cacheManager())
+        return;
+
+    CachingParser original;
+    original.fill();
+    ASSERT_TRUE(original.save("RoundTrip"));
+
+    CachingParser cached;
+    ASSERT_TRUE(cached.load("RoundTrip")) << "The saved data should be a cache hit";
+    expectEqualData(original, cached);
+}
+
+TEST_F(SequenceParserTest, CacheMissLeavesDataUntouched) {
+    if (!FileSys.cacheManager())
+        return;
+
+    CachingParser original;
+    original.fill();
+    ASSERT_TRUE(original.save("Saved"));
+
+    CachingParser other;
+    EXPECT_FALSE(other.load("NeverSaved"));
+    EXPECT_TRUE(other.getSubsetMap().empty());
+    EXPECT_TRUE(other.getCaptureProgression().empty());
+
+    // A disabled cache is neither read nor written
+    other.setCacheEnabled(false);
+    EXPECT_FALSE(other.load("Saved"));
+    EXPECT_FALSE(other.save("Saved"));
+    EXPECT_TRUE(other.getSubsetMap().empty());
+}
+
+TEST_F(SequenceParserTest, KernelInformationFollowsLoadedKernels) {
+    std::string withLeapSeconds = CachingParser::kernels();
+    EXPECT_NE(std::string::npos, withLeapSeconds.find("naif0008.tls"));
+
+    SpiceManager::KernelHandle kernel = SpiceManager::ref().loadKernel(
+        "${TESTDIR}/SpiceTest/spicekernels/cas00084.tsc"
+    );
+    std::string withClock = CachingParser::kernels();
+    EXPECT_NE(withLeapSeconds, withClock) << "Loading a kernel has to invalidate caches";
+
+    SpiceManager::ref().unloadKernel(kernel);
+    EXPECT_EQ(withLeapSeconds, CachingParser::kernels());
+}
+
+TEST_F(SequenceParserTest, ParallelLabelParseMatchesSerialParse) {
+    if (!FileSys.cacheManager())
+        return;
+
+    std::string directory = createLabelDirectory("SequenceParserTestParallel", 64);
+
+    LabelParser serial("SequenceParserTestSerial", directory, labelTranslation());
+    serial.setCacheEnabled(false);
+    serial.setNumThreads(1);
+    ASSERT_TRUE(serial.create());
+
+    LabelParser parallel("SequenceParserTestParallel", directory, labelTranslation());
+    parallel.setCacheEnabled(false);
+    parallel.setNumThreads(8);
+    ASSERT_TRUE(parallel.create());
+
+    ASSERT_EQ(64, serial.getCaptureProgression().size());
+    EXPECT_EQ(2, serial.getSubsetMap().size());
+    expectEqualData(serial, parallel);
+}
+
+TEST_F(SequenceParserTest, CachedLabelParseMatchesParse) {
+    if (!FileSys.cacheManager())
+        return;
+
+    std::string directory = createLabelDirectory("SequenceParserTestCached", 16);
+
+    LabelParser parsed("SequenceParserTestCached", directory, labelTranslation());
+    parsed.setCacheEnabled(false);
+    ASSERT_TRUE(parsed.create());
+
+    // The first cached parse writes the cache, the second one reads it
+    LabelParser writer("SequenceParserTestCached", directory, labelTranslation());
+    ASSERT_TRUE(writer.create());
+    LabelParser cached("SequenceParserTestCached", directory, labelTranslation());
+    ASSERT_TRUE(cached.create());
+
+    expectEqualData(parsed, writer);
+    expectEqualData(parsed, cached);
+}
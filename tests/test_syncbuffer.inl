@@ -0,0 +1,138 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/syncbuffer.h>
+
+class SyncBufferTest : public testing::Test {};
+
+using openspace::SyncBuffer;
+
+TEST_F(SyncBufferTest, UnchangedValuesAreDecoded) {
+    SyncBuffer master(1024);
+    SyncBuffer node(1024);
+
+    const double values[] = { 1.0, 1.0, 2.0, 2.0 };
+    for (double v : values) {
+        master.encode(v);
+        master.encodeDelta(v);
+        node.readFrame(master.writeFrame());
+
+        double full = 0.0;
+        double delta = 0.0;
+        node.decode(full);
+        ASSERT_TRUE(node.decodeDelta(delta));
+        EXPECT_EQ(v, full);
+        EXPECT_EQ(v, delta);
+    }
+    // The second frame repeats the first one and the fourth repeats the third
+    EXPECT_EQ(1, node.statistics().unchangedValues);
+    EXPECT_EQ(0, node.statistics().missingValues);
+}
+
+TEST_F(SyncBufferTest, UnchangedValuesTakeOneByte) {
+    SyncBuffer master(1024);
+    master.encodeDelta(1.0);
+    const size_t keyframeSize = master.writeFrame().size();
+    master.encodeDelta(1.0);
+    const size_t deltaSize = master.writeFrame().size();
+    EXPECT_EQ(sizeof(double), keyframeSize - deltaSize);
+}
+
+TEST_F(SyncBufferTest, LateNodeWaitsForKeyframe) {
+    SyncBuffer master(1024);
+    std::vector<std::vector<char>> frames;
+    for (int i = 0; i < 200; ++i) {
+        master.encodeDelta(42);
+        frames.push_back(master.writeFrame());
+    }
+
+    // A node that joins after the first frame cannot decode the unchanged value, and
+    // keeps its own value instead of reading garbage, until the next keyframe
+    SyncBuffer node(1024);
+    int firstDecodedFrame = -1;
+    for (int i = 10; i < 200; ++i) {
+        node.readFrame(frames[i]);
+        int value = -1;
+        const bool isDecoded = node.decodeDelta(value);
+        if (!isDecoded) {
+            EXPECT_EQ(-1, value);
+            EXPECT_EQ(1, node.statistics().missingValues);
+        }
+        else {
+            EXPECT_EQ(42, value);
+            if (firstDecodedFrame == -1)
+                firstDecodedFrame = i;
+        }
+        if (firstDecodedFrame != -1) {
+            EXPECT_TRUE(isDecoded);
+        }
+    }
+    EXPECT_GT(firstDecodedFrame, 10);
+    EXPECT_LE(firstDecodedFrame, 70);
+}
+
+TEST_F(SyncBufferTest, MissedFrameForgetsPreviousValues) {
+    SyncBuffer master(1024);
+    std::vector<std::vector<char>> frames;
+    for (int i = 0; i < 4; ++i) {
+        master.encodeDelta(i < 2 ? 1 : 2);
+        frames.push_back(master.writeFrame());
+    }
+
+    // The value changed in the missed frame, so the unchanged marker of the next frame
+    // must not be resolved to the value before it
+    SyncBuffer node(1024);
+    int value = 0;
+    node.readFrame(frames[0]);
+    ASSERT_TRUE(node.decodeDelta(value));
+    node.readFrame(frames[1]);
+    ASSERT_TRUE(node.decodeDelta(value));
+    node.readFrame(frames[3]);
+    EXPECT_FALSE(node.decodeDelta(value));
+    EXPECT_EQ(1, value);
+}
+
+TEST_F(SyncBufferTest, RequestedKeyframeSendsFullValues) {
+    SyncBuffer master(1024);
+    for (int i = 0; i < 5; ++i) {
+        master.encodeDelta(7);
+        master.writeFrame();
+    }
+    master.requestKeyframe();
+    master.encodeDelta(7);
+    std::vector<char> keyframe = master.writeFrame();
+    master.encodeDelta(7);
+    std::vector<char> next = master.writeFrame();
+
+    SyncBuffer node(1024);
+    int value = 0;
+    node.readFrame(keyframe);
+    ASSERT_TRUE(node.decodeDelta(value));
+    EXPECT_EQ(7, value);
+    node.readFrame(next);
+    ASSERT_TRUE(node.decodeDelta(value));
+    EXPECT_EQ(7, value);
+}
@@ -26,6 +26,8 @@
 
 #include <modules/globebrowsing/other/threadpool.h>
 
+#include <atomic>
+
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -57,3 +59,26 @@ TEST_F(ThreadPoolTest, Basic) {
     std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     EXPECT_EQ(10, val) << "10 tasks taking 100 to 190 ms on 5 threads should take less than 1000 ms";
 }
+
+TEST_F(ThreadPoolTest, ClearTasksOfOwner) {
+    ThreadPool pool(1);
+
+    std::atomic<int> first(0);
+    std::atomic<int> second(0);
+    int ownerA = 0;
+    int ownerB = 0;
+
+    // Keep the only thread busy so that the following tasks stay in the queue
+    pool.enqueue([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    });
+    for (int i = 0; i < 5; ++i) {
+        pool.enqueue([&first]() { first++; }, &ownerA);
+        pool.enqueue([&second]() { second++; }, &ownerB);
+    }
+    pool.clearTasks(&ownerA);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    EXPECT_EQ(0, first) << "Tasks of the cleared owner should not run";
+    EXPECT_EQ(5, second) << "Tasks of other owners should still run";
+}
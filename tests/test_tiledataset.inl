@@ -0,0 +1,446 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/tile/asynctilereader.h>
+#include <modules/globebrowsing/tile/tiledataset.h>
+#include <modules/globebrowsing/tile/tilereadbatcher.h>
+#include <modules/globebrowsing/other/threadpool.h>
+
+#include "gdal_priv.h"
+#include "cpl_conv.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace openspace;
+
+class TileDatasetTest : public testing::Test {
+protected:
+    void SetUp() override {
+        GDALAllRegister();
+        _filename = std::string(CPLGenerateTempFilename("tiledatasettest")) + ".tif";
+
+        // A compressed, tiled global GeoTIFF with a full overview pyramid so that
+        // reading is dominated by decompression, as it is for real map data
+        GDALDriver* driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+        ASSERT_NE(driver, nullptr) << "GTiff driver is not available";
+        char** options = nullptr;
+        options = CSLSetNameValue(options, "TILED", "YES");
+        options = CSLSetNameValue(options, "COMPRESS", "DEFLATE");
+        GDALDataset* dataset = driver->Create(
+            _filename.c_str(), Width, Height, 1, GDT_Byte, options
+        );
+        CSLDestroy(options);
+        ASSERT_NE(dataset, nullptr) << "Failed to create " << _filename;
+
+        double geoTransform[6] = { -180.0, 360.0 / Width, 0.0, 90.0, 0.0, -180.0 / Height };
+        dataset->SetGeoTransform(geoTransform);
+
+        std::vector<GByte> data(Width * Height);
+        for (int y = 0; y < Height; ++y) {
+            for (int x = 0; x < Width; ++x) {
+                data[y * Width + x] = static_cast<GByte>((x ^ y) + (x * y >> 7));
+            }
+        }
+        CPLErr err = dataset->GetRasterBand(1)->RasterIO(GF_Write, 0, 0, Width, Height,
+            data.data(), Width, Height, GDT_Byte, 0, 0);
+        ASSERT_EQ(CE_None, err);
+
+        int overviews[] = { 2, 4, 8, 16, 32 };
+        err = dataset->BuildOverviews("AVERAGE", 5, overviews, 0, nullptr, nullptr,
+            nullptr);
+        ASSERT_EQ(CE_None, err);
+        GDALClose(dataset);
+    }
+
+    void TearDown() override {
+        std::remove(_filename.c_str());
+    }
+
+    std::vector<ChunkIndex> chunkIndices(int maxLevel) {
+        std::vector<ChunkIndex> indices;
+        for (int level = 1; level <= maxLevel; ++level) {
+            for (int y = 0; y < (1 << (level - 1)); ++y) {
+                for (int x = 0; x < (1 << level); ++x) {
+                    indices.push_back(ChunkIndex(x, y, level));
+                }
+            }
+        }
+        return indices;
+    }
+
+    // Reads all tiles using nThreads threads that share the same TileDataset
+    std::vector<std::shared_ptr<TileIOResult>> readTiles(TileDataset& tileDataset,
+        const std::vector<ChunkIndex>& indices, int nThreads)
+    {
+        std::vector<std::shared_ptr<TileIOResult>> results(indices.size());
+        std::atomic<size_t> next(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < nThreads; ++t) {
+            threads.push_back(std::thread([&]() {
+                size_t i;
+                while ((i = next++) < indices.size()) {
+                    results[i] = tileDataset.readTileData(indices[i]);
+                }
+            }));
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        return results;
+    }
+
+    void freeTiles(std::vector<std::shared_ptr<TileIOResult>>& results) {
+        for (auto& result : results) {
+            delete[] static_cast<char*>(result->imageData);
+        }
+    }
+
+    static const int Width = 4096;
+    static const int Height = 2048;
+    static const int MinimumPixelSize = 256;
+    std::string _filename;
+};
+
+TEST_F(TileDatasetTest, ConcurrentReadsMatchSequentialReads) {
+    const int nThreads = 4;
+    const int nRepetitions = 4;
+
+    TileDataset sequentialDataset(_filename, MinimumPixelSize, true);
+    TileDataset concurrentDataset(_filename, MinimumPixelSize, true);
+    ASSERT_GT(sequentialDataset.getMaximumLevel(), 1);
+
+    std::vector<ChunkIndex> indices;
+    for (int i = 0; i < nRepetitions; ++i) {
+        std::vector<ChunkIndex> repetition =
+            chunkIndices(sequentialDataset.getMaximumLevel());
+        indices.insert(indices.end(), repetition.begin(), repetition.end());
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto expected = readTiles(sequentialDataset, indices, 1);
+    std::chrono::duration<double, std::milli> sequentialTime =
+        std::chrono::high_resolution_clock::now() - start;
+
+    start = std::chrono::high_resolution_clock::now();
+    auto results = readTiles(concurrentDataset, indices, nThreads);
+    std::chrono::duration<double, std::milli> concurrentTime =
+        std::chrono::high_resolution_clock::now() - start;
+
+    EXPECT_EQ(1, sequentialDataset.getNumberOfOpenDatasets());
+    EXPECT_LE(concurrentDataset.getNumberOfOpenDatasets(), static_cast<size_t>(nThreads));
+
+    size_t bytesPerPixel = concurrentDataset.getDataLayout().bytesPerPixel;
+    ASSERT_EQ(expected.size(), results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        ASSERT_EQ(CE_None, results[i]->error);
+        ASSERT_EQ(expected[i]->dimensions, results[i]->dimensions);
+        size_t nBytes = bytesPerPixel * results[i]->dimensions.x *
+            results[i]->dimensions.y;
+        EXPECT_EQ(0, std::memcmp(expected[i]->imageData, results[i]->imageData, nBytes))
+            << "Tile " << indices[i].x << ", " << indices[i].y << ", " <<
+            indices[i].level << " differs";
+        EXPECT_EQ(expected[i]->preprocessData->maxValues,
+            results[i]->preprocessData->maxValues);
+    }
+
+    freeTiles(expected);
+    freeTiles(results);
+
+    RecordProperty("Tiles", static_cast<int>(indices.size()));
+    RecordProperty("SequentialMilliseconds", static_cast<int>(sequentialTime.count()));
+    RecordProperty("ConcurrentMilliseconds", static_cast<int>(concurrentTime.count()));
+}
+
+class AsyncTileDataProviderTest : public TileDatasetTest {
+protected:
+    // Updates the provider until all started reads have finished
+    void waitForReads(AsyncTileDataProvider& provider, size_t numReads,
+        const std::vector<ChunkIndex>& requests)
+    {
+        for (int i = 0; i < 1000 && provider.getRequestStatistics().numReads < numReads; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            for (const ChunkIndex& chunkIndex : requests) {
+                provider.enqueueTextureData(chunkIndex);
+            }
+            provider.update();
+        }
+    }
+
+    std::vector<std::shared_ptr<TileIOResult>> takeLoadedTiles(
+        AsyncTileDataProvider& provider)
+    {
+        std::vector<std::shared_ptr<TileIOResult>> results;
+        while (provider.hasLoadedTextureData()) {
+            results.push_back(provider.nextTileIOResult());
+        }
+        return results;
+    }
+};
+
+TEST_F(AsyncTileDataProviderTest, RepeatedRequestsAreReadOnce) {
+    std::shared_ptr<TileDataset> tileDataset(
+        new TileDataset(_filename, MinimumPixelSize, false));
+    AsyncTileDataProvider provider(tileDataset, std::make_shared<ThreadPool>(2));
+
+    ChunkIndex chunkIndex(2, 1, 2);
+    EXPECT_TRUE(provider.enqueueTextureData(chunkIndex));
+    EXPECT_FALSE(provider.enqueueTextureData(chunkIndex));
+
+    waitForReads(provider, 1, { chunkIndex });
+    auto results = takeLoadedTiles(provider);
+    ASSERT_EQ(1, results.size());
+    EXPECT_EQ(chunkIndex.hashKey(), results[0]->chunkIndex.hashKey());
+
+    const AsyncTileDataProvider::RequestStatistics& statistics =
+        provider.getRequestStatistics();
+    EXPECT_EQ(1, statistics.numRequests);
+    EXPECT_EQ(1, statistics.numReads);
+    EXPECT_EQ(0, statistics.numWastedReads);
+    EXPECT_GE(statistics.numRepeatedRequests, 1);
+    freeTiles(results);
+}
+
+TEST_F(AsyncTileDataProviderTest, ParentsAreReadFirst) {
+    std::shared_ptr<TileDataset> tileDataset(
+        new TileDataset(_filename, MinimumPixelSize, false));
+    AsyncTileDataProvider provider(tileDataset, std::make_shared<ThreadPool>(1));
+
+    // With a single thread, the tiles are read in the order they are started
+    std::vector<ChunkIndex> requests = {
+        ChunkIndex(5, 2, 3), ChunkIndex(1, 0, 1), ChunkIndex(2, 1, 2)
+    };
+    for (const ChunkIndex& chunkIndex : requests) {
+        provider.enqueueTextureData(chunkIndex);
+    }
+    waitForReads(provider, requests.size(), requests);
+
+    auto results = takeLoadedTiles(provider);
+    ASSERT_EQ(requests.size(), results.size());
+    EXPECT_EQ(1, results[0]->chunkIndex.level);
+    EXPECT_EQ(2, results[1]->chunkIndex.level);
+    EXPECT_EQ(3, results[2]->chunkIndex.level);
+    freeTiles(results);
+}
+
+TEST_F(AsyncTileDataProviderTest, RequestsOutOfViewAreCancelled) {
+    std::shared_ptr<TileDataset> tileDataset(
+        new TileDataset(_filename, MinimumPixelSize, false));
+    AsyncTileDataProvider provider(tileDataset, std::make_shared<ThreadPool>(1));
+
+    std::vector<ChunkIndex> requests = chunkIndices(tileDataset->getMaximumLevel());
+    ASSERT_GT(requests.size(), 4);
+    for (const ChunkIndex& chunkIndex : requests) {
+        provider.enqueueTextureData(chunkIndex);
+    }
+    // Starts at most two reads per thread
+    provider.update();
+
+    // None of the tiles are requested anymore
+    waitForReads(provider, 2, {});
+    auto results = takeLoadedTiles(provider);
+
+    const AsyncTileDataProvider::RequestStatistics& statistics =
+        provider.getRequestStatistics();
+    EXPECT_TRUE(results.empty()) << "Tiles that are no longer requested are discarded";
+    EXPECT_EQ(requests.size(), statistics.numRequests);
+    EXPECT_EQ(2, statistics.numReads);
+    EXPECT_EQ(2, statistics.numWastedReads);
+    EXPECT_EQ(requests.size() - 2, statistics.numCancelledRequests);
+}
+
+class TileReadBatcherTest : public TileDatasetTest {
+protected:
+    struct Publication {
+        size_t layer;
+        HashKey chunkHashKey;
+        int frame;
+    };
+
+    TileReadBatcher::PublishFunction publishFunction(size_t layer) {
+        return [this, layer](std::shared_ptr<TileIOResult> tileIOResult) {
+            _publications.push_back({ layer, tileIOResult->chunkIndex.hashKey(), _frame });
+            delete[] static_cast<char*>(tileIOResult->imageData);
+            return static_cast<size_t>(
+                tileIOResult->dimensions.x * tileIOResult->dimensions.y);
+        };
+    }
+
+    // Renders frames, requesting the chunks in all layers, until the batcher has
+    // published numChunks chunks
+    void renderFrames(TileReadBatcher& batcher,
+        std::vector<std::shared_ptr<AsyncTileDataProvider>>& layers,
+        const std::vector<ChunkIndex>& requests, size_t numChunks)
+    {
+        for (int i = 0; i < 1000 &&
+            batcher.getBatchStatistics().numPublishedChunks < numChunks; ++i)
+        {
+            for (auto& layer : layers) {
+                for (const ChunkIndex& chunkIndex : requests) {
+                    layer->enqueueTextureData(chunkIndex);
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            batcher.update();
+            for (auto& layer : layers) {
+                layer->update();
+            }
+            _frame++;
+        }
+    }
+
+    std::vector<std::shared_ptr<AsyncTileDataProvider>> createLayers(
+        std::shared_ptr<ThreadPool> pool, size_t numLayers)
+    {
+        std::vector<std::shared_ptr<AsyncTileDataProvider>> layers;
+        for (size_t i = 0; i < numLayers; ++i) {
+            std::shared_ptr<TileDataset> tileDataset(
+                new TileDataset(_filename, MinimumPixelSize, false));
+            layers.push_back(std::make_shared<AsyncTileDataProvider>(tileDataset, pool));
+        }
+        return layers;
+    }
+
+    std::vector<Publication> _publications;
+    int _frame = 0;
+};
+
+TEST_F(TileReadBatcherTest, ReadsAllLayersOfAChunkInOneJob) {
+    std::shared_ptr<ThreadPool> pool = std::make_shared<ThreadPool>(2);
+    TileReadBatcher batcher(pool);
+    std::vector<std::shared_ptr<AsyncTileDataProvider>> layers = createLayers(pool, 3);
+    for (size_t i = 0; i < layers.size(); ++i) {
+        batcher.addLayer(layers[i], publishFunction(i));
+    }
+
+    ChunkIndex chunkIndex(3, 1, 2);
+    renderFrames(batcher, layers, { chunkIndex }, 1);
+
+    const TileReadBatcher::BatchStatistics& statistics = batcher.getBatchStatistics();
+    EXPECT_EQ(1, statistics.numBatches);
+    EXPECT_EQ(layers.size(), statistics.numTileReads);
+    EXPECT_EQ(1, statistics.numPublishedChunks);
+    EXPECT_EQ(0, statistics.numDiscardedChunks);
+    EXPECT_GT(statistics.averageLatencyMilliseconds, 0.0);
+    EXPECT_GE(statistics.maximumLatencyMilliseconds, statistics.lastLatencyMilliseconds);
+
+    ASSERT_EQ(layers.size(), _publications.size());
+    for (size_t i = 0; i < layers.size(); ++i) {
+        EXPECT_EQ(chunkIndex.hashKey(), _publications[i].chunkHashKey);
+        EXPECT_EQ(_publications[0].frame, _publications[i].frame);
+        EXPECT_EQ(1, layers[i]->getRequestStatistics().numReads);
+    }
+}
+
+TEST_F(TileReadBatcherTest, ChunksArePublishedWhole) {
+    std::shared_ptr<ThreadPool> pool = std::make_shared<ThreadPool>(2);
+    // The budget is used up by the first layer, but the other layers of the chunk
+    // are still published in the same frame
+    TileReadBatcher batcher(pool, TileUploadScheduler::Budget(1, 1000.0));
+    std::vector<std::shared_ptr<AsyncTileDataProvider>> layers = createLayers(pool, 2);
+    for (size_t i = 0; i < layers.size(); ++i) {
+        batcher.addLayer(layers[i], publishFunction(i));
+    }
+
+    std::vector<ChunkIndex> requests = {
+        ChunkIndex(0, 0, 1), ChunkIndex(1, 0, 1), ChunkIndex(2, 1, 2), ChunkIndex(3, 1, 2)
+    };
+    renderFrames(batcher, layers, requests, requests.size());
+
+    ASSERT_EQ(requests.size() * layers.size(), _publications.size());
+    for (size_t i = 0; i < _publications.size(); i += layers.size()) {
+        for (size_t j = 1; j < layers.size(); ++j) {
+            EXPECT_EQ(_publications[i].chunkHashKey, _publications[i + j].chunkHashKey);
+            EXPECT_EQ(_publications[i].frame, _publications[i + j].frame);
+        }
+        if (i > 0) {
+            EXPECT_LT(_publications[i - 1].frame, _publications[i].frame)
+                << "Only one chunk is published per frame";
+        }
+    }
+}
+
+TEST_F(TileReadBatcherTest, DisabledLayersAreNotRead) {
+    std::shared_ptr<ThreadPool> pool = std::make_shared<ThreadPool>(2);
+    TileReadBatcher batcher(pool);
+    std::vector<std::shared_ptr<AsyncTileDataProvider>> layers = createLayers(pool, 2);
+    for (size_t i = 0; i < layers.size(); ++i) {
+        EXPECT_EQ(i, batcher.addLayer(layers[i], publishFunction(i)));
+    }
+
+    // The second layer requests a tile and is disabled before it is read. Disabled
+    // layers are no longer updated, so the request is never repeated nor expires
+    ChunkIndex disabledChunk(2, 1, 2);
+    layers[1]->enqueueTextureData(disabledChunk);
+    batcher.setLayerActive(1, false);
+    EXPECT_FALSE(batcher.isLayerActive(1));
+    EXPECT_FALSE(layers[1]->isRequested(disabledChunk));
+
+    std::vector<std::shared_ptr<AsyncTileDataProvider>> activeLayers = { layers[0] };
+    ChunkIndex chunkIndex(3, 1, 2);
+    renderFrames(batcher, activeLayers, { chunkIndex }, 1);
+    for (int i = 0; i < 10; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        batcher.update();
+        layers[0]->update();
+        _frame++;
+    }
+
+    EXPECT_EQ(1, batcher.getBatchStatistics().numTileReads);
+    EXPECT_EQ(0, layers[1]->getRequestStatistics().numReads);
+    ASSERT_EQ(1, _publications.size());
+    EXPECT_EQ(0, _publications[0].layer);
+    EXPECT_EQ(chunkIndex.hashKey(), _publications[0].chunkHashKey);
+
+    // Once enabled again, the layer is read together with the others
+    batcher.setLayerActive(1, true);
+    renderFrames(batcher, layers, { disabledChunk }, 2);
+    EXPECT_EQ(2, batcher.getBatchStatistics().numPublishedChunks);
+    EXPECT_EQ(1, layers[1]->getRequestStatistics().numReads);
+}
+
+TEST_F(TileReadBatcherTest, DestructionWaitsForRunningReads) {
+    std::shared_ptr<ThreadPool> pool = std::make_shared<ThreadPool>(1);
+    std::vector<std::shared_ptr<AsyncTileDataProvider>> layers = createLayers(pool, 2);
+    {
+        TileReadBatcher batcher(pool);
+        for (size_t i = 0; i < layers.size(); ++i) {
+            batcher.addLayer(layers[i], publishFunction(i));
+        }
+        for (auto& layer : layers) {
+            layer->enqueueTextureData(ChunkIndex(2, 1, 2));
+            layer->enqueueTextureData(ChunkIndex(3, 1, 2));
+        }
+        // Starts the reads, which are still running when the batcher is destroyed
+        batcher.update();
+        EXPECT_GE(batcher.getBatchStatistics().numBatches, 1);
+    }
+    EXPECT_TRUE(_publications.empty()) << "Unpublished reads are released, not published";
+}
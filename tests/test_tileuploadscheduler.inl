@@ -0,0 +1,206 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/tile/tileuploadscheduler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace openspace;
+
+class TileUploadSchedulerTest : public testing::Test {
+protected:
+    std::shared_ptr<TileIOResult> createResult(const ChunkIndex& chunkIndex) {
+        std::shared_ptr<TileIOResult> result(new TileIOResult);
+        result->imageData = nullptr;
+        result->dimensions = glm::uvec3(512, 512, 1);
+        result->chunkIndex = chunkIndex;
+        result->error = CE_None;
+        return result;
+    }
+};
+
+TEST_F(TileUploadSchedulerTest, ByteBudgetCarriesOverUploads) {
+    const size_t TileSize = 1024 * 1024;
+    TileUploadScheduler scheduler(TileUploadScheduler::Budget(3 * TileSize, 1e6));
+    for (int i = 0; i < 10; ++i) {
+        scheduler.add(createResult(ChunkIndex(i, 0, 4)));
+    }
+
+    auto upload = [&](std::shared_ptr<TileIOResult>) { return TileSize; };
+    std::vector<size_t> uploadsPerFrame;
+    while (scheduler.numPendingUploads() > 0) {
+        uploadsPerFrame.push_back(scheduler.upload(upload));
+    }
+
+    std::vector<size_t> expected = { 3, 3, 3, 1 };
+    EXPECT_EQ(expected, uploadsPerFrame);
+    EXPECT_EQ(0, scheduler.upload(upload)) << "Nothing should be left to upload";
+}
+
+TEST_F(TileUploadSchedulerTest, AlwaysUploadsOneTile) {
+    TileUploadScheduler scheduler(TileUploadScheduler::Budget(0, 0.0));
+    scheduler.add(createResult(ChunkIndex(0, 0, 1)));
+    scheduler.add(createResult(ChunkIndex(1, 0, 1)));
+
+    auto upload = [](std::shared_ptr<TileIOResult>) { return size_t(1); };
+    EXPECT_EQ(1, scheduler.upload(upload));
+    EXPECT_EQ(1, scheduler.upload(upload));
+    EXPECT_EQ(0, scheduler.numPendingUploads());
+}
+
+TEST_F(TileUploadSchedulerTest, SharedBudgetLimitsAllSchedulers) {
+    const size_t TileSize = 1024 * 1024;
+    auto frameBudget = std::make_shared<TileUploadScheduler::FrameBudget>(
+        TileUploadScheduler::Budget(3 * TileSize, 1e6));
+
+    // One scheduler per layer or time step, all drawing from the same budget
+    std::vector<std::unique_ptr<TileUploadScheduler>> schedulers;
+    for (int i = 0; i < 8; ++i) {
+        schedulers.emplace_back(new TileUploadScheduler(frameBudget));
+        for (int j = 0; j < 4; ++j) {
+            schedulers.back()->add(createResult(ChunkIndex(j, i, 4)));
+        }
+    }
+
+    auto upload = [&](std::shared_ptr<TileIOResult>) { return TileSize; };
+    size_t nFrames = 0;
+    size_t nPending = 8 * 4;
+    while (nPending > 0) {
+        frameBudget->startFrame();
+        size_t nUploaded = 0;
+        for (const auto& scheduler : schedulers) {
+            nUploaded += scheduler->upload(upload);
+        }
+        EXPECT_EQ(std::min<size_t>(3, nPending), nUploaded);
+        nPending -= nUploaded;
+        ++nFrames;
+    }
+    EXPECT_EQ(11, nFrames);
+
+    // Once the budget is used up, the schedulers wait for the next frame
+    for (int j = 0; j < 4; ++j) {
+        schedulers[0]->add(createResult(ChunkIndex(j, 0, 2)));
+    }
+    frameBudget->startFrame();
+    EXPECT_EQ(3, schedulers[0]->upload(upload));
+    EXPECT_EQ(0, schedulers[1]->upload(upload));
+    EXPECT_EQ(0, schedulers[0]->upload(upload));
+    frameBudget->startFrame();
+    EXPECT_EQ(1, schedulers[0]->upload(upload));
+}
+
+TEST_F(TileUploadSchedulerTest, SharedBudgetUploadsOneTilePerFrame) {
+    auto frameBudget = std::make_shared<TileUploadScheduler::FrameBudget>(
+        TileUploadScheduler::Budget(0, 0.0));
+    TileUploadScheduler first(frameBudget);
+    TileUploadScheduler second(frameBudget);
+    first.add(createResult(ChunkIndex(0, 0, 1)));
+    second.add(createResult(ChunkIndex(1, 0, 1)));
+
+    auto upload = [](std::shared_ptr<TileIOResult>) { return size_t(1); };
+    frameBudget->startFrame();
+    EXPECT_EQ(1, first.upload(upload) + second.upload(upload));
+    frameBudget->startFrame();
+    EXPECT_EQ(1, first.upload(upload) + second.upload(upload));
+    EXPECT_EQ(0, first.numPendingUploads() + second.numPendingUploads());
+}
+
+TEST_F(TileUploadSchedulerTest, TimeBudgetLimitsUploads) {
+    TileUploadScheduler scheduler(TileUploadScheduler::Budget(1024 * 1024 * 1024, 5.0));
+    for (int i = 0; i < 20; ++i) {
+        scheduler.add(createResult(ChunkIndex(i, 0, 5)));
+    }
+
+    auto upload = [](std::shared_ptr<TileIOResult>) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return size_t(1);
+    };
+    size_t nUploaded = scheduler.upload(upload);
+    EXPECT_GE(nUploaded, 1);
+    EXPECT_LE(nUploaded, 3);
+    EXPECT_EQ(20 - nUploaded, scheduler.numPendingUploads());
+}
+
+TEST_F(TileUploadSchedulerTest, UploadsInOrderOfImportance) {
+    TileUploadScheduler scheduler;
+    auto noUpload = [](std::shared_ptr<TileIOResult>) { return size_t(0); };
+
+    // Requested in an earlier frame only
+    ChunkIndex old(3, 1, 2);
+    scheduler.markRequested(old);
+    scheduler.upload(noUpload);
+
+    // The most detailed request defines the focus, which lies within 'near'
+    ChunkIndex coarse(1, 0, 2);
+    ChunkIndex near(10, 5, 4);
+    ChunkIndex far(0, 0, 4);
+    ChunkIndex focus(20, 10, 5);
+    scheduler.markRequested(coarse);
+    scheduler.markRequested(far);
+    scheduler.markRequested(near);
+    scheduler.markRequested(focus);
+
+    scheduler.add(createResult(old));
+    scheduler.add(createResult(far));
+    scheduler.add(createResult(near));
+    scheduler.add(createResult(coarse));
+
+    std::vector<HashKey> order;
+    scheduler.upload([&](std::shared_ptr<TileIOResult> result) {
+        order.push_back(result->chunkIndex.hashKey());
+        return size_t(0);
+    });
+
+    std::vector<HashKey> expected = {
+        coarse.hashKey(), near.hashKey(), far.hashKey(), old.hashKey()
+    };
+    EXPECT_EQ(expected, order);
+}
+
+TEST_F(TileUploadSchedulerTest, LoadedTilesAreNotReadAgain) {
+    TileUploadScheduler scheduler;
+    ChunkIndex chunkIndex(3, 1, 2);
+
+    EXPECT_TRUE(scheduler.markRequested(chunkIndex));
+
+    // The tile is read and waits for its upload, while it is still being requested
+    scheduler.add(createResult(chunkIndex));
+    EXPECT_TRUE(scheduler.isPending(chunkIndex));
+    EXPECT_FALSE(scheduler.markRequested(chunkIndex));
+
+    size_t nUploads = 0;
+    scheduler.upload([&](std::shared_ptr<TileIOResult>) {
+        ++nUploads;
+        return size_t(0);
+    });
+    EXPECT_EQ(1, nUploads);
+    EXPECT_FALSE(scheduler.isPending(chunkIndex));
+    EXPECT_TRUE(scheduler.markRequested(chunkIndex));
+}
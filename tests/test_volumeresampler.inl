@@ -0,0 +1,90 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2016                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <glm/glm.hpp>
+#include <functional>
+#include <vector>
+
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/volumesampler.h>
+#include <modules/volume/volumeresampler.h>
+
+class VolumeResamplerTest : public testing::Test {
+protected:
+    // Resamples the volume with the VolumeResampler and compares every voxel with the
+    // result of the VolumeSampler
+    void compareWithSampler(const openspace::RawVolume<float>& volume,
+                            const glm::ivec3& outDimensions, unsigned int nThreads)
+    {
+        using namespace openspace;
+
+        glm::vec3 resolutionRatio =
+            glm::vec3(volume.dimensions()) / glm::vec3(outDimensions);
+        VolumeSampler<RawVolume<float>> sampler(volume, resolutionRatio);
+
+        VolumeResampler<RawVolume<float>> resampler(volume, outDimensions, nThreads);
+        ASSERT_EQ(outDimensions, resampler.dimensions());
+
+        std::vector<float> slice(outDimensions.x * outDimensions.y);
+        for (int z = 0; z < outDimensions.z; ++z) {
+            resampler.sampleSlice(z, slice.data());
+            for (int y = 0; y < outDimensions.y; ++y) {
+                for (int x = 0; x < outDimensions.x; ++x) {
+                    glm::vec3 inCoord = (glm::vec3(x, y, z) + glm::vec3(0.5)) *
+                        resolutionRatio - glm::vec3(0.5);
+                    float expected = sampler.sample(inCoord);
+                    EXPECT_NEAR(expected, slice[y * outDimensions.x + x], 1e-3f) <<
+                        "at " << x << ", " << y << ", " << z;
+                }
+            }
+        }
+    }
+
+    openspace::RawVolume<float> createVolume(const glm::ivec3& dimensions) {
+        openspace::RawVolume<float> volume(dimensions);
+        size_t size = static_cast<size_t>(dimensions.x) * dimensions.y * dimensions.z;
+        for (size_t i = 0; i < size; ++i) {
+            volume.set(i, static_cast<float>((i * 7919) % 101));
+        }
+        return volume;
+    }
+};
+
+TEST_F(VolumeResamplerTest, Downsampling) {
+    openspace::RawVolume<float> volume = createVolume(glm::ivec3(37, 23, 19));
+    compareWithSampler(volume, glm::ivec3(8, 5, 3), 1);
+    compareWithSampler(volume, glm::ivec3(8, 5, 3), 4);
+}
+
+TEST_F(VolumeResamplerTest, SameResolution) {
+    openspace::RawVolume<float> volume = createVolume(glm::ivec3(16, 12, 8));
+    compareWithSampler(volume, glm::ivec3(16, 12, 8), 2);
+}
+
+TEST_F(VolumeResamplerTest, Upsampling) {
+    openspace::RawVolume<float> volume = createVolume(glm::ivec3(9, 7, 5));
+    compareWithSampler(volume, glm::ivec3(20, 11, 7), 3);
+}